@@ -0,0 +1,462 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2018 The Regents of the University of Michigan and DFT-FE authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+
+#ifndef cellQuadratureField_H_
+#define cellQuadratureField_H_
+
+#include <vector>
+#include <map>
+#include <memory>
+
+#include "headers.h"
+
+namespace dftfe {
+//
+//Declare dftUtils functions
+//
+namespace dftUtils
+{
+
+  /**
+   *  @brief Enumeration of the locally owned cells on which cell quadrature data is stored.
+   *
+   *  Cells are numbered contiguously in the order in which dealii::MatrixFree visits them
+   *  (macro cell major, sub cell minor), so that the macro cell loops used in the
+   *  FEEvaluation based kernels can address the quadrature data of a cell without a
+   *  CellId lookup. A layout can also be generated from a triangulation, in which case every
+   *  locally owned active cell forms its own macro cell. A single layout is shared between
+   *  all quadrature fields defined on the same triangulation.
+   */
+  class cellQuadratureFieldLayout
+  {
+
+  public:
+
+    /**
+     * class constructor
+     */
+    cellQuadratureFieldLayout();
+
+    /**
+     * @brief enumerate the cells in the order of the macro cells of a MatrixFree object
+     *
+     * @param matrixFreeData MatrixFree object
+     * @param dofHandlerIndex index of the DoFHandler in matrixFreeData used to access the cells
+     */
+    void reinit(const dealii::MatrixFree<3,double> & matrixFreeData,
+		const unsigned int dofHandlerIndex=0);
+
+    /**
+     * @brief enumerate the locally owned active cells of a triangulation in the iterator order
+     *
+     * @param triangulation triangulation object
+     */
+    void reinit(const dealii::Triangulation<3> & triangulation);
+
+    /**
+     * @brief number of locally owned cells
+     */
+    unsigned int nCells() const;
+
+    /**
+     * @brief number of macro cells
+     */
+    unsigned int nMacroCells() const;
+
+    /**
+     * @brief number of sub cells of a macro cell
+     */
+    unsigned int nSubCells(const unsigned int macroCell) const;
+
+    /**
+     * @brief cell index of a given sub cell of a macro cell
+     */
+    unsigned int cellIndex(const unsigned int macroCell,
+	                   const unsigned int subCell) const;
+
+    /**
+     * @brief cell index of a given locally owned cell
+     */
+    unsigned int cellIndex(const dealii::CellId & cellId) const;
+
+    /**
+     * @brief CellId of a given cell index
+     */
+    const dealii::CellId & cellId(const unsigned int cellIndex) const;
+
+  private:
+
+    std::vector<dealii::CellId> d_cellIds;
+    std::map<dealii::CellId,unsigned int> d_cellIdToCellIndexMap;
+    std::vector<unsigned int> d_macroCellStartIndex;
+
+  };
+
+  /**
+   *  @brief Flat storage of quadrature point data on the locally owned cells.
+   *
+   *  Stores a fixed number of values per cell in one contiguous aligned buffer addressed by
+   *  the cell index of a cellQuadratureFieldLayout. Replaces std::map<dealii::CellId,std::vector<double> >
+   *  for fields like the electron-density and its gradient which are accessed in every SCF iteration.
+   *  The CellId based access operator is provided for the code paths which are not performance
+   *  critical.
+   */
+  class cellQuadratureField
+  {
+
+  public:
+
+    /**
+     * class constructor
+     */
+    cellQuadratureField();
+
+    /**
+     * @brief allocate storage for a given layout and set all values to zero
+     *
+     * @param layout cell layout shared with other fields
+     * @param nValuesPerCell number of values stored per cell
+     */
+    void reinit(const std::shared_ptr<const cellQuadratureFieldLayout> & layout,
+	        const unsigned int nValuesPerCell);
+
+    /**
+     * @brief copy values from another field with the same number of values per cell. If the
+     * layouts are different the values are copied cell by cell using the CellIds.
+     */
+    void copyFrom(const cellQuadratureField & field);
+
+    /**
+     * @brief copy values from std::map<dealii::CellId,std::vector<double> > based storage
+     */
+    void copyFrom(const std::map<dealii::CellId, std::vector<double> > & cellQuadDataMap);
+
+    /**
+     * @brief copy values to std::map<dealii::CellId,std::vector<double> > based storage
+     */
+    void copyTo(std::map<dealii::CellId, std::vector<double> > & cellQuadDataMap) const;
+
+    /**
+     * @brief pointer to the values of a locally owned cell
+     */
+    double * operator[](const dealii::CellId & cellId);
+
+    /**
+     * @brief pointer to the values of a locally owned cell
+     */
+    const double * operator[](const dealii::CellId & cellId) const;
+
+    /**
+     * @brief pointer to the values of a cell given its cell index
+     */
+    double * cellData(const unsigned int cellIndex);
+
+    /**
+     * @brief pointer to the values of a cell given its cell index
+     */
+    const double * cellData(const unsigned int cellIndex) const;
+
+    /**
+     * @brief pointer to the beginning of the flat storage
+     */
+    double * data();
+
+    /**
+     * @brief pointer to the beginning of the flat storage
+     */
+    const double * data() const;
+
+    /**
+     * @brief total number of values stored
+     */
+    unsigned int size() const;
+
+    /**
+     * @brief number of values stored per cell
+     */
+    unsigned int nValuesPerCell() const;
+
+    /**
+     * @brief cell layout
+     */
+    const std::shared_ptr<const cellQuadratureFieldLayout> & getLayout() const;
+
+    /**
+     * @brief set all values to zero
+     */
+    void setZero();
+
+    /**
+     * clear data members
+     */
+    void clear();
+
+  private:
+
+    std::shared_ptr<const cellQuadratureFieldLayout> d_layout;
+    unsigned int d_nValuesPerCell;
+    dealii::AlignedVector<double> d_data;
+
+  };
+
+
+  /**
+   *  @brief Fixed capacity ring buffer of cellQuadratureField objects used for the mixing histories.
+   *
+   *  The storage of the slots is retained when fields are dropped from the history, so once the
+   *  history has reached its capacity adding a new field reuses the storage of the oldest one and
+   *  no memory is allocated. Fields are accessed as in a std::deque with index 0 denoting the
+   *  oldest field. References to the fields stay valid until the corresponding slot is reused.
+   */
+  class cellQuadratureFieldHistory
+  {
+
+  public:
+
+    /**
+     * class constructor
+     */
+    cellQuadratureFieldHistory();
+
+    /**
+     * @brief set the maximum number of fields stored. Clears the history.
+     */
+    void setCapacity(const unsigned int capacity);
+
+    /**
+     * @brief maximum number of fields stored
+     */
+    unsigned int capacity() const;
+
+    /**
+     * @brief number of fields currently stored
+     */
+    unsigned int size() const;
+
+    /**
+     * @brief whether the history is empty
+     */
+    bool empty() const;
+
+    /**
+     * @brief access a field, index 0 being the oldest
+     */
+    cellQuadratureField & operator[](const unsigned int index);
+
+    /**
+     * @brief access a field, index 0 being the oldest
+     */
+    const cellQuadratureField & operator[](const unsigned int index) const;
+
+    /**
+     * @brief oldest field
+     */
+    cellQuadratureField & front();
+
+    /**
+     * @brief most recent field
+     */
+    cellQuadratureField & back();
+
+    /**
+     * @brief most recent field
+     */
+    const cellQuadratureField & back() const;
+
+    /**
+     * @brief append a field set to zero. If the history is full the oldest field is dropped and its
+     * storage reused.
+     *
+     * @return reference to the appended field
+     */
+    cellQuadratureField & push_back(const std::shared_ptr<const cellQuadratureFieldLayout> & layout,
+		                    const unsigned int nValuesPerCell);
+
+    /**
+     * @brief append a copy of a field. If the history is full the oldest field is dropped and its
+     * storage reused.
+     */
+    void push_back(const cellQuadratureField & field);
+
+    /**
+     * @brief drop the oldest field. Its storage is retained for reuse.
+     */
+    void pop_front();
+
+    /**
+     * @brief drop all fields. The storage is retained for reuse.
+     */
+    void clear();
+
+  private:
+
+    /// index of the slot holding a given field of the history
+    unsigned int slotIndex(const unsigned int index) const;
+
+    /// index of the slot to be filled by push_back
+    unsigned int nextSlotIndex();
+
+    std::vector<cellQuadratureField> d_slots;
+    unsigned int d_head;
+    unsigned int d_size;
+
+  };
+
+  inline
+  unsigned int cellQuadratureFieldLayout::nCells() const
+  {
+    return d_cellIds.size();
+  }
+
+  inline
+  unsigned int cellQuadratureFieldLayout::nMacroCells() const
+  {
+    return d_macroCellStartIndex.size()-1;
+  }
+
+  inline
+  unsigned int cellQuadratureFieldLayout::nSubCells(const unsigned int macroCell) const
+  {
+    return d_macroCellStartIndex[macroCell+1]-d_macroCellStartIndex[macroCell];
+  }
+
+  inline
+  unsigned int cellQuadratureFieldLayout::cellIndex(const unsigned int macroCell,
+	                                            const unsigned int subCell) const
+  {
+    return d_macroCellStartIndex[macroCell]+subCell;
+  }
+
+  inline
+  const dealii::CellId & cellQuadratureFieldLayout::cellId(const unsigned int cellIndex) const
+  {
+    return d_cellIds[cellIndex];
+  }
+
+  inline
+  double * cellQuadratureField::operator[](const dealii::CellId & cellId)
+  {
+    return &d_data[d_layout->cellIndex(cellId)*d_nValuesPerCell];
+  }
+
+  inline
+  const double * cellQuadratureField::operator[](const dealii::CellId & cellId) const
+  {
+    return &d_data[d_layout->cellIndex(cellId)*d_nValuesPerCell];
+  }
+
+  inline
+  double * cellQuadratureField::cellData(const unsigned int cellIndex)
+  {
+    return &d_data[cellIndex*d_nValuesPerCell];
+  }
+
+  inline
+  const double * cellQuadratureField::cellData(const unsigned int cellIndex) const
+  {
+    return &d_data[cellIndex*d_nValuesPerCell];
+  }
+
+  inline
+  double * cellQuadratureField::data()
+  {
+    return d_data.begin();
+  }
+
+  inline
+  const double * cellQuadratureField::data() const
+  {
+    return d_data.begin();
+  }
+
+  inline
+  unsigned int cellQuadratureField::size() const
+  {
+    return d_data.size();
+  }
+
+  inline
+  unsigned int cellQuadratureField::nValuesPerCell() const
+  {
+    return d_nValuesPerCell;
+  }
+
+  inline
+  const std::shared_ptr<const cellQuadratureFieldLayout> & cellQuadratureField::getLayout() const
+  {
+    return d_layout;
+  }
+
+
+  inline
+  unsigned int cellQuadratureFieldHistory::capacity() const
+  {
+    return d_slots.size();
+  }
+
+  inline
+  unsigned int cellQuadratureFieldHistory::size() const
+  {
+    return d_size;
+  }
+
+  inline
+  bool cellQuadratureFieldHistory::empty() const
+  {
+    return d_size==0;
+  }
+
+  inline
+  unsigned int cellQuadratureFieldHistory::slotIndex(const unsigned int index) const
+  {
+    return (d_head+index)%d_slots.size();
+  }
+
+  inline
+  cellQuadratureField & cellQuadratureFieldHistory::operator[](const unsigned int index)
+  {
+    return d_slots[slotIndex(index)];
+  }
+
+  inline
+  const cellQuadratureField & cellQuadratureFieldHistory::operator[](const unsigned int index) const
+  {
+    return d_slots[slotIndex(index)];
+  }
+
+  inline
+  cellQuadratureField & cellQuadratureFieldHistory::front()
+  {
+    return d_slots[d_head];
+  }
+
+  inline
+  cellQuadratureField & cellQuadratureFieldHistory::back()
+  {
+    return d_slots[slotIndex(d_size-1)];
+  }
+
+  inline
+  const cellQuadratureField & cellQuadratureFieldHistory::back() const
+  {
+    return d_slots[slotIndex(d_size-1)];
+  }
+
+}
+
+}
+#endif
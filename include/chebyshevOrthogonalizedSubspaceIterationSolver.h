@@ -63,7 +63,8 @@ namespace dftfe{
 					    std::vector<double> & eigenValues,
 					    std::vector<double> & residuals,
 					    const MPI_Comm &interBandGroupComm,
-					    const bool useMixedPrec);
+					    const bool useMixedPrec,
+					    const bool useMixedPrecCheby=false);
 
     /**
      * @brief Solve a generalized eigen problem.
@@ -79,6 +80,89 @@ namespace dftfe{
     void reinitSpectrumBounds(double lowerBoundWantedSpectrum,
 			      double lowerBoundUnWantedSpectrum);
 
+    /**
+     * @brief set the Chebyshev polynomial degree to be used in the next solve. If set to 0,
+     * the value of CHEBYSHEV POLYNOMIAL DEGREE or the default value depending on the upper
+     * bound of the eigen-spectrum is used.
+     */
+    void setChebyshevPolynomialDegree(const unsigned int chebyshevOrder);
+
+    /**
+     * @brief Chebyshev polynomial degree used in the last solve
+     */
+    unsigned int getChebyshevPolynomialDegree() const;
+
+    /**
+     * @brief set the upper bound of the unwanted spectrum to be used in the next solve instead of the
+     * k-step Lanczos estimate. If set to 0, the upper bound is estimated using the Lanczos iteration.
+     */
+    void setUpperBoundUnWantedSpectrum(const double upperBoundUnWantedSpectrum);
+
+    /**
+     * @brief upper bound of the unwanted spectrum used in the last solve
+     */
+    double getUpperBoundUnWantedSpectrum() const;
+
+    /**
+     * @brief wall time of the Chebyshev filtering per polynomial degree in the last solve
+     */
+    double getFilterWallTimePerDegree() const;
+
+    /**
+     * @brief wall time of the orthogonalization, Rayleigh-Ritz and residual computation steps in the last solve
+     */
+    double getSubspaceWallTime() const;
+
+    /**
+     * @brief set whether the next solve with the spectrum split uses a partial Rayleigh-Ritz step. In the
+     * partial Rayleigh-Ritz step, the valence Ritz pairs are taken from the partial diagonalization of the
+     * projected Hamiltonian over the full subspace and only the secondary dense Rayleigh-Ritz step on the
+     * valence block of the subspace is skipped. The projection over the full subspace is still computed.
+     * The valence block of the subspace is only rotated within its own span, so the subspace stays
+     * orthonormal, and the core block is reused as is.
+     */
+    void setPartialRayleighRitz(const bool partialRayleighRitz);
+
+    /**
+     * @brief set the residual norms of the eigenstates from the last solve to be used for soft locking
+     * in the next solve. The residual norms correspond to the highest eigenstates of the subspace. Blocks
+     * of eigenstates whose residual norms are all below LOCKING RESIDUAL TOL are filtered with the lower
+     * Chebyshev polynomial degree LOCKED STATES CHEBYSHEV DEGREE or not filtered at all, but are still
+     * part of the orthogonalization and Rayleigh-Ritz steps.
+     */
+    void setLockingResidualNorms(const std::vector<double> & residualNorms);
+
+    /**
+     * @brief compute the Chebyshev polynomial degree for the next solve of a given k point and spin from the
+     * residual reduction of the highest occupied state and the cost of the steps of the last solve of the same
+     * k point and spin.
+     *
+     * The residual reduction per polynomial degree is estimated from the Ritz value of the highest occupied state
+     * relative to the filtering interval and, if available, from the residual reduction measured in the last solve.
+     * The degree is chosen to reduce the residual norm by one order of magnitude. Only with ADAPTIVE CHEBYSHEV POLYNOMIAL
+     * DEGREE WALL TIME, it is not chosen below the degree for which the measured wall time of the Chebyshev filtering
+     * equals that of the orthogonalization, Rayleigh-Ritz and residual computation steps.
+     *
+     * @param highestOccupiedRitzValue Ritz value of the highest occupied state
+     * @param residualNorm residual norm of the highest occupied state after the last solve
+     * @param measuredResidualReductionRate logarithm of the residual reduction of the highest occupied state per
+     * polynomial degree measured in the last solve. Negative if not available.
+     * @param upperBoundUnWantedSpectrum upper bound of the unwanted spectrum used in the last solve
+     * @param lowerBoundUnWantedSpectrum lower bound of the unwanted spectrum to be used in the next solve
+     * @param filterWallTimePerDegree wall time of the Chebyshev filtering per polynomial degree in the last solve
+     * @param subspaceWallTime wall time of the orthogonalization, Rayleigh-Ritz and residual computation steps
+     * in the last solve
+     *
+     * @return Chebyshev polynomial degree
+     */
+    unsigned int computeAdaptiveChebyshevPolynomialDegree(const double highestOccupiedRitzValue,
+							  const double residualNorm,
+							  const double measuredResidualReductionRate,
+							  const double upperBoundUnWantedSpectrum,
+							  const double lowerBoundUnWantedSpectrum,
+							  const double filterWallTimePerDegree,
+							  const double subspaceWallTime) const;
+
   private:
     //
     //stores lower bound of wanted spectrum
@@ -90,6 +174,37 @@ namespace dftfe{
     //
     double d_lowerBoundUnWantedSpectrum;
 
+    //
+    //upper bound of unwanted spectrum requested for the next solve (0 if not set) and
+    //upper bound of unwanted spectrum of the last solve
+    //
+    double d_upperBoundUnWantedSpectrumRequested;
+    double d_upperBoundUnWantedSpectrum;
+
+    //
+    //Chebyshev polynomial degree requested for the next solve (0 if not set) and
+    //Chebyshev polynomial degree used in the last solve
+    //
+    unsigned int d_chebyshevOrderRequested;
+    unsigned int d_chebyshevOrder;
+
+    //
+    //partial Rayleigh-Ritz step requested for the next solve
+    //
+    bool d_partialRayleighRitzRequested;
+
+    //
+    //residual norms of the highest eigenstates from the last solve used for soft locking in the next solve
+    //
+    std::vector<double> d_lockingResidualNorms;
+
+    //
+    //wall times of the Chebyshev filtering per polynomial degree and of the orthogonalization,
+    //Rayleigh-Ritz and residual computation steps in the last solve
+    //
+    double d_filterWallTimePerDegree;
+    double d_subspaceWallTime;
+
     //
     //variables for printing out and timing
     //
@@ -84,10 +84,13 @@ namespace dftUtils
      * the slave node field values from master nodes
      *
      * @param blockSize number of components for a given node
+     * @param updateGhostValues if false the ghost values of fieldVector are assumed to be
+     * up to date already, for instance after a split update_ghost_values_start/finish call
      */
     template<typename T>
     void distribute(dealii::parallel::distributed::Vector<T> &fieldVector,
-		    const unsigned int blockSize) const;
+		    const unsigned int blockSize,
+		    const bool updateGhostValues=true) const;
 
     /**
      * @brief transfers the contributions of slave nodes to master nodes using the constraint equation
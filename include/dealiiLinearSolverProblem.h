@@ -78,10 +78,31 @@ namespace dftfe {
 	/// function needed by dealii to mimic SparseMatrix
         virtual bool operator!= (double val) const =0;
 
+	/**
+	 * @brief get the estimate of the largest eigenvalue of the Jacobi preconditioned A
+	 * cached by the linear solver.
+	 *
+	 * @return cached estimate. Zero if not available, or if A has changed since the estimate
+	 */
+	double getMaxEigenValueJacobiPreconditioned() const;
+
+	/**
+	 * @brief cache the estimate of the largest eigenvalue of the Jacobi preconditioned A for
+	 * reuse in the linear solves with the same A. Derived classes reset it to zero when A changes.
+	 *
+	 * @param maxEigenValue estimate to be cached
+	 */
+	void setMaxEigenValueJacobiPreconditioned(const double maxEigenValue);
+
      //protected:
 
 	 /// typedef declaration needed by dealii
 	typedef dealii::types::global_dof_index size_type;
+
+     private:
+
+	/// cached estimate of the largest eigenvalue of the Jacobi preconditioned A
+	double d_maxEigenValueJacobiPreconditioned;
     };
 
 }
@@ -26,6 +26,7 @@
 #include <headers.h>
 #include <constants.h>
 #include <constraintMatrixInfo.h>
+#include <cellQuadratureField.h>
 
 #include <kohnShamDFTOperator.h>
 #include <meshMovementAffineTransform.h>
@@ -330,10 +331,10 @@ namespace dftfe {
        *@brief computes density quadratrue dat from wavefunctions
        */
       void computeRhoFromPSI
-		    (std::map<dealii::CellId, std::vector<double> > * _rhoValues,
-		     std::map<dealii::CellId, std::vector<double> > * _gradRhoValues,
-		     std::map<dealii::CellId, std::vector<double> > * _rhoValuesSpinPolarized,
-		     std::map<dealii::CellId, std::vector<double> > * _gradRhoValuesSpinPolarized,
+		    (dftUtils::cellQuadratureField * _rhoValues,
+		     dftUtils::cellQuadratureField * _gradRhoValues,
+		     dftUtils::cellQuadratureField * _rhoValuesSpinPolarized,
+		     dftUtils::cellQuadratureField * _gradRhoValuesSpinPolarized,
 		     const bool isEvaluateGradRho,
 		     const bool isConsiderSpectrumSplitting);
 
@@ -341,10 +342,10 @@ namespace dftfe {
       /**
        *@brief sums rho cell quadratrure data from  inter communicator
        */
-      void sumRhoData(std::map<dealii::CellId, std::vector<double> > * _rhoValues,
-	              std::map<dealii::CellId, std::vector<double> > * _gradRhoValues,
-	              std::map<dealii::CellId, std::vector<double> > * _rhoValuesSpinPolarized,
-		      std::map<dealii::CellId, std::vector<double> > * _gradRhoValuesSpinPolarized,
+      void sumRhoData(dftUtils::cellQuadratureField * _rhoValues,
+	              dftUtils::cellQuadratureField * _gradRhoValues,
+	              dftUtils::cellQuadratureField * _rhoValuesSpinPolarized,
+		      dftUtils::cellQuadratureField * _gradRhoValuesSpinPolarized,
 		      const bool isGradRhoDataPresent,
 		      const MPI_Comm &interComm);
 
@@ -352,12 +353,18 @@ namespace dftfe {
        *@brief resize and allocate table storage for rho cell quadratrue data
        */
       void resizeAndAllocateRhoTableStorage
-			    (std::deque<std::map<dealii::CellId,std::vector<double> >> & rhoVals,
-			     std::deque<std::map<dealii::CellId,std::vector<double> >> & gradRhoVals,
-			     std::deque<std::map<dealii::CellId,std::vector<double> >> & rhoValsSpinPolarized,
-			     std::deque<std::map<dealii::CellId,std::vector<double> >> & gradRhoValsSpinPolarized);
+			    (dftUtils::cellQuadratureFieldHistory & rhoVals,
+			     dftUtils::cellQuadratureFieldHistory & gradRhoVals,
+			     dftUtils::cellQuadratureFieldHistory & rhoValsSpinPolarized,
+			     dftUtils::cellQuadratureFieldHistory & gradRhoValsSpinPolarized);
 
       void noRemeshRhoDataInit();
+
+      /**
+       *@brief moves rho cell quadrature data stored on a different cell enumeration to d_rhoQuadDataLayout
+       */
+      void remapRhoDataToCurrentLayout();
+
       void readPSI();
       void readPSIRadialValues();
       void loadPSIFiles(unsigned int Z, unsigned int n, unsigned int l, unsigned int & flag);
@@ -391,7 +398,7 @@ namespace dftfe {
        */
       double totalCharge(const dealii::DoFHandler<3> & dofHandlerOfField,
 			 const vectorType & rhoNodalField,
-			 std::map<dealii::CellId, std::vector<double> > & rhoQuadValues);
+			 dftUtils::cellQuadratureField & rhoQuadValues);
 
 
       double totalCharge(const dealii::DoFHandler<3> & dofHandlerOfField,
@@ -399,14 +406,14 @@ namespace dftfe {
 
 
       double totalCharge(const dealii::DoFHandler<3> & dofHandlerOfField,
-			 const std::map<dealii::CellId, std::vector<double> > *rhoQuadValues);
+			 const dftUtils::cellQuadratureField *rhoQuadValues);
 
 
 
       /**
        *@brief Computes net magnetization from the difference of local spin densities
        */
-      double totalMagnetization(const std::map<dealii::CellId, std::vector<double> > *rhoQuadValues) ;
+      double totalMagnetization(const dftUtils::cellQuadratureField *rhoQuadValues) ;
 
       /**
        *@brief normalize the electron density
@@ -427,6 +434,39 @@ namespace dftfe {
       double mixing_anderson_spinPolarized();
       double mixing_broyden();
       double mixing_broyden_spinPolarized();
+      double mixing_anderson_kerker();
+      double mixing_anderson_kerker_spinPolarized();
+
+      /**
+       *@brief Anderson mixing coefficients computed from the total electron-density histories
+       *
+       *@param[out] mixingCoeffs weights of the input and output histories, ordered as the histories
+       *@return (rhoIn-rhoOut)^2 of the current iteration integrated over the domain
+       */
+      double computeAndersonMixingCoeffs(std::vector<double> & mixingCoeffs);
+
+      /**
+       *@brief Broyden mixing of the total or of the spin polarized electron-densities
+       */
+      double broydenMixing(const bool isSpinPolarized);
+
+      /**
+       *@brief Anderson mixing of the total or of the spin polarized electron-densities with the
+       *Kerker preconditioner applied to the Anderson extrapolated residual
+       */
+      double andersonKerkerMixing(const bool isSpinPolarized);
+
+      /**
+       *@brief apply the Kerker preconditioner |G|^2/(|G|^2+k^2) in real space. The preconditioned residual is
+       *obtained as residual - k^2 (-\nabla^2+k^2)^{-1} residual by solving a screened Poisson problem
+       *with the right hand side computed from the residual cell quadrature values.
+       *
+       *@param[in,out] residualValues electron-density residual cell quadrature values, one value per quadrature point
+       *@param[in,out] gradResidualValues gradient of the residual, three values per quadrature point. Only
+       *updated if not NULL
+       */
+      void applyKerkerPreconditioner(dftUtils::cellQuadratureField & residualValues,
+				     dftUtils::cellQuadratureField * gradResidualValues);
 
 
       /**
@@ -646,18 +686,26 @@ namespace dftfe {
       dealii::Timer d_globalTimer;
 
       //dft related objects
-      std::map<dealii::CellId, std::vector<double> > *rhoInValues, *rhoOutValues, *rhoInValuesSpinPolarized, *rhoOutValuesSpinPolarized;
-      std::deque<std::map<dealii::CellId,std::vector<double> >> rhoInVals, rhoOutVals, rhoInValsSpinPolarized, rhoOutValsSpinPolarized;
 
+      /// enumeration of the locally owned cells in matrix_free_data order used by all the rho cell quadrature data
+      std::shared_ptr<dftUtils::cellQuadratureFieldLayout> d_rhoQuadDataLayout;
+
+      /// JxW values of the density quadrature points in the cell ordering of d_rhoQuadDataLayout
+      std::vector<double> d_rhoQuadJxWValues;
 
-      std::map<dealii::CellId, std::vector<double> > * gradRhoInValues, *gradRhoInValuesSpinPolarized;
-      std::map<dealii::CellId, std::vector<double> > * gradRhoOutValues, *gradRhoOutValuesSpinPolarized;
-      std::deque<std::map<dealii::CellId,std::vector<double> >> gradRhoInVals,gradRhoInValsSpinPolarized,gradRhoOutVals, gradRhoOutValsSpinPolarized;
+      dftUtils::cellQuadratureField *rhoInValues, *rhoOutValues, *rhoInValuesSpinPolarized, *rhoOutValuesSpinPolarized;
+      dftUtils::cellQuadratureFieldHistory rhoInVals, rhoOutVals, rhoInValsSpinPolarized, rhoOutValsSpinPolarized;
+
+
+      dftUtils::cellQuadratureField * gradRhoInValues, *gradRhoInValuesSpinPolarized;
+      dftUtils::cellQuadratureField * gradRhoOutValues, *gradRhoOutValuesSpinPolarized;
+      dftUtils::cellQuadratureFieldHistory gradRhoInVals,gradRhoInValsSpinPolarized,gradRhoOutVals, gradRhoOutValsSpinPolarized;
 
       // Broyden mixing related objects
-      std::map<dealii::CellId, std::vector<double> > FBroyden, gradFBroyden ;
-      std::deque<std::map<dealii::CellId,std::vector<double> >> dFBroyden, graddFBroyden ;
-      std::deque<std::map<dealii::CellId,std::vector<double> >> uBroyden, gradUBroyden ;
+      dftUtils::cellQuadratureField FBroyden, gradFBroyden ;
+      dftUtils::cellQuadratureField delRhoBroyden, delGradRhoBroyden ;
+      dftUtils::cellQuadratureFieldHistory dFBroyden, graddFBroyden ;
+      dftUtils::cellQuadratureFieldHistory uBroyden, gradUBroyden ;
       std::deque<double>  wtBroyden;
       double w0Broyden = 0.0 ;
       //
@@ -672,6 +720,10 @@ namespace dftfe {
       // storage for sum of nuclear electrostatic potential
       vectorType d_phiExt;
 
+      // true if the vself bins fields solved in the previous ionic step are valid initial guesses for the
+      // current vself bins solve, which is the case when the mesh was moved without remeshing
+      bool d_isVselfFieldBinsInitialGuessValid;
+
       // storage for projection of rho cell quadrature data to nodal field
       vectorType d_rhoNodalField;
 
@@ -809,6 +861,35 @@ namespace dftfe {
       std::vector<double> a0;
       std::vector<double> bLow;
 
+      //adaptive Chebyshev polynomial degree and residual norm of the highest occupied state
+      //after the last Chebyshev filtering pass for each k point and spin
+      std::vector<unsigned int> d_chebyshevPolynomialDegree;
+      std::vector<double> d_chebyshevResidualNorm;
+
+      //upper bound of the unwanted spectrum, residual reduction rate of the highest occupied state
+      //(negative if not available), and wall times of the Chebyshev filtering per polynomial degree and
+      //of the orthogonalization, Rayleigh-Ritz and residual computation steps in the last Chebyshev
+      //filtering pass for each k point and spin, used for the adaptive Chebyshev polynomial degree
+      std::vector<double> d_chebyshevUpperBoundUnwantedSpectrum;
+      std::vector<double> d_chebyshevResidualReductionRate;
+      std::vector<double> d_chebyshevFilterWallTimePerDegree;
+      std::vector<double> d_chebyshevSubspaceWallTime;
+
+      //last k-step Lanczos estimate of the upper bound of the eigen-spectrum, accumulated change of the
+      //effective potential at the time of the estimate, and number of Chebyshev solves using the estimate
+      //for each k point and spin
+      std::vector<double> d_upperBoundUnwantedSpectrum;
+      std::vector<double> d_upperBoundVEffCumulativeChange;
+      std::vector<unsigned int> d_upperBoundNumberSolves;
+
+      //maximum residual norm of the valence eigenstates in the last spectrum split Chebyshev solve for each
+      //k point and spin (negative if not available), used to switch to the partial Rayleigh-Ritz step
+      std::vector<double> d_spectrumSplitMaxResidualNorm;
+
+      //residual norms of the eigenstates in the last Chebyshev solve for each k point and spin, used for
+      //the soft locking of the converged eigenstates
+      std::vector<std::vector<double> > d_lockingResidualNorms;
+
 
       vectorType d_tempEigenVec;
       vectorType d_tempEigenVecPrev;
@@ -820,6 +901,15 @@ namespace dftfe {
 							    const std::vector<std::vector<double> > & eigenValuesAllkPoints,
 							    const double _fermiEnergy);
 
+      /**
+       * @brief update the adaptive Chebyshev polynomial degrees of all k points for a given spin from the
+       * residual norms and Ritz values of the highest occupied states after the last Chebyshev filtering pass
+       */
+      void updateAdaptiveChebyshevPolynomialDegrees(const std::vector<std::vector<double> > & residualNormWaveFunctionsAllkPoints,
+						    const std::vector<std::vector<double> > & eigenValuesAllkPoints,
+						    const unsigned int spinType,
+						    const chebyshevOrthogonalizedSubspaceIterationSolver & subspaceIterationSolver);
+
 
       void kohnShamEigenSpaceCompute(const unsigned int s,
 				     const unsigned int kPointIndex,
@@ -827,7 +917,8 @@ namespace dftfe {
 				     chebyshevOrthogonalizedSubspaceIterationSolver & subspaceIterationSolver,
 				     std::vector<double> & residualNormWaveFunctions,
 				     const bool isSpectrumSplit,
-				     const bool useMixedPrec);
+				     const bool useMixedPrec,
+				     const bool useMixedPrecCheby=false);
 
       void computeResidualNorm(const std::vector<double> & eigenValuesTemp,
 			       kohnShamDFTOperatorClass<FEOrder> & kohnShamDFTEigenOperator,
@@ -35,13 +35,13 @@ namespace dftfe {
     {
 
       extern unsigned int finiteElementPolynomialOrder,n_refinement_steps,numberEigenValues,xc_id, spinPolarized, nkx,nky,nkz , offsetFlagX,offsetFlagY,offsetFlagZ;
-      extern unsigned int chebyshevOrder,numPass,numSCFIterations,maxLinearSolverIterations, mixingHistory, npool;
+      extern unsigned int chebyshevOrder,numPass,numSCFIterations,maxLinearSolverIterations,poissonChebyshevPreconditionerDegree, mixingHistory, npool;
 
-      extern double radiusAtomBall, mixingParameter;
+      extern double radiusAtomBall, mixingParameter, kerkerParameter;
       extern double lowerEndWantedSpectrum,relLinearSolverTolerance,selfConsistentSolverTolerance,TVal, start_magnetization;
 
       extern bool isPseudopotential, periodicX, periodicY, periodicZ, useSymm, timeReversal,pseudoTestsFlag, constraintMagnetization;
-      extern std::string meshFileName,coordinatesFile,domainBoundingVectorsFile,kPointDataFile, ionRelaxFlagsFile, orthogType,pseudoPotentialFile;
+      extern std::string meshFileName,coordinatesFile,domainBoundingVectorsFile,kPointDataFile, ionRelaxFlagsFile, orthogType,pseudoPotentialFile,poissonPreconditionerType;
 
       extern double outerAtomBallRadius, meshSizeOuterDomain;
       extern double meshSizeInnerBall, meshSizeOuterBall;
@@ -73,12 +73,14 @@ namespace dftfe {
       extern unsigned int subspaceRotDofsBlockSize;
       extern bool enableSwitchToGS;
       extern unsigned int nbandGrps;
+      extern unsigned int numThreadsPerTask;
       extern bool computeEnergyEverySCF;
       extern unsigned int scalapackParalProcs;
       extern unsigned int natoms;
       extern unsigned int natomTypes;
       extern double lowerBoundUnwantedFracUpper;
       extern bool triMatPGSOpt;
+      extern unsigned int choleskyQRPasses;
       extern bool reuseWfcGeoOpt;
       extern double mpiAllReduceMessageBlockSizeMB;
       extern bool useHigherQuadNLP;
@@ -87,8 +89,21 @@ namespace dftfe {
       extern bool useMixedPrecXTHXSpectrumSplit;
       extern bool useMixedPrecSubspaceRotSpectrumSplit;
       extern unsigned int numAdaptiveFilterStates;
+      extern bool adaptiveChebyshevOrder;
+      extern bool adaptiveChebyshevOrderWallTime;
+      extern unsigned int lanczosUpperBoundUpdateFrequency;
+      extern double lanczosUpperBoundVEffTol;
+      extern bool matrixFreeHamiltonian;
+      extern bool packedCellHamiltonianMatrices;
       extern bool useMixedPrecCheby;
+      extern double mixedPrecStoppingTol;
+      extern double lockingResidualTol;
+      extern unsigned int lockedStatesChebyshevOrder;
       extern unsigned int spectrumSplitStartingScfIter;
+      extern double spectrumSplitPartialRRTol;
+      extern bool poissonWarmStart;
+      extern bool vselfBlockCG;
+      extern double poissonAdaptiveToleranceFactor;
 
       /**
        * Declare parameters.
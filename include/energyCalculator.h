@@ -16,6 +16,7 @@
 
 #include <headers.h>
 #include <xc.h>
+#include <cellQuadratureField.h>
 
 #ifndef energyCalculator_H_
 #define energyCalculator_H_
@@ -95,11 +96,11 @@ namespace dftfe {
 			     const vectorType & phiTotRhoOut,
 			     const vectorType & phiExt,
 			     const vectorType & phiExtElec,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoInValues,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoOutValues,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectrostatic,
-			     const std::map<dealii::CellId, std::vector<double> > & gradRhoInValues,
-			     const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValues,
+			     const dftUtils::cellQuadratureField & rhoInValues,
+			     const dftUtils::cellQuadratureField & rhoOutValues,
+			     const dftUtils::cellQuadratureField & rhoOutValuesElectrostatic,
+			     const dftUtils::cellQuadratureField & gradRhoInValues,
+			     const dftUtils::cellQuadratureField & gradRhoOutValues,
 		             const std::vector<std::vector<double> > & localVselfs,
 			     const std::map<dealii::CellId, std::vector<double> > & pseudoValuesElectronic,
                              const std::map<dealii::CellId, std::vector<double> > & pseudoValuesElectrostatic,
@@ -175,15 +176,15 @@ namespace dftfe {
 			     const vectorType & phiTotRhoOut,
 			     const vectorType & phiExt,
 			     const vectorType & phiExtElec,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoInValues,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoOutValues,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectrostatic,
-			     const std::map<dealii::CellId, std::vector<double> > & gradRhoInValues,
-			     const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValues,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoInValuesSpinPolarized,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesSpinPolarized,
-			     const std::map<dealii::CellId, std::vector<double> > & gradRhoInValuesSpinPolarized,
-			     const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesSpinPolarized,
+			     const dftUtils::cellQuadratureField & rhoInValues,
+			     const dftUtils::cellQuadratureField & rhoOutValues,
+			     const dftUtils::cellQuadratureField & rhoOutValuesElectrostatic,
+			     const dftUtils::cellQuadratureField & gradRhoInValues,
+			     const dftUtils::cellQuadratureField & gradRhoOutValues,
+			     const dftUtils::cellQuadratureField & rhoInValuesSpinPolarized,
+			     const dftUtils::cellQuadratureField & rhoOutValuesSpinPolarized,
+			     const dftUtils::cellQuadratureField & gradRhoInValuesSpinPolarized,
+			     const dftUtils::cellQuadratureField & gradRhoOutValuesSpinPolarized,
 			     const std::vector<std::vector<double> > & localVselfs,
 			     const std::map<dealii::CellId, std::vector<double> > & pseudoValuesElectronic,
                              const std::map<dealii::CellId, std::vector<double> > & pseudoValuesElectrostatic,
@@ -20,6 +20,7 @@
 #include "constants.h"
 #include "meshMovementGaussian.h"
 #include <vselfBinsManager.h>
+#include <cellQuadratureField.h>
 
 
 using namespace dealii;
@@ -122,8 +123,8 @@ namespace dftfe {
 		 const unsigned int phiExtDofHandlerIndexElectro,
 		 const vectorType & phiTotRhoOutElectro,
 		 const vectorType & phiExtElectro,
-		 const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-		 const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+		 const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+		 const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		 const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		 const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		 const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -171,8 +172,8 @@ namespace dftfe {
 		 const unsigned int phiExtDofHandlerIndexElectro,
 		 const vectorType & phiTotRhoOutElectro,
 		 const vectorType & phiExtElectro,
-		 const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-		 const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+		 const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+		 const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		 const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		 const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		 const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -245,8 +246,8 @@ namespace dftfe {
 		              const unsigned int phiExtDofHandlerIndexElectro,
 		              const vectorType & phiTotRhoOutElectro,
 		              const vectorType & phiExtElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 	          	      const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		              const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -269,8 +270,8 @@ namespace dftfe {
 		              const unsigned int phiExtDofHandlerIndexElectro,
 		              const vectorType & phiTotRhoOutElectro,
 		              const vectorType & phiExtElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		              const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -282,8 +283,8 @@ namespace dftfe {
 		             const unsigned int phiExtDofHandlerIndexElectro,
 		             const vectorType & phiTotRhoOutElectro,
 		             const vectorType & phiExtElectro,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			     const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			     const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			     const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		             const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		             const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 			     const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -313,8 +314,8 @@ namespace dftfe {
 		                     const unsigned int phiExtDofHandlerIndexElectro,
 		                     const vectorType & phiTotRhoOutElectro,
 		                     const vectorType & phiExtElectro,
-				     const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-				     const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+				     const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+				     const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		                     const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		                     const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		                     const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -405,8 +406,8 @@ namespace dftfe {
 		              const unsigned int phiExtDofHandlerIndexElectro,
 		              const vectorType & phiTotRhoOutElectro,
 		              const vectorType & phiExtElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-                              const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+                              const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		              const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -418,8 +419,8 @@ namespace dftfe {
 	                     const unsigned int phiExtDofHandlerIndexElectro,
 		             const vectorType & phiTotRhoOutElectro,
 		             const vectorType & phiExtElectro,
-			     const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			     const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			     const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			     const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		             const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 			     const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
 			     const vselfBinsManager<FEOrder> & vselfBinsManagerElectro);
@@ -440,8 +441,8 @@ namespace dftfe {
 			      const unsigned int phiExtDofHandlerIndexElectro,
 			      const vectorType & phiTotRhoOutElectro,
 			      const vectorType & phiExtElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		              const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
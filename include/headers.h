@@ -26,6 +26,9 @@
 #include <deal.II/base/function.h>
 #include <deal.II/base/logstream.h>
 #include <deal.II/base/timer.h>
+#include <deal.II/base/parallel.h>
+#include <deal.II/base/multithread_info.h>
+#include <deal.II/base/thread_management.h>
 #include <deal.II/base/table.h>
 #include <deal.II/lac/vector.h>
 #include <deal.II/lac/full_matrix.h>
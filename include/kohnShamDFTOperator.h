@@ -20,6 +20,7 @@
 #include <headers.h>
 #include <constants.h>
 #include <constraintMatrixInfo.h>
+#include <cellQuadratureField.h>
 #include <operator.h>
 
 namespace dftfe{
@@ -150,7 +151,7 @@ namespace dftfe{
        * @param phiExt electrostatic potential arising from nuclear charges
        * @param pseudoValues quadrature data of pseudopotential values
        */
-      void computeVEff(const std::map<dealii::CellId,std::vector<double> >* rhoValues,
+      void computeVEff(const dftUtils::cellQuadratureField* rhoValues,
 		       const vectorType & phi,
 		       const vectorType & phiExt,
 		       const std::map<dealii::CellId,std::vector<double> > & pseudoValues);
@@ -165,7 +166,7 @@ namespace dftfe{
        * @param spinIndex flag to toggle spin-up or spin-down
        * @param pseudoValues quadrature data of pseudopotential values
        */
-      void computeVEffSpinPolarized(const std::map<dealii::CellId,std::vector<double> >* rhoValues,
+      void computeVEffSpinPolarized(const dftUtils::cellQuadratureField* rhoValues,
 				    const vectorType & phi,
 				    const vectorType & phiExt,
 				    unsigned int spinIndex,
@@ -180,8 +181,8 @@ namespace dftfe{
        * @param phiExt electrostatic potential arising from nuclear charges
        * @param pseudoValues quadrature data of pseudopotential values
        */
-      void computeVEff(const std::map<dealii::CellId,std::vector<double> >* rhoValues,
-		       const std::map<dealii::CellId,std::vector<double> >* gradRhoValues,
+      void computeVEff(const dftUtils::cellQuadratureField* rhoValues,
+		       const dftUtils::cellQuadratureField* gradRhoValues,
 		       const vectorType & phi,
 		       const vectorType & phiExt,
 		       const std::map<dealii::CellId,std::vector<double> > & pseudoValues);
@@ -197,13 +198,22 @@ namespace dftfe{
        * @param spinIndex flag to toggle spin-up or spin-down
        * @param pseudoValues quadrature data of pseudopotential values
        */
-      void computeVEffSpinPolarized(const std::map<dealii::CellId,std::vector<double> >* rhoValues,
-				    const std::map<dealii::CellId,std::vector<double> >* gradRhoValues,
+      void computeVEffSpinPolarized(const dftUtils::cellQuadratureField* rhoValues,
+				    const dftUtils::cellQuadratureField* gradRhoValues,
 				    const vectorType & phi,
 				    const vectorType & phiExt,
 				    const unsigned int spinIndex,
 				    const std::map<dealii::CellId,std::vector<double> > & pseudoValues);
 
+      /**
+       * @brief accumulated maximum absolute change of the effective potential at the quadrature points over the
+       * calls of computeVEff (computeVEffSpinPolarized for the given spin). Only tracked if LANCZOS UPPER BOUND
+       * UPDATE FREQUENCY is greater than 1, and used to shift a reused upper bound of the eigen-spectrum.
+       *
+       * @param spinIndex spin index (0 for spin unpolarized calculations)
+       */
+      double getVEffCumulativeChange(const unsigned int spinIndex) const;
+
 
       /**
        * @brief sets the data member to appropriate kPoint Index
@@ -238,6 +248,24 @@ namespace dftfe{
 
       void reinit(const unsigned int wavefunBlockSize);
 
+      /**
+       * @brief flattened array workspace for the given number of wavefunctions, owned by the operator and
+       * reused across calls. Workspaces with different ids are distinct vectors, and their entries are
+       * not initialized.
+       *
+       * @param wavefunBlockSize number of wavefunction vectors
+       * @param workspaceId id of the workspace
+       */
+      dealii::parallel::distributed::Vector<dataTypes::number> &
+      getFlattenedArrayWorkspace(const unsigned int wavefunBlockSize,
+				 const unsigned int workspaceId);
+
+      /**
+       * @brief release the memory of all the flattened array workspaces. References obtained from
+       * getFlattenedArrayWorkspace are invalidated.
+       */
+      void releaseFlattenedArrayWorkspaces();
+
 
 
       /**
@@ -264,6 +292,13 @@ namespace dftfe{
 
 
     private:
+      /**
+       * @brief partitioner of the flattened arrays for the given number of wavefunctions. The partitioners
+       * are created once and reused in reinit and for the workspaces
+       */
+      const std::shared_ptr<const dealii::Utilities::MPI::Partitioner> &
+      getFlattenedArrayPartitioner(const unsigned int numberWaveFunctions);
+
       /**
        * @brief implementation of matrix-free based matrix-vector product at cell-level
        * @param data matrix-free data
@@ -302,12 +337,51 @@ namespace dftfe{
        * in a flattened format with all the wavefunction value corresponding to a given node is stored
        * contiguously.
        * @param numberWaveFunctions Number of wavefunctions at a given node.
+       * @param macroCellColoring colors of the cells on which the product is computed
+       * @param macroCells the same cells in their natural order, used with a single thread
        * @param dst Vector containing matrix times given multi-vectors product
        */
       void computeLocalHamiltonianTimesX(const dealii::parallel::distributed::Vector<dataTypes::number> & src,
 					 const unsigned int numberWaveFunctions,
+					 const std::vector<std::vector<unsigned int> > & macroCellColoring,
+					 const std::vector<unsigned int> & macroCells,
 					 dealii::parallel::distributed::Vector<dataTypes::number> & dst) const;
 
+      /**
+       * @brief single precision version of computeLocalHamiltonianTimesX using the low precision copies
+       * of the cell-level stiffness matrices. The cell level products are done in single precision and
+       * accumulated into the double precision dst. Only implemented for real data type
+       * @param src Vector containing current values of source array with multi-vector array stored
+       * in a flattened format with all the wavefunction value corresponding to a given node is stored
+       * contiguously.
+       * @param numberWaveFunctions Number of wavefunctions at a given node.
+       * @param macroCellColoring colors of the cells on which the product is computed
+       * @param macroCells the same cells in their natural order, used with a single thread
+       * @param dst Vector containing matrix times given multi-vectors product
+       */
+      void computeLocalHamiltonianTimesXSinglePrec(const dealii::parallel::distributed::Vector<dataTypes::number> & src,
+						   const unsigned int numberWaveFunctions,
+						   const std::vector<std::vector<unsigned int> > & macroCellColoring,
+						   const std::vector<unsigned int> & macroCells,
+						   dealii::parallel::distributed::Vector<dataTypes::number> & dst) const;
+
+      /**
+       * @brief implementation of matrix-vector product using matrix-free sum factorization on the macro cells
+       * instead of the cell-level stiffness matrices. works for both real and complex data type
+       * @param src Vector containing current values of source array with multi-vector array stored
+       * in a flattened format with all the wavefunction value corresponding to a given node is stored
+       * contiguously.
+       * @param numberWaveFunctions Number of wavefunctions at a given node.
+       * @param macroCellColoring colors of the macro cells on which the product is computed
+       * @param macroCells the same macro cells in their natural order, used with a single thread
+       * @param dst Vector containing matrix times given multi-vectors product
+       */
+      void computeLocalHamiltonianTimesXMatrixFree(const dealii::parallel::distributed::Vector<dataTypes::number> & src,
+						   const unsigned int numberWaveFunctions,
+						   const std::vector<std::vector<unsigned int> > & macroCellColoring,
+						   const std::vector<unsigned int> & macroCells,
+						   dealii::parallel::distributed::Vector<dataTypes::number> & dst) const;
+
 #ifdef WITH_MKL
 
       /**
@@ -332,18 +406,27 @@ namespace dftfe{
 
 #endif
       /**
-       * @brief implementation of non-local Hamiltonian matrix-vector product
-       * using non-local discretized projectors at cell-level.
+       * @brief first part of the non-local Hamiltonian matrix-vector product using non-local discretized
+       * projectors at cell-level: computes C^{T}*X and starts its accumulation over the processors sharing
+       * the compact support of the nonlocal atoms, without waiting for it to complete.
        * works for both complex and real data type
        * @param src Vector containing current values of source array with multi-vector array stored
        * in a flattened format with all the wavefunction value corresponding to a given node is stored
        * contiguously.
        * @param numberWaveFunctions Number of wavefunctions at a given node.
+       */
+      void computeNonLocalProjectorKetTimesXStart(const dealii::parallel::distributed::Vector<dataTypes::number> & src,
+						  const unsigned int numberWaveFunctions) const;
+
+      /**
+       * @brief second part of the non-local Hamiltonian matrix-vector product started by
+       * computeNonLocalProjectorKetTimesXStart: completes the accumulation of C^{T}*X and adds C*V*C^{T}*X to dst.
+       * works for both complex and real data type
+       * @param numberWaveFunctions Number of wavefunctions at a given node.
        * @param dst Vector containing matrix times given multi-vectors product
        */
-      void computeNonLocalHamiltonianTimesX(const dealii::parallel::distributed::Vector<dataTypes::number> & src,
-					    const unsigned int numberWaveFunctions,
-					    dealii::parallel::distributed::Vector<dataTypes::number> & dst) const;
+      void computeNonLocalHamiltonianTimesXFinish(const unsigned int numberWaveFunctions,
+						  dealii::parallel::distributed::Vector<dataTypes::number> & dst) const;
 
 #ifdef WITH_MKL
       /**
@@ -367,6 +450,20 @@ namespace dftfe{
 	     dealii::parallel::distributed::Vector<dataTypes::number>  & dst) const;
 #endif
 
+      /**
+       * @brief adds the maximum absolute change of vEff from the previous call for the given spin to the
+       * accumulated change of the effective potential, and stores vEff for the next call
+       */
+      void updateVEffCumulativeChange(const unsigned int spinIndex);
+
+      /**
+       * @brief groups the nonlocal projector element matrices of the given k point by cell. The matrices of
+       * all the nonlocal atoms of a cell are concatenated into a single block, so that the nonlocal Hamiltonian
+       * is applied with one gemm per cell instead of one gemm per atom and cell.
+       * @param kPointIndex k point index
+       */
+      void computeNonLocalProjectorCellMatrices(const unsigned int kPointIndex);
+
       ///pointer to dft class
       dftClass<FEOrder>* dftPtr;
 
@@ -377,6 +474,10 @@ namespace dftfe{
       dealii::Table<2, dealii::VectorizedArray<double> > vEff;
       dealii::Table<2, dealii::Tensor<1,3,dealii::VectorizedArray<double> > > derExcWithSigmaTimesGradRho;
 
+      ///effective potential of the last computeVEff call and accumulated maximum change of the effective potential for each spin
+      std::vector<dealii::Table<2, dealii::VectorizedArray<double> > > d_vEffPrevious;
+      std::vector<double> d_vEffCumulativeChange;
+
 
        /**
        * @brief finite-element cell level matrix to store dot product between shapeFunction gradients (\int(del N_i \dot \del N_j))
@@ -411,6 +512,57 @@ namespace dftfe{
 
       //storage for precomputing index maps
       std::vector<std::vector<dealii::types::global_dof_index> > d_flattenedArrayMacroCellLocalProcIndexIdMap, d_flattenedArrayCellLocalProcIndexIdMap;
+
+      //colorings of the cells in the above index maps such that cells of the same color
+      //do not share nodes, used in the thread parallel cell loops
+      std::vector<std::vector<unsigned int> > d_macroCellColoring, d_cellColoring;
+
+      //restrictions of d_macroCellColoring to the interior cells, whose nodes are all locally owned
+      //and unconstrained, and to the remaining boundary cells. The local Hamiltonian action on the
+      //interior cells is overlapped with the ghost exchange in HX
+      std::vector<std::vector<unsigned int> > d_macroCellColoringInterior, d_macroCellColoringBoundary;
+
+      //cells of the above two colorings in their natural order, used in the single thread cell loops
+      std::vector<unsigned int> d_macroCellsInterior, d_macroCellsBoundary;
+
+      //index of the first cell of each macro cell in the above index maps, and colorings of the macro
+      //cells split into interior and boundary macro cells as above, used in the matrix-free HX
+      std::vector<unsigned int> d_macroCellStartIndex;
+      std::vector<std::vector<unsigned int> > d_matrixFreeMacroCellColoringInterior, d_matrixFreeMacroCellColoringBoundary;
+      std::vector<unsigned int> d_matrixFreeMacroCellsInterior, d_matrixFreeMacroCellsBoundary;
+
+      //cells with nonlocal atoms in the order of d_flattenedArrayCellLocalProcIndexIdMap, index of each cell in this
+      //list (invalid if the cell has no nonlocal atoms), and for each of these cells the range of its pseudo atomic
+      //wavefunctions (numbered contiguously over the nonlocal atoms in the current process) in d_nonLocalCellProjectorIds
+      std::vector<unsigned int> d_nonLocalCellIds, d_nonLocalCellIndex;
+      std::vector<unsigned int> d_nonLocalCellProjectorStartIndex, d_nonLocalCellProjectorIds;
+
+      //concatenated projector element matrices (numberNodesPerElement x numberCellPseudoWaveFunctions) and transposed
+      //projector element matrices (numberCellPseudoWaveFunctions x numberNodesPerElement) of the above cells
+      std::vector<dataTypes::number> d_nonLocalCellProjectorMatrices, d_nonLocalCellProjectorMatricesTranspose;
+
+      //for each pseudo atomic wavefunction in the current process, its columns in the above cell blocks, its id in
+      //d_projectorKetTimesVectorParFlattened and its pseudopotential constant
+      std::vector<unsigned int> d_nonLocalProjectorCellColumnStartIndex, d_nonLocalProjectorCellColumns;
+      std::vector<unsigned int> d_nonLocalProjectorIdsPar;
+      std::vector<double> d_nonLocalProjectorConstants;
+
+      //C^{T}*X on the above cells, one numberWaveFunctions x numberCellPseudoWaveFunctions block per cell,
+      //kept between computeNonLocalProjectorKetTimesXStart and computeNonLocalHamiltonianTimesXFinish
+      mutable std::vector<dataTypes::number> d_cellProjectorKetTimesVector;
+
+      //partitioners of the flattened arrays and of d_projectorKetTimesVectorParFlattened for each number
+      //of wavefunctions, and the single component partitioners they were created from
+      std::map<unsigned int, std::shared_ptr<const dealii::Utilities::MPI::Partitioner> > d_flattenedArrayPartitioners;
+      std::map<unsigned int, std::shared_ptr<const dealii::Utilities::MPI::Partitioner> > d_projectorKetTimesVectorFlattenedPartitioners;
+      std::shared_ptr<const dealii::Utilities::MPI::Partitioner> d_flattenedArrayBasePartitioner;
+      std::shared_ptr<const dealii::Utilities::MPI::Partitioner> d_projectorKetTimesVectorBasePartitioner;
+
+      //flattened array workspaces for each number of wavefunctions and workspace id
+      std::map<std::pair<unsigned int,unsigned int>, dealii::parallel::distributed::Vector<dataTypes::number> > d_flattenedArrayWorkspaces;
+
+      //number of wavefunctions for which the above index maps and cell colorings were computed (0 if none)
+      unsigned int d_flattenedArrayIndexMapsBlockSize;
     };
 }
 #endif
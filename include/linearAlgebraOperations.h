@@ -79,6 +79,28 @@ namespace dftfe
 		   std::complex<double> * a,
 		   const unsigned int *lda,
                    int * info);
+      void dtrsm_(const char * side,
+	          const char * uplo,
+		  const char * transA,
+		  const char * diag,
+		  const unsigned int *m,
+		  const unsigned int *n,
+		  const double * alpha,
+		  const double * A,
+		  const unsigned int *lda,
+		  double * B,
+		  const unsigned int *ldb);
+      void ztrsm_(const char * side,
+	          const char * uplo,
+		  const char * transA,
+		  const char * diag,
+		  const unsigned int *m,
+		  const unsigned int *n,
+		  const std::complex<double> * alpha,
+		  const std::complex<double> * A,
+		  const unsigned int *lda,
+		  std::complex<double> * B,
+		  const unsigned int *ldb);
     }
 #endif
 /**
@@ -198,6 +220,24 @@ namespace dftfe
 						      const MPI_Comm &mpiComm,
 						      const bool useMixedPrec);
 
+     /** @brief Orthogonalize given subspace using Cholesky-QR orthogonalization. The overlap matrix is
+      * computed with a single all reduce and factorized redundantly on every processor using LAPACK,
+      * so no ScaLAPACK process grid is required. A shifted pass is added if the first Cholesky factorization breaks down.
+      *
+      *  @param[in,out]  X Given subspace as flattened array of multi-vectors.
+      *  In-place update of the given subspace
+      *  @param[in] numberComponents Number of multiple-fields
+      *  @param[in] numberPasses Number of Cholesky-QR passes (2 for Cholesky-QR2)
+      *  @param[in] mpiComm global communicator
+      *
+      *  @return flag indicating success/failure. 1 for failure, 0 for success
+      */
+    template<typename T>
+      unsigned int choleskyQROrthogonalization(std::vector<T> & X,
+					       const unsigned int numberComponents,
+					       const unsigned int numberPasses,
+					       const MPI_Comm &mpiComm);
+
     /** @brief Compute Rayleigh-Ritz projection
      *
      *  @param[in] operatorMatrix An object which has access to the given matrix
@@ -235,25 +275,28 @@ namespace dftfe
      *  (serial version using LAPACK, parallel version using ScaLAPACK)
      *
      *  @param[in] operatorMatrix An object which has access to the given matrix
-     *  @param[in]  X Given subspace as flattened array of multi-vectors.
+     *  @param[in,out]  X Given subspace as flattened array of multi-vectors.
      *  @param[out] Y rotated subspace of top states
      *  @param[in] numberComponents Number of vectors
      *  @param[in] numberCoreStates Number of core states to be used for spectrum splitting
      *  @param[in] interBandGroupComm interpool communicator for parallelization over band groups
      *  @param[in] mpiComm domain decomposition communicator
      *  @param[out] eigenValues of the Projected Hamiltonian
+     *  @param[in] rotateValenceBlock if true, the valence block of X is rotated within its own span towards
+     *  the valence Ritz vectors Y, keeping X orthonormal with an unchanged span
      */
     template<typename T>
     void rayleighRitzSpectrumSplitDirect
                      (operatorDFTClass        & operatorMatrix,
-		      const std::vector<T> & X,
+		      std::vector<T> & X,
 		      std::vector<T> & Y,
 		      const unsigned int numberComponents,
 		      const unsigned int numberCoreStates,
 		      const MPI_Comm &interBandGroupComm,
 		      const MPI_Comm &mpiComm,
 		      const bool useMixedPrec,
-		      std::vector<double>     & eigenValues);
+		      std::vector<double>     & eigenValues,
+		      const bool rotateValenceBlock=false);
 
 
     /** @brief Compute Compute residual norm associated with eigenValue problem of the given operator
@@ -32,13 +32,20 @@ namespace dftfe
     {
 #ifdef DEAL_II_WITH_SCALAPACK
 	/** @brief Wrapper function to create a two dimensional processor grid for a square matrix in
-	 * dealii::ScaLAPACKMatrix storage format.
+	 * dealii::ScaLAPACKMatrix storage format. The process grid is cached and reused in later calls
+	 * with the same communicator and processor grid dimensions until clearProcessGridCache is called.
 	 *
 	 */
 	void createProcessGridSquareMatrix(const MPI_Comm & mpi_communicator,
 		                           const unsigned size,
 					   std::shared_ptr< const dealii::Utilities::MPI::ProcessGrid>  & processGrid);
 
+	/** @brief Releases the process grids cached by createProcessGridSquareMatrix. Must be called
+	 * before the communicators used to create the process grids are freed.
+	 *
+	 */
+	void clearProcessGridCache();
+
 	/** @brief Wrapper function to create a two dimensional processor grid for a rectangular matrix in
 	 * dealii::ScaLAPACKMatrix storage format.
 	 *
@@ -49,14 +56,16 @@ namespace dftfe
 						 std::shared_ptr< const dealii::Utilities::MPI::ProcessGrid>  & processGrid);
 
 
-	/** @brief Creates global row/column id to local row/column ids for dealii::ScaLAPACKMatrix
+	/** @brief Creates global row/column id to local row/column ids for dealii::ScaLAPACKMatrix.
+	 * The maps are flat arrays of size equal to the larger matrix dimension, with -1
+	 * for the rows/columns not owned by the current processor.
 	 *
 	 */
         template<typename T>
 	void createGlobalToLocalIdMapsScaLAPACKMat(const std::shared_ptr< const dealii::Utilities::MPI::ProcessGrid>  & processGrid,
 		                                   const dealii::ScaLAPACKMatrix<T> & mat,
-				                   std::map<unsigned int, unsigned int> & globalToLocalRowIdMap,
-					           std::map<unsigned int, unsigned int> & globalToLocalColumnIdMap);
+				                   std::vector<int> & globalToLocalRowIdMap,
+					           std::vector<int> & globalToLocalColumnIdMap);
 
 
 	/** @brief Mpi all reduce of ScaLAPACKMat across a given inter communicator.
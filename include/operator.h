@@ -68,6 +68,25 @@ namespace dftfe{
 
     virtual void reinit(const unsigned int wavefunBlockSize) = 0;
 
+    /**
+     * @brief flattened array workspace for the given number of wavefunctions, owned by the operator and
+     * reused across calls. Workspaces with different ids are distinct vectors. The workspace has the
+     * same parallel layout as the flattened array created by reinit for the same number of wavefunctions,
+     * but its entries are not initialized.
+     *
+     * @param wavefunBlockSize number of wavefunction vectors
+     * @param workspaceId id of the workspace
+     */
+    virtual dealii::parallel::distributed::Vector<dataTypes::number> &
+    getFlattenedArrayWorkspace(const unsigned int wavefunBlockSize,
+			       const unsigned int workspaceId) = 0;
+
+    /**
+     * @brief release the memory of all the flattened array workspaces. References obtained from
+     * getFlattenedArrayWorkspace are invalidated.
+     */
+    virtual void releaseFlattenedArrayWorkspaces() = 0;
+
     /**
      * @brief compute diagonal mass matrix
      *
@@ -16,6 +16,7 @@
 
 
 #include <dealiiLinearSolverProblem.h>
+#include <cellQuadratureField.h>
 
 #ifndef poissonSolverProblem_H_
 #define poissonSolverProblem_H_
@@ -41,6 +42,8 @@ namespace dftfe {
 	 * @brief reinitialize data structures for total electrostatic potential solve.
 	 *
 	 * For Hartree electrostatic potential solve give an empty map to the atoms parameter.
+	 * A non-zero screeningParameter adds the screening term screeningParameter*x to the
+	 * Laplace operator, which gives the screened Poisson problem used for Kerker preconditioning.
 	 *
 	 */
 	 void reinit(const dealii::MatrixFree<3,double> & matrixFreeData,
@@ -48,8 +51,9 @@ namespace dftfe {
 		     const dealii::ConstraintMatrix & constraintMatrix,
 		     const unsigned int matrixFreeVectorComponent,
 	             const std::map<dealii::types::global_dof_index, double> & atoms,
-		     const std::map<dealii::CellId,std::vector<double> > & rhoValues,
-		     const bool isComputeDiagonalA=true);
+		     const dftUtils::cellQuadratureField & rhoValues,
+		     const bool isComputeDiagonalA=true,
+		     const double screeningParameter=0.0);
 
 	/**
 	 * @brief reinitialize data structures for nuclear electrostatic potential solve
@@ -106,10 +110,10 @@ namespace dftfe {
 	/// function needed by dealii to mimic SparseMatrix
         bool operator!= (double val) const {return true;};
 
-    private:
-
        /**
-	 * @brief required for the cell_loop operation in dealii's MatrixFree class
+	 * @brief cell level A*src over a range of cells, required for the cell_loop operation in dealii's
+	 * MatrixFree class. Also used by the solvers which apply the operators of several problems in a
+	 * single cell loop
 	 *
 	 */
         void AX (const dealii::MatrixFree<3,double>  &matrixFreeData,
@@ -117,6 +121,8 @@ namespace dftfe {
 		          const vectorType &src,
 		          const std::pair<unsigned int,unsigned int> &cell_range) const;
 
+    private:
+
 
 	/**
 	 * @brief Compute the diagonal of A.
@@ -142,11 +148,14 @@ namespace dftfe {
         unsigned int d_matrixFreeVectorComponent;
 
 	/// pointer to electron density cell quadrature data
-	const std::map<dealii::CellId,std::vector<double> >* d_rhoValuesPtr;
+	const dftUtils::cellQuadratureField* d_rhoValuesPtr;
 
 	/// pointer to map between global dof index in current processor and the atomic charge on that dof
 	const std::map<dealii::types::global_dof_index, double> * d_atomsPtr;
 
+	/// coefficient of the screening term (square of the screening wavevector)
+	double d_screeningParameter;
+
         const MPI_Comm mpi_communicator;
         const unsigned int n_mpi_processes;
         const unsigned int this_mpi_process;
@@ -63,6 +63,34 @@ namespace dftfe{
 				     std::vector<std::vector<dealii::types::global_dof_index> >         & flattenedArrayCellLocalProcIndexId);
 
 
+    /** @brief Flags the locally owned cells, in the macrocell, subcell order of computeCellLocalIndexSetMap,
+     *  whose nodes are all locally owned and unconstrained. The cell level operations on these interior
+     *  cells neither read ghost nor slave node values and can hence overlap with the ghost exchange.
+     *
+     *  @param partitioner associated with the unflattened dealii vector
+     *  @param matrix_free_data object
+     *  @param constraintMatrix constraints on the nodes of the unflattened dealii vector
+     *
+     *  @return isInteriorCell flag for each locally owned cell
+     */
+    void computeInteriorCellFlags(const std::shared_ptr< const dealii::Utilities::MPI::Partitioner > & partitioner,
+				  const dealii::MatrixFree<3,double>                                 & matrix_free_data,
+				  const dealii::ConstraintMatrix                                     & constraintMatrix,
+				  std::vector<bool>                                                  & isInteriorCell);
+
+
+    /** @brief Partitions cells into colors such that no two cells of the same color share a node.
+     *  Cells of the same color can hence scatter their contributions into a vector concurrently
+     *  in the thread parallel cell loops.
+     *
+     *  @param cellLocalProcIndexIdMap local proc index map of each cell as created by computeCellLocalIndexSetMap
+     *
+     *  @return cellColors cell indices into cellLocalProcIndexIdMap grouped by color
+     */
+    void computeCellColoring(const std::vector<std::vector<dealii::types::global_dof_index> > & cellLocalProcIndexIdMap,
+			     std::vector<std::vector<unsigned int> >                          & cellColors);
+
+
 #ifdef USE_COMPLEX
     /** @brief Copies a single field component from a flattenedArray STL
      * vector containing multiple component fields to a 2-component field (real and complex)
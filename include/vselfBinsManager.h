@@ -64,7 +64,9 @@ namespace dftfe {
 	                     );
 
 	  /**
-	   * @brief Solve nuclear electrostatic self-potential of atoms in each bin one-by-one
+	   * @brief Solve nuclear electrostatic self-potential of atoms in all bins together using a block
+	   * conjugate gradient solve with fused operator applications and reductions over the bins, or in
+	   * each bin separately if VSELF BLOCK CG is false
 	   *
            * @param[in] matrix_free_data MatrixFree object
            * @param[in] offset MatrixFree object starting offset for vself bins solve
@@ -74,6 +76,9 @@ namespace dftfe {
 	   * @param[in] imageIds image atoms Ids data
 	   * @param[in] imageCharges image atoms charge values data	   *
 	   * @param[out] localVselfs peak self-potential values of atoms in the local processor
+	   * @param[in] usePreviousSolutionAsInitialGuess use the vself fields solved in the previous call as
+	   * the initial guesses, if the atom bins are unchanged. Requires the same dofs as the previous call,
+	   * for example after a mesh movement without remeshing
 	   */
 	  void solveVselfInBins(const dealii::MatrixFree<3,double> & matrix_free_data,
 		                                  const unsigned int offset,
@@ -82,7 +87,8 @@ namespace dftfe {
 						  const std::vector<std::vector<double> > & imagePositions,
 						  const std::vector<int> & imageIds,
 						  const std::vector<double> & imageCharges,
-	                                          std::vector<std::vector<double> > & localVselfs);
+	                                          std::vector<std::vector<double> > & localVselfs,
+						  const bool usePreviousSolutionAsInitialGuess=false);
 
           /// get const reference map of binIds and atomIds
 	  const std::map<int,std::set<int> > & getAtomIdsBins() const;
@@ -151,6 +157,9 @@ namespace dftfe {
 	/// solved vself solution field for each bin
 	std::vector<vectorType> d_vselfFieldBins;
 
+	/// map of binIds and atomIds corresponding to d_vselfFieldBins
+	std::map<int,std::set<int> > d_vselfFieldBinsAtomIds;
+
 	/// Map of locally relevant global dof index and the atomic charge in each bin
 	std::vector<std::map<dealii::types::global_dof_index, double> > d_atomsInBin;
 
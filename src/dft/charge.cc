@@ -23,7 +23,7 @@
 //
 template <unsigned int FEOrder>
 double dftClass<FEOrder>::totalCharge(const dealii::DoFHandler<3> & dofHandlerOfField,
-				      const std::map<dealii::CellId, std::vector<double> > *rhoQuadValues)
+				      const dftUtils::cellQuadratureField *rhoQuadValues)
 {
   double normValue = 0.0;
   QGauss<3>  quadrature_formula(C_num1DQuad<FEOrder>());
@@ -37,8 +37,9 @@ double dftClass<FEOrder>::totalCharge(const dealii::DoFHandler<3> & dofHandlerOf
   for (; cell!=endc; ++cell) {
     if (cell->is_locally_owned()){
       fe_values.reinit (cell);
+      const double * rhoQuadValuesCell=(*rhoQuadValues)[cell->id()];
       for (unsigned int q_point=0; q_point<n_q_points; ++q_point){
-        normValue+=(*rhoQuadValues).find(cell->id())->second[q_point]*fe_values.JxW(q_point);
+        normValue+=rhoQuadValuesCell[q_point]*fe_values.JxW(q_point);
       }
     }
   }
@@ -84,7 +85,7 @@ double dftClass<FEOrder>::totalCharge(const dealii::DoFHandler<3> & dofHandlerOf
 template <unsigned int FEOrder>
 double dftClass<FEOrder>::totalCharge(const dealii::DoFHandler<3> & dofHandlerOfField,
 				      const vectorType & rhoNodalField,
-				      std::map<dealii::CellId,std::vector<double> > & rhoQuadValues)
+				      dftUtils::cellQuadratureField & rhoQuadValues)
 {
   double normValue = 0.0;
   QGauss<3>  quadrature_formula(C_num1DQuad<FEOrder>());
@@ -93,6 +94,10 @@ double dftClass<FEOrder>::totalCharge(const dealii::DoFHandler<3> & dofHandlerOf
   const unsigned int n_q_points    = quadrature_formula.size();
   std::vector<double> tempRho(n_q_points);
 
+  std::shared_ptr<dftUtils::cellQuadratureFieldLayout> rhoQuadValuesLayout=std::make_shared<dftUtils::cellQuadratureFieldLayout>();
+  rhoQuadValuesLayout->reinit(dofHandlerOfField.get_triangulation());
+  rhoQuadValues.reinit(rhoQuadValuesLayout,n_q_points);
+
   DoFHandler<3>::active_cell_iterator
     cell = dofHandlerOfField.begin_active(),
     endc = dofHandlerOfField.end();
@@ -102,10 +107,10 @@ double dftClass<FEOrder>::totalCharge(const dealii::DoFHandler<3> & dofHandlerOf
 	{
 	  fe_values.reinit (cell);
 	  fe_values.get_function_values(rhoNodalField,tempRho);
-	  rhoQuadValues[cell->id()].resize(n_q_points);
+	  double * rhoQuadValuesCell=rhoQuadValues[cell->id()];
 	  for (unsigned int q_point=0; q_point<n_q_points; ++q_point)
 	    {
-	      rhoQuadValues[cell->id()][q_point] = tempRho[q_point];
+	      rhoQuadValuesCell[q_point] = tempRho[q_point];
 	      normValue += tempRho[q_point]*fe_values.JxW(q_point);
 	    }
 	}
@@ -116,7 +121,7 @@ double dftClass<FEOrder>::totalCharge(const dealii::DoFHandler<3> & dofHandlerOf
 
 //compute total charge
 template <unsigned int FEOrder>
-double dftClass<FEOrder>::totalMagnetization(const std::map<dealii::CellId, std::vector<double> > *rhoQuadValues){
+double dftClass<FEOrder>::totalMagnetization(const dftUtils::cellQuadratureField *rhoQuadValues){
   double normValue=0.0;
   QGauss<3>  quadrature_formula(C_num1DQuad<FEOrder>());
   FEValues<3> fe_values (FE, quadrature_formula, update_JxW_values);
@@ -129,8 +134,9 @@ double dftClass<FEOrder>::totalMagnetization(const std::map<dealii::CellId, std:
   for (; cell!=endc; ++cell) {
     if (cell->is_locally_owned()){
       fe_values.reinit (cell);
+      const double * rhoQuadValuesCell=(*rhoQuadValues)[cell->id()];
       for (unsigned int q_point=0; q_point<n_q_points; ++q_point){
-        normValue+=((*rhoQuadValues).find(cell->id())->second[2*q_point]-(*rhoQuadValues).find(cell->id())->second[2*q_point+1])*fe_values.JxW(q_point);
+        normValue+=(rhoQuadValuesCell[2*q_point]-rhoQuadValuesCell[2*q_point+1])*fe_values.JxW(q_point);
       }
     }
   }
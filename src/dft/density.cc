@@ -47,8 +47,9 @@ void dftClass<FEOrder>::compute_rhoOut(const bool isConsiderSpectrumSplitting)
 		    isConsiderSpectrumSplitting);
 
 
-  //pop out rhoInVals and rhoOutVals if their size exceeds mixing history size
-  if(rhoInVals.size() == dftParameters::mixingHistory)
+  //pop out rhoInVals and rhoOutVals if their size exceeds mixing history size. The storage of the
+  //popped entries is reused by the next push_back into the history
+  while(rhoInVals.size() >= dftParameters::mixingHistory)
     {
       rhoInVals.pop_front();
       rhoOutVals.pop_front();
@@ -88,81 +89,72 @@ void dftClass<FEOrder>::compute_rhoOut(const bool isConsiderSpectrumSplitting)
 
 template<unsigned int FEOrder>
 void dftClass<FEOrder>::resizeAndAllocateRhoTableStorage
-		    (std::deque<std::map<dealii::CellId,std::vector<double> >> & rhoVals,
-		     std::deque<std::map<dealii::CellId,std::vector<double> >> & gradRhoVals,
-		     std::deque<std::map<dealii::CellId,std::vector<double> >> & rhoValsSpinPolarized,
-		     std::deque<std::map<dealii::CellId,std::vector<double> >> & gradRhoValsSpinPolarized)
+		    (dftUtils::cellQuadratureFieldHistory & rhoVals,
+		     dftUtils::cellQuadratureFieldHistory & gradRhoVals,
+		     dftUtils::cellQuadratureFieldHistory & rhoValsSpinPolarized,
+		     dftUtils::cellQuadratureFieldHistory & gradRhoValsSpinPolarized)
 {
   const unsigned int numQuadPoints = matrix_free_data.get_n_q_points(0);;
 
   //create new rhoValue tables
-  rhoVals.push_back(std::map<dealii::CellId,std::vector<double> > ());
+  rhoVals.push_back(d_rhoQuadDataLayout,numQuadPoints);
   if (dftParameters::spinPolarized==1)
-	rhoValsSpinPolarized.push_back(std::map<dealii::CellId,std::vector<double> > ());
+  {
+	rhoValsSpinPolarized.push_back(d_rhoQuadDataLayout,2*numQuadPoints);
+  }
 
   if(dftParameters::xc_id == 4)
     {
-      gradRhoVals.push_back(std::map<dealii::CellId, std::vector<double> >());
+      gradRhoVals.push_back(d_rhoQuadDataLayout,3*numQuadPoints);
       if (dftParameters::spinPolarized==1)
-         gradRhoValsSpinPolarized.push_back(std::map<dealii::CellId, std::vector<double> >());
+      {
+         gradRhoValsSpinPolarized.push_back(d_rhoQuadDataLayout,6*numQuadPoints);
+      }
     }
-
-
-   typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
-   for (; cell!=endc; ++cell)
-      if (cell->is_locally_owned())
-	{
-	    const dealii::CellId cellId=cell->id();
-	    rhoVals.back()[cellId] = std::vector<double>(numQuadPoints,0.0);
-	    if(dftParameters::xc_id == 4)
-		gradRhoVals.back()[cellId] = std::vector<double>(3*numQuadPoints,0.0);
-
-	    if (dftParameters::spinPolarized==1)
-	    {
-		 rhoValsSpinPolarized.back()[cellId] = std::vector<double>(2*numQuadPoints,0.0);
-		 if(dftParameters::xc_id == 4)
-		    gradRhoValsSpinPolarized.back()[cellId]
-		     = std::vector<double>(6*numQuadPoints,0.0);
-	    }
-	}
 }
 
 template<unsigned int FEOrder>
-void dftClass<FEOrder>::sumRhoData(std::map<dealii::CellId, std::vector<double> > * _rhoValues,
-	              std::map<dealii::CellId, std::vector<double> > * _gradRhoValues,
-	              std::map<dealii::CellId, std::vector<double> > * _rhoValuesSpinPolarized,
-		      std::map<dealii::CellId, std::vector<double> > * _gradRhoValuesSpinPolarized,
+void dftClass<FEOrder>::sumRhoData(dftUtils::cellQuadratureField * _rhoValues,
+	              dftUtils::cellQuadratureField * _gradRhoValues,
+	              dftUtils::cellQuadratureField * _rhoValuesSpinPolarized,
+		      dftUtils::cellQuadratureField * _gradRhoValuesSpinPolarized,
 		      const bool isGradRhoDataPresent,
 		      const MPI_Comm &interComm)
 {
-   typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
-
-   //gather density from inter communicator
+   //gather density from inter communicator. The flat storage allows a single reduction per field
    if (dealii::Utilities::MPI::n_mpi_processes(interComm)>1)
-      for (; cell!=endc; ++cell)
-	  if (cell->is_locally_owned())
+   {
+	    MPI_Allreduce(MPI_IN_PLACE,
+			  _rhoValues->data(),
+			  _rhoValues->size(),
+			  MPI_DOUBLE,
+			  MPI_SUM,
+			  interComm);
+	    if(isGradRhoDataPresent)
+		MPI_Allreduce(MPI_IN_PLACE,
+			      _gradRhoValues->data(),
+			      _gradRhoValues->size(),
+			      MPI_DOUBLE,
+			      MPI_SUM,
+			      interComm);
+
+	    if (dftParameters::spinPolarized==1)
 	    {
-		    const dealii::CellId cellId=cell->id();
-
-		    dealii::Utilities::MPI::sum((*_rhoValues)[cellId],
-						interComm,
-						(*_rhoValues)[cellId]);
-		    if(isGradRhoDataPresent)
-		       dealii::Utilities::MPI::sum((*_gradRhoValues)[cellId],
-						   interComm,
-						   (*_gradRhoValues)[cellId]);
-
-		    if (dftParameters::spinPolarized==1)
-		    {
-			dealii::Utilities::MPI::sum((*_rhoValuesSpinPolarized)[cellId],
-						    interComm,
-						    (*_rhoValuesSpinPolarized)[cellId]);
-			if(isGradRhoDataPresent)
-			   dealii::Utilities::MPI::sum((*_gradRhoValuesSpinPolarized)[cellId],
-						       interComm,
-						       (*_gradRhoValuesSpinPolarized)[cellId]);
-		    }
-	      }
+		MPI_Allreduce(MPI_IN_PLACE,
+			      _rhoValuesSpinPolarized->data(),
+			      _rhoValuesSpinPolarized->size(),
+			      MPI_DOUBLE,
+			      MPI_SUM,
+			      interComm);
+		if(isGradRhoDataPresent)
+		    MPI_Allreduce(MPI_IN_PLACE,
+				  _gradRhoValuesSpinPolarized->data(),
+				  _gradRhoValuesSpinPolarized->size(),
+				  MPI_DOUBLE,
+				  MPI_SUM,
+				  interComm);
+	    }
+   }
 }
 
 //rho data reinitilization without remeshing. The rho out of last ground state solve is made the rho in of the new solve
@@ -170,22 +162,22 @@ template<unsigned int FEOrder>
 void dftClass<FEOrder>::noRemeshRhoDataInit()
 {
   //create temporary copies of rho Out data
-  std::map<dealii::CellId, std::vector<double> > rhoOutValuesCopy=*(rhoOutValues);
+  dftUtils::cellQuadratureField rhoOutValuesCopy=*(rhoOutValues);
 
-  std::map<dealii::CellId, std::vector<double> > gradRhoOutValuesCopy;
+  dftUtils::cellQuadratureField gradRhoOutValuesCopy;
   if (dftParameters::xc_id==4)
   {
      gradRhoOutValuesCopy=*(gradRhoOutValues);
   }
 
-  std::map<dealii::CellId, std::vector<double> > rhoOutValuesSpinPolarizedCopy;
+  dftUtils::cellQuadratureField rhoOutValuesSpinPolarizedCopy;
   if(dftParameters::spinPolarized==1)
   {
      rhoOutValuesSpinPolarizedCopy=*(rhoOutValuesSpinPolarized);
 
   }
 
-  std::map<dealii::CellId, std::vector<double> > gradRhoOutValuesSpinPolarizedCopy;
+  dftUtils::cellQuadratureField gradRhoOutValuesSpinPolarizedCopy;
   if(dftParameters::spinPolarized==1 && dftParameters::xc_id==4)
   {
      gradRhoOutValuesSpinPolarizedCopy=*(gradRhoOutValuesSpinPolarized);
@@ -216,16 +208,53 @@ void dftClass<FEOrder>::noRemeshRhoDataInit()
     gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
   }
 
+  //matrix_free_data has been reinitialized in initBoundaryConditions
+  remapRhoDataToCurrentLayout();
+
   normalizeRho();
 
 }
 
+//move rho cell quadrature data stored on a different cell enumeration (previous matrix_free_data
+//initialization or checkpoint) to the current cell enumeration of matrix_free_data
+template<unsigned int FEOrder>
+void dftClass<FEOrder>::remapRhoDataToCurrentLayout()
+{
+  std::vector<dftUtils::cellQuadratureFieldHistory *> rhoDataHistories
+	  ={&rhoInVals, &rhoOutVals,
+	    &gradRhoInVals, &gradRhoOutVals,
+	    &rhoInValsSpinPolarized, &rhoOutValsSpinPolarized,
+	    &gradRhoInValsSpinPolarized, &gradRhoOutValsSpinPolarized,
+	    &dFBroyden, &graddFBroyden,
+	    &uBroyden, &gradUBroyden};
+
+  for (unsigned int i=0; i<rhoDataHistories.size(); ++i)
+     for (unsigned int j=0; j<rhoDataHistories[i]->size(); ++j)
+	if ((*rhoDataHistories[i])[j].getLayout()!=d_rhoQuadDataLayout)
+	{
+	   dftUtils::cellQuadratureField remappedField;
+	   remappedField.reinit(d_rhoQuadDataLayout,(*rhoDataHistories[i])[j].nValuesPerCell());
+	   remappedField.copyFrom((*rhoDataHistories[i])[j]);
+	   (*rhoDataHistories[i])[j]=remappedField;
+	}
+
+  std::vector<dftUtils::cellQuadratureField *> broydenFields={&FBroyden, &gradFBroyden};
+  for (unsigned int i=0; i<broydenFields.size(); ++i)
+    if (broydenFields[i]->getLayout() && broydenFields[i]->getLayout()!=d_rhoQuadDataLayout)
+    {
+       dftUtils::cellQuadratureField remappedField;
+       remappedField.reinit(d_rhoQuadDataLayout,broydenFields[i]->nValuesPerCell());
+       remappedField.copyFrom(*broydenFields[i]);
+       *broydenFields[i]=remappedField;
+    }
+}
+
 template <unsigned int FEOrder>
 void dftClass<FEOrder>::computeRhoFromPSI
-                                (std::map<dealii::CellId, std::vector<double> > * _rhoValues,
-	                         std::map<dealii::CellId, std::vector<double> > * _gradRhoValues,
-	                         std::map<dealii::CellId, std::vector<double> > * _rhoValuesSpinPolarized,
-		                 std::map<dealii::CellId, std::vector<double> > * _gradRhoValuesSpinPolarized,
+                                (dftUtils::cellQuadratureField * _rhoValues,
+	                         dftUtils::cellQuadratureField * _gradRhoValues,
+	                         dftUtils::cellQuadratureField * _rhoValuesSpinPolarized,
+		                 dftUtils::cellQuadratureField * _gradRhoValuesSpinPolarized,
 		                 const bool isEvaluateGradRho,
 				 const bool isConsiderSpectrumSplitting)
 {
@@ -234,12 +263,7 @@ void dftClass<FEOrder>::computeRhoFromPSI
    const unsigned int numEigenVectorsCore=d_numEigenValues-d_numEigenValuesRR;
    const unsigned int numKPoints=d_kPointWeights.size();
 
-#ifdef USE_COMPLEX
-   FEEvaluation<3,FEOrder,C_num1DQuad<FEOrder>(),2> psiEval(matrix_free_data,eigenDofHandlerIndex , 0);
-#else
-   FEEvaluation<3,FEOrder,C_num1DQuad<FEOrder>(),1> psiEval(matrix_free_data,eigenDofHandlerIndex , 0);
-#endif
-   const unsigned int numQuadPoints=psiEval.n_q_points;
+   const unsigned int numQuadPoints=QGauss<3>(C_num1DQuad<FEOrder>()).size();
 
    Tensor<1,2,VectorizedArray<double> > zeroTensor1;
    zeroTensor1[0]=make_vectorized_array(0.0);
@@ -253,11 +277,6 @@ void dftClass<FEOrder>::computeRhoFromPSI
      zeroTensor3[idim]=make_vectorized_array(0.0);
    }
 
-   //temp arrays
-   std::vector<double> rhoTemp(numQuadPoints), rhoTempSpinPolarized(2*numQuadPoints), rho(numQuadPoints), rhoSpinPolarized(2*numQuadPoints);
-   std::vector<double> gradRhoTemp(3*numQuadPoints), gradRhoTempSpinPolarized(6*numQuadPoints),gradRho(3*numQuadPoints), gradRhoSpinPolarized(6*numQuadPoints);
-
-
    //band group parallelization data structures
    const unsigned int numberBandGroups=
 	dealii::Utilities::MPI::n_mpi_processes(interBandGroupComm);
@@ -438,451 +457,472 @@ void dftClass<FEOrder>::computeRhoFromPSI
 		 }
 	  }
 
+	  //
+	  //the macro cells are distributed among the threads as each macro cell
+	  //only adds to the quadrature point data of its own sub cells
+	  //
+	  dealii::parallel::apply_to_subranges
+	    (0U,
+	     matrix_free_data.n_macro_cells(),
+	     [&](const unsigned int macroCellBegin, const unsigned int macroCellEnd)
+	     {
 #ifdef USE_COMPLEX
-	  std::vector<Tensor<1,2,VectorizedArray<double> > > psiQuads(numQuadPoints*currentBlockSize*numKPoints,zeroTensor1);
-	  std::vector<Tensor<1,2,VectorizedArray<double> > > psiQuads2(numQuadPoints*currentBlockSize*numKPoints,zeroTensor1);
-	  std::vector<Tensor<1,2,Tensor<1,3,VectorizedArray<double> > > > gradPsiQuads(numQuadPoints*currentBlockSize*numKPoints,zeroTensor2);
-	  std::vector<Tensor<1,2,Tensor<1,3,VectorizedArray<double> > > > gradPsiQuads2(numQuadPoints*currentBlockSize*numKPoints,zeroTensor2);
-
-	  std::vector<Tensor<1,2,VectorizedArray<double> > > psiRotFracQuads(numQuadPoints*currentBlockSizeFrac*numKPoints,zeroTensor1);
-	  std::vector<Tensor<1,2,VectorizedArray<double> > > psiRotFracQuads2(numQuadPoints*currentBlockSizeFrac*numKPoints,zeroTensor1);
-	  std::vector<Tensor<1,2,Tensor<1,3,VectorizedArray<double> > > > gradPsiRotFracQuads(numQuadPoints*currentBlockSizeFrac*numKPoints,zeroTensor2);
-	  std::vector<Tensor<1,2,Tensor<1,3,VectorizedArray<double> > > > gradPsiRotFracQuads2(numQuadPoints*currentBlockSizeFrac*numKPoints,zeroTensor2);
+	       FEEvaluation<3,FEOrder,C_num1DQuad<FEOrder>(),2> psiEval(matrix_free_data,eigenDofHandlerIndex , 0);
 #else
-	  std::vector< VectorizedArray<double> > psiQuads(numQuadPoints*currentBlockSize,make_vectorized_array(0.0));
-	  std::vector< VectorizedArray<double> > psiQuads2(numQuadPoints*currentBlockSize,make_vectorized_array(0.0));
-	  std::vector<Tensor<1,3,VectorizedArray<double> > > gradPsiQuads(numQuadPoints*currentBlockSize,zeroTensor3);
-	  std::vector<Tensor<1,3,VectorizedArray<double> > > gradPsiQuads2(numQuadPoints*currentBlockSize,zeroTensor3);
-
-	  std::vector< VectorizedArray<double> > psiRotFracQuads(numQuadPoints*currentBlockSizeFrac,make_vectorized_array(0.0));
-	  std::vector< VectorizedArray<double> > psiRotFracQuads2(numQuadPoints*currentBlockSizeFrac,make_vectorized_array(0.0));
-	  std::vector<Tensor<1,3,VectorizedArray<double> > > gradPsiRotFracQuads(numQuadPoints*currentBlockSizeFrac,zeroTensor3);
-	  std::vector<Tensor<1,3,VectorizedArray<double> > > gradPsiRotFracQuads2(numQuadPoints*currentBlockSizeFrac,zeroTensor3);
+	       FEEvaluation<3,FEOrder,C_num1DQuad<FEOrder>(),1> psiEval(matrix_free_data,eigenDofHandlerIndex , 0);
 #endif
 
-	  for (unsigned int cell=0; cell<matrix_free_data.n_macro_cells(); ++cell)
-	  {
-		  psiEval.reinit(cell);
+	       //temp arrays
+	       std::vector<double> rhoTemp(numQuadPoints), rhoTempSpinPolarized(2*numQuadPoints), rho(numQuadPoints), rhoSpinPolarized(2*numQuadPoints);
+	       std::vector<double> gradRhoTemp(3*numQuadPoints), gradRhoTempSpinPolarized(6*numQuadPoints),gradRho(3*numQuadPoints), gradRhoSpinPolarized(6*numQuadPoints);
 
-		  const unsigned int numSubCells=matrix_free_data.n_components_filled(cell);
+#ifdef USE_COMPLEX
+	       std::vector<Tensor<1,2,VectorizedArray<double> > > psiQuads(numQuadPoints*currentBlockSize*numKPoints,zeroTensor1);
+	       std::vector<Tensor<1,2,VectorizedArray<double> > > psiQuads2(numQuadPoints*currentBlockSize*numKPoints,zeroTensor1);
+	       std::vector<Tensor<1,2,Tensor<1,3,VectorizedArray<double> > > > gradPsiQuads(numQuadPoints*currentBlockSize*numKPoints,zeroTensor2);
+	       std::vector<Tensor<1,2,Tensor<1,3,VectorizedArray<double> > > > gradPsiQuads2(numQuadPoints*currentBlockSize*numKPoints,zeroTensor2);
+
+	       std::vector<Tensor<1,2,VectorizedArray<double> > > psiRotFracQuads(numQuadPoints*currentBlockSizeFrac*numKPoints,zeroTensor1);
+	       std::vector<Tensor<1,2,VectorizedArray<double> > > psiRotFracQuads2(numQuadPoints*currentBlockSizeFrac*numKPoints,zeroTensor1);
+	       std::vector<Tensor<1,2,Tensor<1,3,VectorizedArray<double> > > > gradPsiRotFracQuads(numQuadPoints*currentBlockSizeFrac*numKPoints,zeroTensor2);
+	       std::vector<Tensor<1,2,Tensor<1,3,VectorizedArray<double> > > > gradPsiRotFracQuads2(numQuadPoints*currentBlockSizeFrac*numKPoints,zeroTensor2);
+#else
+	       std::vector< VectorizedArray<double> > psiQuads(numQuadPoints*currentBlockSize,make_vectorized_array(0.0));
+	       std::vector< VectorizedArray<double> > psiQuads2(numQuadPoints*currentBlockSize,make_vectorized_array(0.0));
+	       std::vector<Tensor<1,3,VectorizedArray<double> > > gradPsiQuads(numQuadPoints*currentBlockSize,zeroTensor3);
+	       std::vector<Tensor<1,3,VectorizedArray<double> > > gradPsiQuads2(numQuadPoints*currentBlockSize,zeroTensor3);
+
+	       std::vector< VectorizedArray<double> > psiRotFracQuads(numQuadPoints*currentBlockSizeFrac,make_vectorized_array(0.0));
+	       std::vector< VectorizedArray<double> > psiRotFracQuads2(numQuadPoints*currentBlockSizeFrac,make_vectorized_array(0.0));
+	       std::vector<Tensor<1,3,VectorizedArray<double> > > gradPsiRotFracQuads(numQuadPoints*currentBlockSizeFrac,zeroTensor3);
+	       std::vector<Tensor<1,3,VectorizedArray<double> > > gradPsiRotFracQuads2(numQuadPoints*currentBlockSizeFrac,zeroTensor3);
+#endif
 
-		  for(unsigned int kPoint = 0; kPoint < numKPoints; ++kPoint)
-		      for(unsigned int iEigenVec=0; iEigenVec<currentBlockSize; ++iEigenVec)
-			{
+	       for (unsigned int cell=macroCellBegin; cell<macroCellEnd; ++cell)
+	       {
+		       psiEval.reinit(cell);
 
-			   psiEval.read_dof_values_plain
-			       (eigenVectors[(1+dftParameters::spinPolarized)*kPoint][iEigenVec]);
+		       const unsigned int numSubCells=matrix_free_data.n_components_filled(cell);
 
-			   if(isEvaluateGradRho)
-			      psiEval.evaluate(true,true);
-			   else
-			      psiEval.evaluate(true,false);
+		       for(unsigned int kPoint = 0; kPoint < numKPoints; ++kPoint)
+			   for(unsigned int iEigenVec=0; iEigenVec<currentBlockSize; ++iEigenVec)
+			     {
 
-			   for (unsigned int q=0; q<numQuadPoints; ++q)
-			   {
-			     psiQuads[q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec]=psiEval.get_value(q);
-			     if(isEvaluateGradRho)
-				gradPsiQuads[q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec]=psiEval.get_gradient(q);
-			   }
-
-			   if(dftParameters::spinPolarized==1)
-			   {
-
-			       psiEval.read_dof_values_plain
-				   (eigenVectors[(1+dftParameters::spinPolarized)*kPoint+1][iEigenVec]);
-
-			       if(isEvaluateGradRho)
-				  psiEval.evaluate(true,true);
-			       else
-				  psiEval.evaluate(true,false);
-
-			       for (unsigned int q=0; q<numQuadPoints; ++q)
-			       {
-				 psiQuads2[q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec]=psiEval.get_value(q);
-				 if(isEvaluateGradRho)
-				    gradPsiQuads2[q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec]=psiEval.get_gradient(q);
-			       }
-			   }
-
-			   if (isRotFracEigenVectorsInBlock && iEigenVec>=startingIndexFrac)
-			   {
-
-			       const unsigned int vectorIndex=iEigenVec-startingIndexFrac;
-			       psiEval.read_dof_values_plain
-				   (eigenVectorsRotFrac
-				    [(1+dftParameters::spinPolarized)*kPoint][vectorIndex]);
-
-			       if(isEvaluateGradRho)
-				  psiEval.evaluate(true,true);
-			       else
-				  psiEval.evaluate(true,false);
-
-			       for (unsigned int q=0; q<numQuadPoints; ++q)
-			       {
-				 psiRotFracQuads[q*currentBlockSizeFrac*numKPoints
-				     +currentBlockSizeFrac*kPoint+vectorIndex]=psiEval.get_value(q);
-				 if(isEvaluateGradRho)
-				    gradPsiRotFracQuads[q*currentBlockSizeFrac*numKPoints
-					+currentBlockSizeFrac*kPoint+vectorIndex]=psiEval.get_gradient(q);
-			       }
-
-			       if(dftParameters::spinPolarized==1)
-			       {
-
-				   psiEval.read_dof_values_plain
-				       (eigenVectorsRotFrac[(1+dftParameters::spinPolarized)*kPoint
-					                       +1][vectorIndex]);
-
-				   if(isEvaluateGradRho)
-				      psiEval.evaluate(true,true);
-				   else
-				      psiEval.evaluate(true,false);
-
-				   for (unsigned int q=0; q<numQuadPoints; ++q)
-				   {
-				     psiRotFracQuads2[q*currentBlockSizeFrac*numKPoints
-					 +currentBlockSizeFrac*kPoint+vectorIndex]=psiEval.get_value(q);
-				     if(isEvaluateGradRho)
-					gradPsiRotFracQuads2[q*currentBlockSizeFrac*numKPoints
-					    +currentBlockSizeFrac*kPoint+vectorIndex]=psiEval.get_gradient(q);
-				   }
-			       }
-			   }
-
-			}//eigenvector per k point
-
-		  for (unsigned int iSubCell=0; iSubCell<numSubCells; ++iSubCell)
-		  {
-			const dealii::CellId subCellId=matrix_free_data.get_cell_iterator(cell,iSubCell)->id();
-
-			std::fill(rhoTemp.begin(),rhoTemp.end(),0.0); std::fill(rho.begin(),rho.end(),0.0);
-
-			if (dftParameters::spinPolarized==1)
-			    std::fill(rhoTempSpinPolarized.begin(),rhoTempSpinPolarized.end(),0.0);
-
-			if(isEvaluateGradRho)
-			{
-			  std::fill(gradRhoTemp.begin(),gradRhoTemp.end(),0.0);
-			  if (dftParameters::spinPolarized==1)
-			      std::fill(gradRhoTempSpinPolarized.begin(),gradRhoTempSpinPolarized.end(),0.0);
-			}
-
-			for(unsigned int kPoint = 0; kPoint < numKPoints; ++kPoint)
-			{
-			  for(unsigned int iEigenVec=0; iEigenVec<currentBlockSize; ++iEigenVec)
-			    {
-
-			      double partialOccupancy=dftUtils::getPartialOccupancy
-							    (eigenValues[kPoint][ivec+iEigenVec],
-							     fermiEnergy,
-							     C_kb,
-							     dftParameters::TVal);
-
-			      double partialOccupancy2=dftUtils::getPartialOccupancy
-							    (eigenValues[kPoint][ivec+iEigenVec
-							     +dftParameters::spinPolarized*numEigenVectorsTotal],
-							     fermiEnergy,
-							     C_kb,
-							     dftParameters::TVal);
-			      if(dftParameters::constraintMagnetization)
-				{
-				 partialOccupancy = 1.0 , partialOccupancy2 = 1.0 ;
-				 if (eigenValues[kPoint][ivec+iEigenVec
-					 +dftParameters::spinPolarized*numEigenVectorsTotal] > fermiEnergyDown)
-					partialOccupancy2 = 0.0 ;
-				 if (eigenValues[kPoint][ivec+iEigenVec] > fermiEnergyUp)
-					partialOccupancy = 0.0 ;
+				psiEval.read_dof_values_plain
+				    (eigenVectors[(1+dftParameters::spinPolarized)*kPoint][iEigenVec]);
 
-				}
+				if(isEvaluateGradRho)
+				   psiEval.evaluate(true,true);
+				else
+				   psiEval.evaluate(true,false);
 
-			      for(unsigned int q=0; q<numQuadPoints; ++q)
+				for (unsigned int q=0; q<numQuadPoints; ++q)
 				{
-				  const unsigned int id=q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec;
-#ifdef USE_COMPLEX
-				  Vector<double> psi, psi2;
-				  psi.reinit(2); psi2.reinit(2);
-
-				  psi(0)= psiQuads[id][0][iSubCell];
-				  psi(1)=psiQuads[id][1][iSubCell];
-
-				  if(dftParameters::spinPolarized==1)
-				  {
-				    psi2(0)=psiQuads2[id][0][iSubCell];
-				    psi2(1)=psiQuads2[id][1][iSubCell];
-				  }
-
-				  std::vector<Tensor<1,3,double> > gradPsi(2),gradPsi2(2);
-
+				  psiQuads[q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec]=psiEval.get_value(q);
 				  if(isEvaluateGradRho)
-				      for(unsigned int idim=0; idim<3; ++idim)
-				      {
-					 gradPsi[0][idim]=gradPsiQuads[id][0][idim][iSubCell];
-					 gradPsi[1][idim]=gradPsiQuads[id][1][idim][iSubCell];
-
-					 if(dftParameters::spinPolarized==1)
-					 {
-					     gradPsi2[0][idim]=gradPsiQuads2[id][0][idim][iSubCell];
-					     gradPsi2[1][idim]=gradPsiQuads2[id][1][idim][iSubCell];
-					 }
-				      }
-#else
-				  double psi, psi2;
-				  psi=psiQuads[id][iSubCell];
-				  if (dftParameters::spinPolarized==1)
-				      psi2=psiQuads2[id][iSubCell];
+				     gradPsiQuads[q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec]=psiEval.get_gradient(q);
+				}
 
-				  Tensor<1,3,double> gradPsi,gradPsi2;
-				  if(isEvaluateGradRho)
-				      for(unsigned int idim=0; idim<3; ++idim)
-				      {
-					 gradPsi[idim]=gradPsiQuads[id][idim][iSubCell];
-					 if(dftParameters::spinPolarized==1)
-					     gradPsi2[idim]=gradPsiQuads2[id][idim][iSubCell];
-				      }
+				if(dftParameters::spinPolarized==1)
+				{
 
-#endif
+				    psiEval.read_dof_values_plain
+					(eigenVectors[(1+dftParameters::spinPolarized)*kPoint+1][iEigenVec]);
 
-				  if (isRotFracEigenVectorsInBlock && iEigenVec>=startingIndexFrac)
-				  {
-				      const unsigned int idFrac=q*currentBlockSizeFrac*numKPoints
-					             +currentBlockSizeFrac*kPoint
-						     +iEigenVec-startingIndexFrac;
-#ifdef USE_COMPLEX
-				      Vector<double> psiRotFrac, psiRotFrac2;
-				      psiRotFrac.reinit(2); psiRotFrac2.reinit(2);
+				    if(isEvaluateGradRho)
+				       psiEval.evaluate(true,true);
+				    else
+				       psiEval.evaluate(true,false);
 
-				      psiRotFrac(0)= psiRotFracQuads[idFrac][0][iSubCell];
-				      psiRotFrac(1)=psiRotFracQuads[idFrac][1][iSubCell];
+				    for (unsigned int q=0; q<numQuadPoints; ++q)
+				    {
+				      psiQuads2[q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec]=psiEval.get_value(q);
+				      if(isEvaluateGradRho)
+					 gradPsiQuads2[q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec]=psiEval.get_gradient(q);
+				    }
+				}
 
-				      if(dftParameters::spinPolarized==1)
-				      {
-					psiRotFrac2(0)=psiRotFracQuads2[idFrac][0][iSubCell];
-					psiRotFrac2(1)=psiRotFracQuads2[idFrac][1][iSubCell];
-				      }
+				if (isRotFracEigenVectorsInBlock && iEigenVec>=startingIndexFrac)
+				{
 
-				      std::vector<Tensor<1,3,double> > gradPsiRotFrac(2),gradPsiRotFrac2(2);
+				    const unsigned int vectorIndex=iEigenVec-startingIndexFrac;
+				    psiEval.read_dof_values_plain
+					(eigenVectorsRotFrac
+					 [(1+dftParameters::spinPolarized)*kPoint][vectorIndex]);
 
+				    if(isEvaluateGradRho)
+				       psiEval.evaluate(true,true);
+				    else
+				       psiEval.evaluate(true,false);
+
+				    for (unsigned int q=0; q<numQuadPoints; ++q)
+				    {
+				      psiRotFracQuads[q*currentBlockSizeFrac*numKPoints
+					  +currentBlockSizeFrac*kPoint+vectorIndex]=psiEval.get_value(q);
 				      if(isEvaluateGradRho)
-					  for(unsigned int idim=0; idim<3; ++idim)
-					  {
-					     gradPsiRotFrac[0][idim]
-						 =gradPsiRotFracQuads[idFrac][0][idim][iSubCell];
-					     gradPsiRotFrac[1][idim]
-						 =gradPsiRotFracQuads[idFrac][1][idim][iSubCell];
-
-					     if(dftParameters::spinPolarized==1)
-					     {
-						 gradPsiRotFrac2[0][idim]
-						     =gradPsiRotFracQuads2[idFrac][0][idim][iSubCell];
-						 gradPsiRotFrac2[1][idim]
-						     =gradPsiRotFracQuads2[idFrac][1][idim][iSubCell];
-					     }
-					  }
-#else
-				      double psiRotFrac, psiRotFrac2;
-				      psiRotFrac=psiRotFracQuads[idFrac][iSubCell];
-				      if (dftParameters::spinPolarized==1)
-					  psiRotFrac2=psiRotFracQuads2[idFrac][iSubCell];
+					 gradPsiRotFracQuads[q*currentBlockSizeFrac*numKPoints
+					     +currentBlockSizeFrac*kPoint+vectorIndex]=psiEval.get_gradient(q);
+				    }
 
-				      Tensor<1,3,double> gradPsiRotFrac,gradPsiRotFrac2;
-				      if(isEvaluateGradRho)
-					  for(unsigned int idim=0; idim<3; ++idim)
-					  {
-					     gradPsiRotFrac[idim]
-						 =gradPsiRotFracQuads[idFrac][idim][iSubCell];
-					     if(dftParameters::spinPolarized==1)
-						 gradPsiRotFrac2[idim]
-						     =gradPsiRotFracQuads2[idFrac][idim][iSubCell];
-					  }
+				    if(dftParameters::spinPolarized==1)
+				    {
 
-#endif
+					psiEval.read_dof_values_plain
+					    (eigenVectorsRotFrac[(1+dftParameters::spinPolarized)*kPoint
+								    +1][vectorIndex]);
 
-#ifdef USE_COMPLEX
-				      if(dftParameters::spinPolarized==1)
-					{
-					  rhoTempSpinPolarized[2*q]
-					      +=
-					      d_kPointWeights[kPoint]
-					      *(partialOccupancy*(psiRotFrac(0)*psiRotFrac(0)
-					         + psiRotFrac(1)*psiRotFrac(1))
-					      -(psiRotFrac(0)*psiRotFrac(0)
-					         + psiRotFrac(1)*psiRotFrac(1))
-					      +(psi(0)*psi(0) + psi(1)*psi(1)));
-
-					  rhoTempSpinPolarized[2*q+1]
-					      +=
-					      d_kPointWeights[kPoint]
-					      *(partialOccupancy2*(psiRotFrac2(0)*psiRotFrac2(0)
-							  + psiRotFrac2(1)*psiRotFrac2(1))
-					       -(psiRotFrac2(0)*psiRotFrac2(0)
-							  + psiRotFrac2(1)*psiRotFrac2(1))
-					       +(psi2(0)*psi2(0)+ psi2(1)*psi2(1)));
-					  //
-					  if(isEvaluateGradRho)
-					      for(unsigned int idim=0; idim<3; ++idim)
-					      {
-						  gradRhoTempSpinPolarized[6*q + idim]
-						  += 2.0*d_kPointWeights[kPoint]
-						  *(partialOccupancy*(psiRotFrac(0)*gradPsiRotFrac[0][idim]
-						      + psiRotFrac(1)*gradPsiRotFrac[1][idim])
-					             -(psiRotFrac(0)*gradPsiRotFrac[0][idim]
-						      + psiRotFrac(1)*gradPsiRotFrac[1][idim])
-						     +(psi(0)*gradPsi[0][idim] + psi(1)*gradPsi[1][idim]));
-						  gradRhoTempSpinPolarized[6*q + 3+idim]
-						  += 2.0*d_kPointWeights[kPoint]
-						  *(partialOccupancy2*(psiRotFrac2(0)*gradPsiRotFrac2[0][idim]
-						     + psiRotFrac2(1)*gradPsiRotFrac2[1][idim])
-					            -(psiRotFrac2(0)*gradPsiRotFrac2[0][idim]
-						     + psiRotFrac2(1)*gradPsiRotFrac2[1][idim])
-						    +(psi2(0)*gradPsi2[0][idim] + psi2(1)*gradPsi2[1][idim]));
-					      }
-					}
-				      else
+					if(isEvaluateGradRho)
+					   psiEval.evaluate(true,true);
+					else
+					   psiEval.evaluate(true,false);
+
+					for (unsigned int q=0; q<numQuadPoints; ++q)
 					{
-					  rhoTemp[q] += 2.0*d_kPointWeights[kPoint]
-					      *(partialOccupancy*(psiRotFrac(0)*psiRotFrac(0)
-					          + psiRotFrac(1)*psiRotFrac(1))
-						-(psiRotFrac(0)*psiRotFrac(0)
-					          + psiRotFrac(1)*psiRotFrac(1))
-						+(psi(0)*psi(0) + psi(1)*psi(1)));
+					  psiRotFracQuads2[q*currentBlockSizeFrac*numKPoints
+					      +currentBlockSizeFrac*kPoint+vectorIndex]=psiEval.get_value(q);
 					  if(isEvaluateGradRho)
-					    for(unsigned int idim=0; idim<3; ++idim)
-					       gradRhoTemp[3*q + idim]
-						   += 2.0*2.0*d_kPointWeights[kPoint]
-						   *(partialOccupancy*(psiRotFrac(0)*gradPsiRotFrac[0][idim]
-						       + psiRotFrac(1)*gradPsiRotFrac[1][idim])
-						      -(psiRotFrac(0)*gradPsiRotFrac[0][idim]
-						       + psiRotFrac(1)*gradPsiRotFrac[1][idim])
-					            +(psi(0)*gradPsi[0][idim] + psi(1)*gradPsi[1][idim]));
+					     gradPsiRotFracQuads2[q*currentBlockSizeFrac*numKPoints
+						 +currentBlockSizeFrac*kPoint+vectorIndex]=psiEval.get_gradient(q);
 					}
-#else
-				      if(dftParameters::spinPolarized==1)
-					{
-					  rhoTempSpinPolarized[2*q] += (partialOccupancy*psiRotFrac*psiRotFrac
-						                        -psiRotFrac*psiRotFrac
-						                        +psi*psi);
-					  rhoTempSpinPolarized[2*q+1] +=(partialOccupancy2*psiRotFrac2*psiRotFrac2
-						                         -psiRotFrac2*psiRotFrac2
-						                         +psi2*psi2);
+				    }
+				}
 
-					  if(isEvaluateGradRho)
-					      for(unsigned int idim=0; idim<3; ++idim)
-					      {
-						  gradRhoTempSpinPolarized[6*q + idim]
-						      += 2.0*(partialOccupancy*psiRotFrac*gradPsiRotFrac[idim]
-							      -psiRotFrac*gradPsiRotFrac[idim]
-							     +psi*gradPsi[idim]);
-						  gradRhoTempSpinPolarized[6*q + 3+idim]
-						      +=  2.0*(partialOccupancy2*psiRotFrac2*gradPsiRotFrac2[idim]
-							      -psiRotFrac2*gradPsiRotFrac2[idim]
-							      +psi2*gradPsi2[idim]);
-					      }
-					}
-				      else
-					{
-					  rhoTemp[q] += 2.0*(partialOccupancy*psiRotFrac*psiRotFrac
-						            -psiRotFrac*psiRotFrac
-							    +psi*psi);
+			     }//eigenvector per k point
 
-					  if(isEvaluateGradRho)
-					    for(unsigned int idim=0; idim<3; ++idim)
-					       gradRhoTemp[3*q + idim]
-						   += 2.0*2.0*(partialOccupancy*psiRotFrac*gradPsiRotFrac[idim]
-							       -psiRotFrac*gradPsiRotFrac[idim]
-							       +psi*gradPsi[idim]);
-					}
+		       for (unsigned int iSubCell=0; iSubCell<numSubCells; ++iSubCell)
+		       {
+			     const unsigned int subCellIndex=d_rhoQuadDataLayout->cellIndex(cell,iSubCell);
 
-#endif
+			     std::fill(rhoTemp.begin(),rhoTemp.end(),0.0); std::fill(rho.begin(),rho.end(),0.0);
 
-				  }
-				  else
-				  {
+			     if (dftParameters::spinPolarized==1)
+				 std::fill(rhoTempSpinPolarized.begin(),rhoTempSpinPolarized.end(),0.0);
+
+			     if(isEvaluateGradRho)
+			     {
+			       std::fill(gradRhoTemp.begin(),gradRhoTemp.end(),0.0);
+			       if (dftParameters::spinPolarized==1)
+				   std::fill(gradRhoTempSpinPolarized.begin(),gradRhoTempSpinPolarized.end(),0.0);
+			     }
+
+			     for(unsigned int kPoint = 0; kPoint < numKPoints; ++kPoint)
+			     {
+			       for(unsigned int iEigenVec=0; iEigenVec<currentBlockSize; ++iEigenVec)
+				 {
+
+				   double partialOccupancy=dftUtils::getPartialOccupancy
+								 (eigenValues[kPoint][ivec+iEigenVec],
+								  fermiEnergy,
+								  C_kb,
+								  dftParameters::TVal);
+
+				   double partialOccupancy2=dftUtils::getPartialOccupancy
+								 (eigenValues[kPoint][ivec+iEigenVec
+								  +dftParameters::spinPolarized*numEigenVectorsTotal],
+								  fermiEnergy,
+								  C_kb,
+								  dftParameters::TVal);
+				   if(dftParameters::constraintMagnetization)
+				     {
+				      partialOccupancy = 1.0 , partialOccupancy2 = 1.0 ;
+				      if (eigenValues[kPoint][ivec+iEigenVec
+					      +dftParameters::spinPolarized*numEigenVectorsTotal] > fermiEnergyDown)
+					     partialOccupancy2 = 0.0 ;
+				      if (eigenValues[kPoint][ivec+iEigenVec] > fermiEnergyUp)
+					     partialOccupancy = 0.0 ;
+
+				     }
+
+				   for(unsigned int q=0; q<numQuadPoints; ++q)
+				     {
+				       const unsigned int id=q*currentBlockSize*numKPoints+currentBlockSize*kPoint+iEigenVec;
 #ifdef USE_COMPLEX
-				      if(dftParameters::spinPolarized==1)
-					{
-					  rhoTempSpinPolarized[2*q] += partialOccupancy*d_kPointWeights[kPoint]*(psi(0)*psi(0) + psi(1)*psi(1));
-					  rhoTempSpinPolarized[2*q+1] += partialOccupancy2*d_kPointWeights[kPoint]*(psi2(0)*psi2(0) + psi2(1)*psi2(1));
-					  //
-					  if(isEvaluateGradRho)
-					      for(unsigned int idim=0; idim<3; ++idim)
+				       Vector<double> psi, psi2;
+				       psi.reinit(2); psi2.reinit(2);
+
+				       psi(0)= psiQuads[id][0][iSubCell];
+				       psi(1)=psiQuads[id][1][iSubCell];
+
+				       if(dftParameters::spinPolarized==1)
+				       {
+					 psi2(0)=psiQuads2[id][0][iSubCell];
+					 psi2(1)=psiQuads2[id][1][iSubCell];
+				       }
+
+				       std::vector<Tensor<1,3,double> > gradPsi(2),gradPsi2(2);
+
+				       if(isEvaluateGradRho)
+					   for(unsigned int idim=0; idim<3; ++idim)
+					   {
+					      gradPsi[0][idim]=gradPsiQuads[id][0][idim][iSubCell];
+					      gradPsi[1][idim]=gradPsiQuads[id][1][idim][iSubCell];
+
+					      if(dftParameters::spinPolarized==1)
 					      {
-						  gradRhoTempSpinPolarized[6*q + idim] +=
-						  2.0*partialOccupancy*d_kPointWeights[kPoint]*(psi(0)*gradPsi[0][idim] + psi(1)*gradPsi[1][idim]);
-						  gradRhoTempSpinPolarized[6*q + 3+idim] +=
-						  2.0*partialOccupancy2*d_kPointWeights[kPoint]*(psi2(0)*gradPsi2[0][idim] + psi2(1)*gradPsi2[1][idim]);
+						  gradPsi2[0][idim]=gradPsiQuads2[id][0][idim][iSubCell];
+						  gradPsi2[1][idim]=gradPsiQuads2[id][1][idim][iSubCell];
 					      }
-					}
-				      else
-					{
-					  rhoTemp[q] += 2.0*partialOccupancy*d_kPointWeights[kPoint]*(psi(0)*psi(0) + psi(1)*psi(1));
-					  if(isEvaluateGradRho)
-					    for(unsigned int idim=0; idim<3; ++idim)
-					       gradRhoTemp[3*q + idim] += 2.0*2.0*partialOccupancy*d_kPointWeights[kPoint]*(psi(0)*gradPsi[0][idim] + psi(1)*gradPsi[1][idim]);
-					}
+					   }
 #else
-				      if(dftParameters::spinPolarized==1)
-					{
-					  rhoTempSpinPolarized[2*q] += partialOccupancy*psi*psi;
-					  rhoTempSpinPolarized[2*q+1] += partialOccupancy2*psi2*psi2;
+				       double psi, psi2;
+				       psi=psiQuads[id][iSubCell];
+				       if (dftParameters::spinPolarized==1)
+					   psi2=psiQuads2[id][iSubCell];
+
+				       Tensor<1,3,double> gradPsi,gradPsi2;
+				       if(isEvaluateGradRho)
+					   for(unsigned int idim=0; idim<3; ++idim)
+					   {
+					      gradPsi[idim]=gradPsiQuads[id][idim][iSubCell];
+					      if(dftParameters::spinPolarized==1)
+						  gradPsi2[idim]=gradPsiQuads2[id][idim][iSubCell];
+					   }
 
-					  if(isEvaluateGradRho)
-					      for(unsigned int idim=0; idim<3; ++idim)
-					      {
-						  gradRhoTempSpinPolarized[6*q + idim] += 2.0*partialOccupancy*(psi*gradPsi[idim]);
-						  gradRhoTempSpinPolarized[6*q + 3+idim] +=  2.0*partialOccupancy2*(psi2*gradPsi2[idim]);
-					      }
-					}
-				      else
-					{
-					  rhoTemp[q] += 2.0*partialOccupancy*psi*psi;
+#endif
 
-					  if(isEvaluateGradRho)
-					    for(unsigned int idim=0; idim<3; ++idim)
-					       gradRhoTemp[3*q + idim] += 2.0*2.0*partialOccupancy*psi*gradPsi[idim];
-					}
+				       if (isRotFracEigenVectorsInBlock && iEigenVec>=startingIndexFrac)
+				       {
+					   const unsigned int idFrac=q*currentBlockSizeFrac*numKPoints
+							  +currentBlockSizeFrac*kPoint
+							  +iEigenVec-startingIndexFrac;
+#ifdef USE_COMPLEX
+					   Vector<double> psiRotFrac, psiRotFrac2;
+					   psiRotFrac.reinit(2); psiRotFrac2.reinit(2);
+
+					   psiRotFrac(0)= psiRotFracQuads[idFrac][0][iSubCell];
+					   psiRotFrac(1)=psiRotFracQuads[idFrac][1][iSubCell];
+
+					   if(dftParameters::spinPolarized==1)
+					   {
+					     psiRotFrac2(0)=psiRotFracQuads2[idFrac][0][iSubCell];
+					     psiRotFrac2(1)=psiRotFracQuads2[idFrac][1][iSubCell];
+					   }
+
+					   std::vector<Tensor<1,3,double> > gradPsiRotFrac(2),gradPsiRotFrac2(2);
+
+					   if(isEvaluateGradRho)
+					       for(unsigned int idim=0; idim<3; ++idim)
+					       {
+						  gradPsiRotFrac[0][idim]
+						      =gradPsiRotFracQuads[idFrac][0][idim][iSubCell];
+						  gradPsiRotFrac[1][idim]
+						      =gradPsiRotFracQuads[idFrac][1][idim][iSubCell];
+
+						  if(dftParameters::spinPolarized==1)
+						  {
+						      gradPsiRotFrac2[0][idim]
+							  =gradPsiRotFracQuads2[idFrac][0][idim][iSubCell];
+						      gradPsiRotFrac2[1][idim]
+							  =gradPsiRotFracQuads2[idFrac][1][idim][iSubCell];
+						  }
+					       }
+#else
+					   double psiRotFrac, psiRotFrac2;
+					   psiRotFrac=psiRotFracQuads[idFrac][iSubCell];
+					   if (dftParameters::spinPolarized==1)
+					       psiRotFrac2=psiRotFracQuads2[idFrac][iSubCell];
+
+					   Tensor<1,3,double> gradPsiRotFrac,gradPsiRotFrac2;
+					   if(isEvaluateGradRho)
+					       for(unsigned int idim=0; idim<3; ++idim)
+					       {
+						  gradPsiRotFrac[idim]
+						      =gradPsiRotFracQuads[idFrac][idim][iSubCell];
+						  if(dftParameters::spinPolarized==1)
+						      gradPsiRotFrac2[idim]
+							  =gradPsiRotFracQuads2[idFrac][idim][iSubCell];
+					       }
 
 #endif
-				  }
 
-				}//quad point loop
-			    }//block eigenvectors per k point
-			}
+#ifdef USE_COMPLEX
+					   if(dftParameters::spinPolarized==1)
+					     {
+					       rhoTempSpinPolarized[2*q]
+						   +=
+						   d_kPointWeights[kPoint]
+						   *(partialOccupancy*(psiRotFrac(0)*psiRotFrac(0)
+						      + psiRotFrac(1)*psiRotFrac(1))
+						   -(psiRotFrac(0)*psiRotFrac(0)
+						      + psiRotFrac(1)*psiRotFrac(1))
+						   +(psi(0)*psi(0) + psi(1)*psi(1)));
+
+					       rhoTempSpinPolarized[2*q+1]
+						   +=
+						   d_kPointWeights[kPoint]
+						   *(partialOccupancy2*(psiRotFrac2(0)*psiRotFrac2(0)
+							       + psiRotFrac2(1)*psiRotFrac2(1))
+						    -(psiRotFrac2(0)*psiRotFrac2(0)
+							       + psiRotFrac2(1)*psiRotFrac2(1))
+						    +(psi2(0)*psi2(0)+ psi2(1)*psi2(1)));
+					       //
+					       if(isEvaluateGradRho)
+						   for(unsigned int idim=0; idim<3; ++idim)
+						   {
+						       gradRhoTempSpinPolarized[6*q + idim]
+						       += 2.0*d_kPointWeights[kPoint]
+						       *(partialOccupancy*(psiRotFrac(0)*gradPsiRotFrac[0][idim]
+							   + psiRotFrac(1)*gradPsiRotFrac[1][idim])
+							  -(psiRotFrac(0)*gradPsiRotFrac[0][idim]
+							   + psiRotFrac(1)*gradPsiRotFrac[1][idim])
+							  +(psi(0)*gradPsi[0][idim] + psi(1)*gradPsi[1][idim]));
+						       gradRhoTempSpinPolarized[6*q + 3+idim]
+						       += 2.0*d_kPointWeights[kPoint]
+						       *(partialOccupancy2*(psiRotFrac2(0)*gradPsiRotFrac2[0][idim]
+							  + psiRotFrac2(1)*gradPsiRotFrac2[1][idim])
+							 -(psiRotFrac2(0)*gradPsiRotFrac2[0][idim]
+							  + psiRotFrac2(1)*gradPsiRotFrac2[1][idim])
+							 +(psi2(0)*gradPsi2[0][idim] + psi2(1)*gradPsi2[1][idim]));
+						   }
+					     }
+					   else
+					     {
+					       rhoTemp[q] += 2.0*d_kPointWeights[kPoint]
+						   *(partialOccupancy*(psiRotFrac(0)*psiRotFrac(0)
+						       + psiRotFrac(1)*psiRotFrac(1))
+						     -(psiRotFrac(0)*psiRotFrac(0)
+						       + psiRotFrac(1)*psiRotFrac(1))
+						     +(psi(0)*psi(0) + psi(1)*psi(1)));
+					       if(isEvaluateGradRho)
+						 for(unsigned int idim=0; idim<3; ++idim)
+						    gradRhoTemp[3*q + idim]
+							+= 2.0*2.0*d_kPointWeights[kPoint]
+							*(partialOccupancy*(psiRotFrac(0)*gradPsiRotFrac[0][idim]
+							    + psiRotFrac(1)*gradPsiRotFrac[1][idim])
+							   -(psiRotFrac(0)*gradPsiRotFrac[0][idim]
+							    + psiRotFrac(1)*gradPsiRotFrac[1][idim])
+							 +(psi(0)*gradPsi[0][idim] + psi(1)*gradPsi[1][idim]));
+					     }
+#else
+					   if(dftParameters::spinPolarized==1)
+					     {
+					       rhoTempSpinPolarized[2*q] += (partialOccupancy*psiRotFrac*psiRotFrac
+									     -psiRotFrac*psiRotFrac
+									     +psi*psi);
+					       rhoTempSpinPolarized[2*q+1] +=(partialOccupancy2*psiRotFrac2*psiRotFrac2
+									      -psiRotFrac2*psiRotFrac2
+									      +psi2*psi2);
+
+					       if(isEvaluateGradRho)
+						   for(unsigned int idim=0; idim<3; ++idim)
+						   {
+						       gradRhoTempSpinPolarized[6*q + idim]
+							   += 2.0*(partialOccupancy*psiRotFrac*gradPsiRotFrac[idim]
+								   -psiRotFrac*gradPsiRotFrac[idim]
+								  +psi*gradPsi[idim]);
+						       gradRhoTempSpinPolarized[6*q + 3+idim]
+							   +=  2.0*(partialOccupancy2*psiRotFrac2*gradPsiRotFrac2[idim]
+								   -psiRotFrac2*gradPsiRotFrac2[idim]
+								   +psi2*gradPsi2[idim]);
+						   }
+					     }
+					   else
+					     {
+					       rhoTemp[q] += 2.0*(partialOccupancy*psiRotFrac*psiRotFrac
+								 -psiRotFrac*psiRotFrac
+								 +psi*psi);
+
+					       if(isEvaluateGradRho)
+						 for(unsigned int idim=0; idim<3; ++idim)
+						    gradRhoTemp[3*q + idim]
+							+= 2.0*2.0*(partialOccupancy*psiRotFrac*gradPsiRotFrac[idim]
+								    -psiRotFrac*gradPsiRotFrac[idim]
+								    +psi*gradPsi[idim]);
+					     }
 
-			for (unsigned int q=0; q<numQuadPoints; ++q)
-			{
-			    if(dftParameters::spinPolarized==1)
-			    {
-				    (*_rhoValuesSpinPolarized)[subCellId][2*q]+=rhoTempSpinPolarized[2*q];
-				    (*_rhoValuesSpinPolarized)[subCellId][2*q+1]+=rhoTempSpinPolarized[2*q+1];
+#endif
 
-				    if(isEvaluateGradRho)
-					for(unsigned int idim=0; idim<3; ++idim)
-					{
-					  (*_gradRhoValuesSpinPolarized)[subCellId][6*q+idim]
-					      +=gradRhoTempSpinPolarized[6*q + idim];
-					  (*_gradRhoValuesSpinPolarized)[subCellId][6*q+3+idim]
-					      +=gradRhoTempSpinPolarized[6*q + 3+idim];
 				       }
+				       else
+				       {
+#ifdef USE_COMPLEX
+					   if(dftParameters::spinPolarized==1)
+					     {
+					       rhoTempSpinPolarized[2*q] += partialOccupancy*d_kPointWeights[kPoint]*(psi(0)*psi(0) + psi(1)*psi(1));
+					       rhoTempSpinPolarized[2*q+1] += partialOccupancy2*d_kPointWeights[kPoint]*(psi2(0)*psi2(0) + psi2(1)*psi2(1));
+					       //
+					       if(isEvaluateGradRho)
+						   for(unsigned int idim=0; idim<3; ++idim)
+						   {
+						       gradRhoTempSpinPolarized[6*q + idim] +=
+						       2.0*partialOccupancy*d_kPointWeights[kPoint]*(psi(0)*gradPsi[0][idim] + psi(1)*gradPsi[1][idim]);
+						       gradRhoTempSpinPolarized[6*q + 3+idim] +=
+						       2.0*partialOccupancy2*d_kPointWeights[kPoint]*(psi2(0)*gradPsi2[0][idim] + psi2(1)*gradPsi2[1][idim]);
+						   }
+					     }
+					   else
+					     {
+					       rhoTemp[q] += 2.0*partialOccupancy*d_kPointWeights[kPoint]*(psi(0)*psi(0) + psi(1)*psi(1));
+					       if(isEvaluateGradRho)
+						 for(unsigned int idim=0; idim<3; ++idim)
+						    gradRhoTemp[3*q + idim] += 2.0*2.0*partialOccupancy*d_kPointWeights[kPoint]*(psi(0)*gradPsi[0][idim] + psi(1)*gradPsi[1][idim]);
+					     }
+#else
+					   if(dftParameters::spinPolarized==1)
+					     {
+					       rhoTempSpinPolarized[2*q] += partialOccupancy*psi*psi;
+					       rhoTempSpinPolarized[2*q+1] += partialOccupancy2*psi2*psi2;
+
+					       if(isEvaluateGradRho)
+						   for(unsigned int idim=0; idim<3; ++idim)
+						   {
+						       gradRhoTempSpinPolarized[6*q + idim] += 2.0*partialOccupancy*(psi*gradPsi[idim]);
+						       gradRhoTempSpinPolarized[6*q + 3+idim] +=  2.0*partialOccupancy2*(psi2*gradPsi2[idim]);
+						   }
+					     }
+					   else
+					     {
+					       rhoTemp[q] += 2.0*partialOccupancy*psi*psi;
 
-				    (*_rhoValues)[subCellId][q]+= rhoTempSpinPolarized[2*q] + rhoTempSpinPolarized[2*q+1];
+					       if(isEvaluateGradRho)
+						 for(unsigned int idim=0; idim<3; ++idim)
+						    gradRhoTemp[3*q + idim] += 2.0*2.0*partialOccupancy*psi*gradPsi[idim];
+					     }
 
-				    if(isEvaluateGradRho)
-				      for(unsigned int idim=0; idim<3; ++idim)
-					(*_gradRhoValues)[subCellId][3*q + idim]
-					    += gradRhoTempSpinPolarized[6*q + idim]
-					       + gradRhoTempSpinPolarized[6*q + 3+idim];
+#endif
+				       }
+
+				     }//quad point loop
+				 }//block eigenvectors per k point
 			     }
-			     else
+
+			     for (unsigned int q=0; q<numQuadPoints; ++q)
 			     {
-				    (*_rhoValues)[subCellId][q] += rhoTemp[q];
+				 if(dftParameters::spinPolarized==1)
+				 {
+					 _rhoValuesSpinPolarized->cellData(subCellIndex)[2*q]+=rhoTempSpinPolarized[2*q];
+					 _rhoValuesSpinPolarized->cellData(subCellIndex)[2*q+1]+=rhoTempSpinPolarized[2*q+1];
 
-				     if(isEvaluateGradRho)
-					 for(unsigned int idim=0; idim<3; ++idim)
-					    (*_gradRhoValues)[subCellId][3*q+idim]+= gradRhoTemp[3*q+idim];
+					 if(isEvaluateGradRho)
+					     for(unsigned int idim=0; idim<3; ++idim)
+					     {
+					       _gradRhoValuesSpinPolarized->cellData(subCellIndex)[6*q+idim]
+						   +=gradRhoTempSpinPolarized[6*q + idim];
+					       _gradRhoValuesSpinPolarized->cellData(subCellIndex)[6*q+3+idim]
+						   +=gradRhoTempSpinPolarized[6*q + 3+idim];
+					    }
+
+					 _rhoValues->cellData(subCellIndex)[q]+= rhoTempSpinPolarized[2*q] + rhoTempSpinPolarized[2*q+1];
+
+					 if(isEvaluateGradRho)
+					   for(unsigned int idim=0; idim<3; ++idim)
+					     _gradRhoValues->cellData(subCellIndex)[3*q + idim]
+						 += gradRhoTempSpinPolarized[6*q + idim]
+						    + gradRhoTempSpinPolarized[6*q + 3+idim];
+				  }
+				  else
+				  {
+					 _rhoValues->cellData(subCellIndex)[q] += rhoTemp[q];
+
+					  if(isEvaluateGradRho)
+					      for(unsigned int idim=0; idim<3; ++idim)
+						 _gradRhoValues->cellData(subCellIndex)[3*q+idim]+= gradRhoTemp[3*q+idim];
+				  }
 			     }
-			}
-		  }//subcell loop
-	   }//macro cell loop
+		       }//subcell loop
+		}//macro cell loop
+	     },
+	     1);
 	}//band parallelization
    }//eigenvectors block loop
 
@@ -367,6 +367,12 @@ namespace dftfe {
 
     a0.resize((dftParameters::spinPolarized+1)*d_kPointWeights.size(),dftParameters::lowerEndWantedSpectrum);
     bLow.resize((dftParameters::spinPolarized+1)*d_kPointWeights.size(),0.0);
+    d_chebyshevPolynomialDegree.resize((dftParameters::spinPolarized+1)*d_kPointWeights.size(),0);
+    d_chebyshevResidualNorm.resize((dftParameters::spinPolarized+1)*d_kPointWeights.size(),-1.0);
+    d_chebyshevUpperBoundUnwantedSpectrum.resize((dftParameters::spinPolarized+1)*d_kPointWeights.size(),0.0);
+    d_chebyshevResidualReductionRate.resize((dftParameters::spinPolarized+1)*d_kPointWeights.size(),-1.0);
+    d_chebyshevFilterWallTimePerDegree.resize((dftParameters::spinPolarized+1)*d_kPointWeights.size(),0.0);
+    d_chebyshevSubspaceWallTime.resize((dftParameters::spinPolarized+1)*d_kPointWeights.size(),0.0);
 
     d_eigenVectorsFlattenedSTL.resize((1+dftParameters::spinPolarized)*d_kPointWeights.size());
     if (d_numEigenValuesRR!=d_numEigenValues)
@@ -524,6 +530,8 @@ namespace dftfe {
   {
     computingTimerStandard.enter_section("KSDFT problem initialization");
 
+    d_isVselfFieldBinsInitialGuessValid=false;
+
     if (dftParameters::verbosity>=4)
       dftUtils::printCurrentMemoryUsage(mpi_communicator,
 	                      "Entering init");
@@ -630,6 +638,12 @@ namespace dftfe {
     //
     initBoundaryConditions();
 
+    //
+    //the dofs are moved along with the mesh, so the nodal values of the previous vself bins fields
+    //are their moved fields
+    //
+    d_isVselfFieldBinsInitialGuessValid=dftParameters::poissonWarmStart;
+
     //rho init (use previous ground state electron density)
     //
     noRemeshRhoDataInit();
@@ -712,7 +726,8 @@ namespace dftfe {
 				        d_imagePositions,
 				        d_imageIds,
 				        d_imageCharges,
-					d_localVselfs);
+					d_localVselfs,
+					d_isVselfFieldBinsInitialGuessValid);
     computingTimerStandard.exit_section("Nuclear self-potential solve");
     computing_timer.exit_section("Nuclear self-potential solve");
 
@@ -742,6 +757,15 @@ namespace dftfe {
 	                                                                   dftParameters::lowerEndWantedSpectrum,
 									   0.0);
 
+    //
+    //the upper bounds of the eigen-spectrum are tied to the effective potential history of the above operator
+    //
+    d_upperBoundUnwantedSpectrum.assign((dftParameters::spinPolarized+1)*d_kPointWeights.size(),0.0);
+    d_upperBoundVEffCumulativeChange.assign((dftParameters::spinPolarized+1)*d_kPointWeights.size(),0.0);
+    d_upperBoundNumberSolves.assign((dftParameters::spinPolarized+1)*d_kPointWeights.size(),0);
+    d_spectrumSplitMaxResidualNorm.assign((dftParameters::spinPolarized+1)*d_kPointWeights.size(),-1.0);
+    d_lockingResidualNorms.assign((dftParameters::spinPolarized+1)*d_kPointWeights.size(),std::vector<double>());
+
 
     //
     //precompute shapeFunctions and shapeFunctionGradients and shapeFunctionGradientIntegrals
@@ -764,6 +788,33 @@ namespace dftfe {
     //
     unsigned int scfIter=0;
     double norm = 1.0;
+
+    //
+    //initial guess for the phiTot solve with rhoIn. With WARM START in Poisson problem parameters the previous phiTot with rhoIn
+    //solution is used in the second SCF iteration, and the linear extrapolation of the solutions of the last two
+    //SCF iterations from the third SCF iteration onwards. Otherwise the previous phiTot with rhoOut solution is used
+    //
+    vectorType phiTotRhoInPrevious;
+    bool isPhiTotRhoInPreviousSet=false;
+    auto setPhiTotRhoInInitialGuess=[&]()
+      {
+	if (!dftParameters::poissonWarmStart)
+	  {
+	    d_phiTotRhoIn = d_phiTotRhoOut;
+	    return;
+	  }
+
+	if (isPhiTotRhoInPreviousSet)
+	  {
+	    phiTotRhoInPrevious.sadd(-1.0,2.0,d_phiTotRhoIn);
+	    phiTotRhoInPrevious.swap(d_phiTotRhoIn);
+	  }
+	else
+	  {
+	    phiTotRhoInPrevious = d_phiTotRhoIn;
+	    isPhiTotRhoInPreviousSet=true;
+	  }
+      };
     //CAUTION: Choosing a looser tolerance might lead to failed tests
     const double adaptiveChebysevFilterPassesTol = dftParameters::chebyshevTolerance;
 
@@ -802,6 +853,8 @@ namespace dftfe {
 		        norm = sqrt(mixing_anderson_spinPolarized());
 		     if (dftParameters::mixingMethod=="BROYDEN" )
 		        norm = sqrt(mixing_broyden_spinPolarized());
+		     if (dftParameters::mixingMethod=="ANDERSON_WITH_KERKER" )
+		        norm = sqrt(mixing_anderson_kerker_spinPolarized());
 		  }
 		else
 		  {
@@ -809,6 +862,8 @@ namespace dftfe {
 		        norm = sqrt(mixing_anderson());
 		    if (dftParameters::mixingMethod=="BROYDEN")
 		        norm = sqrt(mixing_broyden());
+		    if (dftParameters::mixingMethod=="ANDERSON_WITH_KERKER")
+		        norm = sqrt(mixing_anderson_kerker());
 		  }
 
 		if (dftParameters::verbosity>=1)
@@ -816,7 +871,7 @@ namespace dftfe {
 	      }
 
 
-	    d_phiTotRhoIn = d_phiTotRhoOut;
+	    setPhiTotRhoInInitialGuess();
 	  }
 	else if (dftParameters::restartFromChk && dftParameters::chkType==2)
 	  {
@@ -830,9 +885,17 @@ namespace dftfe {
 	    if (dftParameters::verbosity>=1)
 	      pcout<<"Anderson Mixing, L2 norm of electron-density difference: "<< norm<< std::endl;
 
-	    d_phiTotRhoIn = d_phiTotRhoOut;
+	    setPhiTotRhoInInitialGuess();
 	  }
         computing_timer.exit_section("density mixing");
+
+	//
+	//mixed precision Chebyshev filtering is only used while the electron-density residual is large
+	//enough for the single precision errors in the filtered subspace to not affect the SCF convergence
+	//
+	const bool useMixedPrecCheby=dftParameters::useMixedPrecCheby
+	                             && norm>dftParameters::mixedPrecStoppingTol;
+
 	//
 	//phiTot with rhoIn
 	//
@@ -856,9 +919,24 @@ namespace dftfe {
 				       d_atomNodeIdToChargeMap,
 				       *rhoInValues);
 
-	dealiiCGSolver.solve(phiTotalSolverProblem,
+	//
+	//inexact SCF: the phiTot with rhoIn solve is only done as accurately as warranted by the current
+	//electron-density difference norm, and with the user tolerance close to the SCF convergence. The
+	//user tolerance is also used until the mixing has computed the first electron-density difference norm
+	//
+	const bool isMixingNormComputed=scfIter>0 || (dftParameters::restartFromChk && dftParameters::chkType==2);
+	double phiTotRhoInSolveTolerance=dftParameters::relLinearSolverTolerance;
+	if (dftParameters::poissonAdaptiveToleranceFactor>0.0
+	    && isMixingNormComputed
+	    && norm>10.0*dftParameters::selfConsistentSolverTolerance)
+	  phiTotRhoInSolveTolerance=std::max(dftParameters::relLinearSolverTolerance,
+					     dftParameters::poissonAdaptiveToleranceFactor*norm);
 
-			     dftParameters::relLinearSolverTolerance,
+	if (dftParameters::verbosity>=2 && dftParameters::poissonAdaptiveToleranceFactor>0.0)
+	  pcout<<"relative tolerance: "<<phiTotRhoInSolveTolerance<<std::endl;
+
+	dealiiCGSolver.solve(phiTotalSolverProblem,
+			     phiTotRhoInSolveTolerance,
 			     dftParameters::maxLinearSolverIterations,
 			     dftParameters::verbosity);
 
@@ -922,7 +1000,8 @@ namespace dftfe {
 						  subspaceIterationSolver,
 						  residualNormWaveFunctionsAllkPointsSpins[s][kPoint],
 						  scfIter<dftParameters::spectrumSplitStartingScfIter?false:true,
-						  true);
+						  true,
+						  useMixedPrecCheby);
 		      }
 		  }
 	      }
@@ -957,6 +1036,13 @@ namespace dftfe {
 				     eigenValuesSpins[1],
 				     fermiEnergy));
 
+	    if (dftParameters::adaptiveChebyshevOrder)
+	      for(unsigned int s=0; s<2; ++s)
+		updateAdaptiveChebyshevPolynomialDegrees(residualNormWaveFunctionsAllkPointsSpins[s],
+							 eigenValuesSpins[s],
+							 s,
+							 subspaceIterationSolver);
+
 	    if (dftParameters::verbosity>=2)
 	      {
 		pcout << "Maximum residual norm of the state closest to and below Fermi level: "<< maxRes << std::endl;
@@ -1007,7 +1093,8 @@ namespace dftfe {
 						  subspaceIterationSolver,
 						  residualNormWaveFunctionsAllkPointsSpins[s][kPoint],
 						  scfIter<dftParameters::spectrumSplitStartingScfIter?false:true,
-						  true);
+						  true,
+						  useMixedPrecCheby);
 
 		      }
 		  }
@@ -1037,6 +1124,13 @@ namespace dftfe {
 				 (residualNormWaveFunctionsAllkPointsSpins[1],
 				  eigenValuesSpins[1],
 				  fermiEnergy));
+
+		if (dftParameters::adaptiveChebyshevOrder)
+		  for(unsigned int s=0; s<2; ++s)
+		    updateAdaptiveChebyshevPolynomialDegrees(residualNormWaveFunctionsAllkPointsSpins[s],
+							     eigenValuesSpins[s],
+							     s,
+							     subspaceIterationSolver);
 		if (dftParameters::verbosity>=2)
 		  pcout << "Maximum residual norm of the state closest to and below Fermi level: "<< maxRes << std::endl;
 
@@ -1093,7 +1187,8 @@ namespace dftfe {
 					      subspaceIterationSolver,
 					      residualNormWaveFunctionsAllkPoints[kPoint],
 					      scfIter<dftParameters::spectrumSplitStartingScfIter?false:true,
-					      true);
+					      true,
+					      useMixedPrecCheby);
 
 		  }
 	      }
@@ -1114,6 +1209,13 @@ namespace dftfe {
 	      (residualNormWaveFunctionsAllkPoints,
 	       scfIter<dftParameters::spectrumSplitStartingScfIter?eigenValues:eigenValuesRRSplit,
 	       fermiEnergy);
+
+	    if (dftParameters::adaptiveChebyshevOrder)
+	      updateAdaptiveChebyshevPolynomialDegrees(residualNormWaveFunctionsAllkPoints,
+						       scfIter<dftParameters::spectrumSplitStartingScfIter?eigenValues:eigenValuesRRSplit,
+						       0,
+						       subspaceIterationSolver);
+
 	    if (dftParameters::verbosity>=2)
 	      pcout << "Maximum residual norm of the state closest to and below Fermi level: "<< maxRes << std::endl;
 
@@ -1147,7 +1249,8 @@ namespace dftfe {
 					      subspaceIterationSolver,
 					      residualNormWaveFunctionsAllkPoints[kPoint],
 					      scfIter<dftParameters::spectrumSplitStartingScfIter?false:true,
-					      true);
+					      true,
+					      useMixedPrecCheby);
 		  }
 		count++;
 		//
@@ -1161,6 +1264,13 @@ namespace dftfe {
 		  (residualNormWaveFunctionsAllkPoints,
 		   scfIter<dftParameters::spectrumSplitStartingScfIter?eigenValues:eigenValuesRRSplit,
 		   fermiEnergy);
+
+		if (dftParameters::adaptiveChebyshevOrder)
+		  updateAdaptiveChebyshevPolynomialDegrees(residualNormWaveFunctionsAllkPoints,
+							   scfIter<dftParameters::spectrumSplitStartingScfIter?eigenValues:eigenValuesRRSplit,
+							   0,
+							   subspaceIterationSolver);
+
 		if (dftParameters::verbosity>=2)
 		  pcout << "Maximum residual norm of the state closest to and below Fermi level: "<< maxRes << std::endl;
 	      }
@@ -1393,6 +1503,13 @@ namespace dftfe {
 
     }
 
+    //
+    //the flattened array workspaces of the eigen solves are reused across the k points and SCF iterations,
+    //and are only released after the last eigen solve so that they do not add to the peak memory of the
+    //post-processing steps
+    //
+    kohnShamDFTEigenOperator.releaseFlattenedArrayWorkspaces();
+
     if (!dftParameters::computeEnergyEverySCF || d_numEigenValuesRR!=d_numEigenValues)
     {
 	if(dftParameters::verbosity>=2)
@@ -1725,7 +1842,7 @@ namespace dftfe {
                          const unsigned int q)> funcRho =
                           [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell ,
                               const unsigned int q)
-                              {return (*rhoOutValues).find(cell->id())->second[q];};
+                              {return (*rhoOutValues)[cell->id()][q];};
     dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double>> (dealii::MappingQ1<3,3>(),
 										   dofHandler,
 										   constraintsNone,
@@ -1744,7 +1861,7 @@ namespace dftfe {
                              const unsigned int q)> funcRhoSpin0 =
                              [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell ,
                               const unsigned int q)
-                              {return (*rhoOutValuesSpinPolarized).find(cell->id())->second[2*q];};
+                              {return (*rhoOutValuesSpinPolarized)[cell->id()][2*q];};
 	dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double>> (dealii::MappingQ1<3,3>(),
 										       dofHandler,
 										       constraintsNone,
@@ -1760,7 +1877,7 @@ namespace dftfe {
                              const unsigned int q)> funcRhoSpin1 =
                              [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell ,
                               const unsigned int q)
-                              {return (*rhoOutValuesSpinPolarized).find(cell->id())->second[2*q+1];};
+                              {return (*rhoOutValuesSpinPolarized)[cell->id()][2*q+1];};
 	dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double>> (dealii::MappingQ1<3,3>(),
 										       dofHandler,
 										       constraintsNone,
@@ -34,8 +34,8 @@ void dftClass<FEOrder>::computeElectrostaticEnergyHRefined()
    dealii::QGauss<3> quadrature(C_num1DQuad<FEOrder>());
    const unsigned int n_q_points = quadrature.size();
 
-   std::map<dealii::CellId, std::vector<double> > _gradRhoOutValues;
-   std::map<dealii::CellId, std::vector<double> > _gradRhoOutValuesSpinPolarized;
+   dftUtils::cellQuadratureField _gradRhoOutValues;
+   dftUtils::cellQuadratureField _gradRhoOutValuesSpinPolarized;
    if (dftParameters::isCellStress || dftParameters::isIonForce)
 	if (!(dftParameters::xc_id == 4))
 	{
@@ -45,22 +45,14 @@ void dftClass<FEOrder>::computeElectrostaticEnergyHRefined()
 		   gradRhoOutValuesSpinPolarized=&_gradRhoOutValuesSpinPolarized;
 
 
-	       typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
-	       for (; cell!=endc; ++cell)
-		  if (cell->is_locally_owned())
-		    {
-			const dealii::CellId cellId=cell->id();
-			(*rhoOutValues)[cellId] = std::vector<double>(n_q_points,0.0);
-			(*gradRhoOutValues)[cellId] = std::vector<double>(3*n_q_points,0.0);
+	       rhoOutValues->reinit(d_rhoQuadDataLayout,n_q_points);
+	       gradRhoOutValues->reinit(d_rhoQuadDataLayout,3*n_q_points);
 
-			if (dftParameters::spinPolarized==1)
-			{
-			   (*rhoOutValuesSpinPolarized)[cellId]
-				 = std::vector<double>(2*n_q_points,0.0);
-			   (*gradRhoOutValuesSpinPolarized)[cellId]
-				 = std::vector<double>(6*n_q_points,0.0);
-			}
-		    }
+	       if (dftParameters::spinPolarized==1)
+	       {
+		   rhoOutValuesSpinPolarized->reinit(d_rhoQuadDataLayout,2*n_q_points);
+		   gradRhoOutValuesSpinPolarized->reinit(d_rhoQuadDataLayout,6*n_q_points);
+	       }
 
 	       computeRhoFromPSI(rhoOutValues,
 			    gradRhoOutValues,
@@ -97,7 +89,7 @@ void dftClass<FEOrder>::computeElectrostaticEnergyHRefined()
    //create a lambda function for L2 projection of quadrature electron-density to nodal electron density
    //
    std::function<double(const typename dealii::DoFHandler<3>::active_cell_iterator & cell,const unsigned int q)> funcRho = [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell , const unsigned int q)
-     {return (*rhoOutValues).find(cell->id())->second[q];};
+     {return (*rhoOutValues)[cell->id()][q];};
 
    dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double> >(dealii::MappingQ1<3,3>(),
 										  matrix_free_data.get_dof_handler(),
@@ -108,7 +100,7 @@ void dftClass<FEOrder>::computeElectrostaticEnergyHRefined()
    if (dftParameters::isCellStress || dftParameters::isIonForce)
    {
        std::function<double(const typename dealii::DoFHandler<3>::active_cell_iterator & cell,const unsigned int q)> funcDelxRho = [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell , const unsigned int q)
-	 {return (*gradRhoOutValues).find(cell->id())->second[3*q];};
+	 {return (*gradRhoOutValues)[cell->id()][3*q];};
 
        dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double> >(dealii::MappingQ1<3,3>(),
 										      matrix_free_data.get_dof_handler(),
@@ -118,7 +110,7 @@ void dftClass<FEOrder>::computeElectrostaticEnergyHRefined()
 										      delxRhoNodalFieldCoarse);
 
        std::function<double(const typename dealii::DoFHandler<3>::active_cell_iterator & cell,const unsigned int q)> funcDelyRho = [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell , const unsigned int q)
-	 {return (*gradRhoOutValues).find(cell->id())->second[3*q+1];};
+	 {return (*gradRhoOutValues)[cell->id()][3*q+1];};
 
        dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double> >(dealii::MappingQ1<3,3>(),
 										      matrix_free_data.get_dof_handler(),
@@ -128,7 +120,7 @@ void dftClass<FEOrder>::computeElectrostaticEnergyHRefined()
 										      delyRhoNodalFieldCoarse);
 
        std::function<double(const typename dealii::DoFHandler<3>::active_cell_iterator & cell,const unsigned int q)> funcDelzRho = [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell , const unsigned int q)
-	 {return (*gradRhoOutValues).find(cell->id())->second[3*q+2];};
+	 {return (*gradRhoOutValues)[cell->id()][3*q+2];};
 
        dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double> >(dealii::MappingQ1<3,3>(),
 										      matrix_free_data.get_dof_handler(),
@@ -356,14 +348,14 @@ void dftClass<FEOrder>::computeElectrostaticEnergyHRefined()
    //
    //fill in quadrature values of the field on the refined mesh and compute total charge
    //
-   std::map<dealii::CellId, std::vector<double> > rhoOutHRefinedQuadValues;
+   dftUtils::cellQuadratureField rhoOutHRefinedQuadValues;
    const double integralRhoValue = totalCharge(dofHandlerHRefined,
 					       rhoNodalFieldRefined,
 					       rhoOutHRefinedQuadValues);
    //
    //fill in grad rho at quadrature values of the field on the refined mesh
    //
-   std::map<dealii::CellId, std::vector<double> > gradRhoOutHRefinedQuadValues;
+   dftUtils::cellQuadratureField gradRhoOutHRefinedQuadValues;
 
    if (dftParameters::isCellStress || dftParameters::isIonForce)
    {
@@ -372,6 +364,8 @@ void dftClass<FEOrder>::computeElectrostaticEnergyHRefined()
        std::vector<double> tempDelyRho(n_q_points);
        std::vector<double> tempDelzRho(n_q_points);
 
+       gradRhoOutHRefinedQuadValues.reinit(rhoOutHRefinedQuadValues.getLayout(),3*n_q_points);
+
        DoFHandler<3>::active_cell_iterator
        cell = dofHandlerHRefined.begin_active(),
        endc = dofHandlerHRefined.end();
@@ -383,12 +377,12 @@ void dftClass<FEOrder>::computeElectrostaticEnergyHRefined()
 	      fe_values.get_function_values(delyRhoNodalFieldRefined,tempDelyRho);
 	      fe_values.get_function_values(delzRhoNodalFieldRefined,tempDelzRho);
 
-	      gradRhoOutHRefinedQuadValues[cell->id()].resize(3*n_q_points);
+	      double * gradRhoOutCell=gradRhoOutHRefinedQuadValues[cell->id()];
 	      for (unsigned int q_point=0; q_point<n_q_points; ++q_point)
 		{
-		  gradRhoOutHRefinedQuadValues[cell->id()][3*q_point] = tempDelxRho[q_point];
-		  gradRhoOutHRefinedQuadValues[cell->id()][3*q_point+1] = tempDelyRho[q_point];
-		  gradRhoOutHRefinedQuadValues[cell->id()][3*q_point+2] = tempDelzRho[q_point];
+		  gradRhoOutCell[3*q_point] = tempDelxRho[q_point];
+		  gradRhoOutCell[3*q_point+1] = tempDelyRho[q_point];
+		  gradRhoOutCell[3*q_point+2] = tempDelzRho[q_point];
 		}
 	  }
    }
@@ -239,13 +239,13 @@ void dftClass<FEOrder>::computeElectrostaticEnergyPRefined()
    dealii::FEValues<3> fe_values (dofHandlerEigen.get_fe(), quadraturePRefined, dealii::update_values | dealii::update_gradients);
    const unsigned int num_quad_points = quadraturePRefined.size();
 
-   std::map<dealii::CellId, std::vector<double> > rhoOutPRefinedQuadValues;
+   //the p refined mesh shares the triangulation and hence the cell layout of the original mesh
+   dftUtils::cellQuadratureField rhoOutPRefinedQuadValues;
+   rhoOutPRefinedQuadValues.reinit(d_rhoQuadDataLayout,num_quad_points);
    typename dealii::DoFHandler<3>::active_cell_iterator cellOld = dofHandlerEigen.begin_active(), endcOld = dofHandlerEigen.end();
    for(; cellOld!=endcOld; ++cellOld)
       if(cellOld->is_locally_owned())
       {
-	  rhoOutPRefinedQuadValues[cellOld->id()] = std::vector<double>(num_quad_points);
-
 	  fe_values.reinit (cellOld);
 #ifdef USE_COMPLEX
 	  std::vector<dealii::Vector<double> > tempPsi(num_quad_points), tempPsi2(num_quad_points);
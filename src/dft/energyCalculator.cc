@@ -252,11 +252,11 @@ namespace dftfe
    const vectorType & phiTotRhoOut,
    const vectorType & phiExt,
    const vectorType & phiExtElec,
-   const std::map<dealii::CellId, std::vector<double> > & rhoInValues,
-   const std::map<dealii::CellId, std::vector<double> > & rhoOutValues,
-   const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectrostatic,
-   const std::map<dealii::CellId, std::vector<double> > & gradRhoInValues,
-   const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValues,
+   const dftUtils::cellQuadratureField & rhoInValues,
+   const dftUtils::cellQuadratureField & rhoOutValues,
+   const dftUtils::cellQuadratureField & rhoOutValuesElectrostatic,
+   const dftUtils::cellQuadratureField & gradRhoInValues,
+   const dftUtils::cellQuadratureField & gradRhoOutValues,
    const std::vector<std::vector<double> > & localVselfs,
    const std::map<dealii::CellId, std::vector<double> > & pseudoValuesElectronic,
    const std::map<dealii::CellId, std::vector<double> > & pseudoValuesElectrostatic,
@@ -301,6 +301,49 @@ namespace dftfe
 
     typename dealii::DoFHandler<3>::active_cell_iterator cellElectronic = dofHandlerElectronic.begin_active(), endcElectronic = dofHandlerElectronic.end();
 
+    //
+    //evaluate the exchange-correlation energy densities and potentials at all the quadrature points of the
+    //locally owned cells with a single libxc call per functional, directly on the flat storage of the densities
+    //
+    const unsigned int numberQuadPointsTotal=rhoOutValues.size();
+    std::vector<double> exchangeEnergyDensity(numberQuadPointsTotal),
+      corrEnergyDensity(numberQuadPointsTotal);
+    std::vector<double> derExchEnergyWithInputDensity(numberQuadPointsTotal),
+      derCorrEnergyWithInputDensity(numberQuadPointsTotal);
+    std::vector<double> derExchEnergyWithSigmaGradDenInput, derCorrEnergyWithSigmaGradDenInput;
+    std::vector<double> gradRhoInDotgradRhoOut;
+
+    if(dftParameters::xc_id == 4)
+      {
+	std::vector<double> sigmaWithOutputGradDensity(numberQuadPointsTotal),
+	  sigmaWithInputGradDensity(numberQuadPointsTotal);
+	derExchEnergyWithSigmaGradDenInput.resize(numberQuadPointsTotal);
+	derCorrEnergyWithSigmaGradDenInput.resize(numberQuadPointsTotal);
+	gradRhoInDotgradRhoOut.resize(numberQuadPointsTotal);
+
+	for (unsigned int iPoint=0; iPoint<numberQuadPointsTotal; ++iPoint)
+	  {
+	    const double * gradRhoIn = gradRhoInValues.data()+3*iPoint;
+	    const double * gradRhoOut = gradRhoOutValues.data()+3*iPoint;
+	    sigmaWithInputGradDensity[iPoint] = gradRhoIn[0]*gradRhoIn[0] + gradRhoIn[1]*gradRhoIn[1] + gradRhoIn[2]*gradRhoIn[2];
+	    sigmaWithOutputGradDensity[iPoint] = gradRhoOut[0]*gradRhoOut[0] + gradRhoOut[1]*gradRhoOut[1] + gradRhoOut[2]*gradRhoOut[2];
+	    gradRhoInDotgradRhoOut[iPoint] = gradRhoIn[0]*gradRhoOut[0] + gradRhoIn[1]*gradRhoOut[1] + gradRhoIn[2]*gradRhoOut[2];
+	  }
+
+	xc_gga_exc(&funcX,numberQuadPointsTotal,rhoOutValues.data(),&sigmaWithOutputGradDensity[0],&exchangeEnergyDensity[0]);
+	xc_gga_exc(&funcC,numberQuadPointsTotal,rhoOutValues.data(),&sigmaWithOutputGradDensity[0],&corrEnergyDensity[0]);
+
+	xc_gga_vxc(&funcX,numberQuadPointsTotal,rhoInValues.data(),&sigmaWithInputGradDensity[0],&derExchEnergyWithInputDensity[0],&derExchEnergyWithSigmaGradDenInput[0]);
+	xc_gga_vxc(&funcC,numberQuadPointsTotal,rhoInValues.data(),&sigmaWithInputGradDensity[0],&derCorrEnergyWithInputDensity[0],&derCorrEnergyWithSigmaGradDenInput[0]);
+      }
+    else
+      {
+	xc_lda_exc(&funcX,numberQuadPointsTotal,rhoOutValues.data(),&exchangeEnergyDensity[0]);
+	xc_lda_exc(&funcC,numberQuadPointsTotal,rhoOutValues.data(),&corrEnergyDensity[0]);
+	xc_lda_vxc(&funcX,numberQuadPointsTotal,rhoInValues.data(),&derExchEnergyWithInputDensity[0]);
+	xc_lda_vxc(&funcC,numberQuadPointsTotal,rhoInValues.data(),&derCorrEnergyWithInputDensity[0]);
+      }
+
     for (; cellElectronic!=endcElectronic; ++cellElectronic)
       if (cellElectronic->is_locally_owned())
 	{
@@ -308,110 +351,35 @@ namespace dftfe
 	  feValuesElectronic.reinit (cellElectronic);
 	  feValuesElectronic.get_function_values(phiTotRhoIn,cellPhiTotRhoIn);
 	  feValuesElectronic.get_function_values(phiExt,cellPhiExt);
+	  const unsigned int cellIndex=rhoOutValues.getLayout()->cellIndex(cellElectronic->id());
 
-	  if(dftParameters::xc_id == 4)
+	  for (unsigned int q_point = 0; q_point < num_quad_points_electronic; ++q_point)
 	    {
-	      // Get exc
-	      std::vector<double> densityValueIn(num_quad_points_electronic),
-		densityValueOut(num_quad_points_electronic);
-	      std::vector<double> exchangeEnergyDensity(num_quad_points_electronic),
-		corrEnergyDensity(num_quad_points_electronic);
-	      std::vector<double> derExchEnergyWithInputDensity(num_quad_points_electronic),
-		derCorrEnergyWithInputDensity(num_quad_points_electronic);
-	      std::vector<double> derExchEnergyWithSigmaGradDenInput(num_quad_points_electronic),
-		derCorrEnergyWithSigmaGradDenInput(num_quad_points_electronic);
-	      std::vector<double> sigmaWithOutputGradDensity(num_quad_points_electronic),
-		sigmaWithInputGradDensity(num_quad_points_electronic);
-	      std::vector<double> gradRhoInDotgradRhoOut(num_quad_points_electronic);
-
-	      for (unsigned int q_point=0; q_point<num_quad_points_electronic; ++q_point)
-		{
-		  densityValueIn[q_point] = rhoInValues.find(cellElectronic->id())->second[q_point];
-		  densityValueOut[q_point] = rhoOutValues.find(cellElectronic->id())->second[q_point];
-		  const double gradRhoInX = (gradRhoInValues.find(cellElectronic->id())->second[3*q_point + 0]);
-		  const double gradRhoInY = (gradRhoInValues.find(cellElectronic->id())->second[3*q_point + 1]);
-		  const double gradRhoInZ = (gradRhoInValues.find(cellElectronic->id())->second[3*q_point + 2]);
-		  const double gradRhoOutX = (gradRhoOutValues.find(cellElectronic->id())->second[3*q_point + 0]);
-		  const double gradRhoOutY = (gradRhoOutValues.find(cellElectronic->id())->second[3*q_point + 1]);
-		  const double gradRhoOutZ = (gradRhoOutValues.find(cellElectronic->id())->second[3*q_point + 2]);
-		  sigmaWithInputGradDensity[q_point] = gradRhoInX*gradRhoInX + gradRhoInY*gradRhoInY + gradRhoInZ*gradRhoInZ;
-		  sigmaWithOutputGradDensity[q_point] = gradRhoOutX*gradRhoOutX + gradRhoOutY*gradRhoOutY + gradRhoOutZ*gradRhoOutZ;
-		  gradRhoInDotgradRhoOut[q_point] = gradRhoInX*gradRhoOutX + gradRhoInY*gradRhoOutY + gradRhoInZ*gradRhoOutZ;
-		}
-	      xc_gga_exc(&funcX,num_quad_points_electronic,&densityValueOut[0],&sigmaWithOutputGradDensity[0],&exchangeEnergyDensity[0]);
-	      xc_gga_exc(&funcC,num_quad_points_electronic,&densityValueOut[0],&sigmaWithOutputGradDensity[0],&corrEnergyDensity[0]);
-
-	      xc_gga_vxc(&funcX,num_quad_points_electronic,&densityValueIn[0],&sigmaWithInputGradDensity[0],&derExchEnergyWithInputDensity[0],&derExchEnergyWithSigmaGradDenInput[0]);
-	      xc_gga_vxc(&funcC,num_quad_points_electronic,&densityValueIn[0],&sigmaWithInputGradDensity[0],&derCorrEnergyWithInputDensity[0],&derCorrEnergyWithSigmaGradDenInput[0]);
+	      const unsigned int iPoint=cellIndex*num_quad_points_electronic+q_point;
 
-	      for (unsigned int q_point = 0; q_point < num_quad_points_electronic; ++q_point)
-		{
-		  // Vxc computed with rhoIn
-		  const double Vxc=derExchEnergyWithInputDensity[q_point]+derCorrEnergyWithInputDensity[q_point];
-		  const double VxcGrad = 2.0*(derExchEnergyWithSigmaGradDenInput[q_point]+derCorrEnergyWithSigmaGradDenInput[q_point])*gradRhoInDotgradRhoOut[q_point];
+	      // Vxc computed with rhoIn
+	      const double Vxc=derExchEnergyWithInputDensity[iPoint]+derCorrEnergyWithInputDensity[iPoint];
+	      const double VxcGrad = dftParameters::xc_id == 4?
+		2.0*(derExchEnergyWithSigmaGradDenInput[iPoint]+derCorrEnergyWithSigmaGradDenInput[iPoint])*gradRhoInDotgradRhoOut[iPoint]:0.0;
 
-		  excCorrPotentialTimesRho+=(Vxc*(rhoOutValues.find(cellElectronic->id())->second[q_point])+VxcGrad)*feValuesElectronic.JxW (q_point);
+	      excCorrPotentialTimesRho+=(Vxc*(rhoOutValues.cellData(cellIndex)[q_point])+VxcGrad)*feValuesElectronic.JxW (q_point);
 
-		  exchangeEnergy+=(exchangeEnergyDensity[q_point])*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW(q_point);
+	      exchangeEnergy+=(exchangeEnergyDensity[iPoint])*(rhoOutValues.cellData(cellIndex)[q_point])*feValuesElectronic.JxW(q_point);
 
-		  correlationEnergy+=(corrEnergyDensity[q_point])*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW(q_point);
+	      correlationEnergy+=(corrEnergyDensity[iPoint])*(rhoOutValues.cellData(cellIndex)[q_point])*feValuesElectronic.JxW(q_point);
 
-		  electrostaticPotentialTimesRho+=(cellPhiTotRhoIn[q_point])
-				  *(rhoOutValues.find(cellElectronic->id())->second[q_point])
-				  *feValuesElectronic.JxW (q_point);
+	      electrostaticPotentialTimesRho+=(cellPhiTotRhoIn[q_point])
+			      *(rhoOutValues.cellData(cellIndex)[q_point])
+			      *feValuesElectronic.JxW (q_point);
 
-		  if(dftParameters::isPseudopotential)
-		      electrostaticPotentialTimesRho+=(pseudoValuesElectronic.find(cellElectronic->id())->second[q_point]
-						      -cellPhiExt[q_point])
-				      *(rhoOutValues.find(cellElectronic->id())->second[q_point])
-				      *feValuesElectronic.JxW (q_point);
-
-		  vSelfPotentialTimesRho+=cellPhiExt[q_point]*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW (q_point);
-
-		}
-
-	    }
-	  else
-	    {
-	      // Get Exc
-	      std::vector<double> densityValueIn(num_quad_points_electronic),
-		densityValueOut(num_quad_points_electronic);
-	      std::vector<double> exchangeEnergyVal(num_quad_points_electronic),
-		corrEnergyVal(num_quad_points_electronic);
-	      std::vector<double> exchangePotentialVal(num_quad_points_electronic),
-		corrPotentialVal(num_quad_points_electronic);
-
-	      for (unsigned int q_point=0; q_point<num_quad_points_electronic; ++q_point)
-		{
-		  densityValueIn[q_point] = rhoInValues.find(cellElectronic->id())->second[q_point];
-		  densityValueOut[q_point] = rhoOutValues.find(cellElectronic->id())->second[q_point];
-		}
-	      xc_lda_exc(&funcX,num_quad_points_electronic,&densityValueOut[0],&exchangeEnergyVal[0]);
-	      xc_lda_exc(&funcC,num_quad_points_electronic,&densityValueOut[0],&corrEnergyVal[0]);
-	      xc_lda_vxc(&funcX,num_quad_points_electronic,&densityValueIn[0],&exchangePotentialVal[0]);
-	      xc_lda_vxc(&funcC,num_quad_points_electronic,&densityValueIn[0],&corrPotentialVal[0]);
-
-	      for (unsigned int q_point = 0; q_point < num_quad_points_electronic; ++q_point)
-		{
-		  excCorrPotentialTimesRho+=(exchangePotentialVal[q_point]+corrPotentialVal[q_point])*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW (q_point);
-
-		  exchangeEnergy+=(exchangeEnergyVal[q_point])*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW(q_point);
-
-		  correlationEnergy+=(corrEnergyVal[q_point])*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW(q_point);
-
-		  electrostaticPotentialTimesRho+=(cellPhiTotRhoIn[q_point])
-				  *(rhoOutValues.find(cellElectronic->id())->second[q_point])
+	      if(dftParameters::isPseudopotential)
+		  electrostaticPotentialTimesRho+=(pseudoValuesElectronic.find(cellElectronic->id())->second[q_point]
+						  -cellPhiExt[q_point])
+				  *(rhoOutValues.cellData(cellIndex)[q_point])
 				  *feValuesElectronic.JxW (q_point);
 
-		  if(dftParameters::isPseudopotential)
-		      electrostaticPotentialTimesRho+=(pseudoValuesElectronic.find(cellElectronic->id())->second[q_point]
-						      -cellPhiExt[q_point])
-				      *(rhoOutValues.find(cellElectronic->id())->second[q_point])
-				      *feValuesElectronic.JxW (q_point);
-
-		  vSelfPotentialTimesRho+=cellPhiExt[q_point]*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW (q_point);
+	      vSelfPotentialTimesRho+=cellPhiExt[q_point]*(rhoOutValues.cellData(cellIndex)[q_point])*feValuesElectronic.JxW (q_point);
 
-		}
 	    }
 
 	}
@@ -425,17 +393,18 @@ namespace dftfe
 	  feValuesElectrostatic.reinit(cellElectrostatic);
 	  feValuesElectrostatic.get_function_values(phiTotRhoOut,cellPhiTotRhoOut);
 	  feValuesElectrostatic.get_function_values(phiExtElec,cellPhiExtElec);
+	  const double * rhoOutElectrostaticCell=rhoOutValuesElectrostatic[cellElectrostatic->id()];
 
 	  for (unsigned int q_point = 0; q_point < num_quad_points_electrostatic; ++q_point)
 	    {
-	      electrostaticEnergyTotPot  += 0.5*(cellPhiTotRhoOut[q_point])*(rhoOutValuesElectrostatic.find(cellElectrostatic->id())->second[q_point])*feValuesElectrostatic.JxW(q_point);
-	      vSelfPotentialElecTimesRho += cellPhiExtElec[q_point]*(rhoOutValuesElectrostatic.find(cellElectrostatic->id())->second[q_point])*feValuesElectrostatic.JxW (q_point);
+	      electrostaticEnergyTotPot  += 0.5*(cellPhiTotRhoOut[q_point])*rhoOutElectrostaticCell[q_point]*feValuesElectrostatic.JxW(q_point);
+	      vSelfPotentialElecTimesRho += cellPhiExtElec[q_point]*rhoOutElectrostaticCell[q_point]*feValuesElectrostatic.JxW (q_point);
 
 	      if(dftParameters::isPseudopotential)
 		  electrostaticEnergyTotPot+=
 			 (pseudoValuesElectrostatic.find(cellElectrostatic->id())->second[q_point]
 			 -cellPhiExtElec[q_point])
-			 *(rhoOutValuesElectrostatic.find(cellElectrostatic->id())->second[q_point])
+			 *rhoOutElectrostaticCell[q_point]
 			 *feValuesElectrostatic.JxW (q_point);
 	    }
 	}
@@ -510,15 +479,15 @@ namespace dftfe
    const vectorType & phiTotRhoOut,
    const vectorType & phiExt,
    const vectorType & phiExtElec,
-   const std::map<dealii::CellId, std::vector<double> > & rhoInValues,
-   const std::map<dealii::CellId, std::vector<double> > & rhoOutValues,
-   const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectrostatic,
-   const std::map<dealii::CellId, std::vector<double> > & gradRhoInValues,
-   const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValues,
-   const std::map<dealii::CellId, std::vector<double> > & rhoInValuesSpinPolarized,
-   const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesSpinPolarized,
-   const std::map<dealii::CellId, std::vector<double> > & gradRhoInValuesSpinPolarized,
-   const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesSpinPolarized,
+   const dftUtils::cellQuadratureField & rhoInValues,
+   const dftUtils::cellQuadratureField & rhoOutValues,
+   const dftUtils::cellQuadratureField & rhoOutValuesElectrostatic,
+   const dftUtils::cellQuadratureField & gradRhoInValues,
+   const dftUtils::cellQuadratureField & gradRhoOutValues,
+   const dftUtils::cellQuadratureField & rhoInValuesSpinPolarized,
+   const dftUtils::cellQuadratureField & rhoOutValuesSpinPolarized,
+   const dftUtils::cellQuadratureField & gradRhoInValuesSpinPolarized,
+   const dftUtils::cellQuadratureField & gradRhoOutValuesSpinPolarized,
    const std::vector<std::vector<double> > & localVselfs,
    const std::map<dealii::CellId, std::vector<double> > & pseudoValuesElectronic,
    const std::map<dealii::CellId, std::vector<double> > & pseudoValuesElectrostatic,
@@ -560,6 +529,56 @@ namespace dftfe
 
     typename dealii::DoFHandler<3>::active_cell_iterator cellElectronic = dofHandlerElectronic.begin_active(), endcElectronic = dofHandlerElectronic.end();
 
+    //
+    //evaluate the exchange-correlation energy densities and potentials at all the quadrature points of the
+    //locally owned cells with a single libxc call per functional, directly on the flat storage of the densities
+    //
+    const unsigned int numberQuadPointsTotal=rhoOutValues.size();
+    std::vector<double> exchangeEnergyDensity(numberQuadPointsTotal),
+      corrEnergyDensity(numberQuadPointsTotal);
+    std::vector<double> derExchEnergyWithInputDensity(2*numberQuadPointsTotal),
+      derCorrEnergyWithInputDensity(2*numberQuadPointsTotal);
+    std::vector<double> derExchEnergyWithSigmaGradDenInput, derCorrEnergyWithSigmaGradDenInput;
+    std::vector<double> gradRhoInDotgradRhoOut;
+
+    if(dftParameters::xc_id == 4)
+      {
+	std::vector<double> sigmaWithOutputGradDensity(3*numberQuadPointsTotal),
+	  sigmaWithInputGradDensity(3*numberQuadPointsTotal);
+	derExchEnergyWithSigmaGradDenInput.resize(3*numberQuadPointsTotal);
+	derCorrEnergyWithSigmaGradDenInput.resize(3*numberQuadPointsTotal);
+	gradRhoInDotgradRhoOut.resize(3*numberQuadPointsTotal);
+
+	for (unsigned int iPoint=0; iPoint<numberQuadPointsTotal; ++iPoint)
+	  {
+	    const double * gradRhoIn = gradRhoInValuesSpinPolarized.data()+6*iPoint;
+	    const double * gradRhoOut = gradRhoOutValuesSpinPolarized.data()+6*iPoint;
+	    //
+	    sigmaWithInputGradDensity[3*iPoint+0] = gradRhoIn[0]*gradRhoIn[0] + gradRhoIn[1]*gradRhoIn[1] + gradRhoIn[2]*gradRhoIn[2];
+	    sigmaWithInputGradDensity[3*iPoint+1] = gradRhoIn[0]*gradRhoIn[3] + gradRhoIn[1]*gradRhoIn[4] + gradRhoIn[2]*gradRhoIn[5];
+	    sigmaWithInputGradDensity[3*iPoint+2] = gradRhoIn[3]*gradRhoIn[3] + gradRhoIn[4]*gradRhoIn[4] + gradRhoIn[5]*gradRhoIn[5];
+	    sigmaWithOutputGradDensity[3*iPoint+0] = gradRhoOut[0]*gradRhoOut[0] + gradRhoOut[1]*gradRhoOut[1] + gradRhoOut[2]*gradRhoOut[2];
+	    sigmaWithOutputGradDensity[3*iPoint+1] = gradRhoOut[0]*gradRhoOut[3] + gradRhoOut[1]*gradRhoOut[4] + gradRhoOut[2]*gradRhoOut[5];
+	    sigmaWithOutputGradDensity[3*iPoint+2] = gradRhoOut[3]*gradRhoOut[3] + gradRhoOut[4]*gradRhoOut[4] + gradRhoOut[5]*gradRhoOut[5];
+	    gradRhoInDotgradRhoOut[3*iPoint+0] = gradRhoIn[0]*gradRhoOut[0] + gradRhoIn[1]*gradRhoOut[1] + gradRhoIn[2]*gradRhoOut[2];
+	    gradRhoInDotgradRhoOut[3*iPoint+1] = gradRhoIn[0]*gradRhoOut[3] + gradRhoIn[1]*gradRhoOut[4] + gradRhoIn[2]*gradRhoOut[5];
+	    gradRhoInDotgradRhoOut[3*iPoint+2] = gradRhoIn[3]*gradRhoOut[3] + gradRhoIn[4]*gradRhoOut[4] + gradRhoIn[5]*gradRhoOut[5];
+	  }
+
+	xc_gga_exc(&funcX,numberQuadPointsTotal,rhoOutValuesSpinPolarized.data(),&sigmaWithOutputGradDensity[0],&exchangeEnergyDensity[0]);
+	xc_gga_exc(&funcC,numberQuadPointsTotal,rhoOutValuesSpinPolarized.data(),&sigmaWithOutputGradDensity[0],&corrEnergyDensity[0]);
+
+	xc_gga_vxc(&funcX,numberQuadPointsTotal,rhoInValuesSpinPolarized.data(),&sigmaWithInputGradDensity[0],&derExchEnergyWithInputDensity[0],&derExchEnergyWithSigmaGradDenInput[0]);
+	xc_gga_vxc(&funcC,numberQuadPointsTotal,rhoInValuesSpinPolarized.data(),&sigmaWithInputGradDensity[0],&derCorrEnergyWithInputDensity[0],&derCorrEnergyWithSigmaGradDenInput[0]);
+      }
+    else
+      {
+	xc_lda_exc(&funcX,numberQuadPointsTotal,rhoOutValuesSpinPolarized.data(),&exchangeEnergyDensity[0]);
+	xc_lda_exc(&funcC,numberQuadPointsTotal,rhoOutValuesSpinPolarized.data(),&corrEnergyDensity[0]);
+	xc_lda_vxc(&funcX,numberQuadPointsTotal,rhoInValuesSpinPolarized.data(),&derExchEnergyWithInputDensity[0]);
+	xc_lda_vxc(&funcC,numberQuadPointsTotal,rhoInValuesSpinPolarized.data(),&derCorrEnergyWithInputDensity[0]);
+      }
+
     for (; cellElectronic!=endcElectronic; ++cellElectronic)
       if (cellElectronic->is_locally_owned())
 	{
@@ -567,139 +586,41 @@ namespace dftfe
 	  feValuesElectronic.reinit (cellElectronic);
 	  feValuesElectronic.get_function_values(phiTotRhoIn,cellPhiTotRhoIn);
 	  feValuesElectronic.get_function_values(phiExt,cellPhiExt);
+	  const unsigned int cellIndex=rhoOutValues.getLayout()->cellIndex(cellElectronic->id());
 
-	  if(dftParameters::xc_id == 4)
+	  for (unsigned int q_point=0; q_point<num_quad_points_electronic; ++q_point)
 	    {
-	      // Get exc
-	      std::vector<double> densityValueIn(2*num_quad_points_electronic),
-		densityValueOut(2*num_quad_points_electronic);
-	      std::vector<double> exchangeEnergyDensity(num_quad_points_electronic),
-		corrEnergyDensity(num_quad_points_electronic);
-	      std::vector<double> derExchEnergyWithInputDensity(2*num_quad_points_electronic),
-		derCorrEnergyWithInputDensity(2*num_quad_points_electronic);
-	      std::vector<double> derExchEnergyWithSigmaGradDenInput(3*num_quad_points_electronic),
-		derCorrEnergyWithSigmaGradDenInput(3*num_quad_points_electronic);
-	      std::vector<double> sigmaWithOutputGradDensity(3*num_quad_points_electronic),
-		sigmaWithInputGradDensity(3*num_quad_points_electronic);
-	      std::vector<double> gradRhoInDotgradRhoOut(3*num_quad_points_electronic);
-
-	      for (unsigned int q_point=0; q_point<num_quad_points_electronic; ++q_point)
-		{
-		  densityValueIn[2*q_point+0] = rhoInValuesSpinPolarized.find(cellElectronic->id())->second[2*q_point+0];
-		  densityValueIn[2*q_point+1] = rhoInValuesSpinPolarized.find(cellElectronic->id())->second[2*q_point+1];
-		  densityValueOut[2*q_point+0] = rhoOutValuesSpinPolarized.find(cellElectronic->id())->second[2*q_point+0];
-		  densityValueOut[2*q_point+1] = rhoOutValuesSpinPolarized.find(cellElectronic->id())->second[2*q_point+1];
-		  //
-		  const double gradRhoInX1 = (gradRhoInValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 0]);
-		  const double gradRhoInY1 = (gradRhoInValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 1]);
-		  const double gradRhoInZ1 = (gradRhoInValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 2]);
-		  const double gradRhoOutX1 = (gradRhoOutValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 0]);
-		  const double gradRhoOutY1 = (gradRhoOutValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 1]);
-		  const double gradRhoOutZ1 = (gradRhoOutValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 2]);
-		  //
-		  const double gradRhoInX2 = (gradRhoInValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 3]);
-		  const double gradRhoInY2 = (gradRhoInValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 4]);
-		  const double gradRhoInZ2 = (gradRhoInValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 5]);
-		  const double gradRhoOutX2 = (gradRhoOutValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 3]);
-		  const double gradRhoOutY2 = (gradRhoOutValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 4]);
-		  const double gradRhoOutZ2 = (gradRhoOutValuesSpinPolarized.find(cellElectronic->id())->second[6*q_point + 5]);
-		  //
-		  sigmaWithInputGradDensity[3*q_point+0] = gradRhoInX1*gradRhoInX1 + gradRhoInY1*gradRhoInY1 + gradRhoInZ1*gradRhoInZ1;
-		  sigmaWithInputGradDensity[3*q_point+1] = gradRhoInX1*gradRhoInX2 + gradRhoInY1*gradRhoInY2 + gradRhoInZ1*gradRhoInZ2;
-		  sigmaWithInputGradDensity[3*q_point+2] = gradRhoInX2*gradRhoInX2 + gradRhoInY2*gradRhoInY2 + gradRhoInZ2*gradRhoInZ2;
-		  sigmaWithOutputGradDensity[3*q_point+0] = gradRhoOutX1*gradRhoOutX1 + gradRhoOutY1*gradRhoOutY1 + gradRhoOutZ1*gradRhoOutZ1;
-		  sigmaWithOutputGradDensity[3*q_point+1] = gradRhoOutX1*gradRhoOutX2 + gradRhoOutY1*gradRhoOutY2 + gradRhoOutZ1*gradRhoOutZ2;
-		  sigmaWithOutputGradDensity[3*q_point+2] = gradRhoOutX2*gradRhoOutX2 + gradRhoOutY2*gradRhoOutY2 + gradRhoOutZ2*gradRhoOutZ2;
-		  gradRhoInDotgradRhoOut[3*q_point+0] = gradRhoInX1*gradRhoOutX1 + gradRhoInY1*gradRhoOutY1 + gradRhoInZ1*gradRhoOutZ1;
-		  gradRhoInDotgradRhoOut[3*q_point+1] = gradRhoInX1*gradRhoOutX2 + gradRhoInY1*gradRhoOutY2 + gradRhoInZ1*gradRhoOutZ2;
-		  gradRhoInDotgradRhoOut[3*q_point+2] = gradRhoInX2*gradRhoOutX2 + gradRhoInY2*gradRhoOutY2 + gradRhoInZ2*gradRhoOutZ2;
-		}
-	      xc_gga_exc(&funcX,num_quad_points_electronic,&densityValueOut[0],&sigmaWithOutputGradDensity[0],&exchangeEnergyDensity[0]);
-	      xc_gga_exc(&funcC,num_quad_points_electronic,&densityValueOut[0],&sigmaWithOutputGradDensity[0],&corrEnergyDensity[0]);
-
-	      xc_gga_vxc(&funcX,num_quad_points_electronic,&densityValueIn[0],&sigmaWithInputGradDensity[0],&derExchEnergyWithInputDensity[0],&derExchEnergyWithSigmaGradDenInput[0]);
-	      xc_gga_vxc(&funcC,num_quad_points_electronic,&densityValueIn[0],&sigmaWithInputGradDensity[0],&derCorrEnergyWithInputDensity[0],&derCorrEnergyWithSigmaGradDenInput[0]);
-
-	      for (unsigned int q_point=0; q_point<num_quad_points_electronic; ++q_point)
-		{
-		  // Vxc computed with rhoIn
-		  double Vxc=derExchEnergyWithInputDensity[2*q_point+0]+derCorrEnergyWithInputDensity[2*q_point+0];
-		  double VxcGrad = 2.0*(derExchEnergyWithSigmaGradDenInput[3*q_point+0]+derCorrEnergyWithSigmaGradDenInput[3*q_point+0])*gradRhoInDotgradRhoOut[3*q_point+0];
+	      const unsigned int iPoint=cellIndex*num_quad_points_electronic+q_point;
 
-		  VxcGrad += 2.0*(derExchEnergyWithSigmaGradDenInput[3*q_point+1]+derCorrEnergyWithSigmaGradDenInput[3*q_point+1])*gradRhoInDotgradRhoOut[3*q_point+1];
+	      // Vxc computed with rhoIn
+	      double Vxc=derExchEnergyWithInputDensity[2*iPoint+0]+derCorrEnergyWithInputDensity[2*iPoint+0];
+	      double VxcGrad=0.0;
+	      if(dftParameters::xc_id == 4)
+		for (unsigned int iSigma=0; iSigma<3; ++iSigma)
+		  VxcGrad += 2.0*(derExchEnergyWithSigmaGradDenInput[3*iPoint+iSigma]+derCorrEnergyWithSigmaGradDenInput[3*iPoint+iSigma])*gradRhoInDotgradRhoOut[3*iPoint+iSigma];
 
-		  VxcGrad += 2.0*(derExchEnergyWithSigmaGradDenInput[3*q_point+2]+derCorrEnergyWithSigmaGradDenInput[3*q_point+2] )*gradRhoInDotgradRhoOut[3*q_point+2];
+	      excCorrPotentialTimesRho+=(Vxc*(rhoOutValuesSpinPolarized.cellData(cellIndex)[2*q_point+0])+VxcGrad)*feValuesElectronic.JxW (q_point);
 
-		  excCorrPotentialTimesRho+=(Vxc*(rhoOutValuesSpinPolarized.find(cellElectronic->id())->second[2*q_point+0])+VxcGrad)*feValuesElectronic.JxW (q_point);
+	      Vxc=derExchEnergyWithInputDensity[2*iPoint+1]+derCorrEnergyWithInputDensity[2*iPoint+1];
 
-		  Vxc=derExchEnergyWithInputDensity[2*q_point+1]+derCorrEnergyWithInputDensity[2*q_point+1];
+	      excCorrPotentialTimesRho+=(Vxc*(rhoOutValuesSpinPolarized.cellData(cellIndex)[2*q_point+1]))*feValuesElectronic.JxW (q_point);
 
-		  excCorrPotentialTimesRho+=(Vxc*(rhoOutValuesSpinPolarized.find(cellElectronic->id())->second[2*q_point+1]))*feValuesElectronic.JxW (q_point);
+	      exchangeEnergy+=(exchangeEnergyDensity[iPoint])*(rhoOutValues.cellData(cellIndex)[q_point])*feValuesElectronic.JxW(q_point);
 
-		  exchangeEnergy+=(exchangeEnergyDensity[q_point])*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW(q_point);
-
-		  correlationEnergy+=(corrEnergyDensity[q_point])*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW(q_point);
-
-		  electrostaticPotentialTimesRho+=(cellPhiTotRhoIn[q_point])
-				  *(rhoOutValues.find(cellElectronic->id())->second[q_point])
-				  *feValuesElectronic.JxW (q_point);
+	      correlationEnergy+=(corrEnergyDensity[iPoint])*(rhoOutValues.cellData(cellIndex)[q_point])*feValuesElectronic.JxW(q_point);
 
-		  if(dftParameters::isPseudopotential)
-		      electrostaticPotentialTimesRho+=(pseudoValuesElectronic.find(cellElectronic->id())->second[q_point]
-						      -cellPhiExt[q_point])
-				      *(rhoOutValues.find(cellElectronic->id())->second[q_point])
-				      *feValuesElectronic.JxW (q_point);
+	      electrostaticPotentialTimesRho+=(cellPhiTotRhoIn[q_point])
+			      *(rhoOutValues.cellData(cellIndex)[q_point])
+			      *feValuesElectronic.JxW (q_point);
 
-		  vSelfPotentialTimesRho+=cellPhiExt[q_point]*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW (q_point);
-
-		}
-	    }
-	  else
-	    {
-	      // Get Exc
-	      std::vector<double> densityValueIn(2*num_quad_points_electronic),
-		densityValueOut(2*num_quad_points_electronic);
-	      std::vector<double> exchangeEnergyVal(num_quad_points_electronic),
-		corrEnergyVal(num_quad_points_electronic);
-	      std::vector<double> exchangePotentialVal(2*num_quad_points_electronic),
-		corrPotentialVal(2*num_quad_points_electronic);
-	      for (unsigned int q_point=0; q_point<2*num_quad_points_electronic; ++q_point)
-		{
-		  densityValueIn[q_point] = rhoInValuesSpinPolarized.find(cellElectronic->id())->second[q_point];
-		  densityValueOut[q_point] = rhoOutValuesSpinPolarized.find(cellElectronic->id())->second[q_point];
-		}
-	      //
-
-	      xc_lda_exc(&funcX,num_quad_points_electronic,&densityValueOut[0],&exchangeEnergyVal[0]);
-	      xc_lda_exc(&funcC,num_quad_points_electronic,&densityValueOut[0],&corrEnergyVal[0]);
-	      xc_lda_vxc(&funcX,num_quad_points_electronic,&densityValueIn[0],&exchangePotentialVal[0]);
-	      xc_lda_vxc(&funcC,num_quad_points_electronic,&densityValueIn[0],&corrPotentialVal[0]);
-
-	      for (unsigned int q_point = 0; q_point < num_quad_points_electronic; ++q_point)
-		{
-		  // Vxc computed with rhoIn
-		  double Vxc=exchangePotentialVal[2*q_point]+corrPotentialVal[2*q_point] ;
-		  excCorrPotentialTimesRho+=Vxc*(rhoOutValuesSpinPolarized.find(cellElectronic->id())->second[2*q_point])*feValuesElectronic.JxW (q_point);
-		  //
-		  Vxc= exchangePotentialVal[2*q_point+1]+corrPotentialVal[2*q_point+1] ;
-		  excCorrPotentialTimesRho+=Vxc*(rhoOutValuesSpinPolarized.find(cellElectronic->id())->second[2*q_point+1])*feValuesElectronic.JxW (q_point);
-		  //
-		  exchangeEnergy+=(exchangeEnergyVal[q_point])*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW(q_point);
-		  correlationEnergy+=(corrEnergyVal[q_point])*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW(q_point) ;
-
-		  electrostaticPotentialTimesRho+=(cellPhiTotRhoIn[q_point])
-				  *(rhoOutValues.find(cellElectronic->id())->second[q_point])
+	      if(dftParameters::isPseudopotential)
+		  electrostaticPotentialTimesRho+=(pseudoValuesElectronic.find(cellElectronic->id())->second[q_point]
+						  -cellPhiExt[q_point])
+				  *(rhoOutValues.cellData(cellIndex)[q_point])
 				  *feValuesElectronic.JxW (q_point);
 
-		  if(dftParameters::isPseudopotential)
-		      electrostaticPotentialTimesRho+=(pseudoValuesElectronic.find(cellElectronic->id())->second[q_point]
-						      -cellPhiExt[q_point])
-				      *(rhoOutValues.find(cellElectronic->id())->second[q_point])
-				      *feValuesElectronic.JxW (q_point);
-
-		  vSelfPotentialTimesRho+=cellPhiExt[q_point]*(rhoOutValues.find(cellElectronic->id())->second[q_point])*feValuesElectronic.JxW (q_point);
+	      vSelfPotentialTimesRho+=cellPhiExt[q_point]*(rhoOutValues.cellData(cellIndex)[q_point])*feValuesElectronic.JxW (q_point);
 
-		}
 	    }
 
 	}
@@ -715,14 +636,14 @@ namespace dftfe
 
 	  for(unsigned int q_point = 0; q_point < num_quad_points_electrostatic; ++q_point)
 	    {
-	      electrostaticEnergyTotPot+=0.5*(cellPhiTotRhoOut[q_point])*(rhoOutValuesElectrostatic.find(cellElectrostatic->id())->second[q_point])*feValuesElectrostatic.JxW(q_point);
-	      vSelfPotentialElecTimesRho += cellPhiExtElec[q_point]*(rhoOutValuesElectrostatic.find(cellElectrostatic->id())->second[q_point])*feValuesElectrostatic.JxW (q_point);
+	      electrostaticEnergyTotPot+=0.5*(cellPhiTotRhoOut[q_point])*rhoOutElectrostaticCell[q_point]*feValuesElectrostatic.JxW(q_point);
+	      vSelfPotentialElecTimesRho += cellPhiExtElec[q_point]*rhoOutElectrostaticCell[q_point]*feValuesElectrostatic.JxW (q_point);
 
 	      if(dftParameters::isPseudopotential)
 		  electrostaticEnergyTotPot+=
 			 (pseudoValuesElectrostatic.find(cellElectrostatic->id())->second[q_point]
 			 -cellPhiExtElec[q_point])
-			 *(rhoOutValuesElectrostatic.find(cellElectrostatic->id())->second[q_point])
+			 *rhoOutElectrostaticCell[q_point]
 			 *feValuesElectrostatic.JxW (q_point);
 	    }
 	}
@@ -174,6 +174,32 @@ void dftClass<FEOrder>::initBoundaryConditions(){
 
   matrix_free_data.reinit(dofHandlerVector, d_constraintsVector, quadratureVector, additional_data);
 
+  //
+  //enumerate the cells for the rho cell quadrature data in the macro cell order of matrix_free_data.
+  //A new layout object is created as existing rho data (see noRemeshRhoDataInit) still refers to the old one
+  //
+  d_rhoQuadDataLayout=std::make_shared<dftUtils::cellQuadratureFieldLayout>();
+  d_rhoQuadDataLayout->reinit(matrix_free_data);
+
+  //
+  //JxW values used for the integrals over the rho cell quadrature data in the mixing schemes
+  //
+  {
+    QGauss<3>  quadrature(C_num1DQuad<FEOrder>());
+    FEValues<3> fe_values (FE, quadrature, update_JxW_values);
+    const unsigned int num_quad_points = quadrature.size();
+    d_rhoQuadJxWValues.resize(d_rhoQuadDataLayout->nCells()*num_quad_points);
+    typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
+    for (; cell!=endc; ++cell)
+      if (cell->is_locally_owned())
+	{
+	  fe_values.reinit (cell);
+	  const unsigned int cellIndex=d_rhoQuadDataLayout->cellIndex(cell->id());
+	  for (unsigned int q_point=0; q_point<num_quad_points; ++q_point)
+	    d_rhoQuadJxWValues[cellIndex*num_quad_points+q_point]=fe_values.JxW(q_point);
+	}
+  }
+
   if (dftParameters::verbosity>=4)
       dftUtils::printCurrentMemoryUsage(mpi_communicator,
 	                      "Called matrix free reinit");
@@ -136,6 +136,8 @@ void dftClass<FEOrder>::initElectronicFields(const unsigned int usePreviousGroun
 
      if (!(dftParameters::chkType==2 && dftParameters::restartFromChk))
 	initRho();
+     else
+	remapRhoDataToCurrentLayout();
 
      if (dftParameters::verbosity>=4)
        dftUtils::printCurrentMemoryUsage(mpi_communicator,
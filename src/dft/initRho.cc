@@ -24,18 +24,25 @@
 template<unsigned int FEOrder>
 void dftClass<FEOrder>::clearRhoData()
 {
-  rhoInVals.clear();
-  rhoOutVals.clear();
-  gradRhoInVals.clear();
-  gradRhoOutVals.clear();
-  rhoInValsSpinPolarized.clear();
-  rhoOutValsSpinPolarized.clear();
-  gradRhoInValsSpinPolarized.clear();
-  gradRhoOutValsSpinPolarized.clear();
-  dFBroyden.clear();
-  graddFBroyden.clear() ;
-  uBroyden.clear();
-  gradUBroyden.clear() ;
+  //
+  //the histories are ring buffers which retain the storage of the dropped entries. One slot more than
+  //the mixing history is needed as the new rhoIn is appended by the mixing schemes before the oldest entry
+  //is dropped in compute_rhoOut
+  //
+  const unsigned int historyCapacity=std::max(dftParameters::mixingHistory,(unsigned int)1)+1;
+
+  rhoInVals.setCapacity(historyCapacity);
+  rhoOutVals.setCapacity(historyCapacity);
+  gradRhoInVals.setCapacity(historyCapacity);
+  gradRhoOutVals.setCapacity(historyCapacity);
+  rhoInValsSpinPolarized.setCapacity(historyCapacity);
+  rhoOutValsSpinPolarized.setCapacity(historyCapacity);
+  gradRhoInValsSpinPolarized.setCapacity(historyCapacity);
+  gradRhoOutValsSpinPolarized.setCapacity(historyCapacity);
+  dFBroyden.setCapacity(historyCapacity);
+  graddFBroyden.setCapacity(historyCapacity) ;
+  uBroyden.setCapacity(historyCapacity);
+  gradUBroyden.setCapacity(historyCapacity) ;
 }
 
 template<unsigned int FEOrder>
@@ -98,11 +105,11 @@ void dftClass<FEOrder>::initRho()
 
   //Initialize electron density table storage
 
-  rhoInVals.push_back(std::map<dealii::CellId, std::vector<double> >());
+  rhoInVals.push_back(d_rhoQuadDataLayout,n_q_points);
   rhoInValues=&(rhoInVals.back());
   if(dftParameters::spinPolarized==1)
     {
-      rhoInValsSpinPolarized.push_back(std::map<dealii::CellId, std::vector<double> >());
+      rhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,2*n_q_points);
       rhoInValuesSpinPolarized=&(rhoInValsSpinPolarized.back());
     }
   //
@@ -117,13 +124,11 @@ void dftClass<FEOrder>::initRho()
       if (cell->is_locally_owned())
 	{
 	  fe_values.reinit(cell);
-	  (*rhoInValues)[cell->id()]=std::vector<double>(n_q_points);
 	  double *rhoInValuesPtr = &((*rhoInValues)[cell->id()][0]);
 
           double *rhoInValuesSpinPolarizedPtr;
           if(dftParameters::spinPolarized==1)
 	  {
-	      (*rhoInValuesSpinPolarized)[cell->id()]=std::vector<double>(2*n_q_points);
 	      rhoInValuesSpinPolarizedPtr = &((*rhoInValuesSpinPolarized)[cell->id()][0]);
 	  }
 	  for (unsigned int q = 0; q < n_q_points; ++q)
@@ -179,12 +184,12 @@ void dftClass<FEOrder>::initRho()
   //loop over elements
   if(dftParameters::xc_id == 4)
     {
-      gradRhoInVals.push_back(std::map<dealii::CellId, std::vector<double> >());
+      gradRhoInVals.push_back(d_rhoQuadDataLayout,3*n_q_points);
       gradRhoInValues= &(gradRhoInVals.back());
       //
 	if(dftParameters::spinPolarized==1)
         {
-          gradRhoInValsSpinPolarized.push_back(std::map<dealii::CellId, std::vector<double> >());
+          gradRhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,6*n_q_points);
           gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
         }
       //
@@ -195,13 +200,11 @@ void dftClass<FEOrder>::initRho()
 	    {
 	      fe_values.reinit(cell);
 
-	      (*gradRhoInValues)[cell->id()]=std::vector<double>(3*n_q_points);
 	      double *gradRhoInValuesPtr = &((*gradRhoInValues)[cell->id()][0]);
 
               double *gradRhoInValuesSpinPolarizedPtr;
               if(dftParameters::spinPolarized==1)
               {
-	        (*gradRhoInValuesSpinPolarized)[cell->id()]=std::vector<double>(6*n_q_points);
                 gradRhoInValuesSpinPolarizedPtr = &((*gradRhoInValuesSpinPolarized)[cell->id()][0]);
 	      }
 	      for (unsigned int q = 0; q < n_q_points; ++q)
@@ -312,22 +315,22 @@ void dftClass<FEOrder>::computeRhoInitialGuessFromPSI(std::vector<std::vector<ve
 
   //Initialize electron density table storage
 
-  rhoInVals.push_back(std::map<dealii::CellId, std::vector<double> >());
+  rhoInVals.push_back(d_rhoQuadDataLayout,num_quad_points);
   rhoInValues=&(rhoInVals.back());
   if (dftParameters::spinPolarized==1)
   {
-      rhoInValsSpinPolarized.push_back(std::map<dealii::CellId, std::vector<double> >());
+      rhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,2*num_quad_points);
       rhoInValuesSpinPolarized=&(rhoInValsSpinPolarized.back());
   }
 
   if(dftParameters::xc_id == 4)
   {
-      gradRhoInVals.push_back(std::map<dealii::CellId, std::vector<double> >());
+      gradRhoInVals.push_back(d_rhoQuadDataLayout,3*num_quad_points);
       gradRhoInValues= &(gradRhoInVals.back());
       //
 	if(dftParameters::spinPolarized==1)
         {
-          gradRhoInValsSpinPolarized.push_back(std::map<dealii::CellId, std::vector<double> >());
+          gradRhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,6*num_quad_points);
           gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
         }
   }
@@ -343,11 +346,9 @@ void dftClass<FEOrder>::computeRhoInitialGuessFromPSI(std::vector<std::vector<ve
        {
 	  fe_values.reinit (cell);
 
-	  (*rhoInValues)[cell->id()] = std::vector<double>(num_quad_points);
 	  std::fill(rhoTemp.begin(),rhoTemp.end(),0.0); std::fill(rhoIn.begin(),rhoIn.end(),0.0);
 	  if (dftParameters::spinPolarized==1)
     	     {
-	       	(*rhoInValuesSpinPolarized)[cell->id()] = std::vector<double>(2*num_quad_points);
 		std::fill(rhoTempSpinPolarized.begin(),rhoTempSpinPolarized.end(),0.0);
 	     }
 
@@ -366,11 +367,9 @@ void dftClass<FEOrder>::computeRhoInitialGuessFromPSI(std::vector<std::vector<ve
 
 	  if(dftParameters::xc_id == 4)//GGA
 	    {
-	      (*gradRhoInValues)[cell->id()] = std::vector<double>(3*num_quad_points);
 	      std::fill(gradRhoTemp.begin(),gradRhoTemp.end(),0.0);
 	      if (dftParameters::spinPolarized==1)
     	        {
-	       	   (*gradRhoInValuesSpinPolarized)[cell->id()] = std::vector<double>(6*num_quad_points);
 	            std::fill(gradRhoTempSpinPolarized.begin(),gradRhoTempSpinPolarized.end(),0.0);
 	        }
 #ifdef USE_COMPLEX
@@ -573,7 +572,7 @@ void dftClass<FEOrder>::computeNodalRhoFromQuadData()
                        const unsigned int q)> funcRho =
                        [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell ,
                        const unsigned int q)
-                       {return (*rhoOutValues).find(cell->id())->second[q];};
+                       {return (*rhoOutValues)[cell->id()][q];};
 
   dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double>>
       (dealii::MappingQ1<3,3>(),
@@ -595,7 +594,7 @@ void dftClass<FEOrder>::computeNodalRhoFromQuadData()
                            const unsigned int q)> funcRhoSpin0 =
 				   [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell ,
 				   const unsigned int q)
-				   {return (*rhoOutValuesSpinPolarized).find(cell->id())->second[2*q];};
+				   {return (*rhoOutValuesSpinPolarized)[cell->id()][2*q];};
 
       dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double>>
 	  (dealii::MappingQ1<3,3>(),
@@ -614,7 +613,7 @@ void dftClass<FEOrder>::computeNodalRhoFromQuadData()
                            const unsigned int q)> funcRhoSpin1 =
 				   [&](const typename dealii::DoFHandler<3>::active_cell_iterator & cell ,
 				   const unsigned int q)
-				   {return (*rhoOutValuesSpinPolarized).find(cell->id())->second[2*q+1];};
+				   {return (*rhoOutValuesSpinPolarized)[cell->id()][2*q+1];};
 
       dealii::VectorTools::project<3,dealii::parallel::distributed::Vector<double>>
 	  (dealii::MappingQ1<3,3>(),
@@ -764,30 +763,30 @@ void dftClass<FEOrder>::initRhoFromPreviousGroundStateRho()
 
 	  for (unsigned int iSubCell=0; iSubCell<numSubCells; ++iSubCell)
 	  {
-	      const dealii::CellId subCellId=matrix_free_data.get_cell_iterator(cell,iSubCell)->id();
+	      const unsigned int subCellIndex=d_rhoQuadDataLayout->cellIndex(cell,iSubCell);
 
 	      for (unsigned int q=0; q<numQuadPoints; ++q)
 	      {
 		   if(dftParameters::spinPolarized==1)
 		   {
-			(*rhoInValuesSpinPolarized)[subCellId][2*q]=rhoQuadsSpin0[q][iSubCell];
-			(*rhoInValuesSpinPolarized)[subCellId][2*q+1]=rhoQuadsSpin1[q][iSubCell];
+			rhoInValuesSpinPolarized->cellData(subCellIndex)[2*q]=rhoQuadsSpin0[q][iSubCell];
+			rhoInValuesSpinPolarized->cellData(subCellIndex)[2*q+1]=rhoQuadsSpin1[q][iSubCell];
 
 			if(dftParameters::xc_id == 4)
 			    for(unsigned int idim=0; idim<3; ++idim)
 			    {
-			      (*gradRhoInValuesSpinPolarized)[subCellId][6*q+idim]
+			      gradRhoInValuesSpinPolarized->cellData(subCellIndex)[6*q+idim]
 				  =gradRhoQuadsSpin0[q][idim][iSubCell];
-			      (*gradRhoInValuesSpinPolarized)[subCellId][6*q+3+idim]
+			      gradRhoInValuesSpinPolarized->cellData(subCellIndex)[6*q+3+idim]
 				  =gradRhoQuadsSpin1[q][idim][iSubCell];
 			   }
 		   }
 
-		   (*rhoInValues)[subCellId][q]= rhoQuads[q][iSubCell];
+		   rhoInValues->cellData(subCellIndex)[q]= rhoQuads[q][iSubCell];
 
 		   if(dftParameters::xc_id == 4)
 		      for(unsigned int idim=0; idim<3; ++idim)
-			(*gradRhoInValues)[subCellId][3*q + idim]
+			gradRhoInValues->cellData(subCellIndex)[3*q + idim]
 			    = gradRhoQuads[q][idim][iSubCell];
 
 	       }//quad point loop
@@ -813,9 +812,6 @@ void dftClass<FEOrder>::initRhoFromPreviousGroundStateRho()
 template<unsigned int FEOrder>
 void dftClass<FEOrder>::normalizeRho()
 {
-  QGauss<3>  quadrature_formula(C_num1DQuad<FEOrder>());
-  const unsigned int n_q_points    = quadrature_formula.size();
-
   const double charge = totalCharge(dofHandler,
 				    rhoInValues);
   const double scaling=((double)numElectrons)/charge;
@@ -824,28 +820,22 @@ void dftClass<FEOrder>::normalizeRho()
      pcout<< "initial total charge before normalizing to number of electrons: "<< charge<<std::endl;
 
   //scaling rho
-  typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      for (unsigned int q=0; q<n_q_points; ++q){
-	(*rhoInValues)[cell->id()][q]*=scaling;
-
-	if(dftParameters::xc_id == 4)
-	    for (unsigned int idim=0; idim<3; ++idim)
-	      (*gradRhoInValues)[cell->id()][3*q+idim]*=scaling;
-	if (dftParameters::spinPolarized==1)
-	   {
-           	(*rhoInValuesSpinPolarized)[cell->id()][2*q+1]*=scaling;
-           	(*rhoInValuesSpinPolarized)[cell->id()][2*q]*=scaling;
-	        if(dftParameters::xc_id == 4)
-	          for (unsigned int idim=0; idim<3; ++idim)
-		  {
-	              (*gradRhoInValuesSpinPolarized)[cell->id()][6*q+idim]*=scaling;
-		      (*gradRhoInValuesSpinPolarized)[cell->id()][6*q+3+idim]*=scaling;
-		  }
-	   }
-      }
-    }
+  std::vector<dftUtils::cellQuadratureField *> rhoInFields(1,rhoInValues);
+  if(dftParameters::xc_id == 4)
+     rhoInFields.push_back(gradRhoInValues);
+  if (dftParameters::spinPolarized==1)
+  {
+     rhoInFields.push_back(rhoInValuesSpinPolarized);
+     if(dftParameters::xc_id == 4)
+	rhoInFields.push_back(gradRhoInValuesSpinPolarized);
+  }
+
+  for (unsigned int ifield=0; ifield<rhoInFields.size(); ++ifield)
+  {
+     double * fieldData=rhoInFields[ifield]->data();
+     const unsigned int fieldSize=rhoInFields[ifield]->size();
+     for (unsigned int i=0; i<fieldSize; ++i)
+	fieldData[i]*=scaling;
   }
   double chargeAfterScaling = totalCharge(dofHandler,
 					  rhoInValues);
@@ -75,7 +75,8 @@ void dftClass<FEOrder>::kohnShamEigenSpaceCompute(const unsigned int spinType,
 						  chebyshevOrthogonalizedSubspaceIterationSolver & subspaceIterationSolver,
 						  std::vector<double>                            & residualNormWaveFunctions,
 						  const bool isSpectrumSplit,
-						  const bool useMixedPrec)
+						  const bool useMixedPrec,
+						  const bool useMixedPrecCheby)
 {
   computing_timer.enter_section("Chebyshev solve");
 
@@ -102,6 +103,50 @@ void dftClass<FEOrder>::kohnShamEigenSpaceCompute(const unsigned int spinType,
   subspaceIterationSolver.reinitSpectrumBounds(a0[(1+dftParameters::spinPolarized)*kPointIndex+spinType],
 					       bLow[(1+dftParameters::spinPolarized)*kPointIndex+spinType]);
 
+  if (dftParameters::adaptiveChebyshevOrder)
+    subspaceIterationSolver.setChebyshevPolynomialDegree(d_chebyshevPolynomialDegree[(1+dftParameters::spinPolarized)*kPointIndex+spinType]);
+
+  const unsigned int index=(1+dftParameters::spinPolarized)*kPointIndex+spinType;
+
+  //
+  //reuse the last Lanczos estimate of the upper bound of the eigen-spectrum, shifted by the change of the
+  //effective potential since the estimate, unless a new estimate is due
+  //
+  bool estimateUpperBound=false;
+  if (dftParameters::lanczosUpperBoundUpdateFrequency>1)
+    {
+      const double vEffChange=kohnShamDFTEigenOperator.getVEffCumulativeChange(spinType)-d_upperBoundVEffCumulativeChange[index];
+      if (d_upperBoundUnwantedSpectrum[index]!=0.0
+	  && d_upperBoundNumberSolves[index]<dftParameters::lanczosUpperBoundUpdateFrequency
+	  && vEffChange<=dftParameters::lanczosUpperBoundVEffTol)
+	{
+	  subspaceIterationSolver.setUpperBoundUnWantedSpectrum(d_upperBoundUnwantedSpectrum[index]+vEffChange);
+	  d_upperBoundNumberSolves[index]++;
+	}
+      else
+	{
+	  estimateUpperBound=true;
+	  d_upperBoundVEffCumulativeChange[index]=kohnShamDFTEigenOperator.getVEffCumulativeChange(spinType);
+	  d_upperBoundNumberSolves[index]=1;
+	}
+    }
+
+  //
+  //partial Rayleigh-Ritz step once the valence eigenstates are nearly converged
+  //
+  const bool partialRayleighRitz=isSpectrumSplit
+                                  && d_numEigenValuesRR!=d_numEigenValues
+                                  && d_spectrumSplitMaxResidualNorm[index]>=0.0
+                                  && d_spectrumSplitMaxResidualNorm[index]<dftParameters::spectrumSplitPartialRRTol;
+  if (partialRayleighRitz)
+    subspaceIterationSolver.setPartialRayleighRitz(true);
+
+  //
+  //soft locking of the eigenstates converged in the last solve
+  //
+  if (dftParameters::lockingResidualTol>0.0)
+    subspaceIterationSolver.setLockingResidualNorms(d_lockingResidualNorms[index]);
+
   subspaceIterationSolver.solve(kohnShamDFTEigenOperator,
   				d_eigenVectorsFlattenedSTL[(1+dftParameters::spinPolarized)*kPointIndex+spinType],
 				d_eigenVectorsRotFracDensityFlattenedSTL[(1+dftParameters::spinPolarized)*kPointIndex+spinType],
@@ -110,7 +155,30 @@ void dftClass<FEOrder>::kohnShamEigenSpaceCompute(const unsigned int spinType,
   				eigenValuesTemp,
 				residualNormWaveFunctions,
 				interBandGroupComm,
-				useMixedPrec);
+				useMixedPrec,
+				useMixedPrecCheby);
+
+  if (dftParameters::adaptiveChebyshevOrder)
+    {
+      d_chebyshevPolynomialDegree[index]=subspaceIterationSolver.getChebyshevPolynomialDegree();
+      d_chebyshevUpperBoundUnwantedSpectrum[index]=subspaceIterationSolver.getUpperBoundUnWantedSpectrum();
+      d_chebyshevFilterWallTimePerDegree[index]=subspaceIterationSolver.getFilterWallTimePerDegree();
+      d_chebyshevSubspaceWallTime[index]=subspaceIterationSolver.getSubspaceWallTime();
+    }
+
+  if (estimateUpperBound)
+    d_upperBoundUnwantedSpectrum[index]=subspaceIterationSolver.getUpperBoundUnWantedSpectrum();
+
+  d_spectrumSplitMaxResidualNorm[index]=isSpectrumSplit?
+                                        *std::max_element(residualNormWaveFunctions.begin(),residualNormWaveFunctions.end())
+                                        :-1.0;
+
+  //
+  //the residual norms after a partial Rayleigh-Ritz step belong to the rotated valence vectors
+  //and not to the vectors stored in the subspace, hence locking is not used for the next solve
+  //
+  if (dftParameters::lockingResidualTol>0.0)
+    d_lockingResidualNorms[index]=partialRayleighRitz?std::vector<double>():residualNormWaveFunctions;
 
   //
   //scale the eigenVectors with M^{-1/2} to represent the wavefunctions in the usual FE basis
@@ -248,3 +316,48 @@ double dftClass<FEOrder>::computeMaximumHighestOccupiedStateResidualNorm(const s
   maxHighestOccupiedStateResNorm= Utilities::MPI::max(maxHighestOccupiedStateResNorm, interpoolcomm);
   return maxHighestOccupiedStateResNorm;
 }
+
+//update the adaptive Chebyshev polynomial degrees from the residual norm of the highest occupied state
+template<unsigned int FEOrder>
+void dftClass<FEOrder>::updateAdaptiveChebyshevPolynomialDegrees(const std::vector<std::vector<double> > & residualNormWaveFunctionsAllkPoints,
+								 const std::vector<std::vector<double> > & eigenValuesAllkPoints,
+								 const unsigned int spinType,
+								 const chebyshevOrthogonalizedSubspaceIterationSolver & subspaceIterationSolver)
+{
+  for (unsigned int kPoint = 0; kPoint < residualNormWaveFunctionsAllkPoints.size(); ++kPoint)
+   {
+     const unsigned int index=(1+dftParameters::spinPolarized)*kPoint+spinType;
+     const unsigned int numberEigenValues=residualNormWaveFunctionsAllkPoints[kPoint].size();
+     unsigned int highestOccupiedState = 0;
+
+     for(unsigned int i = 0; i < numberEigenValues; i++)
+       {
+         const double factor=(eigenValuesAllkPoints[kPoint][i]-fermiEnergy)/(C_kb*dftParameters::TVal);
+	 if (factor<0)
+	   highestOccupiedState=i;
+       }
+
+     const double residualNorm=residualNormWaveFunctionsAllkPoints[kPoint][highestOccupiedState];
+
+     //
+     //residual reduction per polynomial degree in the last Chebyshev filtering pass of this k point and spin
+     //
+     d_chebyshevResidualReductionRate[index]=
+       (d_chebyshevResidualNorm[index]>residualNorm && residualNorm>0.0 && d_chebyshevPolynomialDegree[index]>0)?
+       std::log(d_chebyshevResidualNorm[index]/residualNorm)/d_chebyshevPolynomialDegree[index]
+       :-1.0;
+
+     d_chebyshevPolynomialDegree[index]=subspaceIterationSolver.computeAdaptiveChebyshevPolynomialDegree
+                                           (eigenValuesAllkPoints[kPoint][highestOccupiedState],
+					    residualNorm,
+					    d_chebyshevResidualReductionRate[index],
+					    d_chebyshevUpperBoundUnwantedSpectrum[index],
+					    bLow[index],
+					    d_chebyshevFilterWallTimePerDegree[index],
+					    d_chebyshevSubspaceWallTime[index]);
+     d_chebyshevResidualNorm[index]=residualNorm;
+
+     if (dftParameters::verbosity>=4)
+       pcout<<"Adaptive Chebyshev polynomial degree for kPoint "<<kPoint<<" and spin "<<spinType+1<<": "<<d_chebyshevPolynomialDegree[index]<<std::endl;
+   }
+}
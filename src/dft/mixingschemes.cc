@@ -38,6 +38,88 @@ void calldgesv(const unsigned int dimensionMatrix,
 
     }
 
+namespace internal
+{
+  //
+  //JxW weighted inner products of a set of fields at the locally owned quadrature points of the rho
+  //cell quadrature data computed in a single sweep over the quadrature points followed by a single
+  //MPI_Allreduce. fieldValues(iquad,values) evaluates all the fields at the quadrature point iquad.
+  //It is called exactly once per quadrature point and hence can also be used to update quadrature
+  //data in the same sweep. On return innerProducts holds the symmetric numFields x numFields matrix.
+  //
+  template<typename T>
+  void computeFieldInnerProducts(const std::vector<double> & jxwValues,
+				 const unsigned int numFields,
+				 T & fieldValues,
+				 const MPI_Comm & mpiComm,
+				 std::vector<double> & innerProducts)
+  {
+    innerProducts.assign(numFields*numFields,0.0);
+    std::vector<double> values(numFields);
+
+    const unsigned int numQuadPoints=jxwValues.size();
+    for (unsigned int iquad=0; iquad<numQuadPoints; ++iquad)
+      {
+	fieldValues(iquad,&values[0]);
+	const double jxw=jxwValues[iquad];
+	for (unsigned int i=0; i<numFields; ++i)
+	  {
+	    const double valueTimesJxW=values[i]*jxw;
+	    for (unsigned int j=i; j<numFields; ++j)
+	      innerProducts[i*numFields+j]+=valueTimesJxW*values[j];
+	  }
+      }
+
+    MPI_Allreduce(MPI_IN_PLACE,
+		  &innerProducts[0],
+		  numFields*numFields,
+		  MPI_DOUBLE,
+		  MPI_SUM,
+		  mpiComm);
+
+    for (unsigned int i=0; i<numFields; ++i)
+      for (unsigned int j=0; j<i; ++j)
+	innerProducts[i*numFields+j]=innerProducts[j*numFields+i];
+  }
+
+  //
+  //Anderson update of a quadrature field: the weighted combinations of the input and the output
+  //histories are linearly mixed
+  //
+  void andersonMixingUpdate(const std::vector<const double *> & inFields,
+			    const std::vector<const double *> & outFields,
+			    const std::vector<double> & weights,
+			    const double mixingParameter,
+			    const bool isAbsoluteValue,
+			    const unsigned int numValues,
+			    double * newField)
+  {
+    const unsigned int numFields=weights.size();
+    for (unsigned int i=0; i<numValues; ++i)
+      {
+	double inBar=0.0, outBar=0.0;
+	for (unsigned int j=0; j<numFields; ++j)
+	  {
+	    inBar+=weights[j]*inFields[j][i];
+	    outBar+=weights[j]*outFields[j][i];
+	  }
+	const double value=(1-mixingParameter)*inBar+mixingParameter*outBar;
+	newField[i]=isAbsoluteValue?std::abs(value):value;
+      }
+  }
+
+  //
+  //pointers to the flat storage of all the fields of a history
+  //
+  std::vector<const double *> historyFieldsData(const dftUtils::cellQuadratureFieldHistory & history)
+  {
+    std::vector<const double *> fieldsData(history.size());
+    for (unsigned int i=0; i<history.size(); ++i)
+      fieldsData[i]=history[i].data();
+    return fieldsData;
+  }
+}
+
 //implement simple mixing scheme
 template<unsigned int FEOrder>
 double dftClass<FEOrder>::mixing_simple()
@@ -49,18 +131,18 @@ double dftClass<FEOrder>::mixing_simple()
 
 
   //create new rhoValue tables
-  std::map<dealii::CellId,std::vector<double> > rhoInValuesOld= *rhoInValues;
-  rhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
+  const dftUtils::cellQuadratureField & rhoInValuesOld= *rhoInValues;
+  rhoInVals.push_back(d_rhoQuadDataLayout,num_quad_points);
   rhoInValues=&(rhoInVals.back());
 
 
   //create new gradRhoValue tables
-  std::map<dealii::CellId,std::vector<double> > gradRhoInValuesOld;
+  const dftUtils::cellQuadratureField * gradRhoInValuesOld=NULL;
 
   if(dftParameters::xc_id == 4)
     {
-      gradRhoInValuesOld=*gradRhoInValues;
-      gradRhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
+      gradRhoInValuesOld=gradRhoInValues;
+      gradRhoInVals.push_back(d_rhoQuadDataLayout,3*num_quad_points);
       gradRhoInValues=&(gradRhoInVals.back());
     }
 
@@ -71,11 +153,9 @@ double dftClass<FEOrder>::mixing_simple()
       if(cell->is_locally_owned())
 	{
 	  fe_values.reinit (cell);
-	  (*rhoInValues)[cell->id()]=std::vector<double>(num_quad_points);
 
 
 	  if(dftParameters::xc_id == 4)
-	    (*gradRhoInValues)[cell->id()]=std::vector<double>(3*num_quad_points);
 
 
 	  for (unsigned int q_point=0; q_point<num_quad_points; ++q_point)
@@ -89,9 +169,9 @@ double dftClass<FEOrder>::mixing_simple()
 
 	      if(dftParameters::xc_id == 4)
 		{
-		  ((*gradRhoInValues)[cell->id()][3*q_point + 0])= ((1-dftParameters::mixingParameter)*(gradRhoInValuesOld)[cell->id()][3*q_point + 0]+ dftParameters::mixingParameter*(*gradRhoOutValues)[cell->id()][3*q_point + 0]);
-		  ((*gradRhoInValues)[cell->id()][3*q_point + 1])= ((1-dftParameters::mixingParameter)*(gradRhoInValuesOld)[cell->id()][3*q_point + 1]+ dftParameters::mixingParameter*(*gradRhoOutValues)[cell->id()][3*q_point + 1]);
-		  ((*gradRhoInValues)[cell->id()][3*q_point + 2])= ((1-dftParameters::mixingParameter)*(gradRhoInValuesOld)[cell->id()][3*q_point + 2]+ dftParameters::mixingParameter*(*gradRhoOutValues)[cell->id()][3*q_point + 2]);
+		  ((*gradRhoInValues)[cell->id()][3*q_point + 0])= ((1-dftParameters::mixingParameter)*(*gradRhoInValuesOld)[cell->id()][3*q_point + 0]+ dftParameters::mixingParameter*(*gradRhoOutValues)[cell->id()][3*q_point + 0]);
+		  ((*gradRhoInValues)[cell->id()][3*q_point + 1])= ((1-dftParameters::mixingParameter)*(*gradRhoInValuesOld)[cell->id()][3*q_point + 1]+ dftParameters::mixingParameter*(*gradRhoOutValues)[cell->id()][3*q_point + 1]);
+		  ((*gradRhoInValues)[cell->id()][3*q_point + 2])= ((1-dftParameters::mixingParameter)*(*gradRhoInValuesOld)[cell->id()][3*q_point + 2]+ dftParameters::mixingParameter*(*gradRhoOutValues)[cell->id()][3*q_point + 2]);
 		}
 
 	    }
@@ -103,230 +183,253 @@ double dftClass<FEOrder>::mixing_simple()
   return Utilities::MPI::sum(normValue, mpi_communicator);
 }
 
-//implement anderson mixing scheme
+//Anderson mixing coefficients computed from the total electron-density histories. The history inner
+//products and the norm of the current residual are accumulated in a single sweep and reduced together
 template<unsigned int FEOrder>
-double dftClass<FEOrder>::mixing_anderson(){
-  double normValue=0.0;
-  QGauss<3>  quadrature(C_num1DQuad<FEOrder>());
-  FEValues<3> fe_values (FE, quadrature, update_JxW_values);
-  const unsigned int num_quad_points = quadrature.size();
-
+double dftClass<FEOrder>::computeAndersonMixingCoeffs(std::vector<double> & mixingCoeffs)
+{
+  const std::vector<const double *> rhoInFields=internal::historyFieldsData(rhoInVals);
+  const std::vector<const double *> rhoOutFields=internal::historyFieldsData(rhoOutVals);
 
   //initialize data structures
   int N = rhoOutVals.size()- 1;
-  //pcout << "\nN:" << N << "\n";
+
+  //
+  //fields: residual Fn of the current iteration and its differences with the previous residuals
+  //
+  auto residualFields=[&](const unsigned int iquad, double * values)
+    {
+      const double Fn=rhoOutFields[N][iquad]-rhoInFields[N][iquad];
+      values[0]=Fn;
+      for (int m=0; m<N; m++)
+	values[m+1]=Fn-(rhoOutFields[N-1-m][iquad]-rhoInFields[N-1-m][iquad]);
+    };
+
+  std::vector<double> innerProducts;
+  internal::computeFieldInnerProducts(d_rhoQuadJxWValues,
+				      N+1,
+				      residualFields,
+				      mpi_communicator,
+				      innerProducts);
+
+  //(rhoIn-rhoOut)^2
+  const double normValue=innerProducts[0];
+
+  mixingCoeffs.assign(N+1,0.0);
+  mixingCoeffs[N]=1.0;
+  if (N==0)
+    return normValue;
+
+  //fill coefficient matrix, rhs
   int NRHS=1, lda=N, ldb=N, info;
   std::vector<int> ipiv(N);
   std::vector<double> A(lda*N), c(ldb*NRHS);
-  for (int i=0; i<lda*N; i++) A[i]=0.0;
-  for (int i=0; i<ldb*NRHS; i++) c[i]=0.0;
-
-  //parallel loop over all elements
-  typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      fe_values.reinit (cell);
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point){
-	//fill coefficient matrix, rhs
-	double Fn=((rhoOutVals[N])[cell->id()][q_point])- ((rhoInVals[N])[cell->id()][q_point]);
-	for (int m=0; m<N; m++){
-	  double Fnm=((rhoOutVals[N-1-m])[cell->id()][q_point])- ((rhoInVals[N-1-m])[cell->id()][q_point]);
-	  for (int k=0; k<N; k++){
-	    double Fnk=((rhoOutVals[N-1-k])[cell->id()][q_point])- ((rhoInVals[N-1-k])[cell->id()][q_point]);
-	    A[k*N+m] += (Fn-Fnm)*(Fn-Fnk)*fe_values.JxW(q_point); // (m,k)^th entry
-	  }
-	  c[m] += (Fn-Fnm)*(Fn)*fe_values.JxW(q_point); // (m)^th entry
-	}
-      }
+  for (int m=0; m<N; m++)
+    {
+      for (int k=0; k<N; k++)
+	A[k*N+m]=innerProducts[(m+1)*(N+1)+k+1]; // (m,k)^th entry
+      c[m]=innerProducts[(m+1)*(N+1)]; // (m)^th entry
     }
-  }
-  //accumulate over all processors
-  std::vector<double> ATotal(lda*N), cTotal(ldb*NRHS);
-  MPI_Allreduce(&A[0], &ATotal[0], lda*N, MPI_DOUBLE, MPI_SUM, mpi_communicator);
-  MPI_Allreduce(&c[0], &cTotal[0], ldb*NRHS, MPI_DOUBLE, MPI_SUM, mpi_communicator);
-  //
-  //pcout << "A,c:" << ATotal[0] << " " << cTotal[0] << "\n";
+
   //solve for coefficients
-  dgesv_(&N, &NRHS, &ATotal[0], &lda, &ipiv[0], &cTotal[0], &ldb, &info);
+  dgesv_(&N, &NRHS, &A[0], &lda, &ipiv[0], &c[0], &ldb, &info);
   if((info > 0) && (this_mpi_process==0)) {
     printf( "Anderson Mixing: The diagonal element of the triangular factor of A,\n" );
     printf( "U(%i,%i) is zero, so that A is singular.\nThe solution could not be computed.\n", info, info );
     exit(1);
   }
   double cn=1.0;
-  for (int i=0; i<N; i++) cn-=cTotal[i];
-  if(this_mpi_process==0) {
-    //printf("\nAnderson mixing  c%u:%12.6e, ", N+1, cn);
-    //for (int i=0; i<N; i++) printf("c%u:%12.6e, ", N-i, cTotal[N-1-i]);
-    //printf("\n");
-  }
+  for (int i=0; i<N; i++) cn-=c[i];
 
-  //create new rhoValue tables
-  std::map<dealii::CellId,std::vector<double> > rhoInValuesOld= *rhoInValues;
-  rhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
-  rhoInValues=&(rhoInVals.back());
+  mixingCoeffs[N]=cn;
+  for (int i=0; i<N; i++)
+    mixingCoeffs[N-1-i]=c[i];
+
+  return normValue;
+}
+
+//implement anderson mixing scheme
+template<unsigned int FEOrder>
+double dftClass<FEOrder>::mixing_anderson(){
 
+  std::vector<double> mixingCoeffs;
+  const double normValue=computeAndersonMixingCoeffs(mixingCoeffs);
 
+  //
   //implement anderson mixing
-  cell = dofHandler.begin_active();
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      (*rhoInValues)[cell->id()]=std::vector<double>(num_quad_points);
-      fe_values.reinit (cell);
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point){
-	//Compute (rhoIn-rhoOut)^2
-        normValue+=std::pow((rhoInValuesOld)[cell->id()][q_point]-(*rhoOutValues)[cell->id()][q_point],2.0)*fe_values.JxW(q_point);
-	//Anderson mixing scheme
-	double rhoOutBar=cn*(rhoOutVals[N])[cell->id()][q_point];
-	double rhoInBar=cn*(rhoInVals[N])[cell->id()][q_point];
-	for (int i = 0; i < N; i++){
-	  rhoOutBar+=cTotal[i]*(rhoOutVals[N-1-i])[cell->id()][q_point];
-	  rhoInBar+=cTotal[i]*(rhoInVals[N-1-i])[cell->id()][q_point];
-	}
-	(*rhoInValues)[cell->id()][q_point]=std::abs((1-dftParameters::mixingParameter)*rhoInBar+dftParameters::mixingParameter*rhoOutBar);
-      }
-    }
+  //
+  {
+    const std::vector<const double *> rhoInFields=internal::historyFieldsData(rhoInVals);
+    const std::vector<const double *> rhoOutFields=internal::historyFieldsData(rhoOutVals);
+
+    //create new rhoValue tables
+    rhoInVals.push_back(d_rhoQuadDataLayout,rhoOutValues->nValuesPerCell());
+    rhoInValues=&(rhoInVals.back());
+
+    internal::andersonMixingUpdate(rhoInFields,
+				   rhoOutFields,
+				   mixingCoeffs,
+				   dftParameters::mixingParameter,
+				   true,
+				   rhoInValues->size(),
+				   rhoInValues->data());
   }
 
   //compute gradRho for GGA using mixing constants from rho mixing
-
-
   if(dftParameters::xc_id == 4)
     {
-      std::map<dealii::CellId,std::vector<double> > gradRhoInValuesOld=*gradRhoInValues;
-      gradRhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
-      gradRhoInValues=&(gradRhoInVals.back());
-      cell = dofHandler.begin_active();
-      for (; cell!=endc; ++cell)
-	{
-	  if (cell->is_locally_owned())
-	    {
-	      (*gradRhoInValues)[cell->id()]=std::vector<double>(3*num_quad_points);
-	      fe_values.reinit (cell);
-	      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point)
-		{
-		  //
-		  //Anderson mixing scheme
-		  //
-		  double gradRhoXOutBar = cn*(gradRhoOutVals[N])[cell->id()][3*q_point + 0];
-		  double gradRhoYOutBar = cn*(gradRhoOutVals[N])[cell->id()][3*q_point + 1];
-		  double gradRhoZOutBar = cn*(gradRhoOutVals[N])[cell->id()][3*q_point + 2];
+      const std::vector<const double *> gradRhoInFields=internal::historyFieldsData(gradRhoInVals);
+      const std::vector<const double *> gradRhoOutFields=internal::historyFieldsData(gradRhoOutVals);
 
-		  double gradRhoXInBar = cn*(gradRhoInVals[N])[cell->id()][3*q_point + 0];
-		  double gradRhoYInBar = cn*(gradRhoInVals[N])[cell->id()][3*q_point + 1];
-		  double gradRhoZInBar = cn*(gradRhoInVals[N])[cell->id()][3*q_point + 2];
+      gradRhoInVals.push_back(d_rhoQuadDataLayout,gradRhoOutValues->nValuesPerCell());
+      gradRhoInValues=&(gradRhoInVals.back());
 
-		  for (int i = 0; i < N; i++)
-		    {
-		      gradRhoXOutBar += cTotal[i]*(gradRhoOutVals[N-1-i])[cell->id()][3*q_point + 0];
-		      gradRhoYOutBar += cTotal[i]*(gradRhoOutVals[N-1-i])[cell->id()][3*q_point + 1];
-		      gradRhoZOutBar += cTotal[i]*(gradRhoOutVals[N-1-i])[cell->id()][3*q_point + 2];
+      internal::andersonMixingUpdate(gradRhoInFields,
+				     gradRhoOutFields,
+				     mixingCoeffs,
+				     dftParameters::mixingParameter,
+				     false,
+				     gradRhoInValues->size(),
+				     gradRhoInValues->data());
+    }
 
-		      gradRhoXInBar += cTotal[i]*(gradRhoInVals[N-1-i])[cell->id()][3*q_point + 0];
-		      gradRhoYInBar += cTotal[i]*(gradRhoInVals[N-1-i])[cell->id()][3*q_point + 1];
-		      gradRhoZInBar += cTotal[i]*(gradRhoInVals[N-1-i])[cell->id()][3*q_point + 2];
-		    }
+  return normValue;
+}
 
-		  (*gradRhoInValues)[cell->id()][3*q_point + 0] = ((1-dftParameters::mixingParameter)*gradRhoXInBar+dftParameters::mixingParameter*gradRhoXOutBar);
-		  (*gradRhoInValues)[cell->id()][3*q_point + 1] = ((1-dftParameters::mixingParameter)*gradRhoYInBar+dftParameters::mixingParameter*gradRhoYOutBar);
-		  (*gradRhoInValues)[cell->id()][3*q_point + 2] = ((1-dftParameters::mixingParameter)*gradRhoZInBar+dftParameters::mixingParameter*gradRhoZOutBar);
-		}
-	    }
 
-	}
-    }
+//implement Broyden mixing scheme
+template<unsigned int FEOrder>
+double dftClass<FEOrder>::mixing_broyden(){
+  return broydenMixing(false);
+}
 
 
 
-  return Utilities::MPI::sum(normValue, mpi_communicator);
+//implement Broyden mixing scheme
+template<unsigned int FEOrder>
+double dftClass<FEOrder>::mixing_broyden_spinPolarized(){
+  return broydenMixing(true);
 }
 
 
-//implement Broyden mixing scheme
+//Broyden mixing of the total electron-density or of the spin up and spin down electron-densities
 template<unsigned int FEOrder>
-double dftClass<FEOrder>::mixing_broyden(){
-  double normValue=0.0;
-  QGauss<3>  quadrature(C_num1DQuad<FEOrder>());
-  FEValues<3> fe_values (FE, quadrature, update_JxW_values);
-  const unsigned int num_quad_points = quadrature.size();
+double dftClass<FEOrder>::broydenMixing(const bool isSpinPolarized)
+{
+  const unsigned int numSpin=isSpinPolarized?2:1;
+  const bool isGradRhoMixed=dftParameters::xc_id == 4;
+  const unsigned int numQuadPointsTotal=d_rhoQuadJxWValues.size();
+  const unsigned int num_quad_points=QGauss<3>(C_num1DQuad<FEOrder>()).size();
+
+  dftUtils::cellQuadratureFieldHistory & rhoInHistory=isSpinPolarized?rhoInValsSpinPolarized:rhoInVals;
+  dftUtils::cellQuadratureFieldHistory & rhoOutHistory=isSpinPolarized?rhoOutValsSpinPolarized:rhoOutVals;
+  dftUtils::cellQuadratureFieldHistory & gradRhoInHistory=isSpinPolarized?gradRhoInValsSpinPolarized:gradRhoInVals;
+  dftUtils::cellQuadratureFieldHistory & gradRhoOutHistory=isSpinPolarized?gradRhoOutValsSpinPolarized:gradRhoOutVals;
   //
   int N = dFBroyden.size() + 1;
-  
+
   //
-  std::map<dealii::CellId,std::vector<double> >  delRho, delGradRho ;
-  dFBroyden.push_back(std::map<dealii::CellId,std::vector<double> >());
-  uBroyden.push_back(std::map<dealii::CellId,std::vector<double> >());
-  if (dftParameters::xc_id == 4)
+  delRhoBroyden.reinit(d_rhoQuadDataLayout,numSpin*num_quad_points);
+  if (N==1)
+    FBroyden.reinit(d_rhoQuadDataLayout,numSpin*num_quad_points);
+  dFBroyden.push_back(d_rhoQuadDataLayout,numSpin*num_quad_points);
+  uBroyden.push_back(d_rhoQuadDataLayout,numSpin*num_quad_points);
+  if (isGradRhoMixed)
     {
-     graddFBroyden.push_back(std::map<dealii::CellId,std::vector<double> >());
-     gradUBroyden.push_back(std::map<dealii::CellId,std::vector<double> >());
-    }	
-  //
-  double FOld ;
-  std::vector<double> gradFOld (3,0.0) ;
+     delGradRhoBroyden.reinit(d_rhoQuadDataLayout,3*numSpin*num_quad_points);
+     if (N==1)
+       gradFBroyden.reinit(d_rhoQuadDataLayout,3*numSpin*num_quad_points);
+     graddFBroyden.push_back(d_rhoQuadDataLayout,3*numSpin*num_quad_points);
+     gradUBroyden.push_back(d_rhoQuadDataLayout,3*numSpin*num_quad_points);
+    }
+
+  double * F=FBroyden.data();
+  double * delRho=delRhoBroyden.data();
+  double * dFNew=dFBroyden.back().data();
+  double * uNew=uBroyden.back().data();
+  const double * rhoIn0=rhoInHistory[0].data();
+  const double * rhoOut0=rhoOutHistory[0].data();
+  const double * rhoInNm1=rhoInHistory[N-1].data();
+  const double * rhoInN=rhoInHistory[N].data();
+  const double * rhoOutN=rhoOutHistory[N].data();
+  const double * rhoTotIn0=rhoInVals[0].data();
+  const double * rhoTotOut0=rhoOutVals[0].data();
+  const double * rhoTotInN=rhoInValues->data();
+  const double * rhoTotOutN=rhoOutValues->data();
+
+  double * gradF=NULL;
+  double * delGradRho=NULL;
+  double * graddFNew=NULL;
+  double * gradUNew=NULL;
+  const double * gradRhoIn0=NULL;
+  const double * gradRhoOut0=NULL;
+  const double * gradRhoInNm1=NULL;
+  const double * gradRhoInN=NULL;
+  const double * gradRhoOutN=NULL;
+  if (isGradRhoMixed)
+    {
+      gradF=gradFBroyden.data();
+      delGradRho=delGradRhoBroyden.data();
+      graddFNew=graddFBroyden.back().data();
+      gradUNew=gradUBroyden.back().data();
+      gradRhoIn0=gradRhoInHistory[0].data();
+      gradRhoOut0=gradRhoOutHistory[0].data();
+      gradRhoInNm1=gradRhoInHistory[N-1].data();
+      gradRhoInN=gradRhoInHistory[N].data();
+      gradRhoOutN=gradRhoOutHistory[N].data();
+    }
+
+  const std::vector<const double *> dFFields=internal::historyFieldsData(dFBroyden);
+
   //
-  //parallel loop over all elements
-  double dfMag = 0.0, dfMagLoc=0.0 ;
-  double wtTemp = 0.0, wtTempLoc=0.0 ;
-  double w0Loc = 0.0 ;
+  //single sweep updating the residual F, its change dF and the change of the input density, which
+  //also evaluates the spin summed fields F, dF_0,...,dF_{N-1}, the residual of the first iteration and
+  //rhoIn-rhoOut of the total density for the inner products
   //
-  typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      //
-      (dFBroyden[N-1])[cell->id()]=std::vector<double>(num_quad_points);
-      delRho[cell->id()]=std::vector<double>(num_quad_points);
-      if (N==1)
-	FBroyden[cell->id()]=std::vector<double>(num_quad_points);
-      //
-      if (dftParameters::xc_id == 4)
-        {
-	 (graddFBroyden[N-1])[cell->id()]=std::vector<double>(3*num_quad_points);
-         delGradRho[cell->id()]=std::vector<double>(3*num_quad_points);
-	 if (N==1)
-	    gradFBroyden[cell->id()]=std::vector<double>(3*num_quad_points);
+  const unsigned int numFields=N+3;
+  auto broydenFields=[&](const unsigned int iquad, double * values)
+    {
+      for (unsigned int ifield=0; ifield<numFields; ++ifield)
+	values[ifield]=0.0;
+
+      for (unsigned int ispin=0; ispin<numSpin; ++ispin)
+	{
+	  const unsigned int i=numSpin*iquad+ispin;
+	  const double FOld=(N==1)?(rhoOut0[i]-rhoIn0[i]):F[i];
+	  F[i] = rhoOutN[i]-rhoInN[i];
+	  delRho[i] = rhoInN[i]-rhoInNm1[i];
+	  dFNew[i] = F[i]-FOld;
+
+	  if (isGradRhoMixed)
+	    for (unsigned int dir=0; dir < 3; ++dir)
+	      {
+		const unsigned int j=3*i+dir;
+		const double gradFOld=(N==1)?(gradRhoOut0[j]-gradRhoIn0[j]):gradF[j];
+		gradF[j] = gradRhoOutN[j]-gradRhoInN[j];
+		delGradRho[j] = gradRhoInN[j]-gradRhoInNm1[j];
+		graddFNew[j] = gradF[j]-gradFOld;
+	      }
+
+	  values[0]+=F[i];
+	  for (int k=0; k<N; ++k)
+	    values[k+1]+=dFFields[k][i];
 	}
-      fe_values.reinit (cell);
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point){
-	if (N==1){
-	    FOld = ((rhoOutVals[0])[cell->id()][q_point])- ((rhoInVals[0])[cell->id()][q_point]);
-	    w0Loc += FOld * FOld * fe_values.JxW(q_point) ;
-	    if (dftParameters::xc_id == 4)
-		{
-		for (unsigned int dir=0; dir < 3; ++dir)
-		    gradFOld[dir]  = ((gradRhoOutVals[0])[cell->id()][3*q_point+dir])- ((gradRhoInVals[0])[cell->id()][3*q_point+dir]);
-		} 
-	    }
-	else
-	    {
-	     FOld  = FBroyden[cell->id()][q_point] ;
-	    if (dftParameters::xc_id == 4)
-		for (unsigned int dir=0; dir < 3; ++dir)
-		    gradFOld[dir]  = gradFBroyden[cell->id()][3*q_point+dir] ;
-	    }
-	//
-         FBroyden[cell->id()][q_point] = (rhoOutVals[N])[cell->id()][q_point]- (rhoInVals[N])[cell->id()][q_point];
-         delRho[cell->id()][q_point] = (rhoInVals[N])[cell->id()][q_point]- (rhoInVals[N-1])[cell->id()][q_point];
-	//	
-	(dFBroyden[N-1])[cell->id()][q_point] = FBroyden[cell->id()][q_point]- FOld;
-        if (dftParameters::xc_id == 4)
-	 {
-	  for (unsigned int dir=0; dir < 3; ++dir) {
-	  delGradRho[cell->id()][3*q_point+dir] = (gradRhoInVals[N])[cell->id()][3*q_point + dir]- (gradRhoInVals[N-1])[cell->id()][3*q_point+dir];
-          gradFBroyden[cell->id()][3*q_point+dir] = (gradRhoOutVals[N])[cell->id()][3*q_point + dir]- (gradRhoInVals[N])[cell->id()][3*q_point+dir];
-  	  (graddFBroyden[N-1])[cell->id()][3*q_point+dir] = gradFBroyden[cell->id()][3*q_point+dir]- gradFOld[dir];
-	  }
-	 }
-	dfMagLoc += (dFBroyden[N-1])[cell->id()][q_point] * (dFBroyden[N-1])[cell->id()][q_point] *fe_values.JxW(q_point);
-	wtTempLoc += FBroyden[cell->id()][q_point] * FBroyden[cell->id()][q_point] *fe_values.JxW(q_point) ;
-      }
-    }
-  }
-  //
-  wtTemp=Utilities::MPI::sum(wtTempLoc, mpi_communicator);
-  dfMag=Utilities::MPI::sum(dfMagLoc, mpi_communicator);
+
+      values[N+1]=rhoTotOut0[iquad]-rhoTotIn0[iquad];
+      values[N+2]=rhoTotInN[iquad]-rhoTotOutN[iquad];
+    };
+
+  std::vector<double> innerProducts;
+  internal::computeFieldInnerProducts(d_rhoQuadJxWValues,
+				      numFields,
+				      broydenFields,
+				      mpi_communicator,
+				      innerProducts);
+
+  const double dfMag=innerProducts[N*numFields+N];
+  double wtTemp=innerProducts[0];
   if (N==1) {
-    w0Broyden = Utilities::MPI::sum(w0Loc, mpi_communicator);
+    w0Broyden = innerProducts[(N+1)*numFields+N+1];
     w0Broyden = std::pow(w0Broyden, -0.5 ) ;
    }
   // Comment out following line, for using w0 computed from simply mixed rho (not recommended)
@@ -334,372 +437,116 @@ double dftClass<FEOrder>::mixing_broyden(){
   //
   wtTemp = std::pow(wtTemp, -0.5 ) ;
   //
-  // Comment out push_back(1.0) and uncomment push_back(wtTemp) to include history dependence in wtBroyden (not recommended) 
+  // Comment out push_back(1.0) and uncomment push_back(wtTemp) to include history dependence in wtBroyden (not recommended)
   //wtBroyden.push_back(wtTemp) ;
   wtBroyden.push_back(1.0) ;
-  //
+
+  //(rhoIn-rhoOut)^2
+  const double normValue=innerProducts[(N+2)*numFields+N+2];
   //
   double G = dftParameters::mixingParameter ;
   //
-  std::vector<double> c(N, 0.0) , invBeta(N*N, 0.0), beta(N*N, 0.0), gamma(N, 0.0), cLoc(N, 0.0) , invBetaLoc(N*N, 0.0) ; 
+  //the latest dF is normalized by dfMag below, which is accounted for in its inner products
   //
-  cell = dofHandler.begin_active(), endc = dofHandler.end();
-  for (; cell!=endc; ++cell)
-    if (cell->is_locally_owned())
-      {
-      (uBroyden[N-1])[cell->id()]=std::vector<double>(num_quad_points);
-      if (dftParameters::xc_id == 4)
-	(gradUBroyden[N-1])[cell->id()]=std::vector<double>(3*num_quad_points);
-      fe_values.reinit (cell);
-      //
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point)
-	  {
-	  (dFBroyden[N-1])[cell->id()][q_point] /= dfMag ;
-          delRho[cell->id()][q_point] /= dfMag ;
-          (uBroyden[N-1])[cell->id()][q_point] = G * (dFBroyden[N-1])[cell->id()][q_point] + delRho[cell->id()][q_point] ;
-          //
-          if (dftParameters::xc_id == 4)
-	    {
-		for (unsigned int dir=0; dir < 3; ++dir) {
-		    (graddFBroyden[N-1])[cell->id()][3*q_point+dir] /= dfMag ;
-		    delGradRho[cell->id()][3*q_point+dir] /= dfMag ;
-		    (gradUBroyden[N-1])[cell->id()][3*q_point+dir] = G * (graddFBroyden[N-1])[cell->id()][3*q_point+dir] + delGradRho[cell->id()][3*q_point+dir] ;
-		}
-	    }
-          //
-          for (unsigned int k = 0; k < N ; ++k) {
-              cLoc[k] += wtBroyden[k] * (dFBroyden[k])[cell->id()][q_point] * FBroyden[cell->id()][q_point] *fe_values.JxW(q_point);
-               for (unsigned int l = k; l < N ; ++l)
-                 {
-	          invBetaLoc[N*k + l] +=  wtBroyden[k] * wtBroyden[l] * (dFBroyden[k])[cell->id()][q_point] * (dFBroyden[l])[cell->id()][q_point] *fe_values.JxW(q_point);
-	          invBetaLoc[N*l + k] = invBetaLoc[N*k + l] ;
-                 }
-	     }
-	 }
-     }
-   //
-   for (unsigned int k = 0; k < N ; ++k) {
-   for (unsigned int l = 0; l < N ; ++l) {
-   invBeta[N*k + l]=Utilities::MPI::sum(invBetaLoc[N*k + l], mpi_communicator);
-   if (l==k) 
+  std::vector<double> c(N, 0.0) , invBeta(N*N, 0.0), beta(N*N, 0.0), gamma(N, 0.0) ;
+  for (int k = 0; k < N ; ++k)
+    {
+      const double scaleK=(k==N-1)?1.0/dfMag:1.0;
+      c[k]=wtBroyden[k]*scaleK*innerProducts[(k+1)*numFields];
+      for (int l = 0; l < N ; ++l)
 	{
-	 invBeta[N*l + l] = w0Broyden*w0Broyden + invBeta[N*l + l] ;
-	 beta[N*l + l] = 1.0 ;
+	  const double scaleL=(l==N-1)?1.0/dfMag:1.0;
+	  invBeta[N*k + l]=wtBroyden[k]*wtBroyden[l]*scaleK*scaleL*innerProducts[(k+1)*numFields+l+1];
 	}
-   }
-   c[k]=Utilities::MPI::sum(cLoc[k], mpi_communicator);
-   }
+      invBeta[N*k + k] = w0Broyden*w0Broyden + invBeta[N*k + k] ;
+      beta[N*k + k] = 1.0 ;
+    }
 
    //
    // Invert beta
    //
-    calldgesv(N,
+   calldgesv(N,
 	   &invBeta[0],
 	   &beta[0]);
 
-   
-   for (unsigned int m = 0; m < N ; ++m)
-	for (unsigned int l = 0; l < N ; ++l)
+   for (int m = 0; m < N ; ++m)
+	for (int l = 0; l < N ; ++l)
 	    gamma[m] += c[l] * beta[N*m + l] ;
+
   //
-  std::map<dealii::CellId,std::vector<double> > rhoInValuesOld= *rhoInValues;
-  rhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
-  rhoInValues=&(rhoInVals.back());
+  //create new rhoValue tables
   //
-  std::map<dealii::CellId,std::vector<double> > gradRhoInValuesOld ;
-  if (dftParameters::xc_id == 4)
+  const std::vector<const double *> uFields=internal::historyFieldsData(uBroyden);
+  const std::vector<const double *> gradUFields=internal::historyFieldsData(gradUBroyden);
+
+  rhoInVals.push_back(d_rhoQuadDataLayout,num_quad_points);
+  rhoInValues=&(rhoInVals.back());
+  if (isGradRhoMixed)
    {
-    gradRhoInValuesOld=*gradRhoInValues;
-    gradRhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
+    gradRhoInVals.push_back(d_rhoQuadDataLayout,3*num_quad_points);
     gradRhoInValues=&(gradRhoInVals.back());
    }
-  //
-  cell = dofHandler.begin_active();
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      (*rhoInValues)[cell->id()]=std::vector<double>(num_quad_points);
-      if (dftParameters::xc_id == 4)
-	(*gradRhoInValues)[cell->id()]=std::vector<double>(3*num_quad_points);
-      fe_values.reinit (cell);
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point){
-	//Compute (rhoIn-rhoOut)^2
-        normValue+=std::pow((rhoInValuesOld)[cell->id()][q_point]-(*rhoOutValues)[cell->id()][q_point],2.0)*fe_values.JxW(q_point);;
-        (*rhoInValues)[cell->id()][q_point] = rhoInValuesOld[cell->id()][q_point] + G * FBroyden[cell->id()][q_point] ;
-	if (dftParameters::xc_id == 4)
-	   for (unsigned int dir=0; dir < 3; ++dir) 
-		(*gradRhoInValues)[cell->id()][3*q_point + dir] = gradRhoInValuesOld[cell->id()][3*q_point + dir] + G * gradFBroyden[cell->id()][3*q_point+dir] ;
-	//
-	for (int i = 0; i < N; ++i){
-	  (*rhoInValues)[cell->id()][q_point] -=  wtBroyden[i] * gamma[i] * (uBroyden[i])[cell->id()][q_point] ;
-	  if (dftParameters::xc_id == 4)
-	   for (unsigned int dir=0; dir < 3; ++dir) 
-		(*gradRhoInValues)[cell->id()][3*q_point + dir] -= wtBroyden[i] * gamma[i] * (gradUBroyden[i])[cell->id()][3*q_point+dir] ;
-       }
-      }
-    }
-  }
-  //
-  //
-  
-
-
-
-  return Utilities::MPI::sum(normValue, mpi_communicator);
-}
 
+  if (isSpinPolarized)
+   {
+    rhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,2*num_quad_points);
+    rhoInValuesSpinPolarized=&(rhoInValsSpinPolarized.back());
+    if (isGradRhoMixed)
+     {
+      gradRhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,6*num_quad_points);
+      gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
+     }
+   }
 
+  double * rhoInNew=rhoInHistory.back().data();
+  double * gradRhoInNew=isGradRhoMixed?gradRhoInHistory.back().data():NULL;
 
-//implement Broyden mixing scheme
-template<unsigned int FEOrder>
-double dftClass<FEOrder>::mixing_broyden_spinPolarized(){
-  double normValue=0.0;
-  QGauss<3>  quadrature(C_num1DQuad<FEOrder>());
-  FEValues<3> fe_values (FE, quadrature, update_JxW_values);
-  const unsigned int num_quad_points = quadrature.size();
-  //
-  int N = dFBroyden.size() + 1;
-  //
-  std::map<dealii::CellId,std::vector<double> >  delRho, delGradRho ;
-  dFBroyden.push_back(std::map<dealii::CellId,std::vector<double> >());
-  uBroyden.push_back(std::map<dealii::CellId,std::vector<double> >());
-  if (dftParameters::xc_id == 4)
+  const unsigned int numValues=numSpin*numQuadPointsTotal;
+  for (unsigned int i=0; i<numValues; ++i)
     {
-     graddFBroyden.push_back(std::map<dealii::CellId,std::vector<double> >());
-     gradUBroyden.push_back(std::map<dealii::CellId,std::vector<double> >());
-    }	
-  //
-  double FOld ;
-  std::vector<double> gradFOld (3,0.0) ;
-  //
-  //parallel loop over all elements
-  double dfMag = 0.0, dfMagLoc=0.0 ;
-  double wtTemp = 0.0, wtTempLoc=0.0 ;
-  double w0Loc = 0.0 ;
-  //
-  typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      //
-      (dFBroyden[N-1])[cell->id()]=std::vector<double>(2*num_quad_points);
-      delRho[cell->id()]=std::vector<double>(2*num_quad_points);
-      if (N==1)
-	FBroyden[cell->id()]=std::vector<double>(2*num_quad_points);
-      //
-      if (dftParameters::xc_id == 4)
-        {
-	 (graddFBroyden[N-1])[cell->id()]=std::vector<double>(6*num_quad_points);
-         delGradRho[cell->id()]=std::vector<double>(6*num_quad_points);
-	 if (N==1)
-	    gradFBroyden[cell->id()]=std::vector<double>(6*num_quad_points);
-	}
-      fe_values.reinit (cell);
-      for (unsigned int q_point=0; q_point<2*num_quad_points; ++q_point){ // factor 2 due to spin splitting
-	if (N==1){
-	    FOld = ((rhoOutValsSpinPolarized[0])[cell->id()][q_point])- ((rhoInValsSpinPolarized[0])[cell->id()][q_point]);
-	    //w0Loc += FOld * FOld * fe_values.JxW(q_point) ;
-            //F[cell->id()]=std::vector<double>(num_quad_points);
-	    if (dftParameters::xc_id == 4)
-		{
-		//gradF[cell->id()]=std::vector<double>(6*num_quad_points);
-		for (unsigned int dir=0; dir < 3; ++dir)
-		    gradFOld[dir]  = ((gradRhoOutValsSpinPolarized[0])[cell->id()][3*q_point+dir])- ((gradRhoInValsSpinPolarized[0])[cell->id()][3*q_point+dir]);
-		} 
-	    }
-	else
-	    {
-	     FOld  = FBroyden[cell->id()][q_point] ;
-	    if (dftParameters::xc_id == 4)
-		for (unsigned int dir=0; dir < 3; ++dir)
-		    gradFOld[dir]  = gradFBroyden[cell->id()][3*q_point+dir] ;
-	    }
+      dFNew[i] /= dfMag ;
+      delRho[i] /= dfMag ;
+      uNew[i] = G * dFNew[i] + delRho[i] ;
 
-         FBroyden[cell->id()][q_point] = (rhoOutValsSpinPolarized[N])[cell->id()][q_point]- (rhoInValsSpinPolarized[N])[cell->id()][q_point];
-         delRho[cell->id()][q_point] = (rhoInValsSpinPolarized[N])[cell->id()][q_point]- (rhoInValsSpinPolarized[N-1])[cell->id()][q_point];
-	//	
-	(dFBroyden[N-1])[cell->id()][q_point] = FBroyden[cell->id()][q_point]- FOld;
-        if (dftParameters::xc_id == 4)
-	 {
-	  for (unsigned int dir=0; dir < 3; ++dir) {
-	  delGradRho[cell->id()][3*q_point+dir] = (gradRhoInValsSpinPolarized[N])[cell->id()][3*q_point + dir]- (gradRhoInValsSpinPolarized[N-1])[cell->id()][3*q_point+dir];
-          gradFBroyden[cell->id()][3*q_point+dir] = (gradRhoOutValsSpinPolarized[N])[cell->id()][3*q_point + dir]- (gradRhoInValsSpinPolarized[N])[cell->id()][3*q_point+dir];
-  	  (graddFBroyden[N-1])[cell->id()][3*q_point+dir] = gradFBroyden[cell->id()][3*q_point+dir]- gradFOld[dir];
-	  }
-	 }
-      }
-      //
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point)
+      double rhoInValue = rhoInN[i] + G * F[i] ;
+      for (int k = 0; k < N; ++k)
+	rhoInValue -= wtBroyden[k] * gamma[k] * uFields[k][i] ;
+      rhoInNew[i] = rhoInValue;
+
+      if (isGradRhoMixed)
+	for (unsigned int dir=0; dir < 3; ++dir)
 	  {
-	  dfMagLoc += ( ( (dFBroyden[N-1])[cell->id()][2*q_point]  + 
-			(dFBroyden[N-1])[cell->id()][2*q_point+1] ) * ( (dFBroyden[N-1])[cell->id()][2*q_point]  + (dFBroyden[N-1])[cell->id()][2*q_point+1] ) )  *fe_values.JxW(q_point);
-	  //
-	  wtTempLoc += ( (FBroyden[cell->id()][2*q_point] + FBroyden[cell->id()][2*q_point+1]) * ((FBroyden[cell->id()][2*q_point] + FBroyden[cell->id()][2*q_point+1]))) *fe_values.JxW(q_point) ;
-	  if (N==1){
-	    FOld = ((rhoOutVals[0])[cell->id()][q_point])- ((rhoInVals[0])[cell->id()][q_point]);
-	    w0Loc += FOld * FOld * fe_values.JxW(q_point) ;
-	   }
-	 }
+	    const unsigned int j=3*i+dir;
+	    graddFNew[j] /= dfMag ;
+	    delGradRho[j] /= dfMag ;
+	    gradUNew[j] = G * graddFNew[j] + delGradRho[j] ;
+
+	    double gradRhoInValue = gradRhoInN[j] + G * gradF[j] ;
+	    for (int k = 0; k < N; ++k)
+	      gradRhoInValue -= wtBroyden[k] * gamma[k] * gradUFields[k][j] ;
+	    gradRhoInNew[j] = gradRhoInValue;
+	  }
     }
-  }
-  //
-  wtTemp=Utilities::MPI::sum(wtTempLoc, mpi_communicator);
-  dfMag=Utilities::MPI::sum(dfMagLoc, mpi_communicator);
-  if (N==1) {
-    w0Broyden = Utilities::MPI::sum(w0Loc, mpi_communicator);
-    w0Broyden = std::pow(w0Broyden, -0.5 ) ;
-   }
-  // Comment out following line, for using w0 computed from simply mixed rho (not recommended)
-  w0Broyden = 0.0 ;
-  //
-  wtTemp = std::pow(wtTemp, -0.5 ) ;
-  //
-  // Comment out push_back(1.0) and uncomment push_back(wtTemp) to include history dependence in wtBroyden (not recommended) 
-  //wtBroyden.push_back(wtTemp) ;
-  wtBroyden.push_back(1.0) ;
-  //
-  double G = dftParameters::mixingParameter ;
-  //
-  std::vector<double> c(N, 0.0) , invBeta(N*N, 0.0), beta(N*N, 0.0), gamma(N, 0.0), cLoc(N, 0.0) , invBetaLoc(N*N, 0.0) ; 
-  //
-  cell = dofHandler.begin_active(), endc = dofHandler.end();
-  for (; cell!=endc; ++cell)
-    if (cell->is_locally_owned())
-      {
-      (uBroyden[N-1])[cell->id()]=std::vector<double>(2*num_quad_points);
-      if (dftParameters::xc_id == 4)
-	(gradUBroyden[N-1])[cell->id()]=std::vector<double>(6*num_quad_points);
-      fe_values.reinit (cell);
-      //
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point)
-	  {
-	  (dFBroyden[N-1])[cell->id()][2*q_point] /= dfMag ; (dFBroyden[N-1])[cell->id()][2*q_point+1] /= dfMag ;
-          delRho[cell->id()][2*q_point] /= dfMag ; delRho[cell->id()][2*q_point+1] /= dfMag ;
-	  //
-          (uBroyden[N-1])[cell->id()][2*q_point] = G * (dFBroyden[N-1])[cell->id()][2*q_point] + delRho[cell->id()][2*q_point] ;
-	  (uBroyden[N-1])[cell->id()][2*q_point+1] = G * (dFBroyden[N-1])[cell->id()][2*q_point+1] + delRho[cell->id()][2*q_point+1] ;
-          //
-          if (dftParameters::xc_id == 4)
-	    {
-		for (unsigned int dir=0; dir < 3; ++dir) {
-		    (graddFBroyden[N-1])[cell->id()][6*q_point+dir] /= dfMag ; (graddFBroyden[N-1])[cell->id()][6*q_point+3+dir] /= dfMag ;
-		    delGradRho[cell->id()][6*q_point+dir] /= dfMag ; delGradRho[cell->id()][6*q_point+3+dir] /= dfMag ;
-		    //
-		    (gradUBroyden[N-1])[cell->id()][6*q_point+dir] = G * (graddFBroyden[N-1])[cell->id()][6*q_point+dir] + delGradRho[cell->id()][6*q_point+dir] ;
-		    (gradUBroyden[N-1])[cell->id()][6*q_point+3+dir] = G * (graddFBroyden[N-1])[cell->id()][6*q_point+3+dir] + delGradRho[cell->id()][6*q_point+3+dir] ;
-		}
-	    }
-          //
-          for (unsigned int k = 0; k < N ; ++k) {
-              cLoc[k] += wtBroyden[k] * ( (dFBroyden[k])[cell->id()][2*q_point] + 
-			(dFBroyden[k])[cell->id()][2*q_point+1]) * ( FBroyden[cell->id()][2*q_point] + FBroyden[cell->id()][2*q_point+1] ) *fe_values.JxW(q_point);
-               for (unsigned int l = k; l < N ; ++l)
-                 {
-	          invBetaLoc[N*k + l] +=  wtBroyden[k] * wtBroyden[l] * ( (dFBroyden[k])[cell->id()][2*q_point] + (dFBroyden[k])[cell->id()][2*q_point+1]) * 
-							  ( (dFBroyden[l])[cell->id()][2*q_point] + (dFBroyden[l])[cell->id()][2*q_point+1]) *fe_values.JxW(q_point);
-	          invBetaLoc[N*l + k] = invBetaLoc[N*k + l] ;
-                 }
-	     }
-	 }
-     }
-   //
-   for (unsigned int k = 0; k < N ; ++k) {
-   for (unsigned int l = 0; l < N ; ++l) {
-   invBeta[N*k + l]=Utilities::MPI::sum(invBetaLoc[N*k + l], mpi_communicator);
-   //
-     if (l==k) 
-     {
-	invBeta[N*l + l] = w0Broyden*w0Broyden + invBeta[N*l + l] ;
-	beta[N*l + l] = 1.0 ;
-     }
-   }
-   c[k]=Utilities::MPI::sum(cLoc[k], mpi_communicator);
-   }
 
-   //
-   // Invert beta
-   //
-    calldgesv(N,
-	   &invBeta[0],
-	   &beta[0]);
-   //
-   
-   for (unsigned int m = 0; m < N ; ++m)
-	for (unsigned int l = 0; l < N ; ++l)
-	    gamma[m] += c[l] * beta[N*m + l] ;
+  if (isSpinPolarized)
+    {
+      double * rhoIn=rhoInValues->data();
+      for (unsigned int iquad=0; iquad<numQuadPointsTotal; ++iquad)
+	rhoIn[iquad] = rhoInNew[2*iquad] + rhoInNew[2*iquad+1] ;
 
-  //
-  std::map<dealii::CellId,std::vector<double> > rhoInValuesOld= *rhoInValues;
-  rhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
-  rhoInValues=&(rhoInVals.back());
-  //
-  std::map<dealii::CellId,std::vector<double> > rhoInValuesOldSpinPolarized= *rhoInValuesSpinPolarized;
-  rhoInValsSpinPolarized.push_back(std::map<dealii::CellId,std::vector<double> >());
-  rhoInValuesSpinPolarized=&(rhoInValsSpinPolarized.back());
-  //
-  std::map<dealii::CellId,std::vector<double> > gradRhoInValuesOld ;
-  std::map<dealii::CellId,std::vector<double> > gradRhoInValuesOldSpinPolarized ;
-  if (dftParameters::xc_id == 4)
-   {
-    gradRhoInValuesOld=*gradRhoInValues;
-    gradRhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
-    gradRhoInValues=&(gradRhoInVals.back());
-   //
-    gradRhoInValuesOldSpinPolarized=*gradRhoInValuesSpinPolarized;
-    gradRhoInValsSpinPolarized.push_back(std::map<dealii::CellId,std::vector<double> >());
-    gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
-   }
-  //
-  cell = dofHandler.begin_active();
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      (*rhoInValues)[cell->id()]=std::vector<double>(num_quad_points);
-      (*rhoInValuesSpinPolarized)[cell->id()]=std::vector<double>(2*num_quad_points);
-      if (dftParameters::xc_id == 4)
+      if (isGradRhoMixed)
 	{
-	(*gradRhoInValues)[cell->id()]=std::vector<double>(3*num_quad_points);
-	(*gradRhoInValuesSpinPolarized)[cell->id()]=std::vector<double>(6*num_quad_points);
+	  double * gradRhoIn=gradRhoInValues->data();
+	  for (unsigned int iquad=0; iquad<numQuadPointsTotal; ++iquad)
+	    for (unsigned int dir=0; dir < 3; ++dir)
+	      gradRhoIn[3*iquad+dir] = gradRhoInNew[6*iquad+dir] + gradRhoInNew[6*iquad+3+dir] ;
 	}
-      fe_values.reinit (cell);
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point){
-	//Compute (rhoIn-rhoOut)^2
-        normValue+=std::pow((rhoInValuesOld)[cell->id()][q_point]-(*rhoOutValues)[cell->id()][q_point],2.0)*fe_values.JxW(q_point);
-        (*rhoInValuesSpinPolarized)[cell->id()][2*q_point] = rhoInValuesOldSpinPolarized[cell->id()][2*q_point] + G * FBroyden[cell->id()][2*q_point] ;
-	(*rhoInValuesSpinPolarized)[cell->id()][2*q_point+1] = rhoInValuesOldSpinPolarized[cell->id()][2*q_point+1] + G * FBroyden[cell->id()][2*q_point+1] ;
-        //
-	if (dftParameters::xc_id == 4)
-	   for (unsigned int dir=0; dir < 3; ++dir) {
-		(*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + dir] = gradRhoInValuesOldSpinPolarized[cell->id()][6*q_point + dir] + G * gradFBroyden[cell->id()][6*q_point+dir] ;
-		(*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 3 + dir] = gradRhoInValuesOldSpinPolarized[cell->id()][6*q_point + 3 + dir] + G * gradFBroyden[cell->id()][6*q_point+3+dir] ;
-		}
-	//
-	for (int i = 0; i < N; ++i){
-	  (*rhoInValuesSpinPolarized)[cell->id()][2*q_point] -=  wtBroyden[i] * gamma[i] * (uBroyden[i])[cell->id()][2*q_point] ;
-	  (*rhoInValuesSpinPolarized)[cell->id()][2*q_point+1] -=  wtBroyden[i] * gamma[i] * (uBroyden[i])[cell->id()][2*q_point+1] ;
-	  if (dftParameters::xc_id == 4)
-	   for (unsigned int dir=0; dir < 3; ++dir) {
-		(*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + dir] -= wtBroyden[i] * gamma[i] * (gradUBroyden[i])[cell->id()][6*q_point+dir] ;
-		(*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 3 + dir] -= wtBroyden[i] * gamma[i] * (gradUBroyden[i])[cell->id()][6*q_point+3+dir] ;
-	   }
-       }
-	(*rhoInValues)[cell->id()][q_point] = (*rhoInValuesSpinPolarized)[cell->id()][2*q_point] + (*rhoInValuesSpinPolarized)[cell->id()][2*q_point+1] ;
-	if (dftParameters::xc_id == 4)
-	   for (unsigned int dir=0; dir < 3; ++dir)
-		(*gradRhoInValues)[cell->id()][3*q_point+dir] = (*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point+dir] + (*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point+3+dir]  ;
-
-
-      }
     }
-  }
-  //
-  //
-  
-
 
-
-  return Utilities::MPI::sum(normValue, mpi_communicator);
+  return normValue;
 }
 
 
-
 template<unsigned int FEOrder>
 double dftClass<FEOrder>::mixing_simple_spinPolarized()
 {
@@ -709,27 +556,27 @@ double dftClass<FEOrder>::mixing_simple_spinPolarized()
   const unsigned int num_quad_points = quadrature.size();
 
    //create new rhoValue tables
-  std::map<dealii::CellId,std::vector<double> > rhoInValuesOld= *rhoInValues;
-  rhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
+  const dftUtils::cellQuadratureField & rhoInValuesOld= *rhoInValues;
+  rhoInVals.push_back(d_rhoQuadDataLayout,num_quad_points);
   rhoInValues=&(rhoInVals.back());
 
-  std::map<dealii::CellId,std::vector<double> > rhoInValuesOldSpinPolarized= *rhoInValuesSpinPolarized;
-  rhoInValsSpinPolarized.push_back(std::map<dealii::CellId,std::vector<double> >());
+  const dftUtils::cellQuadratureField & rhoInValuesOldSpinPolarized= *rhoInValuesSpinPolarized;
+  rhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,2*num_quad_points);
   rhoInValuesSpinPolarized=&(rhoInValsSpinPolarized.back());
   //
 
   //create new gradRhoValue tables
-  std::map<dealii::CellId,std::vector<double> > gradRhoInValuesOld;
-  std::map<dealii::CellId,std::vector<double> > gradRhoInValuesOldSpinPolarized;
+  const dftUtils::cellQuadratureField * gradRhoInValuesOld=NULL;
+  const dftUtils::cellQuadratureField * gradRhoInValuesOldSpinPolarized=NULL;
 
   if(dftParameters::xc_id == 4)
     {
-      gradRhoInValuesOld=*gradRhoInValues;
-      gradRhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
+      gradRhoInValuesOld=gradRhoInValues;
+      gradRhoInVals.push_back(d_rhoQuadDataLayout,3*num_quad_points);
       gradRhoInValues=&(gradRhoInVals.back());
       //
-      gradRhoInValuesOldSpinPolarized=*gradRhoInValuesSpinPolarized;
-      gradRhoInValsSpinPolarized.push_back(std::map<dealii::CellId,std::vector<double> >());
+      gradRhoInValuesOldSpinPolarized=gradRhoInValuesSpinPolarized;
+      gradRhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,6*num_quad_points);
       gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
 
     }
@@ -742,14 +589,10 @@ double dftClass<FEOrder>::mixing_simple_spinPolarized()
 	{
 	  fe_values.reinit (cell);
 	  // if (s==0) {
-	  (*rhoInValuesSpinPolarized)[cell->id()]=std::vector<double>(2*num_quad_points);
-	  (*rhoInValues)[cell->id()]=std::vector<double>(num_quad_points);
 	  // }
 
 	  if(dftParameters::xc_id == 4)
 	    {
-	      (*gradRhoInValues)[cell->id()]=std::vector<double>(3*num_quad_points);
-	      (*gradRhoInValuesSpinPolarized)[cell->id()]=std::vector<double>(6*num_quad_points);
             }
 
 
@@ -773,7 +616,7 @@ double dftClass<FEOrder>::mixing_simple_spinPolarized()
 		  for (unsigned int i=0; i<6; ++i)
 		    {
 		      ((*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + i])=
-			((1-dftParameters::mixingParameter)*(gradRhoInValuesOldSpinPolarized)[cell->id()][6*q_point + i]+ dftParameters::mixingParameter*(*gradRhoOutValuesSpinPolarized)[cell->id()][6*q_point + i]);
+			((1-dftParameters::mixingParameter)*(*gradRhoInValuesOldSpinPolarized)[cell->id()][6*q_point + i]+ dftParameters::mixingParameter*(*gradRhoOutValuesSpinPolarized)[cell->id()][6*q_point + i]);
 		    }
 
 		  //
@@ -794,200 +637,273 @@ double dftClass<FEOrder>::mixing_simple_spinPolarized()
 //implement anderson mixing scheme
 template<unsigned int FEOrder>
 double dftClass<FEOrder>::mixing_anderson_spinPolarized(){
-  double normValue=0.0;
-  QGauss<3>  quadrature(C_num1DQuad<FEOrder>());
-  FEValues<3> fe_values (FE, quadrature,update_JxW_values);
-  const unsigned int num_quad_points = quadrature.size();
 
+  //
+  //mixing coefficients are computed from the total electron-density
+  //
+  std::vector<double> mixingCoeffs;
+  const double normValue=computeAndersonMixingCoeffs(mixingCoeffs);
 
+  const unsigned int numQuadPointsTotal=d_rhoQuadJxWValues.size();
 
-  //initialize data structures
-  int N = rhoOutVals.size()- 1;
-  //pcout << "\nN:" << N << "\n";
-  int NRHS=1, lda=N, ldb=N, info;
-  std::vector<int> ipiv(N);
-  std::vector<double> A(lda*N), c(ldb*NRHS);
-  for (int i=0; i<lda*N; i++) A[i]=0.0;
-  for (int i=0; i<ldb*NRHS; i++) c[i]=0.0;
-
-  //parallel loop over all elements
-  typename DoFHandler<3>::active_cell_iterator cell = dofHandler.begin_active(), endc = dofHandler.end();
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      fe_values.reinit (cell);
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point){
-	//fill coefficient matrix, rhs
-	double Fn=((rhoOutVals[N])[cell->id()][q_point])- ((rhoInVals[N])[cell->id()][q_point]);
-	for (int m=0; m<N; m++){
-	  double Fnm=((rhoOutVals[N-1-m])[cell->id()][q_point])- ((rhoInVals[N-1-m])[cell->id()][q_point]);
-	  for (int k=0; k<N; k++){
-	    double Fnk=((rhoOutVals[N-1-k])[cell->id()][q_point])- ((rhoInVals[N-1-k])[cell->id()][q_point]);
-	    A[k*N+m] += (Fn-Fnm)*(Fn-Fnk)*fe_values.JxW(q_point); // (m,k)^th entry
-	  }
-	  c[m] += (Fn-Fnm)*(Fn)*fe_values.JxW(q_point); // (m)^th entry
-	}
-      }
-    }
-  }
-  //accumulate over all processors
-  std::vector<double> ATotal(lda*N), cTotal(ldb*NRHS);
-  MPI_Allreduce(&A[0], &ATotal[0], lda*N, MPI_DOUBLE, MPI_SUM, mpi_communicator);
-  MPI_Allreduce(&c[0], &cTotal[0], ldb*NRHS, MPI_DOUBLE, MPI_SUM, mpi_communicator);
   //
-  //pcout << "A,c:" << ATotal[0] << " " << cTotal[0] << "\n";
-  //solve for coefficients
-  dgesv_(&N, &NRHS, &ATotal[0], &lda, &ipiv[0], &cTotal[0], &ldb, &info);
-  if((info > 0) && (this_mpi_process==0)) {
-    printf( "Anderson Mixing: The diagonal element of the triangular factor of A,\n" );
-    printf( "U(%i,%i) is zero, so that A is singular.\nThe solution could not be computed.\n", info, info );
-    exit(1);
-  }
-  double cn=1.0;
-  for (int i=0; i<N; i++) cn-=cTotal[i];
-  if(this_mpi_process==0) {
-    //printf("\nAnderson mixing  c%u:%12.6e, ", N+1, cn);
-    //for (int i=0; i<N; i++) printf("c%u:%12.6e, ", N-i, cTotal[N-1-i]);
-    //printf("\n");
+  //implement anderson mixing
+  //
+  {
+    const std::vector<const double *> rhoInFields=internal::historyFieldsData(rhoInValsSpinPolarized);
+    const std::vector<const double *> rhoOutFields=internal::historyFieldsData(rhoOutValsSpinPolarized);
+
+    //create new rhoValue tables
+    rhoInVals.push_back(d_rhoQuadDataLayout,rhoOutValues->nValuesPerCell());
+    rhoInValues=&(rhoInVals.back());
+
+    rhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,rhoOutValuesSpinPolarized->nValuesPerCell());
+    rhoInValuesSpinPolarized=&(rhoInValsSpinPolarized.back());
+
+    internal::andersonMixingUpdate(rhoInFields,
+				   rhoOutFields,
+				   mixingCoeffs,
+				   dftParameters::mixingParameter,
+				   true,
+				   rhoInValuesSpinPolarized->size(),
+				   rhoInValuesSpinPolarized->data());
+
+    const double * rhoInSpin=rhoInValuesSpinPolarized->data();
+    double * rhoIn=rhoInValues->data();
+    for (unsigned int iquad=0; iquad<numQuadPointsTotal; ++iquad)
+      rhoIn[iquad]=rhoInSpin[2*iquad]+rhoInSpin[2*iquad+1];
   }
 
-  //create new rhoValue tables
-  std::map<dealii::CellId,std::vector<double> > rhoInValuesOld= *rhoInValues;
-  rhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
-  rhoInValues=&(rhoInVals.back());
+  //compute gradRho for GGA using mixing constants from rho mixing
+  if(dftParameters::xc_id == 4)
+    {
+      const std::vector<const double *> gradRhoInFields=internal::historyFieldsData(gradRhoInValsSpinPolarized);
+      const std::vector<const double *> gradRhoOutFields=internal::historyFieldsData(gradRhoOutValsSpinPolarized);
 
-  //
-  std::map<dealii::CellId,std::vector<double> > rhoInValuesOldSpinPolarized= *rhoInValuesSpinPolarized;
-  rhoInValsSpinPolarized.push_back(std::map<dealii::CellId,std::vector<double> >());
-  rhoInValuesSpinPolarized=&(rhoInValsSpinPolarized.back());
+      gradRhoInVals.push_back(d_rhoQuadDataLayout,gradRhoOutValues->nValuesPerCell());
+      gradRhoInValues=&(gradRhoInVals.back());
 
-  //
-  //implement anderson mixing
-  cell = dofHandler.begin_active();
-  for (; cell!=endc; ++cell) {
-    if (cell->is_locally_owned()){
-      //if (s==0) {
-      (*rhoInValuesSpinPolarized)[cell->id()]=std::vector<double>(2*num_quad_points);
-      (*rhoInValues)[cell->id()]=std::vector<double>(num_quad_points);
-      //}
-      fe_values.reinit (cell);
-      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point){
-	//Compute (rhoIn-rhoOut)^2
-        //normValue+=std::pow((*rhoInValuesOld)[cell->id()][2*q_point+s]-(*rhoOutValues)[cell->id()][2*q_point+s],2.0)*fe_values.JxW(q_point);
-	//Anderson mixing scheme
-	//normValue+=std::pow((*rhoInValuesOldSpinPolarized)[cell->id()][2*q_point]-(*rhoOutValuesSpinPolarized)[cell->id()][2*q_point],2.0)*fe_values.JxW(q_point);
-	//normValue+=std::pow((*rhoInValuesOldSpinPolarized)[cell->id()][2*q_point+1]-(*rhoOutValuesSpinPolarized)[cell->id()][2*q_point+1],2.0)*fe_values.JxW(q_point);
-	normValue+=std::pow((rhoInValuesOld)[cell->id()][q_point]-(*rhoOutValues)[cell->id()][q_point],2.0)*fe_values.JxW(q_point);
-	double rhoOutBar1=cn*(rhoOutValsSpinPolarized[N])[cell->id()][2*q_point];
-	double rhoInBar1=cn*(rhoInValsSpinPolarized[N])[cell->id()][2*q_point];
-	for (int i = 0; i < N; i++){
-	  rhoOutBar1+=cTotal[i]*(rhoOutValsSpinPolarized[N-1-i])[cell->id()][2*q_point];
-	  rhoInBar1+=cTotal[i]*(rhoInValsSpinPolarized[N-1-i])[cell->id()][2*q_point];
-	}
-	(*rhoInValuesSpinPolarized)[cell->id()][2*q_point]=std::abs((1-dftParameters::mixingParameter)*rhoInBar1+dftParameters::mixingParameter*rhoOutBar1);
-	//
-        double rhoOutBar2=cn*(rhoOutValsSpinPolarized[N])[cell->id()][2*q_point+1];
-	double rhoInBar2=cn*(rhoInValsSpinPolarized[N])[cell->id()][2*q_point+1];
-	for (int i = 0; i < N; i++){
-	  rhoOutBar2+=cTotal[i]*(rhoOutValsSpinPolarized[N-1-i])[cell->id()][2*q_point+1];
-	  rhoInBar2+=cTotal[i]*(rhoInValsSpinPolarized[N-1-i])[cell->id()][2*q_point+1];
-	}
-	(*rhoInValuesSpinPolarized)[cell->id()][2*q_point+1]=std::abs((1-dftParameters::mixingParameter)*rhoInBar2+dftParameters::mixingParameter*rhoOutBar2);
-	//
-	//if (s==1)
-        //   {
-	//    (*rhoInValues)[cell->id()][q_point]+=(*rhoInValuesSpinPolarized)[cell->id()][2*q_point+s] ;
-        //     normValue+=std::pow((*rhoInValuesOld)[cell->id()][q_point]-(*rhoOutValues)[cell->id()][q_point],2.0)*fe_values.JxW(q_point);
-	//   }
-	//else
-	//    (*rhoInValues)[cell->id()][q_point]=(*rhoInValuesSpinPolarized)[cell->id()][2*q_point+s] ;
-	(*rhoInValues)[cell->id()][q_point]=(*rhoInValuesSpinPolarized)[cell->id()][2*q_point] + (*rhoInValuesSpinPolarized)[cell->id()][2*q_point+1] ;
-	//normValue+=std::pow((*rhoInValuesOld)[cell->id()][q_point]-(*rhoOutValues)[cell->id()][q_point],2.0)*fe_values.JxW(q_point);
-      }
+      gradRhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,gradRhoOutValuesSpinPolarized->nValuesPerCell());
+      gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
+
+      internal::andersonMixingUpdate(gradRhoInFields,
+				     gradRhoOutFields,
+				     mixingCoeffs,
+				     dftParameters::mixingParameter,
+				     false,
+				     gradRhoInValuesSpinPolarized->size(),
+				     gradRhoInValuesSpinPolarized->data());
+
+      const double * gradRhoInSpin=gradRhoInValuesSpinPolarized->data();
+      double * gradRhoIn=gradRhoInValues->data();
+      for (unsigned int iquad=0; iquad<numQuadPointsTotal; ++iquad)
+	for (unsigned int dir=0; dir < 3; ++dir)
+	  gradRhoIn[3*iquad+dir]=gradRhoInSpin[6*iquad+dir]+gradRhoInSpin[6*iquad+3+dir];
     }
-  }
 
-  //compute gradRho for GGA using mixing constants from rho mixing
+  return normValue;
+}
 
 
-  if(dftParameters::xc_id == 4)
+//implement anderson mixing scheme with Kerker preconditioning
+template<unsigned int FEOrder>
+double dftClass<FEOrder>::mixing_anderson_kerker(){
+  return andersonKerkerMixing(false);
+}
+
+
+//implement anderson mixing scheme with Kerker preconditioning
+template<unsigned int FEOrder>
+double dftClass<FEOrder>::mixing_anderson_kerker_spinPolarized(){
+  return andersonKerkerMixing(true);
+}
+
+
+//Anderson mixing with the Kerker preconditioner applied to the residual of the Anderson extrapolated
+//electron-densities. The spin up and spin down residuals are preconditioned separately
+template<unsigned int FEOrder>
+double dftClass<FEOrder>::andersonKerkerMixing(const bool isSpinPolarized)
+{
+  std::vector<double> mixingCoeffs;
+  const double normValue=computeAndersonMixingCoeffs(mixingCoeffs);
+
+  const unsigned int numSpin=isSpinPolarized?2:1;
+  const bool isGradRhoMixed=dftParameters::xc_id == 4;
+  const unsigned int numQuadPointsTotal=d_rhoQuadJxWValues.size();
+  const unsigned int num_quad_points=QGauss<3>(C_num1DQuad<FEOrder>()).size();
+  const unsigned int numFields=mixingCoeffs.size();
+
+  dftUtils::cellQuadratureFieldHistory & rhoInHistory=isSpinPolarized?rhoInValsSpinPolarized:rhoInVals;
+  dftUtils::cellQuadratureFieldHistory & rhoOutHistory=isSpinPolarized?rhoOutValsSpinPolarized:rhoOutVals;
+  dftUtils::cellQuadratureFieldHistory & gradRhoInHistory=isSpinPolarized?gradRhoInValsSpinPolarized:gradRhoInVals;
+  dftUtils::cellQuadratureFieldHistory & gradRhoOutHistory=isSpinPolarized?gradRhoOutValsSpinPolarized:gradRhoOutVals;
+
+  const std::vector<const double *> rhoInFields=internal::historyFieldsData(rhoInHistory);
+  const std::vector<const double *> rhoOutFields=internal::historyFieldsData(rhoOutHistory);
+  std::vector<const double *> gradRhoInFields, gradRhoOutFields;
+  if (isGradRhoMixed)
+    {
+      gradRhoInFields=internal::historyFieldsData(gradRhoInHistory);
+      gradRhoOutFields=internal::historyFieldsData(gradRhoOutHistory);
+    }
+
+  //
+  //create new rhoValue tables
+  //
+  rhoInVals.push_back(d_rhoQuadDataLayout,num_quad_points);
+  rhoInValues=&(rhoInVals.back());
+  if (isGradRhoMixed)
     {
-      std::map<dealii::CellId,std::vector<double> > gradRhoInValuesOld=*gradRhoInValues;
-      gradRhoInVals.push_back(std::map<dealii::CellId,std::vector<double> >());
+      gradRhoInVals.push_back(d_rhoQuadDataLayout,3*num_quad_points);
       gradRhoInValues=&(gradRhoInVals.back());
+    }
+
+  if (isSpinPolarized)
+    {
+      rhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,2*num_quad_points);
+      rhoInValuesSpinPolarized=&(rhoInValsSpinPolarized.back());
+      if (isGradRhoMixed)
+	{
+	  gradRhoInValsSpinPolarized.push_back(d_rhoQuadDataLayout,6*num_quad_points);
+	  gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
+	}
+    }
 
+  double * rhoInNew=rhoInHistory.back().data();
+  double * gradRhoInNew=isGradRhoMixed?gradRhoInHistory.back().data():NULL;
+
+  dftUtils::cellQuadratureField residualValues, gradResidualValues;
+  residualValues.reinit(d_rhoQuadDataLayout,num_quad_points);
+  if (isGradRhoMixed)
+    gradResidualValues.reinit(d_rhoQuadDataLayout,3*num_quad_points);
+
+  for (unsigned int ispin=0; ispin<numSpin; ++ispin)
+    {
       //
-      gradRhoInValsSpinPolarized.push_back(std::map<dealii::CellId,std::vector<double> >());
-      gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
+      //Anderson extrapolated input electron-density and residual
       //
-      cell = dofHandler.begin_active();
-      for (; cell!=endc; ++cell)
+      double * residual=residualValues.data();
+      double * gradResidual=isGradRhoMixed?gradResidualValues.data():NULL;
+      for (unsigned int iquad=0; iquad<numQuadPointsTotal; ++iquad)
 	{
-	  if (cell->is_locally_owned())
+	  const unsigned int i=numSpin*iquad+ispin;
+	  double rhoInBar=0.0, rhoOutBar=0.0;
+	  for (unsigned int j=0; j<numFields; ++j)
 	    {
-	      (*gradRhoInValues)[cell->id()]=std::vector<double>(3*num_quad_points);
-	      (*gradRhoInValuesSpinPolarized)[cell->id()]=std::vector<double>(6*num_quad_points);
-	      //
-	      fe_values.reinit (cell);
-	      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point)
-		{
-		  //
-		  //Anderson mixing scheme spin up
-		  //
-		  double gradRhoXOutBar1 = cn*(gradRhoOutValsSpinPolarized[N])[cell->id()][6*q_point + 0];
-		  double gradRhoYOutBar1 = cn*(gradRhoOutValsSpinPolarized[N])[cell->id()][6*q_point + 1];
-		  double gradRhoZOutBar1 = cn*(gradRhoOutValsSpinPolarized[N])[cell->id()][6*q_point + 2];
+	      rhoInBar+=mixingCoeffs[j]*rhoInFields[j][i];
+	      rhoOutBar+=mixingCoeffs[j]*rhoOutFields[j][i];
+	    }
+	  rhoInNew[i]=rhoInBar;
+	  residual[iquad]=rhoOutBar-rhoInBar;
+
+	  if (isGradRhoMixed)
+	    for (unsigned int dir=0; dir < 3; ++dir)
+	      {
+		double gradRhoInBar=0.0, gradRhoOutBar=0.0;
+		for (unsigned int j=0; j<numFields; ++j)
+		  {
+		    gradRhoInBar+=mixingCoeffs[j]*gradRhoInFields[j][3*i+dir];
+		    gradRhoOutBar+=mixingCoeffs[j]*gradRhoOutFields[j][3*i+dir];
+		  }
+		gradRhoInNew[3*i+dir]=gradRhoInBar;
+		gradResidual[3*iquad+dir]=gradRhoOutBar-gradRhoInBar;
+	      }
+	}
 
-		  double gradRhoXInBar1 = cn*(gradRhoInValsSpinPolarized[N])[cell->id()][6*q_point + 0];
-		  double gradRhoYInBar1 = cn*(gradRhoInValsSpinPolarized[N])[cell->id()][6*q_point + 1];
-		  double gradRhoZInBar1 = cn*(gradRhoInValsSpinPolarized[N])[cell->id()][6*q_point + 2];
+      applyKerkerPreconditioner(residualValues,
+				isGradRhoMixed?&gradResidualValues:NULL);
 
-		  for (int i = 0; i < N; i++)
-		    {
-		      gradRhoXOutBar1 += cTotal[i]*(gradRhoOutValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 0];
-		      gradRhoYOutBar1 += cTotal[i]*(gradRhoOutValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 1];
-		      gradRhoZOutBar1 += cTotal[i]*(gradRhoOutValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 2];
+      for (unsigned int iquad=0; iquad<numQuadPointsTotal; ++iquad)
+	{
+	  const unsigned int i=numSpin*iquad+ispin;
+	  rhoInNew[i]=std::abs(rhoInNew[i]+dftParameters::mixingParameter*residual[iquad]);
 
-		      gradRhoXInBar1 += cTotal[i]*(gradRhoInValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 0];
-		      gradRhoYInBar1 += cTotal[i]*(gradRhoInValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 1];
-		      gradRhoZInBar1 += cTotal[i]*(gradRhoInValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 2];
-		    }
-		  //
-		  //Anderson mixing scheme spin down
-		  //
-		  double gradRhoXOutBar2 = cn*(gradRhoOutValsSpinPolarized[N])[cell->id()][6*q_point + 3];
-		  double gradRhoYOutBar2 = cn*(gradRhoOutValsSpinPolarized[N])[cell->id()][6*q_point + 4];
-		  double gradRhoZOutBar2 = cn*(gradRhoOutValsSpinPolarized[N])[cell->id()][6*q_point + 5];
+	  if (isGradRhoMixed)
+	    for (unsigned int dir=0; dir < 3; ++dir)
+	      gradRhoInNew[3*i+dir]+=dftParameters::mixingParameter*gradResidual[3*iquad+dir];
+	}
+    }
 
-		  double gradRhoXInBar2 = cn*(gradRhoInValsSpinPolarized[N])[cell->id()][6*q_point + 3];
-		  double gradRhoYInBar2 = cn*(gradRhoInValsSpinPolarized[N])[cell->id()][6*q_point + 4];
-		  double gradRhoZInBar2 = cn*(gradRhoInValsSpinPolarized[N])[cell->id()][6*q_point + 5];
+  if (isSpinPolarized)
+    {
+      double * rhoIn=rhoInValues->data();
+      for (unsigned int iquad=0; iquad<numQuadPointsTotal; ++iquad)
+	rhoIn[iquad] = rhoInNew[2*iquad] + rhoInNew[2*iquad+1] ;
 
-		  for (int i = 0; i < N; i++)
-		    {
-		      gradRhoXOutBar2 += cTotal[i]*(gradRhoOutValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 3];
-		      gradRhoYOutBar2 += cTotal[i]*(gradRhoOutValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 4];
-		      gradRhoZOutBar2 += cTotal[i]*(gradRhoOutValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 5];
+      if (isGradRhoMixed)
+	{
+	  double * gradRhoIn=gradRhoInValues->data();
+	  for (unsigned int iquad=0; iquad<numQuadPointsTotal; ++iquad)
+	    for (unsigned int dir=0; dir < 3; ++dir)
+	      gradRhoIn[3*iquad+dir] = gradRhoInNew[6*iquad+dir] + gradRhoInNew[6*iquad+3+dir] ;
+	}
+    }
 
-		      gradRhoXInBar2 += cTotal[i]*(gradRhoInValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 3];
-		      gradRhoYInBar2 += cTotal[i]*(gradRhoInValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 4];
-		      gradRhoZInBar2 += cTotal[i]*(gradRhoInValsSpinPolarized[N-1-i])[cell->id()][6*q_point + 5];
-		    }
-		  //
-		  (*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 0] = ((1-dftParameters::mixingParameter)*gradRhoXInBar1+dftParameters::mixingParameter*gradRhoXOutBar1);
-		  (*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 1] = ((1-dftParameters::mixingParameter)*gradRhoYInBar1+dftParameters::mixingParameter*gradRhoYOutBar1);
-		  (*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 2] = ((1-dftParameters::mixingParameter)*gradRhoZInBar1+dftParameters::mixingParameter*gradRhoZOutBar1);
-		  (*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 3] = ((1-dftParameters::mixingParameter)*gradRhoXInBar2+dftParameters::mixingParameter*gradRhoXOutBar2);
-		  (*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 4] = ((1-dftParameters::mixingParameter)*gradRhoYInBar2+dftParameters::mixingParameter*gradRhoYOutBar2);
-		  (*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 5] = ((1-dftParameters::mixingParameter)*gradRhoZInBar2+dftParameters::mixingParameter*gradRhoZOutBar2);
+  return normValue;
+}
 
-		  ((*gradRhoInValues)[cell->id()][3*q_point + 0])= ((*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 0]) + ((*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 3]) ;
-		  ((*gradRhoInValues)[cell->id()][3*q_point + 1])= ((*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 1]) + ((*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 4]) ;
-		  ((*gradRhoInValues)[cell->id()][3*q_point + 2])= ((*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 2]) + ((*gradRhoInValuesSpinPolarized)[cell->id()][6*q_point + 5]) ;
-		}
-	    }
 
+template<unsigned int FEOrder>
+void dftClass<FEOrder>::applyKerkerPreconditioner(dftUtils::cellQuadratureField & residualValues,
+						  dftUtils::cellQuadratureField * gradResidualValues)
+{
+  //
+  //solve (1/4pi)(-\nabla^2+k^2) x = residual. The homogeneous Neumann or periodic boundary conditions
+  //of constraintsNone are used, for which the screened problem is non-singular
+  //
+  vectorType kerkerSolution;
+  matrix_free_data.initialize_dof_vector(kerkerSolution,densityDofHandlerIndex);
+
+  const std::map<dealii::types::global_dof_index, double> noAtoms;
+  poissonSolverProblem<FEOrder> kerkerSolverProblem(mpi_communicator);
+  kerkerSolverProblem.reinit(matrix_free_data,
+			     kerkerSolution,
+			     *d_constraintsVector[densityDofHandlerIndex],
+			     densityDofHandlerIndex,
+			     noAtoms,
+			     residualValues,
+			     true,
+			     dftParameters::kerkerParameter);
+
+  //the preconditioned residual is only used to compute the next input electron-density and
+  //hence does not require the tight tolerance of the electrostatic potential solves
+  dealiiLinearSolver dealiiCGSolver(mpi_communicator, dealiiLinearSolver::CG);
+  dealiiCGSolver.solve(kerkerSolverProblem,
+		       std::max(dftParameters::relLinearSolverTolerance,1e-8),
+		       dftParameters::maxLinearSolverIterations,
+		       dftParameters::verbosity);
+
+  //
+  //residual - k^2 (-\nabla^2+k^2)^{-1} residual = residual - (k^2/4pi) x
+  //
+  const double scalingFactor=dftParameters::kerkerParameter/(4.0*M_PI);
+  const bool isEvaluateGradient=gradResidualValues!=NULL;
+
+  FEEvaluation<3,FEOrder,C_num1DQuad<FEOrder>(),1> kerkerEval(matrix_free_data,densityDofHandlerIndex , 0);
+  const unsigned int numQuadPoints=kerkerEval.n_q_points;
+  for (unsigned int cell=0; cell<matrix_free_data.n_macro_cells(); ++cell)
+    {
+      kerkerEval.reinit(cell);
+      kerkerEval.read_dof_values_plain(kerkerSolution);
+      kerkerEval.evaluate(true,isEvaluateGradient);
+
+      const unsigned int numSubCells=matrix_free_data.n_components_filled(cell);
+      for (unsigned int q=0; q<numQuadPoints; ++q)
+	{
+	  const VectorizedArray<double> value=kerkerEval.get_value(q);
+	  Tensor<1,3,VectorizedArray<double> > gradient;
+	  if (isEvaluateGradient)
+	    gradient=kerkerEval.get_gradient(q);
+
+	  for (unsigned int iSubCell=0; iSubCell<numSubCells; ++iSubCell)
+	    {
+	      const unsigned int subCellIndex=d_rhoQuadDataLayout->cellIndex(cell,iSubCell);
+	      residualValues.cellData(subCellIndex)[q]-=scalingFactor*value[iSubCell];
+
+	      if (isEvaluateGradient)
+		for (unsigned int idim=0; idim<3; ++idim)
+		  gradResidualValues->cellData(subCellIndex)[3*q+idim]-=scalingFactor*gradient[idim][iSubCell];
+	    }
 	}
     }
-  return Utilities::MPI::sum(normValue, mpi_communicator);
 }
-
@@ -24,42 +24,51 @@ template<unsigned int FEOrder>
 void dftClass<FEOrder>::saveTriaInfoAndRhoData()
 {
      pcout<< "Checkpointing tria info and rho data in progress..." << std::endl;
-     std::vector<const std::map<dealii::CellId, std::vector<double> > *>  cellQuadDataContainerIn;
+     std::vector<const dftUtils::cellQuadratureField *>  cellQuadFieldsIn;
 
 
-     for(auto it = rhoInVals.cbegin(); it != rhoInVals.cend(); it++)
-	 cellQuadDataContainerIn.push_back(&(*it));
+     for(unsigned int i=0; i< rhoInVals.size(); i++)
+	 cellQuadFieldsIn.push_back(&rhoInVals[i]);
 
-     for(auto it = rhoOutVals.cbegin(); it != rhoOutVals.cend(); it++)
-	 cellQuadDataContainerIn.push_back(&(*it));
+     for(unsigned int i=0; i< rhoOutVals.size(); i++)
+	 cellQuadFieldsIn.push_back(&rhoOutVals[i]);
 
      if (dftParameters::xc_id==4)
      {
-         for(auto it = gradRhoInVals.cbegin(); it != gradRhoInVals.cend(); it++)
-	    cellQuadDataContainerIn.push_back(&(*it));
+         for(unsigned int i=0; i< gradRhoInVals.size(); i++)
+	    cellQuadFieldsIn.push_back(&gradRhoInVals[i]);
 
-         for(auto it = gradRhoOutVals.cbegin(); it != gradRhoOutVals.cend(); it++)
-	    cellQuadDataContainerIn.push_back(&(*it));
+         for(unsigned int i=0; i< gradRhoOutVals.size(); i++)
+	    cellQuadFieldsIn.push_back(&gradRhoOutVals[i]);
      }
 
      if(dftParameters::spinPolarized==1)
      {
-         for(auto it = rhoInValsSpinPolarized.cbegin(); it != rhoInValsSpinPolarized.cend(); it++)
-	    cellQuadDataContainerIn.push_back(&(*it));
+         for(unsigned int i=0; i< rhoInValsSpinPolarized.size(); i++)
+	    cellQuadFieldsIn.push_back(&rhoInValsSpinPolarized[i]);
 
-         for(auto it = rhoOutValsSpinPolarized.cbegin(); it != rhoOutValsSpinPolarized.cend(); it++)
-	    cellQuadDataContainerIn.push_back(&(*it));
+         for(unsigned int i=0; i< rhoOutValsSpinPolarized.size(); i++)
+	    cellQuadFieldsIn.push_back(&rhoOutValsSpinPolarized[i]);
 
      }
 
      if (dftParameters::xc_id==4 && dftParameters::spinPolarized==1)
      {
-         for(auto it = gradRhoInValsSpinPolarized.cbegin(); it != gradRhoInValsSpinPolarized.cend(); it++)
-	    cellQuadDataContainerIn.push_back(&(*it));
+         for(unsigned int i=0; i< gradRhoInValsSpinPolarized.size(); i++)
+	    cellQuadFieldsIn.push_back(&gradRhoInValsSpinPolarized[i]);
+
+         for(unsigned int i=0; i< gradRhoOutValsSpinPolarized.size(); i++)
+	    cellQuadFieldsIn.push_back(&gradRhoOutValsSpinPolarized[i]);
 
-         for(auto it = gradRhoOutValsSpinPolarized.cbegin(); it != gradRhoOutValsSpinPolarized.cend(); it++)
-	    cellQuadDataContainerIn.push_back(&(*it));
+     }
 
+     //convert to the cell id based storage used by the triangulation data attach functions
+     std::vector<std::map<dealii::CellId, std::vector<double> > > cellQuadDataMaps(cellQuadFieldsIn.size());
+     std::vector<const std::map<dealii::CellId, std::vector<double> > *>  cellQuadDataContainerIn;
+     for(unsigned int i=0; i< cellQuadFieldsIn.size(); i++)
+     {
+	 cellQuadFieldsIn[i]->copyTo(cellQuadDataMaps[i]);
+	 cellQuadDataContainerIn.push_back(&cellQuadDataMaps[i]);
      }
 
      d_mesh.saveTriangulationsCellQuadData(cellQuadDataContainerIn,
@@ -165,18 +174,30 @@ void dftClass<FEOrder>::loadTriaInfoAndRhoData()
      d_mesh.loadTriangulationsCellQuadData(cellQuadDataContainerOut,
 	                                   cellDataSizeContainer);
 
-     //Fill appropriate data structure using the read rho data
+     //Fill appropriate data structure using the read rho data. The cells are enumerated in the order of the
+     //loaded triangulation as matrix_free_data is not yet initialized. The data is later moved to
+     //d_rhoQuadDataLayout in remapRhoDataToCurrentLayout
+     std::shared_ptr<dftUtils::cellQuadratureFieldLayout> loadedRhoQuadDataLayout=std::make_shared<dftUtils::cellQuadratureFieldLayout>();
+     loadedRhoQuadDataLayout->reinit(d_mesh.getParallelMeshMoved());
+
+     std::vector<dftUtils::cellQuadratureField> cellQuadFieldsOut(cellQuadDataContainerOut.size());
+     for(unsigned int i=0; i< cellQuadDataContainerOut.size(); i++)
+     {
+	 cellQuadFieldsOut[i].reinit(loadedRhoQuadDataLayout,cellDataSizeContainer[i]);
+	 cellQuadFieldsOut[i].copyFrom(cellQuadDataContainerOut[i]);
+     }
+
      clearRhoData();
      unsigned int count=0;
      for(unsigned int i=0; i< mixingHistorySize; i++)
      {
-	 rhoInVals.push_back(cellQuadDataContainerOut[count]);
+	 rhoInVals.push_back(cellQuadFieldsOut[count]);
 	 count++;
      }
      rhoInValues=&(rhoInVals.back());
      for(unsigned int i=0; i< mixingHistorySize; i++)
      {
-	 rhoOutVals.push_back(cellQuadDataContainerOut[count]);
+	 rhoOutVals.push_back(cellQuadFieldsOut[count]);
 	 count++;
      }
      rhoOutValues=&(rhoOutVals.back());
@@ -185,13 +206,13 @@ void dftClass<FEOrder>::loadTriaInfoAndRhoData()
      {
 	 for(unsigned int i=0; i< mixingHistorySize; i++)
 	 {
-	     gradRhoInVals.push_back(cellQuadDataContainerOut[count]);
+	     gradRhoInVals.push_back(cellQuadFieldsOut[count]);
 	     count++;
 	 }
 	 gradRhoInValues= &(gradRhoInVals.back());
 	 for(unsigned int i=0; i< mixingHistorySize; i++)
 	 {
-	     gradRhoOutVals.push_back(cellQuadDataContainerOut[count]);
+	     gradRhoOutVals.push_back(cellQuadFieldsOut[count]);
 	     count++;
 	 }
 	 gradRhoOutValues= &(gradRhoOutVals.back());
@@ -201,13 +222,13 @@ void dftClass<FEOrder>::loadTriaInfoAndRhoData()
      {
 	 for(unsigned int i=0; i< mixingHistorySize; i++)
 	 {
-	     rhoInValsSpinPolarized.push_back(cellQuadDataContainerOut[count]);
+	     rhoInValsSpinPolarized.push_back(cellQuadFieldsOut[count]);
 	     count++;
 	 }
 	 rhoInValuesSpinPolarized=&(rhoInValsSpinPolarized.back());
 	 for(unsigned int i=0; i< mixingHistorySize; i++)
 	 {
-	     rhoOutValsSpinPolarized.push_back(cellQuadDataContainerOut[count]);
+	     rhoOutValsSpinPolarized.push_back(cellQuadFieldsOut[count]);
 	     count++;
 	 }
 	 rhoOutValuesSpinPolarized=&(rhoOutValsSpinPolarized.back());
@@ -217,13 +238,13 @@ void dftClass<FEOrder>::loadTriaInfoAndRhoData()
      {
 	 for(unsigned int i=0; i< mixingHistorySize; i++)
 	 {
-	     gradRhoInValsSpinPolarized.push_back(cellQuadDataContainerOut[count]);
+	     gradRhoInValsSpinPolarized.push_back(cellQuadFieldsOut[count]);
 	     count++;
 	 }
 	 gradRhoInValuesSpinPolarized=&(gradRhoInValsSpinPolarized.back());
 	 for(unsigned int i=0; i< mixingHistorySize; i++)
 	 {
-	     gradRhoOutValsSpinPolarized.push_back(cellQuadDataContainerOut[count]);
+	     gradRhoOutValsSpinPolarized.push_back(cellQuadFieldsOut[count]);
 	     count++;
 	 }
 	 gradRhoOutValuesSpinPolarized=&(gradRhoOutValsSpinPolarized.back());
@@ -16,11 +16,209 @@
 // @author Shiva Rudraraju, Phani Motamarri, Sambit Das
 //
 
-#include <dealiiLinearSolver.h>
 #include <poissonSolverProblem.h>
+#include <dealiiLinearSolver.h>
+#include <constants.h>
 
 namespace dftfe
 {
+    namespace internal
+    {
+      //
+      //Jacobi preconditioned conjugate gradient solve of the vself problems of all bins together. The bins are
+      //independent linear systems, so a separate CG recurrence is carried for each bin, but the matrix-free
+      //operator is applied to all the bins in a single cell loop and all the inner products of an iteration are
+      //done with a single MPI reduction. The latter uses the Chronopoulos-Gear formulation of CG, which computes
+      //both the inner products required by an iteration after the single matrix-vector product. Converged bins
+      //are frozen and skipped in the subsequent operator applications
+      //
+      template<unsigned int FEOrder>
+      void vselfBinsBlockCG(const dealii::MatrixFree<3,double> & matrixFreeData,
+			    std::vector<std::shared_ptr<poissonSolverProblem<FEOrder> > > & problems,
+			    std::vector<vectorType> & x,
+			    const double relTolerance,
+			    const unsigned int maxNumberIterations,
+			    const MPI_Comm & mpiComm,
+			    const unsigned int debugLevel)
+      {
+	const unsigned int numberBins=problems.size();
+	dealii::ConditionalOStream pcout(std::cout, (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0));
+
+	std::vector<vectorType> r(numberBins),u(numberBins),w(numberBins),p(numberBins),s(numberBins);
+	std::vector<double> gamma(numberBins,0.0),alpha(numberBins,0.0),beta(numberBins,0.0),tolerance(numberBins,0.0),residualNorm(numberBins,0.0);
+	std::vector<unsigned int> numberIterations(numberBins,0);
+	std::vector<bool> isConverged(numberBins,false);
+
+	//
+	//A*src for the unconverged bins of the block in one cell loop, using the cell level operator
+	//of the poisson solver problem of each bin
+	//
+	const std::function<void(const dealii::MatrixFree<3,double> &,
+				 std::vector<vectorType> &,
+				 const std::vector<vectorType> &,
+				 const std::pair<unsigned int,unsigned int> &)>
+	  AX=[&](const dealii::MatrixFree<3,double> & data,
+		 std::vector<vectorType> & dst,
+		 const std::vector<vectorType> & src,
+		 const std::pair<unsigned int,unsigned int> & cell_range)
+	     {
+	       for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+		 if (!isConverged[iBin])
+		   problems[iBin]->AX(data,
+				      dst[iBin],
+				      src[iBin],
+				      cell_range);
+	     };
+
+	auto blockVmult=[&](std::vector<vectorType> & dst,
+			    const std::vector<vectorType> & src)
+			{
+			  for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+			    if (!isConverged[iBin])
+			      dst[iBin]=0.0;
+			  matrixFreeData.cell_loop(AX,dst,src);
+			};
+
+	auto localDot=[](const vectorType & a,
+			 const vectorType & b)
+		      {
+			double sum=0.0;
+			for(unsigned int i = 0; i < a.local_size(); ++i)
+			  sum+=a.local_element(i)*b.local_element(i);
+			return sum;
+		      };
+
+	//
+	//initial residuals r=b-A*x, u=D^{-1}r and w=A*u
+	//
+	std::vector<double> localInnerProducts(4*numberBins,0.0);
+	for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	  {
+	    x[iBin].update_ghost_values();
+	    problems[iBin]->computeRhs(r[iBin]);
+	    localInnerProducts[4*iBin]=localDot(r[iBin],r[iBin]);
+	    u[iBin].reinit(x[iBin]);
+	    w[iBin].reinit(x[iBin]);
+	    p[iBin].reinit(x[iBin]);
+	    s[iBin].reinit(x[iBin]);
+	  }
+
+	blockVmult(s,x);
+	for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	  {
+	    r[iBin].add(-1.0,s[iBin]);
+	    problems[iBin]->precondition_Jacobi(u[iBin],r[iBin],1.0);
+	  }
+
+	blockVmult(w,u);
+	for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	  {
+	    localInnerProducts[4*iBin+1]=localDot(r[iBin],u[iBin]);
+	    localInnerProducts[4*iBin+2]=localDot(w[iBin],u[iBin]);
+	    localInnerProducts[4*iBin+3]=localDot(r[iBin],r[iBin]);
+	  }
+
+	MPI_Allreduce(MPI_IN_PLACE,
+		      &localInnerProducts[0],
+		      localInnerProducts.size(),
+		      MPI_DOUBLE,
+		      MPI_SUM,
+		      mpiComm);
+
+	unsigned int numberConverged=0;
+	for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	  {
+	    tolerance[iBin]=relTolerance*std::sqrt(localInnerProducts[4*iBin]);
+	    residualNorm[iBin]=std::sqrt(localInnerProducts[4*iBin+3]);
+	    gamma[iBin]=localInnerProducts[4*iBin+1];
+	    if (residualNorm[iBin]<=tolerance[iBin])
+	      {
+		isConverged[iBin]=true;
+		numberConverged++;
+	      }
+	    else
+	      alpha[iBin]=gamma[iBin]/localInnerProducts[4*iBin+2];
+	  }
+
+	localInnerProducts.resize(3*numberBins);
+	for(unsigned int iter = 0; iter < maxNumberIterations && numberConverged<numberBins; ++iter)
+	  {
+	    //
+	    //p=u+beta*p, s=w+beta*s, x=x+alpha*p, r=r-alpha*s and u=D^{-1}r
+	    //
+	    for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	      if (!isConverged[iBin])
+		{
+		  p[iBin].sadd(beta[iBin],1.0,u[iBin]);
+		  s[iBin].sadd(beta[iBin],1.0,w[iBin]);
+		  x[iBin].add(alpha[iBin],p[iBin]);
+		  r[iBin].add(-alpha[iBin],s[iBin]);
+		  problems[iBin]->precondition_Jacobi(u[iBin],r[iBin],1.0);
+		}
+
+	    blockVmult(w,u);
+
+	    std::fill(localInnerProducts.begin(),localInnerProducts.end(),0.0);
+	    for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	      if (!isConverged[iBin])
+		{
+		  localInnerProducts[3*iBin]=localDot(r[iBin],u[iBin]);
+		  localInnerProducts[3*iBin+1]=localDot(w[iBin],u[iBin]);
+		  localInnerProducts[3*iBin+2]=localDot(r[iBin],r[iBin]);
+		}
+
+	    MPI_Allreduce(MPI_IN_PLACE,
+			  &localInnerProducts[0],
+			  localInnerProducts.size(),
+			  MPI_DOUBLE,
+			  MPI_SUM,
+			  mpiComm);
+
+	    for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	      if (!isConverged[iBin])
+		{
+		  numberIterations[iBin]=iter+1;
+		  residualNorm[iBin]=std::sqrt(localInnerProducts[3*iBin+2]);
+		  if (residualNorm[iBin]<=tolerance[iBin])
+		    {
+		      isConverged[iBin]=true;
+		      numberConverged++;
+		      continue;
+		    }
+
+		  const double gammaNew=localInnerProducts[3*iBin];
+		  beta[iBin]=gammaNew/gamma[iBin];
+		  alpha[iBin]=gammaNew/(localInnerProducts[3*iBin+1]-beta[iBin]*gammaNew/alpha[iBin]);
+		  gamma[iBin]=gammaNew;
+		}
+	  }
+
+	AssertThrow(numberConverged==numberBins,dealii::ExcMessage("DFT-FE Error: Poisson solver did not converge as per set tolerances. consider increasing MAXIMUM ITERATIONS in Poisson problem parameters."));
+
+	for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	  {
+	    problems[iBin]->distributeX();
+	    x[iBin].update_ghost_values();
+	  }
+
+	if (debugLevel>=2)
+	  {
+	    pcout<<std::endl;
+	    char buffer[200];
+	    for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	      {
+		sprintf(buffer, "vself bin %u: current abs. residual: %12.6e, nsteps: %u, abs. tolerance criterion: %12.6e\n", \
+			iBin,							\
+			residualNorm[iBin],					\
+			numberIterations[iBin],					\
+			tolerance[iBin]);
+		pcout<<buffer;
+	      }
+	    pcout<<std::endl;
+	  }
+      }
+    }
+
     template<unsigned int FEOrder>
     void vselfBinsManager<FEOrder>::solveVselfInBins
                                     (const dealii::MatrixFree<3,double> & matrix_free_data,
@@ -30,36 +228,47 @@ namespace dftfe
 				     const std::vector<std::vector<double> > & imagePositions,
 				     const std::vector<int> & imageIds,
 				     const std::vector<double> &imageCharges,
-	                             std::vector<std::vector<double> > & localVselfs)
+	                             std::vector<std::vector<double> > & localVselfs,
+				     const bool usePreviousSolutionAsInitialGuess)
     {
       localVselfs.clear();
-      d_vselfFieldBins.clear();
       d_atomIdBinIdMapLocalAllImages.clear();
       //phiExt with nuclear charge
       //
       const unsigned int numberBins = d_boundaryFlagOnlyChargeId.size();
       const unsigned int numberGlobalCharges = d_atomLocations.size();
 
+      //
+      //the previous vself fields are only valid initial guesses if the atoms in each bin are unchanged
+      //
+      std::vector<vectorType> vselfFieldBinsPrevious;
+      vselfFieldBinsPrevious.swap(d_vselfFieldBins);
+      const bool isUsePreviousFields=usePreviousSolutionAsInitialGuess
+	                             && vselfFieldBinsPrevious.size()==numberBins
+				     && d_vselfFieldBinsAtomIds==d_bins;
+
+      if (isUsePreviousFields && dftParameters::verbosity>=2)
+	pcout<<"Using the previous vself fields as initial guesses for the vself bins solve"<<std::endl;
+
       phiExt = 0;
 
-      //set up poisson solver
-      dealiiLinearSolver dealiiCGSolver(mpi_communicator,dealiiLinearSolver::CG);
-      poissonSolverProblem<FEOrder> vselfSolverProblem(mpi_communicator);
+      //set up poisson solver problems of all bins
+      std::vector<std::shared_ptr<poissonSolverProblem<FEOrder> > > vselfSolverProblems(numberBins);
+      std::vector<vectorType> vselfBinsScratch(numberBins);
 
       std::map<dealii::types::global_dof_index, dealii::Point<3> > supportPoints;
       dealii::DoFTools::map_dofs_to_support_points(dealii::MappingQ1<3,3>(), matrix_free_data.get_dof_handler(offset), supportPoints);
 
+      std::map<dealii::types::global_dof_index,dealii::Point<3> >::iterator iterNodalCoorMap;
       std::map<dealii::types::global_dof_index, int>::iterator iterMap;
       std::map<dealii::types::global_dof_index, double>::iterator iterMapVal;
-      d_vselfFieldBins.resize(numberBins);
       for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
 	{
 	  const unsigned int constraintMatrixId = iBin + offset;
-	  vectorType vselfBinScratch;
+	  vectorType & vselfBinScratch = vselfBinsScratch[iBin];
 	  matrix_free_data.initialize_dof_vector(vselfBinScratch,constraintMatrixId);
 	  vselfBinScratch = 0;
 
-	  std::map<dealii::types::global_dof_index,dealii::Point<3> >::iterator iterNodalCoorMap;
 	  std::map<dealii::types::global_dof_index, double> & vSelfBinNodeMap = d_vselfBinField[iBin];
 
 	  //
@@ -69,6 +278,12 @@ namespace dftfe
 	      if(vselfBinScratch.in_local_range(iterNodalCoorMap->first)
 		  && !d_vselfBinConstraintMatrices[iBin].is_constrained(iterNodalCoorMap->first))
 		    {
+		      if (isUsePreviousFields)
+			{
+			  vselfBinScratch(iterNodalCoorMap->first) = vselfFieldBinsPrevious[iBin](iterNodalCoorMap->first);
+			  continue;
+			}
+
 		      iterMapVal = vSelfBinNodeMap.find(iterNodalCoorMap->first);
 		      if(iterMapVal != vSelfBinNodeMap.end())
 			  vselfBinScratch(iterNodalCoorMap->first) = iterMapVal->second;
@@ -78,21 +293,41 @@ namespace dftfe
 	  vselfBinScratch.compress(dealii::VectorOperation::insert);
 	  d_vselfBinConstraintMatrices[iBin].distribute(vselfBinScratch);
 
-	  //
-	  //call the poisson solver to compute vSelf in current bin
-	  //
-	  vselfSolverProblem.reinit(matrix_free_data,
-				    vselfBinScratch,
-				    d_vselfBinConstraintMatrices[iBin],
-				    constraintMatrixId,
-				    d_atomsInBin[iBin]);
-
-
-	  dealiiCGSolver.solve(vselfSolverProblem,
-			       dftParameters::relLinearSolverTolerance,
-			       dftParameters::maxLinearSolverIterations,
-			       dftParameters::verbosity);
+	  vselfSolverProblems[iBin]=std::make_shared<poissonSolverProblem<FEOrder> >(mpi_communicator);
+	  vselfSolverProblems[iBin]->reinit(matrix_free_data,
+					    vselfBinScratch,
+					    d_vselfBinConstraintMatrices[iBin],
+					    constraintMatrixId,
+					    d_atomsInBin[iBin]);
+	}
 
+      //
+      //call the poisson solver to compute vSelf in all bins together, or in each bin separately
+      //
+      if (dftParameters::vselfBlockCG)
+	internal::vselfBinsBlockCG(matrix_free_data,
+				   vselfSolverProblems,
+				   vselfBinsScratch,
+				   dftParameters::relLinearSolverTolerance,
+				   dftParameters::maxLinearSolverIterations,
+				   mpi_communicator,
+				   dftParameters::verbosity);
+      else
+	{
+	  dealiiLinearSolver dealiiCGSolver(mpi_communicator,dealiiLinearSolver::CG);
+	  for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	    dealiiCGSolver.solve(*vselfSolverProblems[iBin],
+				 dftParameters::relLinearSolverTolerance,
+				 dftParameters::maxLinearSolverIterations,
+				 dftParameters::verbosity);
+	}
+
+      vselfFieldBinsPrevious.clear();
+      d_vselfFieldBinsAtomIds=d_bins;
+      d_vselfFieldBins.resize(numberBins);
+      for(unsigned int iBin = 0; iBin < numberBins; ++iBin)
+	{
+	  const vectorType & vselfBinScratch = vselfBinsScratch[iBin];
 
 	  std::set<int> & atomsInBinSet = d_bins[iBin];
 	  std::vector<int> atomsInCurrentBin(atomsInBinSet.begin(),atomsInBinSet.end());
@@ -306,211 +306,332 @@ void kohnShamDFTOperatorClass<FEOrder>::computeNonLocalHamiltonianTimesX(const s
 }
 
 
-#ifdef USE_COMPLEX
+
 template<unsigned int FEOrder>
-void kohnShamDFTOperatorClass<FEOrder>::computeNonLocalHamiltonianTimesX(const dealii::parallel::distributed::Vector<std::complex<double> > & src,
-							   const unsigned int numberWaveFunctions,
-							   dealii::parallel::distributed::Vector<std::complex<double> >       & dst) const
+void kohnShamDFTOperatorClass<FEOrder>::computeNonLocalProjectorCellMatrices(const unsigned int kPointIndex)
 {
-
-  std::map<unsigned int, std::vector<std::complex<double> > > projectorKetTimesVector;
+  const unsigned int numberCells = dftPtr->d_nonLocalAtomIdsInElement.size();
 
   //
-  //allocate memory for matrix-vector product
+  //number the pseudo atomic wavefunctions of the nonlocal atoms in the current process contiguously,
+  //and store their ids in d_projectorKetTimesVectorParFlattened and their pseudopotential constants
   //
+  std::map<unsigned int, unsigned int> atomIdToProjectorStartIndex;
+  d_nonLocalProjectorIdsPar.clear();
+  d_nonLocalProjectorConstants.clear();
   for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInCurrentProcess.size(); ++iAtom)
     {
       const unsigned int atomId=dftPtr->d_nonLocalAtomIdsInCurrentProcess[iAtom];
-      const int numberSingleAtomPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-      projectorKetTimesVector[atomId].resize(numberWaveFunctions*numberSingleAtomPseudoWaveFunctions,0.0);
+      const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
+      atomIdToProjectorStartIndex[atomId]=d_nonLocalProjectorIdsPar.size();
+      for(unsigned int iPseudoAtomicWave = 0; iPseudoAtomicWave < numberPseudoWaveFunctions; ++iPseudoAtomicWave)
+	{
+	  d_nonLocalProjectorIdsPar.push_back(dftPtr->d_projectorIdsNumberingMapCurrentProcess[std::make_pair(atomId,iPseudoAtomicWave)]);
+	  d_nonLocalProjectorConstants.push_back(dftPtr->d_nonLocalPseudoPotentialConstants[atomId][iPseudoAtomicWave]);
+	}
     }
-
-
-  std::vector<std::complex<double> > cellWaveFunctionMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
+  const unsigned int numberProjectors = d_nonLocalProjectorIdsPar.size();
 
   //
-  //blas required settings
+  //list the cells with nonlocal atoms and the projectors of all the nonlocal atoms of each such cell
   //
-  const char transA = 'N';
-  const char transB = 'N';
-  const std::complex<double> alpha = 1.0;
-  const std::complex<double> beta = 1.0;
-  const unsigned int inc = 1;
-
-
-  typename DoFHandler<3>::active_cell_iterator cell = dftPtr->dofHandler.begin_active(), endc = dftPtr->dofHandler.end();
-  int iElem = -1;
-  for(; cell!=endc; ++cell)
+  d_nonLocalCellIds.clear();
+  d_nonLocalCellIndex.assign(numberCells,dealii::numbers::invalid_unsigned_int);
+  d_nonLocalCellProjectorStartIndex.assign(1,0);
+  d_nonLocalCellProjectorIds.clear();
+  for(unsigned int iElem = 0; iElem < numberCells; ++iElem)
     {
-      if(cell->is_locally_owned())
-	{
-	  iElem++;
-	  if (dftPtr->d_nonLocalAtomIdsInElement[iElem].size()>0)
-	  {
-	    for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
-	    {
-	      dealii::types::global_dof_index localNodeId = d_flattenedArrayCellLocalProcIndexIdMap[iElem][iNode];
-	      zcopy_(&numberWaveFunctions,
-		     src.begin()+localNodeId,
-		     &inc,
-		     &cellWaveFunctionMatrix[numberWaveFunctions*iNode],
-		     &inc);
-	    }
-	  }
-
-	  for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInElement[iElem].size();++iAtom)
-	    {
-	      const unsigned int atomId = dftPtr->d_nonLocalAtomIdsInElement[iElem][iAtom];
-	      const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-	      const int nonZeroElementMatrixId = dftPtr->d_sparsityPattern[atomId][iElem];
-
-	      zgemm_(&transA,
-		     &transB,
-		     &numberWaveFunctions,
-		     &numberPseudoWaveFunctions,
-		     &d_numberNodesPerElement,
-		     &alpha,
-		     &cellWaveFunctionMatrix[0],
-		     &numberWaveFunctions,
-		     &dftPtr->d_nonLocalProjectorElementMatricesConjugate[atomId][nonZeroElementMatrixId][d_kPointIndex][0],
-		     &d_numberNodesPerElement,
-		     &beta,
-		     &projectorKetTimesVector[atomId][0],
-		     &numberWaveFunctions);
-	    }
-
+      if(dftPtr->d_nonLocalAtomIdsInElement[iElem].size()==0)
+	continue;
 
+      d_nonLocalCellIndex[iElem]=d_nonLocalCellIds.size();
+      d_nonLocalCellIds.push_back(iElem);
+      for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInElement[iElem].size(); ++iAtom)
+	{
+	  const unsigned int atomId = dftPtr->d_nonLocalAtomIdsInElement[iElem][iAtom];
+	  const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
+	  const unsigned int projectorStartIndex = atomIdToProjectorStartIndex.find(atomId)->second;
+	  for(unsigned int iPseudoAtomicWave = 0; iPseudoAtomicWave < numberPseudoWaveFunctions; ++iPseudoAtomicWave)
+	    d_nonLocalCellProjectorIds.push_back(projectorStartIndex+iPseudoAtomicWave);
 	}
-
-    }//cell loop
-
-  dftPtr->d_projectorKetTimesVectorParFlattened=std::complex<double>(0.0,0.0);
-
-
-  for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInCurrentProcess.size(); ++iAtom)
-    {
-      const unsigned int atomId=dftPtr->d_nonLocalAtomIdsInCurrentProcess[iAtom];
-      const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-
-      for(unsigned int iPseudoAtomicWave = 0; iPseudoAtomicWave < numberPseudoWaveFunctions; ++iPseudoAtomicWave)
-      {
-        const unsigned int id=dftPtr->d_projectorIdsNumberingMapCurrentProcess[std::make_pair(atomId,iPseudoAtomicWave)];
-	zcopy_(&numberWaveFunctions,
-                &projectorKetTimesVector[atomId][numberWaveFunctions*iPseudoAtomicWave],
-                &inc,
-                &dftPtr->d_projectorKetTimesVectorParFlattened[id*numberWaveFunctions],
-                &inc);
-      }
+      d_nonLocalCellProjectorStartIndex.push_back(d_nonLocalCellProjectorIds.size());
     }
+  const unsigned int numberCellProjectors = d_nonLocalCellProjectorIds.size();
+
+  //
+  //concatenate the projector element matrices of the atoms of each cell into a single
+  //numberNodesPerElement x numberCellProjectors block, and the transposed element matrices
+  //into a single numberCellProjectors x numberNodesPerElement block
+  //
+  d_nonLocalCellProjectorMatrices.resize(d_numberNodesPerElement*numberCellProjectors);
+  d_nonLocalCellProjectorMatricesTranspose.resize(d_numberNodesPerElement*numberCellProjectors);
+  dealii::parallel::apply_to_subranges
+    (0U,
+     d_nonLocalCellIds.size(),
+     [&](const unsigned int iCellBegin, const unsigned int iCellEnd)
+     {
+       for(unsigned int iCell = iCellBegin; iCell < iCellEnd; ++iCell)
+	 {
+	   const unsigned int iElem = d_nonLocalCellIds[iCell];
+	   const unsigned int startIndex = d_nonLocalCellProjectorStartIndex[iCell];
+	   const unsigned int numberCellPseudoWaveFunctions = d_nonLocalCellProjectorStartIndex[iCell+1]-startIndex;
+	   dataTypes::number * cellProjectorMatrix = &d_nonLocalCellProjectorMatrices[d_numberNodesPerElement*startIndex];
+	   dataTypes::number * cellProjectorMatrixTranspose = &d_nonLocalCellProjectorMatricesTranspose[d_numberNodesPerElement*startIndex];
+
+	   unsigned int offset = 0;
+	   for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInElement[iElem].size(); ++iAtom)
+	     {
+	       const unsigned int atomId = dftPtr->d_nonLocalAtomIdsInElement[iElem][iAtom];
+	       const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
+	       const unsigned int iElemComp = dftPtr->d_sparsityPattern[atomId][iElem];
+#ifdef USE_COMPLEX
+	       const std::vector<dataTypes::number> & projectorMatrix = dftPtr->d_nonLocalProjectorElementMatricesConjugate[atomId][iElemComp][kPointIndex];
+#else
+	       const std::vector<dataTypes::number> & projectorMatrix = dftPtr->d_nonLocalProjectorElementMatrices[atomId][iElemComp][kPointIndex];
+#endif
+	       const std::vector<dataTypes::number> & projectorMatrixTranspose = dftPtr->d_nonLocalProjectorElementMatricesTranspose[atomId][iElemComp][kPointIndex];
 
+	       std::copy(projectorMatrix.begin(),
+			 projectorMatrix.begin()+d_numberNodesPerElement*numberPseudoWaveFunctions,
+			 cellProjectorMatrix+d_numberNodesPerElement*offset);
 
-  dftPtr->d_projectorKetTimesVectorParFlattened.compress(VectorOperation::add);
-  dftPtr->d_projectorKetTimesVectorParFlattened.update_ghost_values();
+	       for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+		 for(unsigned int iPseudoAtomicWave = 0; iPseudoAtomicWave < numberPseudoWaveFunctions; ++iPseudoAtomicWave)
+		   cellProjectorMatrixTranspose[numberCellPseudoWaveFunctions*iNode+offset+iPseudoAtomicWave]
+		     = projectorMatrixTranspose[numberPseudoWaveFunctions*iNode+iPseudoAtomicWave];
+
+	       offset += numberPseudoWaveFunctions;
+	     }
+	 }
+     },
+     1);
 
   //
-  //compute V*C^{T}*X
+  //columns of the cell blocks belonging to each projector, used to sum the cell contributions
+  //of C^{T}*X for a given projector
   //
-  for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInCurrentProcess.size(); ++iAtom)
-    {
-      const unsigned int atomId=dftPtr->d_nonLocalAtomIdsInCurrentProcess[iAtom];
-      const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-      for(unsigned int iPseudoAtomicWave = 0; iPseudoAtomicWave < numberPseudoWaveFunctions; ++iPseudoAtomicWave)
-      {
-	  std::complex<double> nonlocalConstantV;
-	  nonlocalConstantV.real(dftPtr->d_nonLocalPseudoPotentialConstants[atomId][iPseudoAtomicWave]);
-	  nonlocalConstantV.imag(0);
-
-          const unsigned int id=dftPtr->d_projectorIdsNumberingMapCurrentProcess[std::make_pair(atomId,iPseudoAtomicWave)];
+  d_nonLocalProjectorCellColumnStartIndex.assign(numberProjectors+1,0);
+  for(unsigned int iColumn = 0; iColumn < numberCellProjectors; ++iColumn)
+    d_nonLocalProjectorCellColumnStartIndex[d_nonLocalCellProjectorIds[iColumn]+1]++;
 
-	  zscal_(&numberWaveFunctions,
-		 &nonlocalConstantV,
-		 &dftPtr->d_projectorKetTimesVectorParFlattened[id*numberWaveFunctions],
-		 &inc);
+  for(unsigned int iProjector = 0; iProjector < numberProjectors; ++iProjector)
+    d_nonLocalProjectorCellColumnStartIndex[iProjector+1] += d_nonLocalProjectorCellColumnStartIndex[iProjector];
 
-	  zcopy_(&numberWaveFunctions,
-		 &dftPtr->d_projectorKetTimesVectorParFlattened[id*numberWaveFunctions],
-		 &inc,
-		 &projectorKetTimesVector[atomId][numberWaveFunctions*iPseudoAtomicWave],
-		 &inc);
-      }
+  std::vector<unsigned int> fillIndex(d_nonLocalProjectorCellColumnStartIndex.begin(),
+				      d_nonLocalProjectorCellColumnStartIndex.end()-1);
+  d_nonLocalProjectorCellColumns.resize(numberCellProjectors);
+  for(unsigned int iColumn = 0; iColumn < numberCellProjectors; ++iColumn)
+    d_nonLocalProjectorCellColumns[fillIndex[d_nonLocalCellProjectorIds[iColumn]]++] = iColumn;
+}
 
-    }
 
+#ifdef USE_COMPLEX
+template<unsigned int FEOrder>
+void kohnShamDFTOperatorClass<FEOrder>::computeNonLocalProjectorKetTimesXStart(const dealii::parallel::distributed::Vector<std::complex<double> > & src,
+								 const unsigned int numberWaveFunctions) const
+{
+  const unsigned int numberProjectors = d_nonLocalProjectorIdsPar.size();
+  const unsigned int numberCellProjectors = d_nonLocalCellProjectorIds.size();
 
-  std::vector<std::complex<double> > cellNonLocalHamTimesWaveMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
+  d_cellProjectorKetTimesVector.resize(numberWaveFunctions*numberCellProjectors);
 
+  //
   //blas required settings
-  const char transA1 = 'N';
-  const char transB1 = 'N';
-  const std::complex<double> alpha1 = 1.0;
-  const std::complex<double> beta1 = 0.0;
-  const unsigned int inc1 = 1;
-
   //
-  //compute C*V*C^{T}*x
+  const char transA = 'N';
+  const char transB = 'N';
+  const std::complex<double> alpha = 1.0;
+  const std::complex<double> beta = 0.0;
+  const unsigned int inc = 1;
+
   //
-  for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInCurrentProcess.size(); ++iAtom)
-    {
-      const unsigned int atomId = dftPtr->d_nonLocalAtomIdsInCurrentProcess[iAtom];
-      const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-       for(unsigned int iElemComp = 0; iElemComp < dftPtr->d_elementIteratorsInAtomCompactSupport[atomId].size(); ++iElemComp)
-	{
+  //compute C^{T}*X. The cells with nonlocal atoms are distributed among the threads, and the contributions
+  //of each cell to the projectors of all its nonlocal atoms are computed by a single gemm with the
+  //concatenated cell projector matrix
+  //
+  dealii::parallel::apply_to_subranges
+    (0U,
+     d_nonLocalCellIds.size(),
+     [&](const unsigned int iCellBegin, const unsigned int iCellEnd)
+     {
+       std::vector<std::complex<double> > cellWaveFunctionMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
+
+       for(unsigned int iCell = iCellBegin; iCell < iCellEnd; ++iCell)
+	 {
+	   const unsigned int elementId = d_nonLocalCellIds[iCell];
+	   const unsigned int startIndex = d_nonLocalCellProjectorStartIndex[iCell];
+	   const unsigned int numberCellPseudoWaveFunctions = d_nonLocalCellProjectorStartIndex[iCell+1]-startIndex;
+
+	   for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	     {
+	       dealii::types::global_dof_index localNodeId = d_flattenedArrayCellLocalProcIndexIdMap[elementId][iNode];
+	       zcopy_(&numberWaveFunctions,
+		      src.begin()+localNodeId,
+		      &inc,
+		      &cellWaveFunctionMatrix[numberWaveFunctions*iNode],
+		      &inc);
+	     }
+
+	   zgemm_(&transA,
+		  &transB,
+		  &numberWaveFunctions,
+		  &numberCellPseudoWaveFunctions,
+		  &d_numberNodesPerElement,
+		  &alpha,
+		  &cellWaveFunctionMatrix[0],
+		  &numberWaveFunctions,
+		  &d_nonLocalCellProjectorMatrices[d_numberNodesPerElement*startIndex],
+		  &d_numberNodesPerElement,
+		  &beta,
+		  &d_cellProjectorKetTimesVector[numberWaveFunctions*startIndex],
+		  &numberWaveFunctions);
+	 }
+     },
+     1);
 
-	  zgemm_(&transA1,
-	         &transB1,
-                 &numberWaveFunctions,
-                 &d_numberNodesPerElement,
-		 &numberPseudoWaveFunctions,
-		 &alpha1,
-		 &projectorKetTimesVector[atomId][0],
-		 &numberWaveFunctions,
-		 &dftPtr->d_nonLocalProjectorElementMatricesTranspose[atomId][iElemComp][d_kPointIndex][0],
-		 &numberPseudoWaveFunctions,
-		 &beta1,
-		 &cellNonLocalHamTimesWaveMatrix[0],
-		 &numberWaveFunctions);
+  dftPtr->d_projectorKetTimesVectorParFlattened=std::complex<double>(0.0,0.0);
 
-        unsigned int elementId =  dftPtr->d_elementIdsInAtomCompactSupport[atomId][iElemComp];
+  //
+  //sum the cell contributions of each projector. The projectors are distributed among the threads
+  //
+  dealii::parallel::apply_to_subranges
+    (0U,
+     numberProjectors,
+     [&](const unsigned int iProjectorBegin, const unsigned int iProjectorEnd)
+     {
+       for(unsigned int iProjector = iProjectorBegin; iProjector < iProjectorEnd; ++iProjector)
+	 {
+	   std::complex<double> * projectorKetTimesVectorPar = &dftPtr->d_projectorKetTimesVectorParFlattened[d_nonLocalProjectorIdsPar[iProjector]*numberWaveFunctions];
+	   for(unsigned int iColumn = d_nonLocalProjectorCellColumnStartIndex[iProjector]; iColumn < d_nonLocalProjectorCellColumnStartIndex[iProjector+1]; ++iColumn)
+	     zaxpy_(&numberWaveFunctions,
+		    &alpha,
+		    &d_cellProjectorKetTimesVector[numberWaveFunctions*d_nonLocalProjectorCellColumns[iColumn]],
+		    &inc,
+		    projectorKetTimesVectorPar,
+		    &inc);
+	 }
+     },
+     1);
+
+  //
+  //start the accumulation of the contributions from the other processors sharing the compact
+  //support of the nonlocal atoms, which is completed in computeNonLocalHamiltonianTimesXFinish
+  //
+  dftPtr->d_projectorKetTimesVectorParFlattened.compress_start(0,VectorOperation::add);
+}
 
-	for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
-	    {
-	      dealii::types::global_dof_index localNodeId = d_flattenedArrayCellLocalProcIndexIdMap[elementId][iNode];
-	      zaxpy_(&numberWaveFunctions,
-		     &alpha1,
-		     &cellNonLocalHamTimesWaveMatrix[numberWaveFunctions*iNode],
-		     &inc1,
-		     dst.begin()+localNodeId,
-		     &inc1);
-	    }
+template<unsigned int FEOrder>
+void kohnShamDFTOperatorClass<FEOrder>::computeNonLocalHamiltonianTimesXFinish(const unsigned int numberWaveFunctions,
+								 dealii::parallel::distributed::Vector<std::complex<double> > & dst) const
+{
+  const unsigned int numberProjectors = d_nonLocalProjectorIdsPar.size();
 
+  //
+  //blas required settings
+  //
+  const char transA = 'N';
+  const char transB = 'N';
+  const std::complex<double> alpha = 1.0;
+  const std::complex<double> beta = 0.0;
+  const unsigned int inc = 1;
 
-	}
+  dftPtr->d_projectorKetTimesVectorParFlattened.compress_finish(VectorOperation::add);
+  dftPtr->d_projectorKetTimesVectorParFlattened.update_ghost_values();
 
-    }
+  //
+  //compute V*C^{T}*X and copy it back into the cell blocks
+  //
+  dealii::parallel::apply_to_subranges
+    (0U,
+     numberProjectors,
+     [&](const unsigned int iProjectorBegin, const unsigned int iProjectorEnd)
+     {
+       for(unsigned int iProjector = iProjectorBegin; iProjector < iProjectorEnd; ++iProjector)
+	 {
+	   std::complex<double> nonlocalConstantV;
+	   nonlocalConstantV.real(d_nonLocalProjectorConstants[iProjector]);
+	   nonlocalConstantV.imag(0);
 
-}
-#else
-template<unsigned int FEOrder>
-void kohnShamDFTOperatorClass<FEOrder>::computeNonLocalHamiltonianTimesX(const dealii::parallel::distributed::Vector<double> & src,
-							   const unsigned int numberWaveFunctions,
-							   dealii::parallel::distributed::Vector<double>       & dst) const
-{
+	   std::complex<double> * projectorKetTimesVectorPar = &dftPtr->d_projectorKetTimesVectorParFlattened[d_nonLocalProjectorIdsPar[iProjector]*numberWaveFunctions];
 
+	   zscal_(&numberWaveFunctions,
+		  &nonlocalConstantV,
+		  projectorKetTimesVectorPar,
+		  &inc);
 
-  std::map<unsigned int, std::vector<double> > projectorKetTimesVector;
+	   for(unsigned int iColumn = d_nonLocalProjectorCellColumnStartIndex[iProjector]; iColumn < d_nonLocalProjectorCellColumnStartIndex[iProjector+1]; ++iColumn)
+	     zcopy_(&numberWaveFunctions,
+		    projectorKetTimesVectorPar,
+		    &inc,
+		    &d_cellProjectorKetTimesVector[numberWaveFunctions*d_nonLocalProjectorCellColumns[iColumn]],
+		    &inc);
+	 }
+     },
+     1);
 
   //
-  //allocate memory for matrix-vector product
+  //compute C*V*C^{T}*x. The elements are processed color by color, so that the threads
+  //working on the elements of a given color scatter into disjoint nodes of dst
   //
-  for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInCurrentProcess.size(); ++iAtom)
+  for(unsigned int iColor = 0; iColor < d_cellColoring.size(); ++iColor)
     {
-      const unsigned int atomId=dftPtr->d_nonLocalAtomIdsInCurrentProcess[iAtom];
-      const int numberSingleAtomPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-      projectorKetTimesVector[atomId].resize(numberWaveFunctions*numberSingleAtomPseudoWaveFunctions,0.0);
+      const std::vector<unsigned int> & cellsInColor = d_cellColoring[iColor];
+      dealii::parallel::apply_to_subranges
+	(0U,
+	 cellsInColor.size(),
+	 [&](const unsigned int iCellBegin, const unsigned int iCellEnd)
+	 {
+	   std::vector<std::complex<double> > cellNonLocalHamTimesWaveMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
+
+	   for(unsigned int iCell = iCellBegin; iCell < iCellEnd; ++iCell)
+	     {
+	       const unsigned int iElem = cellsInColor[iCell];
+	       const unsigned int nonLocalCellIndex = d_nonLocalCellIndex[iElem];
+	       if(nonLocalCellIndex==dealii::numbers::invalid_unsigned_int)
+		 continue;
+
+	       const unsigned int startIndex = d_nonLocalCellProjectorStartIndex[nonLocalCellIndex];
+	       const unsigned int numberCellPseudoWaveFunctions = d_nonLocalCellProjectorStartIndex[nonLocalCellIndex+1]-startIndex;
+
+	       zgemm_(&transA,
+		      &transB,
+		      &numberWaveFunctions,
+		      &d_numberNodesPerElement,
+		      &numberCellPseudoWaveFunctions,
+		      &alpha,
+		      &d_cellProjectorKetTimesVector[numberWaveFunctions*startIndex],
+		      &numberWaveFunctions,
+		      &d_nonLocalCellProjectorMatricesTranspose[d_numberNodesPerElement*startIndex],
+		      &numberCellPseudoWaveFunctions,
+		      &beta,
+		      &cellNonLocalHamTimesWaveMatrix[0],
+		      &numberWaveFunctions);
+
+	       for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+		 {
+		   dealii::types::global_dof_index localNodeId = d_flattenedArrayCellLocalProcIndexIdMap[iElem][iNode];
+		   zaxpy_(&numberWaveFunctions,
+			  &alpha,
+			  &cellNonLocalHamTimesWaveMatrix[numberWaveFunctions*iNode],
+			  &inc,
+			  dst.begin()+localNodeId,
+			  &inc);
+		 }
+	     }
+	 },
+	 1);
     }
 
+}
+#else
+template<unsigned int FEOrder>
+void kohnShamDFTOperatorClass<FEOrder>::computeNonLocalProjectorKetTimesXStart(const dealii::parallel::distributed::Vector<double > & src,
+								 const unsigned int numberWaveFunctions) const
+{
+  const unsigned int numberProjectors = d_nonLocalProjectorIdsPar.size();
+  const unsigned int numberCellProjectors = d_nonLocalCellProjectorIds.size();
 
-  std::vector<double> cellWaveFunctionMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
+  d_cellProjectorKetTimesVector.resize(numberWaveFunctions*numberCellProjectors);
 
   //
   //blas required settings
@@ -518,157 +639,183 @@ void kohnShamDFTOperatorClass<FEOrder>::computeNonLocalHamiltonianTimesX(const d
   const char transA = 'N';
   const char transB = 'N';
   const double alpha = 1.0;
-  const double beta = 1.0;
+  const double beta = 0.0;
   const unsigned int inc = 1;
 
-
-  typename DoFHandler<3>::active_cell_iterator cell = dftPtr->dofHandler.begin_active(), endc = dftPtr->dofHandler.end();
-  int iElem = -1;
-  for(; cell!=endc; ++cell)
-    {
-      if(cell->is_locally_owned())
-	{
-	  iElem++;
-	  if (dftPtr->d_nonLocalAtomIdsInElement[iElem].size()>0)
-	  {
-	    for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
-	    {
-	      dealii::types::global_dof_index localNodeId = d_flattenedArrayCellLocalProcIndexIdMap[iElem][iNode];
-	      dcopy_(&numberWaveFunctions,
-		     src.begin()+localNodeId,
-		     &inc,
-		     &cellWaveFunctionMatrix[numberWaveFunctions*iNode],
-		     &inc);
-	    }
-	  }
-
-	  for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInElement[iElem].size();++iAtom)
-	    {
-	      const unsigned int atomId = dftPtr->d_nonLocalAtomIdsInElement[iElem][iAtom];
-	      const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-	      const int nonZeroElementMatrixId = dftPtr->d_sparsityPattern[atomId][iElem];
-
-	      dgemm_(&transA,
-		     &transB,
-		     &numberWaveFunctions,
-		     &numberPseudoWaveFunctions,
-		     &d_numberNodesPerElement,
-		     &alpha,
-		     &cellWaveFunctionMatrix[0],
-		     &numberWaveFunctions,
-		     &dftPtr->d_nonLocalProjectorElementMatrices[atomId][nonZeroElementMatrixId][d_kPointIndex][0],
-		     &d_numberNodesPerElement,
-		     &beta,
-		     &projectorKetTimesVector[atomId][0],
-		     &numberWaveFunctions);
-	    }
-
-
-	}
-
-    }//cell loop
+  //
+  //compute C^{T}*X. The cells with nonlocal atoms are distributed among the threads, and the contributions
+  //of each cell to the projectors of all its nonlocal atoms are computed by a single gemm with the
+  //concatenated cell projector matrix
+  //
+  dealii::parallel::apply_to_subranges
+    (0U,
+     d_nonLocalCellIds.size(),
+     [&](const unsigned int iCellBegin, const unsigned int iCellEnd)
+     {
+       std::vector<double > cellWaveFunctionMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
+
+       for(unsigned int iCell = iCellBegin; iCell < iCellEnd; ++iCell)
+	 {
+	   const unsigned int elementId = d_nonLocalCellIds[iCell];
+	   const unsigned int startIndex = d_nonLocalCellProjectorStartIndex[iCell];
+	   const unsigned int numberCellPseudoWaveFunctions = d_nonLocalCellProjectorStartIndex[iCell+1]-startIndex;
+
+	   for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	     {
+	       dealii::types::global_dof_index localNodeId = d_flattenedArrayCellLocalProcIndexIdMap[elementId][iNode];
+	       dcopy_(&numberWaveFunctions,
+		      src.begin()+localNodeId,
+		      &inc,
+		      &cellWaveFunctionMatrix[numberWaveFunctions*iNode],
+		      &inc);
+	     }
+
+	   dgemm_(&transA,
+		  &transB,
+		  &numberWaveFunctions,
+		  &numberCellPseudoWaveFunctions,
+		  &d_numberNodesPerElement,
+		  &alpha,
+		  &cellWaveFunctionMatrix[0],
+		  &numberWaveFunctions,
+		  &d_nonLocalCellProjectorMatrices[d_numberNodesPerElement*startIndex],
+		  &d_numberNodesPerElement,
+		  &beta,
+		  &d_cellProjectorKetTimesVector[numberWaveFunctions*startIndex],
+		  &numberWaveFunctions);
+	 }
+     },
+     1);
 
   dftPtr->d_projectorKetTimesVectorParFlattened=0.0;
 
-  for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInCurrentProcess.size(); ++iAtom)
-    {
-      const unsigned int atomId=dftPtr->d_nonLocalAtomIdsInCurrentProcess[iAtom];
-      const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-
-      for(unsigned int iPseudoAtomicWave = 0; iPseudoAtomicWave < numberPseudoWaveFunctions; ++iPseudoAtomicWave)
-      {
-          const unsigned int id=dftPtr->d_projectorIdsNumberingMapCurrentProcess[std::make_pair(atomId,iPseudoAtomicWave)];
+  //
+  //sum the cell contributions of each projector. The projectors are distributed among the threads
+  //
+  dealii::parallel::apply_to_subranges
+    (0U,
+     numberProjectors,
+     [&](const unsigned int iProjectorBegin, const unsigned int iProjectorEnd)
+     {
+       for(unsigned int iProjector = iProjectorBegin; iProjector < iProjectorEnd; ++iProjector)
+	 {
+	   double * projectorKetTimesVectorPar = &dftPtr->d_projectorKetTimesVectorParFlattened[d_nonLocalProjectorIdsPar[iProjector]*numberWaveFunctions];
+	   for(unsigned int iColumn = d_nonLocalProjectorCellColumnStartIndex[iProjector]; iColumn < d_nonLocalProjectorCellColumnStartIndex[iProjector+1]; ++iColumn)
+	     daxpy_(&numberWaveFunctions,
+		    &alpha,
+		    &d_cellProjectorKetTimesVector[numberWaveFunctions*d_nonLocalProjectorCellColumns[iColumn]],
+		    &inc,
+		    projectorKetTimesVectorPar,
+		    &inc);
+	 }
+     },
+     1);
+
+  //
+  //start the accumulation of the contributions from the other processors sharing the compact
+  //support of the nonlocal atoms, which is completed in computeNonLocalHamiltonianTimesXFinish
+  //
+  dftPtr->d_projectorKetTimesVectorParFlattened.compress_start(0,VectorOperation::add);
+}
 
-          dcopy_(&numberWaveFunctions,
-                &projectorKetTimesVector[atomId][numberWaveFunctions*iPseudoAtomicWave],
-                &inc,
-                &dftPtr->d_projectorKetTimesVectorParFlattened[id*numberWaveFunctions],
-                &inc);
+template<unsigned int FEOrder>
+void kohnShamDFTOperatorClass<FEOrder>::computeNonLocalHamiltonianTimesXFinish(const unsigned int numberWaveFunctions,
+								 dealii::parallel::distributed::Vector<double > & dst) const
+{
+  const unsigned int numberProjectors = d_nonLocalProjectorIdsPar.size();
 
-      }
-    }
+  //
+  //blas required settings
+  //
+  const char transA = 'N';
+  const char transB = 'N';
+  const double alpha = 1.0;
+  const double beta = 0.0;
+  const unsigned int inc = 1;
 
-  dftPtr->d_projectorKetTimesVectorParFlattened.compress(VectorOperation::add);
+  dftPtr->d_projectorKetTimesVectorParFlattened.compress_finish(VectorOperation::add);
   dftPtr->d_projectorKetTimesVectorParFlattened.update_ghost_values();
 
   //
-  //compute V*C^{T}*X
+  //compute V*C^{T}*X and copy it back into the cell blocks
   //
-  for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInCurrentProcess.size(); ++iAtom)
-    {
-      const unsigned int atomId=dftPtr->d_nonLocalAtomIdsInCurrentProcess[iAtom];
-      const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-      for(unsigned int iPseudoAtomicWave = 0; iPseudoAtomicWave < numberPseudoWaveFunctions; ++iPseudoAtomicWave)
-	{
-	  double nonlocalConstantV=dftPtr->d_nonLocalPseudoPotentialConstants[atomId][iPseudoAtomicWave];
-
-          const unsigned int id=dftPtr->d_projectorIdsNumberingMapCurrentProcess[std::make_pair(atomId,iPseudoAtomicWave)];
+  dealii::parallel::apply_to_subranges
+    (0U,
+     numberProjectors,
+     [&](const unsigned int iProjectorBegin, const unsigned int iProjectorEnd)
+     {
+       for(unsigned int iProjector = iProjectorBegin; iProjector < iProjectorEnd; ++iProjector)
+	 {
+	   double nonlocalConstantV=d_nonLocalProjectorConstants[iProjector];
 
-	  dscal_(&numberWaveFunctions,
-		 &nonlocalConstantV,
-		 &dftPtr->d_projectorKetTimesVectorParFlattened[id*numberWaveFunctions],
-		 &inc);
+	   double * projectorKetTimesVectorPar = &dftPtr->d_projectorKetTimesVectorParFlattened[d_nonLocalProjectorIdsPar[iProjector]*numberWaveFunctions];
 
-	  dcopy_(&numberWaveFunctions,
-		 &dftPtr->d_projectorKetTimesVectorParFlattened[id*numberWaveFunctions],
-		 &inc,
-		 &projectorKetTimesVector[atomId][numberWaveFunctions*iPseudoAtomicWave],
-		 &inc);
+	   dscal_(&numberWaveFunctions,
+		  &nonlocalConstantV,
+		  projectorKetTimesVectorPar,
+		  &inc);
 
-	}
-
-    }
-
-
-  std::vector<double> cellNonLocalHamTimesWaveMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
-
-  //blas required settings
-  const char transA1 = 'N';
-  const char transB1 = 'N';
-  const double alpha1 = 1.0;
-  const double beta1 = 0.0;
-  const unsigned int inc1 = 1;
+	   for(unsigned int iColumn = d_nonLocalProjectorCellColumnStartIndex[iProjector]; iColumn < d_nonLocalProjectorCellColumnStartIndex[iProjector+1]; ++iColumn)
+	     dcopy_(&numberWaveFunctions,
+		    projectorKetTimesVectorPar,
+		    &inc,
+		    &d_cellProjectorKetTimesVector[numberWaveFunctions*d_nonLocalProjectorCellColumns[iColumn]],
+		    &inc);
+	 }
+     },
+     1);
 
   //
-  //compute C*V*C^{T}*x
+  //compute C*V*C^{T}*x. The elements are processed color by color, so that the threads
+  //working on the elements of a given color scatter into disjoint nodes of dst
   //
-  for(unsigned int iAtom = 0; iAtom < dftPtr->d_nonLocalAtomIdsInCurrentProcess.size(); ++iAtom)
+  for(unsigned int iColor = 0; iColor < d_cellColoring.size(); ++iColor)
     {
-      const unsigned int atomId = dftPtr->d_nonLocalAtomIdsInCurrentProcess[iAtom];
-      const unsigned int numberPseudoWaveFunctions = dftPtr->d_numberPseudoAtomicWaveFunctions[atomId];
-       for(unsigned int iElemComp = 0; iElemComp < dftPtr->d_elementIteratorsInAtomCompactSupport[atomId].size(); ++iElemComp)
-	{
-
-	  dgemm_(&transA1,
-	         &transB1,
-                 &numberWaveFunctions,
-                 &d_numberNodesPerElement,
-		 &numberPseudoWaveFunctions,
-		 &alpha1,
-		 &projectorKetTimesVector[atomId][0],
-		 &numberWaveFunctions,
-		 &dftPtr->d_nonLocalProjectorElementMatricesTranspose[atomId][iElemComp][d_kPointIndex][0],
-		 &numberPseudoWaveFunctions,
-		 &beta1,
-		 &cellNonLocalHamTimesWaveMatrix[0],
-		 &numberWaveFunctions);
-
-        unsigned int elementId =  dftPtr->d_elementIdsInAtomCompactSupport[atomId][iElemComp];
-
-	for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
-	    {
-	      dealii::types::global_dof_index localNodeId = d_flattenedArrayCellLocalProcIndexIdMap[elementId][iNode];
-	      daxpy_(&numberWaveFunctions,
-		     &alpha1,
-		     &cellNonLocalHamTimesWaveMatrix[numberWaveFunctions*iNode],
-		     &inc1,
-		     dst.begin()+localNodeId,
-		     &inc1);
-	    }
-
-
-	}
-
+      const std::vector<unsigned int> & cellsInColor = d_cellColoring[iColor];
+      dealii::parallel::apply_to_subranges
+	(0U,
+	 cellsInColor.size(),
+	 [&](const unsigned int iCellBegin, const unsigned int iCellEnd)
+	 {
+	   std::vector<double > cellNonLocalHamTimesWaveMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
+
+	   for(unsigned int iCell = iCellBegin; iCell < iCellEnd; ++iCell)
+	     {
+	       const unsigned int iElem = cellsInColor[iCell];
+	       const unsigned int nonLocalCellIndex = d_nonLocalCellIndex[iElem];
+	       if(nonLocalCellIndex==dealii::numbers::invalid_unsigned_int)
+		 continue;
+
+	       const unsigned int startIndex = d_nonLocalCellProjectorStartIndex[nonLocalCellIndex];
+	       const unsigned int numberCellPseudoWaveFunctions = d_nonLocalCellProjectorStartIndex[nonLocalCellIndex+1]-startIndex;
+
+	       dgemm_(&transA,
+		      &transB,
+		      &numberWaveFunctions,
+		      &d_numberNodesPerElement,
+		      &numberCellPseudoWaveFunctions,
+		      &alpha,
+		      &d_cellProjectorKetTimesVector[numberWaveFunctions*startIndex],
+		      &numberWaveFunctions,
+		      &d_nonLocalCellProjectorMatricesTranspose[d_numberNodesPerElement*startIndex],
+		      &numberCellPseudoWaveFunctions,
+		      &beta,
+		      &cellNonLocalHamTimesWaveMatrix[0],
+		      &numberWaveFunctions);
+
+	       for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+		 {
+		   dealii::types::global_dof_index localNodeId = d_flattenedArrayCellLocalProcIndexIdMap[iElem][iNode];
+		   daxpy_(&numberWaveFunctions,
+			  &alpha,
+			  &cellNonLocalHamTimesWaveMatrix[numberWaveFunctions*iNode],
+			  &inc,
+			  dst.begin()+localNodeId,
+			  &inc);
+		 }
+	     }
+	 },
+	 1);
     }
 
 }
@@ -36,15 +36,37 @@ void kohnShamDFTOperatorClass<FEOrder>::computeHamiltonianMatrix(unsigned int kP
 
   d_cellHamiltonianMatrixLowPrec.clear();
   d_cellHamiltonianMatrixLowPrec.resize(totalLocallyOwnedCells);
+
+  //
+  //the low precision copies of the cell-level hamiltonian matrices are only used
+  //in the mixed precision chebyshev filtering, which is only implemented for the real
+  //data type or with batch gemm
+  //
+#ifdef USE_COMPLEX
+  const bool storeLowPrecMatrices = dftParameters::useMixedPrecCheby && dftParameters::useBatchGEMM;
+#else
+  const bool storeLowPrecMatrices = dftParameters::useMixedPrecCheby;
+#endif
+
+  //
+  //group the nonlocal projector element matrices of the current k point by cell
+  //
+  if(dftParameters::isPseudopotential)
+    computeNonLocalProjectorCellMatrices(kPointIndex);
+
+  //
+  //the cell-level hamiltonian matrices are not required if the local hamiltonian
+  //is applied using matrix-free sum factorization
+  //
+  if(dftParameters::matrixFreeHamiltonian)
+    return;
+
   //
   //Get some FE related Data
   //
   QGauss<3> quadrature(C_num1DQuad<FEOrder>());
-  FEEvaluation<3, FEOrder, C_num1DQuad<FEOrder>(), 1, double>  fe_eval(dftPtr->matrix_free_data, 0, 0);
-  FEValues<3> fe_values(dftPtr->matrix_free_data.get_dof_handler().get_fe(), quadrature,update_gradients);
   const unsigned int numberDofsPerElement = dftPtr->matrix_free_data.get_dof_handler().get_fe().dofs_per_cell;
   const unsigned int numberQuadraturePoints = quadrature.size();
-  typename dealii::DoFHandler<3>::active_cell_iterator cellPtr;
 
   //
   //access the kPoint coordinates
@@ -58,133 +80,188 @@ void kohnShamDFTOperatorClass<FEOrder>::computeHamiltonianMatrix(unsigned int kP
   VectorizedArray<double> halfkSquare = make_vectorized_array(kSquareTimesHalf);
 #endif
 
+  //
+  //index of the first cell of each macrocell in the cell-level matrices
+  //
+  std::vector<unsigned int> macroCellStartIndex(numberMacroCells+1,0);
+  for(unsigned int iMacroCell = 0; iMacroCell < numberMacroCells; ++iMacroCell)
+    macroCellStartIndex[iMacroCell+1] = macroCellStartIndex[iMacroCell]+dftPtr->matrix_free_data.n_components_filled(iMacroCell);
+
   //
   //compute cell-level stiffness matrix by going over dealii macrocells
   //which allows efficient integration of cell-level stiffness matrix integrals
-  //using dealii vectorized arrays
-  unsigned int iElem = 0;
-  for(unsigned int iMacroCell = 0; iMacroCell < numberMacroCells; ++iMacroCell)
-    {
-      std::vector<VectorizedArray<double> > elementHamiltonianMatrix;
-      elementHamiltonianMatrix.resize(numberDofsPerElement*numberDofsPerElement);
-      fe_eval.reinit(iMacroCell);
-      const  unsigned int n_sub_cells = dftPtr->matrix_free_data.n_components_filled(iMacroCell);
-
-      for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
-	{
-	  for(unsigned int jNode = 0; jNode < numberDofsPerElement; ++jNode)
-	    {
-	      for(unsigned int q_point = 0; q_point < numberQuadraturePoints; ++q_point)
-		{
+  //using dealii vectorized arrays.
+  //The macrocells are distributed among the threads as the cell-level matrices
+  //of different macrocells are independent
+  //
+  dealii::parallel::apply_to_subranges
+    (0U,
+     numberMacroCells,
+     [&](const unsigned int macroCellBegin, const unsigned int macroCellEnd)
+     {
+       FEEvaluation<3, FEOrder, C_num1DQuad<FEOrder>(), 1, double>  fe_eval(dftPtr->matrix_free_data, 0, 0);
+       FEValues<3> fe_values(dftPtr->matrix_free_data.get_dof_handler().get_fe(), quadrature,update_gradients);
+       typename dealii::DoFHandler<3>::active_cell_iterator cellPtr;
+
+       for(unsigned int iMacroCell = macroCellBegin; iMacroCell < macroCellEnd; ++iMacroCell)
+	 {
+	   unsigned int iElem = macroCellStartIndex[iMacroCell];
+	   std::vector<VectorizedArray<double> > elementHamiltonianMatrix;
+	   elementHamiltonianMatrix.resize(numberDofsPerElement*numberDofsPerElement);
+	   fe_eval.reinit(iMacroCell);
+	   const  unsigned int n_sub_cells = dftPtr->matrix_free_data.n_components_filled(iMacroCell);
+
+	   for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
+	     {
+	       for(unsigned int jNode = 0; jNode < numberDofsPerElement; ++jNode)
+		 {
+		   for(unsigned int q_point = 0; q_point < numberQuadraturePoints; ++q_point)
+		     {
 
 #ifdef USE_COMPLEX
-		  VectorizedArray<double> temp = (vEff(iMacroCell,q_point)+halfkSquare)*make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*iNode+q_point])*make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*jNode+q_point]);
+		       VectorizedArray<double> temp = (vEff(iMacroCell,q_point)+halfkSquare)*make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*iNode+q_point])*make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*jNode+q_point]);
 #else
-		 VectorizedArray<double> temp = vEff(iMacroCell,q_point)*make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*iNode+q_point])*make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*jNode+q_point]);
+		      VectorizedArray<double> temp = vEff(iMacroCell,q_point)*make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*iNode+q_point])*make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*jNode+q_point]);
 #endif
-		  fe_eval.submit_value(temp,q_point);
-		}
+		       fe_eval.submit_value(temp,q_point);
+		     }
 
-	      elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode] = make_vectorized_array(0.5)*d_cellShapeFunctionGradientIntegral[iMacroCell][numberDofsPerElement*iNode + jNode] + fe_eval.integrate_value();
+		   elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode] = make_vectorized_array(0.5)*d_cellShapeFunctionGradientIntegral[iMacroCell][numberDofsPerElement*iNode + jNode] + fe_eval.integrate_value();
 
-	    }//jNode loop
+		 }//jNode loop
 
-	}//iNode loop
+	     }//iNode loop
 
-      std::vector<Tensor<1,3,VectorizedArray<double> > > nonCachedShapeGrad;
+	   std::vector<Tensor<1,3,VectorizedArray<double> > > nonCachedShapeGrad;
 
-      nonCachedShapeGrad.resize(numberDofsPerElement*numberQuadraturePoints);
-      for(unsigned int iCell = 0; iCell < n_sub_cells; ++iCell)
-      {
-	      cellPtr = dftPtr->matrix_free_data.get_cell_iterator(iMacroCell,iCell);
-	      fe_values.reinit(cellPtr);
+	   nonCachedShapeGrad.resize(numberDofsPerElement*numberQuadraturePoints);
+	   for(unsigned int iCell = 0; iCell < n_sub_cells; ++iCell)
+	   {
+		   cellPtr = dftPtr->matrix_free_data.get_cell_iterator(iMacroCell,iCell);
+		   fe_values.reinit(cellPtr);
 
-	      for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
-		  for(unsigned int q_point = 0; q_point < numberQuadraturePoints; ++q_point)
-		  {
-		      const Tensor<1,3,double> tempGrad=fe_values.shape_grad(iNode,q_point);
-		      for(unsigned int idim = 0; idim < 3; ++idim)
-		        nonCachedShapeGrad[iNode*numberQuadraturePoints+q_point][idim][iCell] =tempGrad[idim];
-		  }
-      }
+		   for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
+		       for(unsigned int q_point = 0; q_point < numberQuadraturePoints; ++q_point)
+		       {
+			   const Tensor<1,3,double> tempGrad=fe_values.shape_grad(iNode,q_point);
+			   for(unsigned int idim = 0; idim < 3; ++idim)
+			     nonCachedShapeGrad[iNode*numberQuadraturePoints+q_point][idim][iCell] =tempGrad[idim];
+		       }
+	   }
 
 #ifdef USE_COMPLEX
-      std::vector<VectorizedArray<double> > elementHamiltonianMatrixImag;
-      elementHamiltonianMatrixImag.resize(numberDofsPerElement*numberDofsPerElement);
-      //
-      for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
-	  for(unsigned int jNode = 0; jNode < numberDofsPerElement; ++jNode)
-	    {
-	      for(unsigned int q_point = 0; q_point < numberQuadraturePoints; ++q_point)
-		{
-		  const VectorizedArray<double> temp =
-		       scalar_product(nonCachedShapeGrad[iNode*numberQuadraturePoints+q_point],-kPointCoors)
-		       *make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*jNode+q_point]);
-
-		  fe_eval.submit_value(temp,q_point);
-		}
-
-	      elementHamiltonianMatrixImag[numberDofsPerElement*iNode + jNode] =  fe_eval.integrate_value();
-
-	    }//jNode loop
+	   std::vector<VectorizedArray<double> > elementHamiltonianMatrixImag;
+	   elementHamiltonianMatrixImag.resize(numberDofsPerElement*numberDofsPerElement);
+	   //
+	   for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
+	       for(unsigned int jNode = 0; jNode < numberDofsPerElement; ++jNode)
+		 {
+		   for(unsigned int q_point = 0; q_point < numberQuadraturePoints; ++q_point)
+		     {
+		       const VectorizedArray<double> temp =
+			    scalar_product(nonCachedShapeGrad[iNode*numberQuadraturePoints+q_point],-kPointCoors)
+			    *make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*jNode+q_point]);
+
+		       fe_eval.submit_value(temp,q_point);
+		     }
+
+		   elementHamiltonianMatrixImag[numberDofsPerElement*iNode + jNode] =  fe_eval.integrate_value();
+
+		 }//jNode loop
 #endif
 
 
 
-      if(dftParameters::xc_id == 4)
-	  for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
-	      for(unsigned int jNode = 0; jNode < numberDofsPerElement; ++jNode)
-		{
-		  for(unsigned int q_point = 0; q_point < numberQuadraturePoints; ++q_point)
-		    {
-		      const Tensor<1,3, VectorizedArray<double> > tempVec =
-			  nonCachedShapeGrad[iNode*numberQuadraturePoints+q_point]
-			  *make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*jNode+q_point])
-			  + nonCachedShapeGrad[jNode*numberQuadraturePoints+q_point]
-			    *make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*iNode+q_point]);
-
-		      const VectorizedArray<double> temp =
-			  make_vectorized_array(2.0)*scalar_product(derExcWithSigmaTimesGradRho(iMacroCell,q_point),tempVec);
-
-		      fe_eval.submit_value(temp,q_point);
-		    }
-
-		  elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode] +=  fe_eval.integrate_value();
-
-		}//jNode loop
-
-      for(unsigned int iSubCell = 0; iSubCell < n_sub_cells; ++iSubCell)
-	{
-	  //FIXME: Use functions like mkl_malloc for 64 byte memory alignment.
-	  d_cellHamiltonianMatrix[iElem].resize(numberDofsPerElement*numberDofsPerElement,0.0);
-	  d_cellHamiltonianMatrixLowPrec[iElem].resize(numberDofsPerElement*numberDofsPerElement,0.0);
-
-	  for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
-	    {
-	      for(unsigned int jNode = 0; jNode < numberDofsPerElement; ++jNode)
-		{
+	   if(dftParameters::xc_id == 4)
+	       for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
+		   for(unsigned int jNode = 0; jNode < numberDofsPerElement; ++jNode)
+		     {
+		       for(unsigned int q_point = 0; q_point < numberQuadraturePoints; ++q_point)
+			 {
+			   const Tensor<1,3, VectorizedArray<double> > tempVec =
+			       nonCachedShapeGrad[iNode*numberQuadraturePoints+q_point]
+			       *make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*jNode+q_point])
+			       + nonCachedShapeGrad[jNode*numberQuadraturePoints+q_point]
+				 *make_vectorized_array(d_shapeFunctionValue[numberQuadraturePoints*iNode+q_point]);
+
+			   const VectorizedArray<double> temp =
+			       make_vectorized_array(2.0)*scalar_product(derExcWithSigmaTimesGradRho(iMacroCell,q_point),tempVec);
+
+			   fe_eval.submit_value(temp,q_point);
+			 }
+
+		       elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode] +=  fe_eval.integrate_value();
+
+		     }//jNode loop
+
+	   for(unsigned int iSubCell = 0; iSubCell < n_sub_cells; ++iSubCell)
+	     {
+#ifndef USE_COMPLEX
+	       //
+	       //store the upper triangle of the symmetric cell-level hamiltonian matrix
+	       //in packed column major format
+	       //
+	       if(dftParameters::packedCellHamiltonianMatrices)
+		 {
+		   d_cellHamiltonianMatrix[iElem].resize(numberDofsPerElement*(numberDofsPerElement+1)/2,0.0);
+		   if(storeLowPrecMatrices)
+		     d_cellHamiltonianMatrixLowPrec[iElem].resize(numberDofsPerElement*(numberDofsPerElement+1)/2,0.0);
+
+		   unsigned int count = 0;
+		   for(unsigned int jNode = 0; jNode < numberDofsPerElement; ++jNode)
+		     for(unsigned int iNode = 0; iNode <= jNode; ++iNode)
+		       {
+			 d_cellHamiltonianMatrix[iElem][count]
+			   = elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell];
+
+			 if(storeLowPrecMatrices)
+			   d_cellHamiltonianMatrixLowPrec[iElem][count]
+			     = (dataTypes::numberLowPrec)elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell];
+
+			 count++;
+		       }
+
+		   iElem += 1;
+		   continue;
+		 }
+#endif
+	       //FIXME: Use functions like mkl_malloc for 64 byte memory alignment.
+	       d_cellHamiltonianMatrix[iElem].resize(numberDofsPerElement*numberDofsPerElement,0.0);
+	       if(storeLowPrecMatrices)
+		 d_cellHamiltonianMatrixLowPrec[iElem].resize(numberDofsPerElement*numberDofsPerElement,0.0);
+
+	       for(unsigned int iNode = 0; iNode < numberDofsPerElement; ++iNode)
+		 {
+		   for(unsigned int jNode = 0; jNode < numberDofsPerElement; ++jNode)
+		     {
 #ifdef USE_COMPLEX
-		  d_cellHamiltonianMatrix[iElem][numberDofsPerElement*iNode + jNode].real(elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell]);
-		  d_cellHamiltonianMatrix[iElem][numberDofsPerElement*iNode + jNode].imag(elementHamiltonianMatrixImag[numberDofsPerElement*iNode + jNode][iSubCell]);
+		       d_cellHamiltonianMatrix[iElem][numberDofsPerElement*iNode + jNode].real(elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell]);
+		       d_cellHamiltonianMatrix[iElem][numberDofsPerElement*iNode + jNode].imag(elementHamiltonianMatrixImag[numberDofsPerElement*iNode + jNode][iSubCell]);
 
-		  d_cellHamiltonianMatrixLowPrec[iElem][numberDofsPerElement*iNode + jNode].real((float)elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell]);
-		  d_cellHamiltonianMatrixLowPrec[iElem][numberDofsPerElement*iNode + jNode].imag((float)elementHamiltonianMatrixImag[numberDofsPerElement*iNode + jNode][iSubCell]);
+		       if(storeLowPrecMatrices)
+			 {
+			   d_cellHamiltonianMatrixLowPrec[iElem][numberDofsPerElement*iNode + jNode].real((float)elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell]);
+			   d_cellHamiltonianMatrixLowPrec[iElem][numberDofsPerElement*iNode + jNode].imag((float)elementHamiltonianMatrixImag[numberDofsPerElement*iNode + jNode][iSubCell]);
+			 }
 
 #else
-		  d_cellHamiltonianMatrix[iElem][numberDofsPerElement*iNode + jNode]
-		      = elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell];
+		       d_cellHamiltonianMatrix[iElem][numberDofsPerElement*iNode + jNode]
+			   = elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell];
 
-		  d_cellHamiltonianMatrixLowPrec[iElem][numberDofsPerElement*iNode + jNode]
-		      = (dataTypes::numberLowPrec)elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell];
+		       if(storeLowPrecMatrices)
+			 d_cellHamiltonianMatrixLowPrec[iElem][numberDofsPerElement*iNode + jNode]
+			   = (dataTypes::numberLowPrec)elementHamiltonianMatrix[numberDofsPerElement*iNode + jNode][iSubCell];
 #endif
 
-		}
-	    }
+		     }
+		 }
 
-	  iElem += 1;
-	}
+	       iElem += 1;
+	     }
 
-    }//macrocell loop
+	 }//macrocell loop
+     },
+     1);
 
 }
 
@@ -23,10 +23,65 @@
 #include <linearAlgebraOperationsInternal.h>
 #include <vectorUtilities.h>
 #include <dftUtils.h>
+#include <deal.II/base/thread_local_storage.h>
 
 
 namespace dftfe {
 
+  namespace internal
+  {
+    //
+    //expand the upper triangle of a symmetric matrix stored in packed column major
+    //format into full storage
+    //
+    template<typename T>
+    void unpackSymmetricMatrix(const T * packedMatrix,
+			       const unsigned int n,
+			       T * fullMatrix)
+    {
+      unsigned int count = 0;
+      for(unsigned int j = 0; j < n; ++j)
+	for(unsigned int i = 0; i <= j; ++i)
+	  {
+	    fullMatrix[n*j+i] = packedMatrix[count];
+	    fullMatrix[n*i+j] = packedMatrix[count];
+	    count++;
+	  }
+    }
+
+    //
+    //apply cellRangeWorker(cells,begin,end) to all the cells of the given coloring. With more than one thread
+    //the cells are processed color by color, with the threads working on subranges of the cells of one color,
+    //so that they scatter into disjoint nodes. With a single thread the coloring is not required, and the cells
+    //are processed in their natural order (naturalOrderCells, the sorted cells of the coloring precomputed in
+    //reinit) for better locality of the accesses to the flattened arrays
+    //
+    template<typename CellRangeWorker>
+    void applyToColoredCells(const std::vector<std::vector<unsigned int> > & coloring,
+			     const std::vector<unsigned int> & naturalOrderCells,
+			     const CellRangeWorker & cellRangeWorker)
+    {
+      if(dealii::MultithreadInfo::n_threads() == 1)
+	{
+	  cellRangeWorker(naturalOrderCells,0U,naturalOrderCells.size());
+	  return;
+	}
+
+      for(unsigned int iColor = 0; iColor < coloring.size(); ++iColor)
+	{
+	  const std::vector<unsigned int> & cellsInColor = coloring[iColor];
+	  dealii::parallel::apply_to_subranges
+	    (0U,
+	     cellsInColor.size(),
+	     [&](const unsigned int iCellBegin, const unsigned int iCellEnd)
+	     {
+	       cellRangeWorker(cellsInColor,iCellBegin,iCellEnd);
+	     },
+	     1);
+	}
+    }
+  }
+
 #include "computeNonLocalHamiltonianTimesXMemoryOpt.cc"
 #include "computeNonLocalHamiltonianTimesXMemoryOptBatchGEMM.cc"
 #include "matrixVectorProductImplementations.cc"
@@ -43,6 +98,7 @@ namespace dftfe {
     d_kPointIndex(0),
     d_numberNodesPerElement(_dftPtr->matrix_free_data.get_dofs_per_cell()),
     d_numberMacroCells(_dftPtr->matrix_free_data.n_macro_cells()),
+    d_flattenedArrayIndexMapsBlockSize(0),
     mpi_communicator (mpi_comm_replica),
     n_mpi_processes (Utilities::MPI::n_mpi_processes(mpi_comm_replica)),
     this_mpi_process (Utilities::MPI::this_mpi_process(mpi_comm_replica)),
@@ -95,6 +151,65 @@ namespace dftfe {
     computing_timer.exit_section("kohnShamDFTOperatorClass setup");
   }
 
+  //
+  //partitioner of the flattened arrays for the given number of wavefunctions
+  //
+  template<unsigned int FEOrder>
+  const std::shared_ptr<const dealii::Utilities::MPI::Partitioner> &
+  kohnShamDFTOperatorClass<FEOrder>::getFlattenedArrayPartitioner(const unsigned int numberWaveFunctions)
+  {
+    //
+    //the partitioners and workspaces are only valid for the single component partitioner they were created from
+    //
+    if (d_flattenedArrayBasePartitioner!=dftPtr->matrix_free_data.get_vector_partitioner())
+      {
+	d_flattenedArrayPartitioners.clear();
+	d_flattenedArrayWorkspaces.clear();
+	d_flattenedArrayIndexMapsBlockSize=0;
+	d_flattenedArrayBasePartitioner=dftPtr->matrix_free_data.get_vector_partitioner();
+      }
+
+    std::shared_ptr<const dealii::Utilities::MPI::Partitioner> & partitioner=d_flattenedArrayPartitioners[numberWaveFunctions];
+    if (!partitioner)
+      {
+	dealii::parallel::distributed::Vector<dataTypes::number> flattenedArray;
+	vectorTools::createDealiiVector<dataTypes::number>(d_flattenedArrayBasePartitioner,
+							   numberWaveFunctions,
+							   flattenedArray);
+	partitioner=flattenedArray.get_partitioner();
+      }
+
+    return partitioner;
+  }
+
+  //
+  //flattened array workspace for the given number of wavefunctions
+  //
+  template<unsigned int FEOrder>
+  dealii::parallel::distributed::Vector<dataTypes::number> &
+  kohnShamDFTOperatorClass<FEOrder>::getFlattenedArrayWorkspace(const unsigned int wavefunBlockSize,
+								const unsigned int workspaceId)
+  {
+    const std::shared_ptr<const dealii::Utilities::MPI::Partitioner> & partitioner
+      =getFlattenedArrayPartitioner(wavefunBlockSize);
+
+    dealii::parallel::distributed::Vector<dataTypes::number> & workspace
+      =d_flattenedArrayWorkspaces[std::make_pair(wavefunBlockSize,workspaceId)];
+    if (workspace.get_partitioner()!=partitioner)
+      workspace.reinit(partitioner);
+
+    return workspace;
+  }
+
+  //
+  //release flattened array workspaces, the partitioners are kept as they are cheap to store
+  //
+  template<unsigned int FEOrder>
+  void kohnShamDFTOperatorClass<FEOrder>::releaseFlattenedArrayWorkspaces()
+  {
+    d_flattenedArrayWorkspaces.clear();
+  }
+
   template<unsigned int FEOrder>
   void kohnShamDFTOperatorClass<FEOrder>::reinit(const unsigned int numberWaveFunctions,
 				   dealii::parallel::distributed::Vector<dataTypes::number> & flattenedArray,
@@ -102,24 +217,22 @@ namespace dftfe {
   {
 
     if(flag)
-	vectorTools::createDealiiVector<dataTypes::number>(dftPtr->matrix_free_data.get_vector_partitioner(),
-							   numberWaveFunctions,
-							   flattenedArray);
+      flattenedArray.reinit(getFlattenedArrayPartitioner(numberWaveFunctions));
 
-    if(dftParameters::isPseudopotential)
-    {
-      vectorTools::createDealiiVector<dataTypes::number>(dftPtr->d_projectorKetTimesVectorPar[0].get_partitioner(),
-							 numberWaveFunctions,
-							 dftPtr->d_projectorKetTimesVectorParFlattened);
-
-      ///FIXME In some cases this caused Assert failure. So it is commented to out for now
-      /// requires to be uncommented for developing/experimenting mixed precision in chebyshev filtering
-      //vectorTools::createDealiiVector<dataTypes::numberLowPrec>(dftPtr->d_projectorKetTimesVectorPar[0].get_partitioner(),
-      //							 numberWaveFunctions,
-      //							 dftPtr->d_projectorKetTimesVectorParFlattenedLowPrec);
-    }
+    reinit(numberWaveFunctions);
 
+    //
+    //the index maps and cell colorings below only depend on the number of wavefunctions, and are
+    //reused if the flattened array has the partitioner created by this operator
+    //
+    std::map<unsigned int, std::shared_ptr<const dealii::Utilities::MPI::Partitioner> >::const_iterator
+      partitionerIt=d_flattenedArrayPartitioners.find(numberWaveFunctions);
+    const bool isOperatorPartitioner=partitionerIt!=d_flattenedArrayPartitioners.end()
+                                     && partitionerIt->second==flattenedArray.get_partitioner();
+    if (isOperatorPartitioner && d_flattenedArrayIndexMapsBlockSize==numberWaveFunctions)
+      return;
 
+    d_flattenedArrayIndexMapsBlockSize=isOperatorPartitioner?numberWaveFunctions:0;
 
     vectorTools::computeCellLocalIndexSetMap(flattenedArray.get_partitioner(),
 					     dftPtr->matrix_free_data,
@@ -127,6 +240,99 @@ namespace dftfe {
 					     d_flattenedArrayMacroCellLocalProcIndexIdMap,
 					     d_flattenedArrayCellLocalProcIndexIdMap);
 
+    vectorTools::computeCellColoring(d_flattenedArrayMacroCellLocalProcIndexIdMap,
+				     d_macroCellColoring);
+
+    std::vector<bool> isInteriorCell;
+    vectorTools::computeInteriorCellFlags(dftPtr->matrix_free_data.get_vector_partitioner(),
+					  dftPtr->matrix_free_data,
+					  dftPtr->constraintsNone,
+					  isInteriorCell);
+
+    //
+    //split a coloring into the colorings of the interior and the boundary cells, and also list
+    //the interior and the boundary cells in their natural order
+    //
+    auto splitColoring=[](const std::vector<std::vector<unsigned int> > & cellColoring,
+			  const std::vector<bool> & isInterior,
+			  std::vector<std::vector<unsigned int> > & cellColoringInterior,
+			  std::vector<std::vector<unsigned int> > & cellColoringBoundary,
+			  std::vector<unsigned int> & cellsInterior,
+			  std::vector<unsigned int> & cellsBoundary)
+      {
+	cellColoringInterior.clear();
+	cellColoringBoundary.clear();
+	cellsInterior.clear();
+	cellsBoundary.clear();
+	for(unsigned int iColor = 0; iColor < cellColoring.size(); ++iColor)
+	  {
+	    std::vector<unsigned int> interiorCellsInColor, boundaryCellsInColor;
+	    for(unsigned int iCell = 0; iCell < cellColoring[iColor].size(); ++iCell)
+	      {
+		const unsigned int iElem = cellColoring[iColor][iCell];
+		if(isInterior[iElem])
+		  interiorCellsInColor.push_back(iElem);
+		else
+		  boundaryCellsInColor.push_back(iElem);
+	      }
+
+	    if(!interiorCellsInColor.empty())
+	      cellColoringInterior.push_back(interiorCellsInColor);
+
+	    if(!boundaryCellsInColor.empty())
+	      cellColoringBoundary.push_back(boundaryCellsInColor);
+
+	    cellsInterior.insert(cellsInterior.end(),interiorCellsInColor.begin(),interiorCellsInColor.end());
+	    cellsBoundary.insert(cellsBoundary.end(),boundaryCellsInColor.begin(),boundaryCellsInColor.end());
+	  }
+
+	std::sort(cellsInterior.begin(),cellsInterior.end());
+	std::sort(cellsBoundary.begin(),cellsBoundary.end());
+      };
+
+    splitColoring(d_macroCellColoring,
+		  isInteriorCell,
+		  d_macroCellColoringInterior,
+		  d_macroCellColoringBoundary,
+		  d_macroCellsInterior,
+		  d_macroCellsBoundary);
+
+    if(dftParameters::matrixFreeHamiltonian)
+      {
+	//
+	//the nodes of a macro cell are the union of the nodes of its subcells
+	//
+	d_macroCellStartIndex.assign(d_numberMacroCells+1,0);
+	std::vector<std::vector<dealii::types::global_dof_index> > macroCellLocalProcIndexIdMap(d_numberMacroCells);
+	std::vector<bool> isInteriorMacroCell(d_numberMacroCells,true);
+	for(unsigned int iMacroCell = 0; iMacroCell < d_numberMacroCells; ++iMacroCell)
+	  {
+	    d_macroCellStartIndex[iMacroCell+1] = d_macroCellStartIndex[iMacroCell]+d_macroCellSubCellMap[iMacroCell];
+	    for(unsigned int iElem = d_macroCellStartIndex[iMacroCell]; iElem < d_macroCellStartIndex[iMacroCell+1]; ++iElem)
+	      {
+		macroCellLocalProcIndexIdMap[iMacroCell].insert(macroCellLocalProcIndexIdMap[iMacroCell].end(),
+								d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem].begin(),
+								d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem].end());
+		if(!isInteriorCell[iElem])
+		  isInteriorMacroCell[iMacroCell] = false;
+	      }
+	  }
+
+	std::vector<std::vector<unsigned int> > matrixFreeMacroCellColoring;
+	vectorTools::computeCellColoring(macroCellLocalProcIndexIdMap,
+					 matrixFreeMacroCellColoring);
+
+	splitColoring(matrixFreeMacroCellColoring,
+		      isInteriorMacroCell,
+		      d_matrixFreeMacroCellColoringInterior,
+		      d_matrixFreeMacroCellColoringBoundary,
+		      d_matrixFreeMacroCellsInterior,
+		      d_matrixFreeMacroCellsBoundary);
+      }
+
+    vectorTools::computeCellColoring(d_flattenedArrayCellLocalProcIndexIdMap,
+				     d_cellColoring);
+
     getOverloadedConstraintMatrix()->precomputeMaps(dftPtr->matrix_free_data.get_vector_partitioner(),
 						    flattenedArray.get_partitioner(),
 						    numberWaveFunctions);
@@ -138,9 +344,26 @@ void kohnShamDFTOperatorClass<FEOrder>::reinit(const unsigned int numberWaveFunc
 
   if(dftParameters::isPseudopotential)
   {
-    vectorTools::createDealiiVector<dataTypes::number>(dftPtr->d_projectorKetTimesVectorPar[0].get_partitioner(),
-						       numberWaveFunctions,
-						       dftPtr->d_projectorKetTimesVectorParFlattened);
+    //
+    //reuse the partitioner of d_projectorKetTimesVectorParFlattened created for the same number of wavefunctions
+    //
+    if (d_projectorKetTimesVectorBasePartitioner!=dftPtr->d_projectorKetTimesVectorPar[0].get_partitioner())
+      {
+	d_projectorKetTimesVectorFlattenedPartitioners.clear();
+	d_projectorKetTimesVectorBasePartitioner=dftPtr->d_projectorKetTimesVectorPar[0].get_partitioner();
+      }
+
+    std::shared_ptr<const dealii::Utilities::MPI::Partitioner> & partitioner
+      =d_projectorKetTimesVectorFlattenedPartitioners[numberWaveFunctions];
+    if (!partitioner)
+      {
+	vectorTools::createDealiiVector<dataTypes::number>(d_projectorKetTimesVectorBasePartitioner,
+							   numberWaveFunctions,
+							   dftPtr->d_projectorKetTimesVectorParFlattened);
+	partitioner=dftPtr->d_projectorKetTimesVectorParFlattened.get_partitioner();
+      }
+    else if (dftPtr->d_projectorKetTimesVectorParFlattened.get_partitioner()!=partitioner)
+      dftPtr->d_projectorKetTimesVectorParFlattened.reinit(partitioner);
 
     ///FIXME In some cases this caused Assert failure. So it is commented to out for now
     /// requires to be uncommented for developing/experimenting mixed precision in chebyshev filtering
@@ -220,7 +443,43 @@ void kohnShamDFTOperatorClass<FEOrder>::reinitkPointIndex(unsigned int & kPointI
 
 
 template<unsigned int FEOrder>
-void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellId,std::vector<double> >* rhoValues,
+void kohnShamDFTOperatorClass<FEOrder>::updateVEffCumulativeChange(const unsigned int spinIndex)
+{
+  if (dftParameters::lanczosUpperBoundUpdateFrequency<=1)
+    return;
+
+  if (d_vEffPrevious.size()<2)
+    {
+      d_vEffPrevious.resize(2);
+      d_vEffCumulativeChange.resize(2,0.0);
+    }
+
+  //
+  //no change is accumulated in the first call for a given spin
+  //
+  dealii::Table<2, dealii::VectorizedArray<double> > & vEffPrevious=d_vEffPrevious[spinIndex];
+  double maxChange=0.0;
+  if (vEffPrevious.size(0)==vEff.size(0) && vEffPrevious.size(1)==vEff.size(1))
+    for (unsigned int cell = 0; cell < vEff.size(0); ++cell)
+      {
+	const unsigned int n_sub_cells=dftPtr->matrix_free_data.n_components_filled(cell);
+	for (unsigned int q = 0; q < vEff.size(1); ++q)
+	  for (unsigned int v = 0; v < n_sub_cells; ++v)
+	    maxChange=std::max(maxChange,std::abs(vEff(cell,q)[v]-vEffPrevious(cell,q)[v]));
+      }
+
+  d_vEffCumulativeChange[spinIndex]+=dealii::Utilities::MPI::max(maxChange,mpi_communicator);
+  vEffPrevious=vEff;
+}
+
+template<unsigned int FEOrder>
+double kohnShamDFTOperatorClass<FEOrder>::getVEffCumulativeChange(const unsigned int spinIndex) const
+{
+  return spinIndex<d_vEffCumulativeChange.size()?d_vEffCumulativeChange[spinIndex]:0.0;
+}
+
+template<unsigned int FEOrder>
+void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const dftUtils::cellQuadratureField* rhoValues,
 				      const vectorType & phi,
 				      const vectorType & phiExt,
 				      const std::map<dealii::CellId,std::vector<double> > & pseudoValues)
@@ -233,6 +492,15 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
   vEff.reinit (n_cells, numberQuadraturePoints);
   typename dealii::DoFHandler<3>::active_cell_iterator cellPtr;
 
+  //
+  //evaluate the exchange and correlation potentials at all the quadrature points of the locally owned
+  //cells with a single libxc call per functional, directly on the flat storage of the density
+  //
+  const unsigned int numberQuadPointsTotal = rhoValues->size();
+  std::vector<double> exchangePotentialVal(numberQuadPointsTotal), corrPotentialVal(numberQuadPointsTotal);
+  xc_lda_vxc(&(dftPtr->funcX),numberQuadPointsTotal,rhoValues->data(),&exchangePotentialVal[0]);
+  xc_lda_vxc(&(dftPtr->funcC),numberQuadPointsTotal,rhoValues->data(),&corrPotentialVal[0]);
+
   //
   //loop over cell block
   //
@@ -259,21 +527,12 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 	  //loop over each cell
 	  //
 	  unsigned int n_sub_cells=dftPtr->matrix_free_data.n_components_filled(cell);
-	  std::vector<double> densityValue(n_sub_cells), exchangePotentialVal(n_sub_cells), corrPotentialVal(n_sub_cells);
-	  for (unsigned int v = 0; v < n_sub_cells; ++v)
-	    {
-	      cellPtr=dftPtr->matrix_free_data.get_cell_iterator(cell, v);
-	      densityValue[v] = (*rhoValues).find(cellPtr->id())->second[q];
-	    }
-
-	  xc_lda_vxc(&(dftPtr->funcX),n_sub_cells,&densityValue[0],&exchangePotentialVal[0]);
-	  xc_lda_vxc(&(dftPtr->funcC),n_sub_cells,&densityValue[0],&corrPotentialVal[0]);
-
 	  VectorizedArray<double>  exchangePotential, corrPotential;
 	  for (unsigned int v = 0; v < n_sub_cells; ++v)
 	    {
-	      exchangePotential[v]=exchangePotentialVal[v];
-	      corrPotential[v]=corrPotentialVal[v];
+	      const unsigned int subCellIndex=rhoValues->getLayout()->cellIndex(cell,v);
+	      exchangePotential[v]=exchangePotentialVal[subCellIndex*numberQuadraturePoints+q];
+	      corrPotential[v]=corrPotentialVal[subCellIndex*numberQuadraturePoints+q];
 	    }
 
 	  //
@@ -295,11 +554,13 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 	    }
 	}
     }
+
+  updateVEffCumulativeChange(0);
 }
 
 template<unsigned int FEOrder>
-void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellId,std::vector<double> >* rhoValues,
-				      const std::map<dealii::CellId,std::vector<double> >* gradRhoValues,
+void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const dftUtils::cellQuadratureField* rhoValues,
+				      const dftUtils::cellQuadratureField* gradRhoValues,
 				      const vectorType & phi,
 				      const vectorType & phiExt,
 				      const std::map<dealii::CellId,std::vector<double> > & pseudoValues)
@@ -313,6 +574,21 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
   derExcWithSigmaTimesGradRho.reinit(TableIndices<2>(n_cells, numberQuadraturePoints));
   typename dealii::DoFHandler<3>::active_cell_iterator cellPtr;
 
+  //
+  //evaluate the derivatives of the exchange and correlation energy densities at all the quadrature points of
+  //the locally owned cells with a single libxc call per functional, directly on the flat storage of the density
+  //
+  const unsigned int numberQuadPointsTotal = rhoValues->size();
+  std::vector<double> sigmaValue(numberQuadPointsTotal), derExchEnergyWithDensityVal(numberQuadPointsTotal), derCorrEnergyWithDensityVal(numberQuadPointsTotal), derExchEnergyWithSigma(numberQuadPointsTotal), derCorrEnergyWithSigma(numberQuadPointsTotal);
+  for (unsigned int iPoint = 0; iPoint < numberQuadPointsTotal; ++iPoint)
+    {
+      const double * gradRho = gradRhoValues->data()+3*iPoint;
+      sigmaValue[iPoint] = gradRho[0]*gradRho[0] + gradRho[1]*gradRho[1] + gradRho[2]*gradRho[2];
+    }
+
+  xc_gga_vxc(&(dftPtr->funcX),numberQuadPointsTotal,rhoValues->data(),&sigmaValue[0],&derExchEnergyWithDensityVal[0],&derExchEnergyWithSigma[0]);
+  xc_gga_vxc(&(dftPtr->funcC),numberQuadPointsTotal,rhoValues->data(),&sigmaValue[0],&derCorrEnergyWithDensityVal[0],&derCorrEnergyWithSigma[0]);
+
   //
   //loop over cell block
   //
@@ -341,31 +617,17 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 	  //loop over each cell
 	  //
 	  unsigned int n_sub_cells=dftPtr->matrix_free_data.n_components_filled(cell);
-	  std::vector<double> densityValue(n_sub_cells), derExchEnergyWithDensityVal(n_sub_cells), derCorrEnergyWithDensityVal(n_sub_cells), derExchEnergyWithSigma(n_sub_cells), derCorrEnergyWithSigma(n_sub_cells), sigmaValue(n_sub_cells);
-	  for (unsigned int v = 0; v < n_sub_cells; ++v)
-	    {
-	      cellPtr=dftPtr->matrix_free_data.get_cell_iterator(cell, v);
-	      densityValue[v] = (*rhoValues).find(cellPtr->id())->second[q];
-	      double gradRhoX = (*gradRhoValues).find(cellPtr->id())->second[3*q + 0];
-	      double gradRhoY = (*gradRhoValues).find(cellPtr->id())->second[3*q + 1];
-	      double gradRhoZ = (*gradRhoValues).find(cellPtr->id())->second[3*q + 2];
-	      sigmaValue[v] = gradRhoX*gradRhoX + gradRhoY*gradRhoY + gradRhoZ*gradRhoZ;
-	    }
-
-	  xc_gga_vxc(&(dftPtr->funcX),n_sub_cells,&densityValue[0],&sigmaValue[0],&derExchEnergyWithDensityVal[0],&derExchEnergyWithSigma[0]);
-	  xc_gga_vxc(&(dftPtr->funcC),n_sub_cells,&densityValue[0],&sigmaValue[0],&derCorrEnergyWithDensityVal[0],&derCorrEnergyWithSigma[0]);
-
-
 	  VectorizedArray<double>  derExchEnergyWithDensity, derCorrEnergyWithDensity, derExcWithSigmaTimesGradRhoX, derExcWithSigmaTimesGradRhoY, derExcWithSigmaTimesGradRhoZ;
 	  for (unsigned int v = 0; v < n_sub_cells; ++v)
 	    {
-	      cellPtr=dftPtr->matrix_free_data.get_cell_iterator(cell, v);
-	      derExchEnergyWithDensity[v]=derExchEnergyWithDensityVal[v];
-	      derCorrEnergyWithDensity[v]=derCorrEnergyWithDensityVal[v];
-	      double gradRhoX = (*gradRhoValues).find(cellPtr->id())->second[3*q + 0];
-	      double gradRhoY = (*gradRhoValues).find(cellPtr->id())->second[3*q + 1];
-	      double gradRhoZ = (*gradRhoValues).find(cellPtr->id())->second[3*q + 2];
-	      double term = derExchEnergyWithSigma[v]+derCorrEnergyWithSigma[v];
+	      const unsigned int subCellIndex=rhoValues->getLayout()->cellIndex(cell,v);
+	      const unsigned int iPoint=subCellIndex*numberQuadraturePoints+q;
+	      derExchEnergyWithDensity[v]=derExchEnergyWithDensityVal[iPoint];
+	      derCorrEnergyWithDensity[v]=derCorrEnergyWithDensityVal[iPoint];
+	      double gradRhoX = gradRhoValues->cellData(subCellIndex)[3*q + 0];
+	      double gradRhoY = gradRhoValues->cellData(subCellIndex)[3*q + 1];
+	      double gradRhoZ = gradRhoValues->cellData(subCellIndex)[3*q + 2];
+	      double term = derExchEnergyWithSigma[iPoint]+derCorrEnergyWithSigma[iPoint];
 	      derExcWithSigmaTimesGradRhoX[v] = term*gradRhoX;
 	      derExcWithSigmaTimesGradRhoY[v] = term*gradRhoY;
 	      derExcWithSigmaTimesGradRhoZ[v] = term*gradRhoZ;
@@ -396,6 +658,8 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 	    }
 	}
     }
+
+  updateVEffCumulativeChange(0);
 }
 
 
@@ -441,52 +705,90 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 	  }
       }
 
+#ifdef WITH_MKL
+    const bool useBatchGEMM = dftParameters::useBatchGEMM && numberWaveFunctions<1000;
+#else
+    const bool useBatchGEMM = false;
+#endif
+
     //
-    //update slave nodes before doing element-level matrix-vec multiplication
+    //start the ghost exchange of src and compute Hloc*M^{-1/2}*X on the interior cells, which
+    //neither access ghost nor slave nodes, while the messages are in flight
     //
-    dftPtr->constraintsNoneDataInfo.distribute(src,
-    					       numberWaveFunctions);
+    src.update_ghost_values_start();
 
+    if(dftParameters::matrixFreeHamiltonian)
+      computeLocalHamiltonianTimesXMatrixFree(src,
+					      numberWaveFunctions,
+					      d_matrixFreeMacroCellColoringInterior,
+					      d_matrixFreeMacroCellsInterior,
+					      dst);
+    else if(!useBatchGEMM)
+      computeLocalHamiltonianTimesX(src,
+				    numberWaveFunctions,
+				    d_macroCellColoringInterior,
+				    d_macroCellsInterior,
+				    dst);
 
-    src.update_ghost_values();
+    src.update_ghost_values_finish();
 
+    //
+    //update slave nodes before doing element-level matrix-vec multiplication
+    //on the remaining cells. The ghost values are already up to date
+    //
+    dftPtr->constraintsNoneDataInfo.distribute(src,
+					      numberWaveFunctions,
+					      false);
+
+    //
+    //required if its a pseudopotential calculation and number of nonlocal atoms are greater than zero.
+    //compute C^{T}*M^{-1/2}*X and start its accumulation over the processors, which is overlapped with
+    //Hloc*M^{-1/2}*X on the remaining cells
+    //
+    const bool applyNonLocal = dftParameters::isPseudopotential && dftPtr->d_nonLocalAtomGlobalChargeIds.size() > 0;
+    if(applyNonLocal && !useBatchGEMM)
+      computeNonLocalProjectorKetTimesXStart(src,
+					     numberWaveFunctions);
 
     //
-    //Hloc*M^{-1/2}*X
+    //Hloc*M^{-1/2}*X on the remaining cells
     //
 #ifdef WITH_MKL
-    if (dftParameters::useBatchGEMM && numberWaveFunctions<1000)
+    if (useBatchGEMM && !dftParameters::matrixFreeHamiltonian)
        computeLocalHamiltonianTimesXBatchGEMM(src,
 				              numberWaveFunctions,
 				              dst);
     else
+#endif
+    if (dftParameters::matrixFreeHamiltonian)
+       computeLocalHamiltonianTimesXMatrixFree(src,
+					       numberWaveFunctions,
+					       d_matrixFreeMacroCellColoringBoundary,
+					       d_matrixFreeMacroCellsBoundary,
+					       dst);
+    else
        computeLocalHamiltonianTimesX(src,
 				     numberWaveFunctions,
+				     d_macroCellColoringBoundary,
+				     d_macroCellsBoundary,
  				     dst);
-#else
-       computeLocalHamiltonianTimesX(src,
-				     numberWaveFunctions,
- 				     dst);
-#endif
 
     //
-    //required if its a pseudopotential calculation and number of nonlocal atoms are greater than zero
     //H^{nloc}*M^{-1/2}*X
-    if(dftParameters::isPseudopotential && dftPtr->d_nonLocalAtomGlobalChargeIds.size() > 0)
+    //
+    if(applyNonLocal)
     {
 #ifdef WITH_MKL
-      if (dftParameters::useBatchGEMM && numberWaveFunctions<1000)
+      if (useBatchGEMM)
         computeNonLocalHamiltonianTimesXBatchGEMM(src,
 				                  numberWaveFunctions,
 				                  dst);
       else
-        computeNonLocalHamiltonianTimesX(src,
-				         numberWaveFunctions,
-				         dst);
+        computeNonLocalHamiltonianTimesXFinish(numberWaveFunctions,
+					       dst);
 #else
-        computeNonLocalHamiltonianTimesX(src,
-				         numberWaveFunctions,
-				         dst);
+        computeNonLocalHamiltonianTimesXFinish(numberWaveFunctions,
+					       dst);
 #endif
     }
 
@@ -569,19 +871,62 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 	  }
       }
 
+#ifdef WITH_MKL
+    const bool useBatchGEMM = dftParameters::useBatchGEMM && numberWaveFunctions<1000;
+#else
+    const bool useBatchGEMM = false;
+#endif
+
+    //
+    //start the ghost exchange of src and compute Hloc*M^{-1/2}*X on the interior cells, which
+    //neither access ghost nor slave nodes, while the messages are in flight
+    //
+    src.update_ghost_values_start();
+
+    if(dftParameters::matrixFreeHamiltonian)
+      computeLocalHamiltonianTimesXMatrixFree(src,
+					      numberWaveFunctions,
+					      d_matrixFreeMacroCellColoringInterior,
+					      d_matrixFreeMacroCellsInterior,
+					      dst);
+    else if(!useBatchGEMM && useSinglePrec)
+      computeLocalHamiltonianTimesXSinglePrec(src,
+					      numberWaveFunctions,
+					      d_macroCellColoringInterior,
+					      d_macroCellsInterior,
+					      dst);
+    else if(!useBatchGEMM)
+      computeLocalHamiltonianTimesX(src,
+				    numberWaveFunctions,
+				    d_macroCellColoringInterior,
+				    d_macroCellsInterior,
+				    dst);
+
+    src.update_ghost_values_finish();
+
     //
     //update slave nodes before doing element-level matrix-vec multiplication
+    //on the remaining cells. The ghost values are already up to date
     //
     dftPtr->constraintsNoneDataInfo.distribute(src,
-					      numberWaveFunctions);
+					      numberWaveFunctions,
+					      false);
 
-    src.update_ghost_values();
+    //
+    //required if its a pseudopotential calculation and number of nonlocal atoms are greater than zero.
+    //compute C^{T}*M^{-1/2}*X and start its accumulation over the processors, which is overlapped with
+    //Hloc*M^{-1/2}*X on the remaining cells
+    //
+    const bool applyNonLocal = dftParameters::isPseudopotential && dftPtr->d_nonLocalAtomGlobalChargeIds.size() > 0;
+    if(applyNonLocal && !useBatchGEMM)
+      computeNonLocalProjectorKetTimesXStart(src,
+					     numberWaveFunctions);
 
     //
-    //Hloc*M^{-1/2}*X
+    //Hloc*M^{-1/2}*X on the remaining cells
     //
 #ifdef WITH_MKL
-    if (dftParameters::useBatchGEMM && numberWaveFunctions<1000)
+    if (useBatchGEMM && !dftParameters::matrixFreeHamiltonian)
     {
        if (useSinglePrec)
          computeLocalHamiltonianTimesXBatchGEMMSinglePrec(src,
@@ -593,22 +938,33 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 				  dst);
     }
     else
+#endif
+    if (dftParameters::matrixFreeHamiltonian)
+       computeLocalHamiltonianTimesXMatrixFree(src,
+					       numberWaveFunctions,
+					       d_matrixFreeMacroCellColoringBoundary,
+					       d_matrixFreeMacroCellsBoundary,
+					       dst);
+    else if (useSinglePrec)
+       computeLocalHamiltonianTimesXSinglePrec(src,
+					       numberWaveFunctions,
+					       d_macroCellColoringBoundary,
+					       d_macroCellsBoundary,
+					       dst);
+    else
        computeLocalHamiltonianTimesX(src,
 				     numberWaveFunctions,
+				     d_macroCellColoringBoundary,
+				     d_macroCellsBoundary,
  				     dst);
-#else
-       computeLocalHamiltonianTimesX(src,
-				     numberWaveFunctions,
- 				     dst);
-#endif
 
     //
-    //required if its a pseudopotential calculation and number of nonlocal atoms are greater than zero
     //H^{nloc}*M^{-1/2}*X
-    if(dftParameters::isPseudopotential && dftPtr->d_nonLocalAtomGlobalChargeIds.size() > 0)
+    //
+    if(applyNonLocal)
     {
 #ifdef WITH_MKL
-      if (dftParameters::useBatchGEMM && numberWaveFunctions<1000)
+      if (useBatchGEMM)
       {
 	if (useSinglePrec)
             computeNonLocalHamiltonianTimesXBatchGEMMSinglePrec(src,
@@ -620,13 +976,11 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 				                  dst);
       }
       else
-        computeNonLocalHamiltonianTimesX(src,
-				         numberWaveFunctions,
-				         dst);
+        computeNonLocalHamiltonianTimesXFinish(numberWaveFunctions,
+					       dst);
 #else
-        computeNonLocalHamiltonianTimesX(src,
-				         numberWaveFunctions,
-				         dst);
+        computeNonLocalHamiltonianTimesXFinish(numberWaveFunctions,
+					       dst);
 #endif
     }
 
@@ -1038,11 +1392,11 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
     //
     const unsigned int numberDofs = X.size()/numberWaveFunctions;
 
-    //create temporary arrays XBlock,Hx
-    dealii::parallel::distributed::Vector<dataTypes::number> XBlock,HXBlock;
+    //temporary arrays XBlock,Hx taken from the flattened array workspaces
+    dealii::parallel::distributed::Vector<dataTypes::number> * XBlock, * HXBlock;
 
-    std::map<unsigned int, unsigned int> globalToLocalColumnIdMap;
-    std::map<unsigned int, unsigned int> globalToLocalRowIdMap;
+    std::vector<int> globalToLocalColumnIdMap;
+    std::vector<int> globalToLocalRowIdMap;
     linearAlgebraOperations::internal::createGlobalToLocalIdMapsScaLAPACKMat(processGrid,
 						    projHamPar,
 						    globalToLocalRowIdMap,
@@ -1092,35 +1446,36 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 	  const unsigned int B = std::min(vectorsBlockSize, numberWaveFunctions-jvec);
 	  if (jvec==0 || B!=vectorsBlockSize)
 	  {
+	     XBlock=&getFlattenedArrayWorkspace(B,0);
+	     HXBlock=&getFlattenedArrayWorkspace(B,1);
 	     reinit(B,
-		    XBlock,
-		    true);
-	     HXBlock.reinit(XBlock);
+		    *XBlock,
+		    false);
 	  }
 
 	  if ((jvec+B)<=bandGroupLowHighPlusOneIndices[2*bandGroupTaskId+1] &&
 	      (jvec+B)>bandGroupLowHighPlusOneIndices[2*bandGroupTaskId])
 	  {
-	      XBlock=0;
+	      *XBlock=0;
 	      //fill XBlock^{T} from X:
 	      for(unsigned int iNode = 0; iNode<numberDofs; ++iNode)
 		  for(unsigned int iWave = 0; iWave < B; ++iWave)
-			XBlock.local_element(iNode*B
+			XBlock->local_element(iNode*B
 				 +iWave)
 			     =X[iNode*numberWaveFunctions+jvec+iWave];
 
 
 	      MPI_Barrier(getMPICommunicator());
 	      //evaluate H times XBlock^{T} and store in HXBlock^{T}
-	      HXBlock=0;
+	      *HXBlock=0;
 	      const bool scaleFlag = false;
 	      const dataTypes::number scalar = 1.0;
-	      HX(XBlock,
+	      HX(*XBlock,
 		 B,
 		 scaleFlag,
 		 scalar,
 		 false,
-		 HXBlock);
+		 *HXBlock);
               MPI_Barrier(getMPICommunicator());
 
 	      const char transA = 'N';
@@ -1143,7 +1498,7 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 		     &alpha,
 		     &X[0]+jvec,
 		     &numberWaveFunctions,
-		     HXBlock.begin(),
+		     HXBlock->begin(),
 		     &B,
 		     &beta,
 		     &projHamBlock[0],
@@ -1161,15 +1516,14 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 	      //Copying only the lower triangular part to the ScaLAPACK projected Hamiltonian matrix
 	      if (processGrid->is_process_active())
 		  for (unsigned int j = 0; j <B; ++j)
-		     if(globalToLocalColumnIdMap.find(j+jvec)!=globalToLocalColumnIdMap.end())
+		     if(globalToLocalColumnIdMap[j+jvec]!=-1)
 		     {
 		       const unsigned int localColumnId=globalToLocalColumnIdMap[j+jvec];
 		       for (unsigned int i = jvec; i <numberWaveFunctions; ++i)
 		       {
-			 std::map<unsigned int, unsigned int>::iterator it=
-					      globalToLocalRowIdMap.find(i);
-			 if (it!=globalToLocalRowIdMap.end())
-				 projHamPar.local_el(it->second,
+			 const int localId=globalToLocalRowIdMap[i];
+			 if (localId!=-1)
+				 projHamPar.local_el(localId,
 						     localColumnId)
 						     =projHamBlock[j*D+i-jvec];
 		       }
@@ -1205,11 +1559,11 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
     //
     const unsigned int numberDofs = X.size()/N;
 
-    //create temporary arrays XBlock,Hx
-    dealii::parallel::distributed::Vector<dataTypes::number> XBlock,HXBlock;
+    //temporary arrays XBlock,Hx taken from the flattened array workspaces
+    dealii::parallel::distributed::Vector<dataTypes::number> * XBlock, * HXBlock;
 
-    std::map<unsigned int, unsigned int> globalToLocalColumnIdMap;
-    std::map<unsigned int, unsigned int> globalToLocalRowIdMap;
+    std::vector<int> globalToLocalColumnIdMap;
+    std::vector<int> globalToLocalRowIdMap;
     linearAlgebraOperations::internal::createGlobalToLocalIdMapsScaLAPACKMat(processGrid,
 						    projHamPar,
 						    globalToLocalRowIdMap,
@@ -1263,36 +1617,37 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 	  const unsigned int B = std::min(vectorsBlockSize, N-jvec);
 	  if (jvec==0 || B!=vectorsBlockSize)
 	  {
+	     XBlock=&getFlattenedArrayWorkspace(B,0);
+	     HXBlock=&getFlattenedArrayWorkspace(B,1);
 	     reinit(B,
-		    XBlock,
-		    true);
-	     HXBlock.reinit(XBlock);
+		    *XBlock,
+		    false);
 	     HXBlockSinglePrec.resize(B*numberDofs);
 	  }
 
 	  if ((jvec+B)<=bandGroupLowHighPlusOneIndices[2*bandGroupTaskId+1] &&
 	      (jvec+B)>bandGroupLowHighPlusOneIndices[2*bandGroupTaskId])
 	  {
-	      XBlock=0;
+	      *XBlock=0;
 	      //fill XBlock^{T} from X:
 	      for(unsigned int iNode = 0; iNode<numberDofs; ++iNode)
 		  for(unsigned int iWave = 0; iWave < B; ++iWave)
-			XBlock.local_element(iNode*B
+			XBlock->local_element(iNode*B
 				 +iWave)
 			     =X[iNode*N+jvec+iWave];
 
 
 	      MPI_Barrier(getMPICommunicator());
 	      //evaluate H times XBlock^{T} and store in HXBlock^{T}
-	      HXBlock=0;
+	      *HXBlock=0;
 	      const bool scaleFlag = false;
 	      const dataTypes::number scalar = 1.0;
-	      HX(XBlock,
+	      HX(*XBlock,
 		 B,
 		 scaleFlag,
 		 scalar,
 		 false,
-		 HXBlock);
+		 *HXBlock);
 	      MPI_Barrier(getMPICommunicator());
 
 	      const char transA = 'N';
@@ -1318,7 +1673,7 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 			 &alpha,
 			 &X[0]+jvec,
 			 &N,
-			 HXBlock.begin(),
+			 HXBlock->begin(),
 			 &B,
 			 &beta,
 			 &projHamBlock[0],
@@ -1337,15 +1692,14 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 		  //Copying only the lower triangular part to the ScaLAPACK projected Hamiltonian matrix
 		  if (processGrid->is_process_active())
 		      for (unsigned int j = 0; j <B; ++j)
-			 if(globalToLocalColumnIdMap.find(j+jvec)!=globalToLocalColumnIdMap.end())
+			 if(globalToLocalColumnIdMap[j+jvec]!=-1)
 			 {
 			   const unsigned int localColumnId=globalToLocalColumnIdMap[j+jvec];
 			   for (unsigned int i = jvec; i <N; ++i)
 			   {
-			     std::map<unsigned int, unsigned int>::iterator it=
-						  globalToLocalRowIdMap.find(i);
-			     if (it!=globalToLocalRowIdMap.end())
-				     projHamPar.local_el(it->second,
+			     const int localId=globalToLocalRowIdMap[i];
+			     if (localId!=-1)
+				     projHamPar.local_el(localId,
 							 localColumnId)
 							 =projHamBlock[j*D+i-jvec];
 			   }
@@ -1357,7 +1711,7 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 		  const dataTypes::numberLowPrec alphaSinglePrec = 1.0,betaSinglePrec = 0.0;
 
 		  for(unsigned int i = 0; i<numberDofs*B; ++i)
-	          	HXBlockSinglePrec[i]=HXBlock.local_element(i);
+	          	HXBlockSinglePrec[i]=HXBlock->local_element(i);
 
 		  const unsigned int D=N-jvec;
 
@@ -1386,15 +1740,14 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 
 		  if (processGrid->is_process_active())
 		      for (unsigned int j = 0; j <B; ++j)
-			 if(globalToLocalColumnIdMap.find(j+jvec)!=globalToLocalColumnIdMap.end())
+			 if(globalToLocalColumnIdMap[j+jvec]!=-1)
 			 {
 			   const unsigned int localColumnId=globalToLocalColumnIdMap[j+jvec];
 			   for (unsigned int i = jvec; i <N; ++i)
 			   {
-			     std::map<unsigned int, unsigned int>::iterator it=
-						  globalToLocalRowIdMap.find(i);
-			     if (it!=globalToLocalRowIdMap.end())
-				     projHamPar.local_el(it->second,
+			     const int localId=globalToLocalRowIdMap[i];
+			     if (localId!=-1)
+				     projHamPar.local_el(localId,
 							 localColumnId)
 							 =projHamBlockSinglePrec[j*D+i-jvec];
 			   }
@@ -1418,7 +1771,7 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEff(const std::map<dealii::CellI
 #endif
 
 template<unsigned int FEOrder>
-void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const std::map<dealii::CellId,std::vector<double> >* rhoValues,
+void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const dftUtils::cellQuadratureField* rhoValues,
 						   const vectorType & phi,
 						   const vectorType & phiExt,
 						   const unsigned int spinIndex,
@@ -1433,6 +1786,15 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const std::map<
   vEff.reinit (n_cells, numberQuadraturePoints);
   typename dealii::DoFHandler<3>::active_cell_iterator cellPtr;
 
+  //
+  //evaluate the exchange and correlation potentials at all the quadrature points of the locally owned
+  //cells with a single libxc call per functional, directly on the flat storage of the spin densities
+  //
+  const unsigned int numberQuadPointsTotal = rhoValues->size()/2;
+  std::vector<double> exchangePotentialVal(2*numberQuadPointsTotal), corrPotentialVal(2*numberQuadPointsTotal);
+  xc_lda_vxc(&(dftPtr->funcX),numberQuadPointsTotal,rhoValues->data(),&exchangePotentialVal[0]);
+  xc_lda_vxc(&(dftPtr->funcC),numberQuadPointsTotal,rhoValues->data(),&corrPotentialVal[0]);
+
   //
   //loop over cell block
   //
@@ -1461,22 +1823,13 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const std::map<
 	  //loop over each cell
 	  //
 	  unsigned int n_sub_cells=dftPtr->matrix_free_data.n_components_filled(cell);
-	  std::vector<double> densityValue(2*n_sub_cells), exchangePotentialVal(2*n_sub_cells), corrPotentialVal(2*n_sub_cells);
-	  for (unsigned int v = 0; v < n_sub_cells; ++v)
-	    {
-	      cellPtr=dftPtr->matrix_free_data.get_cell_iterator(cell, v);
-	      densityValue[2*v+1] = (*rhoValues).find(cellPtr->id())->second[2*q+1];
-	      densityValue[2*v] = (*rhoValues).find(cellPtr->id())->second[2*q];
-	    }
-
-	  xc_lda_vxc(&(dftPtr->funcX),n_sub_cells,&densityValue[0],&exchangePotentialVal[0]);
-	  xc_lda_vxc(&(dftPtr->funcC),n_sub_cells,&densityValue[0],&corrPotentialVal[0]);
-
 	  VectorizedArray<double>  exchangePotential, corrPotential;
 	  for (unsigned int v = 0; v < n_sub_cells; ++v)
 	    {
-	      exchangePotential[v]=exchangePotentialVal[2*v+spinIndex];
-	      corrPotential[v]=corrPotentialVal[2*v+spinIndex];
+	      const unsigned int subCellIndex=rhoValues->getLayout()->cellIndex(cell,v);
+	      const unsigned int iPoint=subCellIndex*numberQuadraturePoints+q;
+	      exchangePotential[v]=exchangePotentialVal[2*iPoint+spinIndex];
+	      corrPotential[v]=corrPotentialVal[2*iPoint+spinIndex];
 	    }
 
 	  //
@@ -1498,11 +1851,13 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const std::map<
 	    }
 	}
     }
+
+  updateVEffCumulativeChange(spinIndex);
 }
 
 template<unsigned int FEOrder>
-void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const std::map<dealii::CellId,std::vector<double> >* rhoValues,
-						   const std::map<dealii::CellId,std::vector<double> >* gradRhoValues,
+void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const dftUtils::cellQuadratureField* rhoValues,
+						   const dftUtils::cellQuadratureField* gradRhoValues,
 						   const vectorType & phi,
 						   const vectorType & phiExt,
 						   const unsigned int spinIndex,
@@ -1517,6 +1872,24 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const std::map<
   derExcWithSigmaTimesGradRho.reinit(TableIndices<2>(n_cells, numberQuadraturePoints));
   typename dealii::DoFHandler<3>::active_cell_iterator cellPtr;
 
+  //
+  //evaluate the derivatives of the exchange and correlation energy densities at all the quadrature points of
+  //the locally owned cells with a single libxc call per functional, directly on the flat storage of the spin densities
+  //
+  const unsigned int numberQuadPointsTotal = rhoValues->size()/2;
+  std::vector<double> derExchEnergyWithDensityVal(2*numberQuadPointsTotal), derCorrEnergyWithDensityVal(2*numberQuadPointsTotal),
+			derExchEnergyWithSigma(3*numberQuadPointsTotal), derCorrEnergyWithSigma(3*numberQuadPointsTotal), sigmaValue(3*numberQuadPointsTotal);
+  for (unsigned int iPoint = 0; iPoint < numberQuadPointsTotal; ++iPoint)
+    {
+      const double * gradRho = gradRhoValues->data()+6*iPoint;
+      sigmaValue[3*iPoint+0] = gradRho[0]*gradRho[0] + gradRho[1]*gradRho[1] + gradRho[2]*gradRho[2];
+      sigmaValue[3*iPoint+1] = gradRho[0]*gradRho[3] + gradRho[1]*gradRho[4] + gradRho[2]*gradRho[5];
+      sigmaValue[3*iPoint+2] = gradRho[3]*gradRho[3] + gradRho[4]*gradRho[4] + gradRho[5]*gradRho[5];
+    }
+
+  xc_gga_vxc(&(dftPtr->funcX),numberQuadPointsTotal,rhoValues->data(),&sigmaValue[0],&derExchEnergyWithDensityVal[0],&derExchEnergyWithSigma[0]);
+  xc_gga_vxc(&(dftPtr->funcC),numberQuadPointsTotal,rhoValues->data(),&sigmaValue[0],&derCorrEnergyWithDensityVal[0],&derCorrEnergyWithSigma[0]);
+
   //
   //loop over cell block
   //
@@ -1545,44 +1918,21 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const std::map<
 	  //loop over each cell
 	  //
 	  unsigned int n_sub_cells=dftPtr->matrix_free_data.n_components_filled(cell);
-	  std::vector<double> densityValue(2*n_sub_cells), derExchEnergyWithDensityVal(2*n_sub_cells), derCorrEnergyWithDensityVal(2*n_sub_cells),
-				derExchEnergyWithSigma(3*n_sub_cells), derCorrEnergyWithSigma(3*n_sub_cells), sigmaValue(3*n_sub_cells);
-	  for (unsigned int v = 0; v < n_sub_cells; ++v)
-	    {
-	      cellPtr=dftPtr->matrix_free_data.get_cell_iterator(cell, v);
-	      densityValue[2*v+1] = (*rhoValues).find(cellPtr->id())->second[2*q+1];
-	      densityValue[2*v] = (*rhoValues).find(cellPtr->id())->second[2*q];
-	      double gradRhoX1 = (*gradRhoValues).find(cellPtr->id())->second[6*q + 0];
-	      double gradRhoY1 = (*gradRhoValues).find(cellPtr->id())->second[6*q + 1];
-	      double gradRhoZ1 = (*gradRhoValues).find(cellPtr->id())->second[6*q + 2];
-	      double gradRhoX2 = (*gradRhoValues).find(cellPtr->id())->second[6*q + 3];
-	      double gradRhoY2 = (*gradRhoValues).find(cellPtr->id())->second[6*q + 4];
-	      double gradRhoZ2 = (*gradRhoValues).find(cellPtr->id())->second[6*q + 5];
-	      //
-	      sigmaValue[3*v+0] = gradRhoX1*gradRhoX1 + gradRhoY1*gradRhoY1 + gradRhoZ1*gradRhoZ1;
-	      sigmaValue[3*v+1] = gradRhoX1*gradRhoX2 + gradRhoY1*gradRhoY2 + gradRhoZ1*gradRhoZ2;
-	      sigmaValue[3*v+2] = gradRhoX2*gradRhoX2 + gradRhoY2*gradRhoY2 + gradRhoZ2*gradRhoZ2;
-
-	    }
-
-	  xc_gga_vxc(&(dftPtr->funcX),n_sub_cells,&densityValue[0],&sigmaValue[0],&derExchEnergyWithDensityVal[0],&derExchEnergyWithSigma[0]);
-	  xc_gga_vxc(&(dftPtr->funcC),n_sub_cells,&densityValue[0],&sigmaValue[0],&derCorrEnergyWithDensityVal[0],&derCorrEnergyWithSigma[0]);
-
-
 	  VectorizedArray<double>  derExchEnergyWithDensity, derCorrEnergyWithDensity, derExcWithSigmaTimesGradRhoX, derExcWithSigmaTimesGradRhoY, derExcWithSigmaTimesGradRhoZ;
 	  for (unsigned int v = 0; v < n_sub_cells; ++v)
 	    {
-	      cellPtr=dftPtr->matrix_free_data.get_cell_iterator(cell, v);
-	      derExchEnergyWithDensity[v]=derExchEnergyWithDensityVal[2*v+spinIndex];
-	      derCorrEnergyWithDensity[v]=derCorrEnergyWithDensityVal[2*v+spinIndex];
-	      double gradRhoX = (*gradRhoValues).find(cellPtr->id())->second[6*q + 0 + 3*spinIndex];
-	      double gradRhoY = (*gradRhoValues).find(cellPtr->id())->second[6*q + 1 + 3*spinIndex];
-	      double gradRhoZ = (*gradRhoValues).find(cellPtr->id())->second[6*q + 2 + 3*spinIndex];
-	      double gradRhoOtherX = (*gradRhoValues).find(cellPtr->id())->second[6*q + 0 + 3*(1-spinIndex)];
-	      double gradRhoOtherY = (*gradRhoValues).find(cellPtr->id())->second[6*q + 1 + 3*(1-spinIndex)];
-	      double gradRhoOtherZ = (*gradRhoValues).find(cellPtr->id())->second[6*q + 2 + 3*(1-spinIndex)];
-	      double term = derExchEnergyWithSigma[3*v+2*spinIndex]+derCorrEnergyWithSigma[3*v+2*spinIndex];
-	      double termOff = derExchEnergyWithSigma[3*v+1]+derCorrEnergyWithSigma[3*v+1];
+	      const unsigned int subCellIndex=rhoValues->getLayout()->cellIndex(cell,v);
+	      const unsigned int iPoint=subCellIndex*numberQuadraturePoints+q;
+	      derExchEnergyWithDensity[v]=derExchEnergyWithDensityVal[2*iPoint+spinIndex];
+	      derCorrEnergyWithDensity[v]=derCorrEnergyWithDensityVal[2*iPoint+spinIndex];
+	      double gradRhoX = gradRhoValues->cellData(subCellIndex)[6*q + 0 + 3*spinIndex];
+	      double gradRhoY = gradRhoValues->cellData(subCellIndex)[6*q + 1 + 3*spinIndex];
+	      double gradRhoZ = gradRhoValues->cellData(subCellIndex)[6*q + 2 + 3*spinIndex];
+	      double gradRhoOtherX = gradRhoValues->cellData(subCellIndex)[6*q + 0 + 3*(1-spinIndex)];
+	      double gradRhoOtherY = gradRhoValues->cellData(subCellIndex)[6*q + 1 + 3*(1-spinIndex)];
+	      double gradRhoOtherZ = gradRhoValues->cellData(subCellIndex)[6*q + 2 + 3*(1-spinIndex)];
+	      double term = derExchEnergyWithSigma[3*iPoint+2*spinIndex]+derCorrEnergyWithSigma[3*iPoint+2*spinIndex];
+	      double termOff = derExchEnergyWithSigma[3*iPoint+1]+derCorrEnergyWithSigma[3*iPoint+1];
 	      derExcWithSigmaTimesGradRhoX[v] = term*gradRhoX + 0.5*termOff*gradRhoOtherX;
 	      derExcWithSigmaTimesGradRhoY[v] = term*gradRhoY + 0.5*termOff*gradRhoOtherY;
 	      derExcWithSigmaTimesGradRhoZ[v] = term*gradRhoZ + 0.5*termOff*gradRhoOtherZ;
@@ -1613,6 +1963,8 @@ void kohnShamDFTOperatorClass<FEOrder>::computeVEffSpinPolarized(const std::map<
 	    }
 	}
     }
+
+  updateVEffCumulativeChange(spinIndex);
 }
 
 
@@ -241,6 +241,8 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXMF (const d
 template<unsigned int FEOrder>
 void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesX(const dealii::parallel::distributed::Vector<std::complex<double> > & src,
 							const unsigned int numberWaveFunctions,
+							const std::vector<std::vector<unsigned int> > & macroCellColoring,
+							const std::vector<unsigned int> & macroCells,
 							dealii::parallel::distributed::Vector<std::complex<double> > & dst) const
 {
 
@@ -253,52 +255,63 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesX(const deal
   const std::complex<double> scalarCoeffAlpha = 1.0,scalarCoeffBeta = 0.0;
   const unsigned int inc = 1;
 
-  std::vector<std::complex<double> > cellWaveFunctionMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
-  std::vector<std::complex<double> > cellHamMatrixTimesWaveMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
-
-  unsigned int iElem = 0;
-  for(unsigned int iMacroCell = 0; iMacroCell < d_numberMacroCells; ++iMacroCell)
-    {
-      for(unsigned int iCell = 0; iCell < d_macroCellSubCellMap[iMacroCell]; ++iCell)
-	{
-	  for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
-	    {
-	      dealii::types::global_dof_index localNodeId = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
-	      zcopy_(&numberWaveFunctions,
-		     src.begin()+localNodeId,
-		     &inc,
-		     &cellWaveFunctionMatrix[numberWaveFunctions*iNode],
-		     &inc);
-	    }
-
-	  zgemm_(&transA,
-		 &transB,
-		 &numberWaveFunctions,
-		 &d_numberNodesPerElement,
-		 &d_numberNodesPerElement,
-		 &scalarCoeffAlpha,
-		 &cellWaveFunctionMatrix[0],
-		 &numberWaveFunctions,
-		 &d_cellHamiltonianMatrix[iElem][0],
-		 &d_numberNodesPerElement,
-		 &scalarCoeffBeta,
-		 &cellHamMatrixTimesWaveMatrix[0],
-		 &numberWaveFunctions);
-
-	  for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
-	    {
-	      dealii::types::global_dof_index localNodeId = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
-	      zaxpy_(&numberWaveFunctions,
-		     &scalarCoeffAlpha,
-		     &cellHamMatrixTimesWaveMatrix[numberWaveFunctions*iNode],
-		     &inc,
-		     dst.begin()+localNodeId,
-		     &inc);
-	    }
-
-	  ++iElem;
-	}//subcell loop
-    }//macrocell loop
+  //
+  //scratch storage of each thread, allocated once per call and reused for all the cells
+  //
+  dealii::Threads::ThreadLocalStorage<std::vector<std::complex<double> > >
+    cellWaveFunctionMatrixThreadLocal(std::vector<std::complex<double> >(d_numberNodesPerElement*numberWaveFunctions,0.0));
+  dealii::Threads::ThreadLocalStorage<std::vector<std::complex<double> > >
+    cellHamMatrixTimesWaveMatrixThreadLocal(std::vector<std::complex<double> >(d_numberNodesPerElement*numberWaveFunctions,0.0));
+
+  internal::applyToColoredCells
+    (macroCellColoring,
+     macroCells,
+     [&](const std::vector<unsigned int> & cells,
+	 const unsigned int iCellBegin,
+	 const unsigned int iCellEnd)
+     {
+       std::vector<std::complex<double> > & cellWaveFunctionMatrix = cellWaveFunctionMatrixThreadLocal.get();
+       std::vector<std::complex<double> > & cellHamMatrixTimesWaveMatrix = cellHamMatrixTimesWaveMatrixThreadLocal.get();
+
+       for(unsigned int iCell = iCellBegin; iCell < iCellEnd; ++iCell)
+	 {
+	   const unsigned int iElem = cells[iCell];
+	   for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	     {
+	       dealii::types::global_dof_index localNodeId = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
+	       zcopy_(&numberWaveFunctions,
+		      src.begin()+localNodeId,
+		      &inc,
+		      &cellWaveFunctionMatrix[numberWaveFunctions*iNode],
+		      &inc);
+	     }
+
+	   zgemm_(&transA,
+		  &transB,
+		  &numberWaveFunctions,
+		  &d_numberNodesPerElement,
+		  &d_numberNodesPerElement,
+		  &scalarCoeffAlpha,
+		  &cellWaveFunctionMatrix[0],
+		  &numberWaveFunctions,
+		  &d_cellHamiltonianMatrix[iElem][0],
+		  &d_numberNodesPerElement,
+		  &scalarCoeffBeta,
+		  &cellHamMatrixTimesWaveMatrix[0],
+		  &numberWaveFunctions);
+
+	   for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	     {
+	       dealii::types::global_dof_index localNodeId = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
+	       zaxpy_(&numberWaveFunctions,
+		      &scalarCoeffAlpha,
+		      &cellHamMatrixTimesWaveMatrix[numberWaveFunctions*iNode],
+		      &inc,
+		      dst.begin()+localNodeId,
+		      &inc);
+	     }
+	 }//cell loop
+     });
 
 }
 
@@ -399,10 +412,23 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXBatchGEMMSi
   AssertThrow(false,dftUtils::ExcNotImplementedYet());
 }
 #endif
+
+template<unsigned int FEOrder>
+void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXSinglePrec
+          (const dealii::parallel::distributed::Vector<dataTypes::number> & src,
+	   const unsigned int numberWaveFunctions,
+	   const std::vector<std::vector<unsigned int> > & macroCellColoring,
+	   const std::vector<unsigned int> & macroCells,
+	   dealii::parallel::distributed::Vector<dataTypes::number> & dst) const
+{
+  AssertThrow(false,dftUtils::ExcNotImplementedYet());
+}
 #else
 template<unsigned int FEOrder>
 void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesX(const dealii::parallel::distributed::Vector<double> & src,
 							const unsigned int numberWaveFunctions,
+							const std::vector<std::vector<unsigned int> > & macroCellColoring,
+							const std::vector<unsigned int> & macroCells,
 							dealii::parallel::distributed::Vector<double> & dst) const
 {
 
@@ -414,52 +440,173 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesX(const deal
   const double scalarCoeffAlpha = 1.0,scalarCoeffBeta = 0.0;
   const unsigned int inc = 1;
 
-  std::vector<double> cellWaveFunctionMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
-  std::vector<double> cellHamMatrixTimesWaveMatrix(d_numberNodesPerElement*numberWaveFunctions,0.0);
+  //
+  //scratch storage of each thread, allocated once per call and reused for all the cells
+  //
+  dealii::Threads::ThreadLocalStorage<std::vector<double> >
+    cellWaveFunctionMatrixThreadLocal(std::vector<double>(d_numberNodesPerElement*numberWaveFunctions,0.0));
+  dealii::Threads::ThreadLocalStorage<std::vector<double> >
+    cellHamMatrixTimesWaveMatrixThreadLocal(std::vector<double>(d_numberNodesPerElement*numberWaveFunctions,0.0));
+  dealii::Threads::ThreadLocalStorage<std::vector<double> >
+    cellHamMatrixUnpackedThreadLocal(std::vector<double>(dftParameters::packedCellHamiltonianMatrices?
+							 d_numberNodesPerElement*d_numberNodesPerElement:0));
+
+  internal::applyToColoredCells
+    (macroCellColoring,
+     macroCells,
+     [&](const std::vector<unsigned int> & cells,
+	 const unsigned int iCellBegin,
+	 const unsigned int iCellEnd)
+     {
+       std::vector<double> & cellWaveFunctionMatrix = cellWaveFunctionMatrixThreadLocal.get();
+       std::vector<double> & cellHamMatrixTimesWaveMatrix = cellHamMatrixTimesWaveMatrixThreadLocal.get();
+       std::vector<double> & cellHamMatrixUnpacked = cellHamMatrixUnpackedThreadLocal.get();
+
+       for(unsigned int iCell = iCellBegin; iCell < iCellEnd; ++iCell)
+	 {
+	   const unsigned int iElem = cells[iCell];
+
+	   const double * cellHamMatrix = &d_cellHamiltonianMatrix[iElem][0];
+	   if(dftParameters::packedCellHamiltonianMatrices)
+	     {
+	       internal::unpackSymmetricMatrix(cellHamMatrix,
+					       d_numberNodesPerElement,
+					       &cellHamMatrixUnpacked[0]);
+	       cellHamMatrix = &cellHamMatrixUnpacked[0];
+	     }
+
+	   for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	     {
+	       dealii::types::global_dof_index localNodeId = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
+	       dcopy_(&numberWaveFunctions,
+		      src.begin()+localNodeId,
+		      &inc,
+		      &cellWaveFunctionMatrix[numberWaveFunctions*iNode],
+		      &inc);
+	     }
+
+	   dgemm_(&transA,
+		  &transB,
+		  &numberWaveFunctions,
+		  &d_numberNodesPerElement,
+		  &d_numberNodesPerElement,
+		  &scalarCoeffAlpha,
+		  &cellWaveFunctionMatrix[0],
+		  &numberWaveFunctions,
+		  cellHamMatrix,
+		  &d_numberNodesPerElement,
+		  &scalarCoeffBeta,
+		  &cellHamMatrixTimesWaveMatrix[0],
+		  &numberWaveFunctions);
+
+	   for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	     {
+	       dealii::types::global_dof_index localNodeId = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
+	       daxpy_(&numberWaveFunctions,
+		      &scalarCoeffAlpha,
+		      &cellHamMatrixTimesWaveMatrix[numberWaveFunctions*iNode],
+		      &inc,
+		      dst.begin()+localNodeId,
+		      &inc);
+	     }
+	 }//cell loop
+     });
 
-  unsigned int iElem = 0;
-  for(unsigned int iMacroCell = 0; iMacroCell < d_numberMacroCells; ++iMacroCell)
-    {
-      for(unsigned int iCell = 0; iCell < d_macroCellSubCellMap[iMacroCell]; ++iCell)
-	{
-	  for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
-	    {
-	      dealii::types::global_dof_index localNodeId = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
-	      dcopy_(&numberWaveFunctions,
-		     src.begin()+localNodeId,
-		     &inc,
-		     &cellWaveFunctionMatrix[numberWaveFunctions*iNode],
-		     &inc);
-	    }
+}
 
-	  dgemm_(&transA,
-		 &transB,
-		 &numberWaveFunctions,
-		 &d_numberNodesPerElement,
-		 &d_numberNodesPerElement,
-		 &scalarCoeffAlpha,
-		 &cellWaveFunctionMatrix[0],
-		 &numberWaveFunctions,
-		 &d_cellHamiltonianMatrix[iElem][0],
-		 &d_numberNodesPerElement,
-		 &scalarCoeffBeta,
-		 &cellHamMatrixTimesWaveMatrix[0],
-		 &numberWaveFunctions);
+template<unsigned int FEOrder>
+void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXSinglePrec
+          (const dealii::parallel::distributed::Vector<double> & src,
+	   const unsigned int numberWaveFunctions,
+	   const std::vector<std::vector<unsigned int> > & macroCellColoring,
+	   const std::vector<unsigned int> & macroCells,
+	   dealii::parallel::distributed::Vector<double> & dst) const
+{
 
-	  for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
-	    {
-	      dealii::types::global_dof_index localNodeId = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
-	      daxpy_(&numberWaveFunctions,
-		     &scalarCoeffAlpha,
-		     &cellHamMatrixTimesWaveMatrix[numberWaveFunctions*iNode],
-		     &inc,
-		     dst.begin()+localNodeId,
-		     &inc);
-	    }
+  //
+  //element level matrix-vector multiplications in single precision using the low precision
+  //copies of the cell-level hamiltonian matrices. Only the cell level work is done in
+  //single precision, the accumulation into dst is done in double precision
+  //
+  const char transA = 'N',transB = 'N';
+  const double scalarCoeffAlpha = 1.0;
+  const float scalarCoeffAlphaLowPrec = 1.0,scalarCoeffBetaLowPrec = 0.0;
+  const unsigned int inc = 1;
 
-	  ++iElem;
-	}//subcell loop
-    }//macrocell loop
+  //
+  //scratch storage of each thread, allocated once per call and reused for all the cells
+  //
+  dealii::Threads::ThreadLocalStorage<std::vector<float> >
+    cellWaveFunctionMatrixThreadLocal(std::vector<float>(d_numberNodesPerElement*numberWaveFunctions,0.0));
+  dealii::Threads::ThreadLocalStorage<std::vector<float> >
+    cellHamMatrixTimesWaveMatrixThreadLocal(std::vector<float>(d_numberNodesPerElement*numberWaveFunctions,0.0));
+  dealii::Threads::ThreadLocalStorage<std::vector<double> >
+    tempThreadLocal(std::vector<double>(numberWaveFunctions,0.0));
+  dealii::Threads::ThreadLocalStorage<std::vector<float> >
+    cellHamMatrixUnpackedThreadLocal(std::vector<float>(dftParameters::packedCellHamiltonianMatrices?
+							d_numberNodesPerElement*d_numberNodesPerElement:0));
+
+  internal::applyToColoredCells
+    (macroCellColoring,
+     macroCells,
+     [&](const std::vector<unsigned int> & cells,
+	 const unsigned int iCellBegin,
+	 const unsigned int iCellEnd)
+     {
+       std::vector<float> & cellWaveFunctionMatrix = cellWaveFunctionMatrixThreadLocal.get();
+       std::vector<float> & cellHamMatrixTimesWaveMatrix = cellHamMatrixTimesWaveMatrixThreadLocal.get();
+       std::vector<double> & temp = tempThreadLocal.get();
+       std::vector<float> & cellHamMatrixUnpacked = cellHamMatrixUnpackedThreadLocal.get();
+
+       for(unsigned int iCell = iCellBegin; iCell < iCellEnd; ++iCell)
+	 {
+	   const unsigned int iElem = cells[iCell];
+
+	   const float * cellHamMatrix = &d_cellHamiltonianMatrixLowPrec[iElem][0];
+	   if(dftParameters::packedCellHamiltonianMatrices)
+	     {
+	       internal::unpackSymmetricMatrix(cellHamMatrix,
+					       d_numberNodesPerElement,
+					       &cellHamMatrixUnpacked[0]);
+	       cellHamMatrix = &cellHamMatrixUnpacked[0];
+	     }
+
+	   for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	     {
+	       const double * srcNode = src.begin()+d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
+	       for(unsigned int iwave = 0; iwave < numberWaveFunctions; ++iwave)
+		 cellWaveFunctionMatrix[numberWaveFunctions*iNode+iwave] = (float)srcNode[iwave];
+	     }
+
+	   sgemm_(&transA,
+		  &transB,
+		  &numberWaveFunctions,
+		  &d_numberNodesPerElement,
+		  &d_numberNodesPerElement,
+		  &scalarCoeffAlphaLowPrec,
+		  &cellWaveFunctionMatrix[0],
+		  &numberWaveFunctions,
+		  cellHamMatrix,
+		  &d_numberNodesPerElement,
+		  &scalarCoeffBetaLowPrec,
+		  &cellHamMatrixTimesWaveMatrix[0],
+		  &numberWaveFunctions);
+
+	   for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	     {
+	       for(unsigned int iwave = 0; iwave < numberWaveFunctions; ++iwave)
+		 temp[iwave] = (double)cellHamMatrixTimesWaveMatrix[numberWaveFunctions*iNode+iwave];
+
+	       dealii::types::global_dof_index localNodeId = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElem][iNode];
+	       daxpy_(&numberWaveFunctions,
+		      &scalarCoeffAlpha,
+		      &temp[0],
+		      &inc,
+		      dst.begin()+localNodeId,
+		      &inc);
+	     }
+	 }//cell loop
+     });
 
 }
 
@@ -483,10 +630,13 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXBatchGEMM (
   double ** cellWaveFunctionMatrixBatch = new double*[groupSize];
   double ** cellHamMatrixTimesWaveMatrixBatch = new double*[groupSize];
   const double ** cellHamMatrixBatch = new double*[groupSize];
+  double ** cellHamMatrixUnpackedBatch = new double*[groupSize];
   for(unsigned int i = 0; i < groupSize; i++)
     {
       cellWaveFunctionMatrixBatch[i] = new double[d_numberNodesPerElement*numberWaveFunctions];
       cellHamMatrixTimesWaveMatrixBatch[i] = new double[d_numberNodesPerElement*numberWaveFunctions];
+      cellHamMatrixUnpackedBatch[i] = dftParameters::packedCellHamiltonianMatrices?
+	new double[d_numberNodesPerElement*d_numberNodesPerElement]:NULL;
     }
 
   unsigned int iElem= 0;
@@ -505,7 +655,15 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXBatchGEMM (
 		     &inc);
 	    }
 
-	  cellHamMatrixBatch[isubcell] =&d_cellHamiltonianMatrix[iElem+isubcell][0];
+	  if(dftParameters::packedCellHamiltonianMatrices)
+	    {
+	      internal::unpackSymmetricMatrix(&d_cellHamiltonianMatrix[iElem+isubcell][0],
+					      d_numberNodesPerElement,
+					      cellHamMatrixUnpackedBatch[isubcell]);
+	      cellHamMatrixBatch[isubcell] = cellHamMatrixUnpackedBatch[isubcell];
+	    }
+	  else
+	    cellHamMatrixBatch[isubcell] =&d_cellHamiltonianMatrix[iElem+isubcell][0];
 	}
 
       dgemm_batch_(&transA,
@@ -544,10 +702,12 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXBatchGEMM (
     {
       delete [] cellWaveFunctionMatrixBatch[i];
       delete [] cellHamMatrixTimesWaveMatrixBatch[i];
+      delete [] cellHamMatrixUnpackedBatch[i];
     }
   delete [] cellWaveFunctionMatrixBatch;
   delete []  cellHamMatrixTimesWaveMatrixBatch;
   delete []  cellHamMatrixBatch;
+  delete []  cellHamMatrixUnpackedBatch;
 }
 
 template<unsigned int FEOrder>
@@ -571,10 +731,13 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXBatchGEMMSi
   dataTypes::numberLowPrec ** cellWaveFunctionMatrixBatch = new dataTypes::numberLowPrec*[groupSize];
   dataTypes::numberLowPrec ** cellHamMatrixTimesWaveMatrixBatch = new dataTypes::numberLowPrec*[groupSize];
   const dataTypes::numberLowPrec ** cellHamMatrixBatch = new dataTypes::numberLowPrec*[groupSize];
+  dataTypes::numberLowPrec ** cellHamMatrixUnpackedBatch = new dataTypes::numberLowPrec*[groupSize];
   for(unsigned int i = 0; i < groupSize; i++)
     {
       cellWaveFunctionMatrixBatch[i] = new dataTypes::numberLowPrec[d_numberNodesPerElement*numberWaveFunctions];
       cellHamMatrixTimesWaveMatrixBatch[i] = new dataTypes::numberLowPrec[d_numberNodesPerElement*numberWaveFunctions];
+      cellHamMatrixUnpackedBatch[i] = dftParameters::packedCellHamiltonianMatrices?
+	new dataTypes::numberLowPrec[d_numberNodesPerElement*d_numberNodesPerElement]:NULL;
     }
 
   unsigned int iElem= 0;
@@ -599,7 +762,15 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXBatchGEMMSi
 		       =(dataTypes::numberLowPrec)temp[iwave];
 	    }
 
-	  cellHamMatrixBatch[isubcell] =&d_cellHamiltonianMatrixLowPrec[iElem+isubcell][0];
+	  if(dftParameters::packedCellHamiltonianMatrices)
+	    {
+	      internal::unpackSymmetricMatrix(&d_cellHamiltonianMatrixLowPrec[iElem+isubcell][0],
+					      d_numberNodesPerElement,
+					      cellHamMatrixUnpackedBatch[isubcell]);
+	      cellHamMatrixBatch[isubcell] = cellHamMatrixUnpackedBatch[isubcell];
+	    }
+	  else
+	    cellHamMatrixBatch[isubcell] =&d_cellHamiltonianMatrixLowPrec[iElem+isubcell][0];
 	}
 
       sgemm_batch_(&transA,
@@ -644,10 +815,217 @@ void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXBatchGEMMSi
     {
       delete [] cellWaveFunctionMatrixBatch[i];
       delete [] cellHamMatrixTimesWaveMatrixBatch[i];
+      delete [] cellHamMatrixUnpackedBatch[i];
     }
   delete [] cellWaveFunctionMatrixBatch;
   delete []  cellHamMatrixTimesWaveMatrixBatch;
   delete []  cellHamMatrixBatch;
+  delete []  cellHamMatrixUnpackedBatch;
 }
 #endif
 #endif
+
+
+template<unsigned int FEOrder>
+void kohnShamDFTOperatorClass<FEOrder>::computeLocalHamiltonianTimesXMatrixFree(const dealii::parallel::distributed::Vector<dataTypes::number> & src,
+									       const unsigned int numberWaveFunctions,
+									       const std::vector<std::vector<unsigned int> > & macroCellColoring,
+									       const std::vector<unsigned int> & macroCells,
+									       dealii::parallel::distributed::Vector<dataTypes::number> & dst) const
+{
+  const VectorizedArray<double> half = make_vectorized_array(0.5);
+  const VectorizedArray<double> two = make_vectorized_array(2.0);
+  const unsigned int inc = 1;
+  const dataTypes::number scalarCoeffAlpha = 1.0;
+
+  //
+  //FEEvaluation stores the cell dof values in lexicographic order, while the index maps
+  //are in the hierarchic order of the finite element
+  //
+  const std::vector<unsigned int> & lexicographicNumbering = dftPtr->matrix_free_data.get_shape_info(0,0).lexicographic_numbering;
+
+#ifdef USE_COMPLEX
+  Tensor<1,3,VectorizedArray<double> > kPointCoors;
+  kPointCoors[0] = make_vectorized_array(dftPtr->d_kPointCoordinates[3*d_kPointIndex+0]);
+  kPointCoors[1] = make_vectorized_array(dftPtr->d_kPointCoordinates[3*d_kPointIndex+1]);
+  kPointCoors[2] = make_vectorized_array(dftPtr->d_kPointCoordinates[3*d_kPointIndex+2]);
+  const double kSquareTimesHalf =  0.5*(dftPtr->d_kPointCoordinates[3*d_kPointIndex+0]*dftPtr->d_kPointCoordinates[3*d_kPointIndex+0] + dftPtr->d_kPointCoordinates[3*d_kPointIndex+1]*dftPtr->d_kPointCoordinates[3*d_kPointIndex+1] + dftPtr->d_kPointCoordinates[3*d_kPointIndex+2]*dftPtr->d_kPointCoordinates[3*d_kPointIndex+2]);
+  const VectorizedArray<double> halfkSquare = make_vectorized_array(kSquareTimesHalf);
+#endif
+
+  //
+  //scratch storage of each thread, allocated once per call and reused for all the macro cells
+  //
+  const unsigned int numberSubCellsMax = VectorizedArray<double>::n_array_elements;
+  dealii::Threads::ThreadLocalStorage<std::vector<std::vector<dataTypes::number> > >
+    cellWaveFunctionMatrixThreadLocal(std::vector<std::vector<dataTypes::number> >(numberSubCellsMax,
+										   std::vector<dataTypes::number>(d_numberNodesPerElement*numberWaveFunctions,0.0)));
+  dealii::Threads::ThreadLocalStorage<std::vector<std::vector<dataTypes::number> > >
+    cellHamMatrixTimesWaveMatrixThreadLocal(std::vector<std::vector<dataTypes::number> >(numberSubCellsMax,
+											 std::vector<dataTypes::number>(d_numberNodesPerElement*numberWaveFunctions,0.0)));
+
+  internal::applyToColoredCells
+    (macroCellColoring,
+     macroCells,
+     [&](const std::vector<unsigned int> & cells,
+	 const unsigned int macroCellBegin,
+	 const unsigned int macroCellEnd)
+     {
+#ifdef USE_COMPLEX
+       FEEvaluation<3,FEOrder,C_num1DQuad<FEOrder>(),1,double> fe_evalReal(dftPtr->matrix_free_data,0,0);
+       FEEvaluation<3,FEOrder,C_num1DQuad<FEOrder>(),1,double> fe_evalImag(dftPtr->matrix_free_data,0,0);
+       Tensor<1,3,VectorizedArray<double> > gradientPsiReal, gradientPsiImag;
+       VectorizedArray<double> psiReal, psiImag;
+#else
+       FEEvaluation<3,FEOrder,C_num1DQuad<FEOrder>(),1,double> fe_eval(dftPtr->matrix_free_data,0,0);
+       Tensor<1,3,VectorizedArray<double> > gradientPsi;
+       VectorizedArray<double> psi;
+#endif
+       std::vector<std::vector<dataTypes::number> > & cellWaveFunctionMatrix = cellWaveFunctionMatrixThreadLocal.get();
+       std::vector<std::vector<dataTypes::number> > & cellHamMatrixTimesWaveMatrix = cellHamMatrixTimesWaveMatrixThreadLocal.get();
+
+       for(unsigned int iCell = macroCellBegin; iCell < macroCellEnd; ++iCell)
+	 {
+	   const unsigned int iMacroCell = cells[iCell];
+	   const unsigned int numberSubCells = d_macroCellSubCellMap[iMacroCell];
+	   const unsigned int iElemStart = d_macroCellStartIndex[iMacroCell];
+
+	   //
+	   //gather the wavefunction values of the subcells with the nodes in lexicographic order
+	   //
+	   for(unsigned int iSubCell = 0; iSubCell < numberSubCells; ++iSubCell)
+	     for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	       {
+		 const dealii::types::global_dof_index localNodeId
+		   = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElemStart+iSubCell][lexicographicNumbering[iNode]];
+		 std::copy(src.begin()+localNodeId,
+			   src.begin()+localNodeId+numberWaveFunctions,
+			   cellWaveFunctionMatrix[iSubCell].begin()+numberWaveFunctions*iNode);
+	       }
+
+#ifdef USE_COMPLEX
+	   fe_evalReal.reinit(iMacroCell);
+	   fe_evalImag.reinit(iMacroCell);
+#else
+	   fe_eval.reinit(iMacroCell);
+#endif
+
+	   //
+	   //sum factorized evaluation of Hloc times one wavefunction at a time,
+	   //vectorized over the subcells of the macro cell
+	   //
+	   for(unsigned int iWave = 0; iWave < numberWaveFunctions; ++iWave)
+	     {
+#ifdef USE_COMPLEX
+	       for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+		 {
+		   VectorizedArray<double> & valueReal = fe_evalReal.begin_dof_values()[iNode];
+		   VectorizedArray<double> & valueImag = fe_evalImag.begin_dof_values()[iNode];
+		   valueReal = make_vectorized_array(0.0);
+		   valueImag = make_vectorized_array(0.0);
+		   for(unsigned int iSubCell = 0; iSubCell < numberSubCells; ++iSubCell)
+		     {
+		       valueReal[iSubCell] = cellWaveFunctionMatrix[iSubCell][numberWaveFunctions*iNode+iWave].real();
+		       valueImag[iSubCell] = cellWaveFunctionMatrix[iSubCell][numberWaveFunctions*iNode+iWave].imag();
+		     }
+		 }
+
+	       fe_evalReal.evaluate(true,true,false);
+	       fe_evalImag.evaluate(true,true,false);
+	       for(unsigned int q = 0; q < fe_evalReal.n_q_points; ++q)
+		 {
+		   psiReal = fe_evalReal.get_value(q);
+		   psiImag = fe_evalImag.get_value(q);
+		   gradientPsiReal = fe_evalReal.get_gradient(q);
+		   gradientPsiImag = fe_evalImag.get_gradient(q);
+
+		   //
+		   //Veff, 0.5*k^2 and k dot gradient terms
+		   //
+		   VectorizedArray<double> valueTermReal = (vEff(iMacroCell,q)+halfkSquare)*psiReal + scalar_product(kPointCoors,gradientPsiImag);
+		   VectorizedArray<double> valueTermImag = (vEff(iMacroCell,q)+halfkSquare)*psiImag - scalar_product(kPointCoors,gradientPsiReal);
+		   Tensor<1,3,VectorizedArray<double> > gradientTermReal = gradientPsiReal*half;
+		   Tensor<1,3,VectorizedArray<double> > gradientTermImag = gradientPsiImag*half;
+
+		   if(dftParameters::xc_id == 4)
+		     {
+		       valueTermReal += two*scalar_product(derExcWithSigmaTimesGradRho(iMacroCell,q),gradientPsiReal);
+		       valueTermImag += two*scalar_product(derExcWithSigmaTimesGradRho(iMacroCell,q),gradientPsiImag);
+		       gradientTermReal += two*derExcWithSigmaTimesGradRho(iMacroCell,q)*psiReal;
+		       gradientTermImag += two*derExcWithSigmaTimesGradRho(iMacroCell,q)*psiImag;
+		     }
+
+		   fe_evalReal.submit_value(valueTermReal,q);
+		   fe_evalImag.submit_value(valueTermImag,q);
+		   fe_evalReal.submit_gradient(gradientTermReal,q);
+		   fe_evalImag.submit_gradient(gradientTermImag,q);
+		 }
+	       fe_evalReal.integrate(true,true);
+	       fe_evalImag.integrate(true,true);
+
+	       for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+		 for(unsigned int iSubCell = 0; iSubCell < numberSubCells; ++iSubCell)
+		   cellHamMatrixTimesWaveMatrix[iSubCell][numberWaveFunctions*iNode+iWave]
+		     = std::complex<double>(fe_evalReal.begin_dof_values()[iNode][iSubCell],
+					    fe_evalImag.begin_dof_values()[iNode][iSubCell]);
+#else
+	       for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+		 {
+		   VectorizedArray<double> & value = fe_eval.begin_dof_values()[iNode];
+		   value = make_vectorized_array(0.0);
+		   for(unsigned int iSubCell = 0; iSubCell < numberSubCells; ++iSubCell)
+		     value[iSubCell] = cellWaveFunctionMatrix[iSubCell][numberWaveFunctions*iNode+iWave];
+		 }
+
+	       fe_eval.evaluate(true,true,false);
+	       for(unsigned int q = 0; q < fe_eval.n_q_points; ++q)
+		 {
+		   psi = fe_eval.get_value(q);
+		   gradientPsi = fe_eval.get_gradient(q);
+		   if(dftParameters::xc_id == 4)
+		     {
+		       fe_eval.submit_gradient(gradientPsi*half + two*derExcWithSigmaTimesGradRho(iMacroCell,q)*psi,q);
+		       fe_eval.submit_value(vEff(iMacroCell,q)*psi + two*scalar_product(derExcWithSigmaTimesGradRho(iMacroCell,q),gradientPsi),q);
+		     }
+		   else
+		     {
+		       fe_eval.submit_gradient(gradientPsi*half,q);
+		       fe_eval.submit_value(vEff(iMacroCell,q)*psi,q);
+		     }
+		 }
+	       fe_eval.integrate(true,true);
+
+	       for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+		 for(unsigned int iSubCell = 0; iSubCell < numberSubCells; ++iSubCell)
+		   cellHamMatrixTimesWaveMatrix[iSubCell][numberWaveFunctions*iNode+iWave]
+		     = fe_eval.begin_dof_values()[iNode][iSubCell];
+#endif
+	     }//wavefunction loop
+
+	   //
+	   //scatter the cell level products into dst
+	   //
+	   for(unsigned int iSubCell = 0; iSubCell < numberSubCells; ++iSubCell)
+	     for(unsigned int iNode = 0; iNode < d_numberNodesPerElement; ++iNode)
+	       {
+		 const dealii::types::global_dof_index localNodeId
+		   = d_flattenedArrayMacroCellLocalProcIndexIdMap[iElemStart+iSubCell][lexicographicNumbering[iNode]];
+#ifdef USE_COMPLEX
+		 zaxpy_(&numberWaveFunctions,
+			&scalarCoeffAlpha,
+			&cellHamMatrixTimesWaveMatrix[iSubCell][numberWaveFunctions*iNode],
+			&inc,
+			dst.begin()+localNodeId,
+			&inc);
+#else
+		 daxpy_(&numberWaveFunctions,
+			&scalarCoeffAlpha,
+			&cellHamMatrixTimesWaveMatrix[iSubCell][numberWaveFunctions*iNode],
+			&inc,
+			dst.begin()+localNodeId,
+			&inc);
+#endif
+	       }
+	 }//macro cell loop
+     });
+}
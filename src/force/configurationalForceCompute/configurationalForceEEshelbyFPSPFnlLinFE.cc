@@ -72,8 +72,8 @@ void forceClass<FEOrder>::computeConfigurationalForceEEshelbyTensorFPSPFnlLinFE
 		              const unsigned int phiExtDofHandlerIndexElectro,
 		              const vectorType & phiTotRhoOutElectro,
 		              const vectorType & phiExtElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		              const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -124,24 +124,6 @@ void forceClass<FEOrder>::computeConfigurationalForceEEshelbyTensorFPSPFnlLinFE
 									     2);
 #endif
 
-#ifdef USE_COMPLEX
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),2> psiEval(matrixFreeData,
-	                                                       eigenDofHandlerIndex,
-							       0);
-
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),2> psiEvalNLP(matrixFreeData,
-	                                                       eigenDofHandlerIndex,
-							       2);
-#else
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),1> psiEval(matrixFreeData,
-	                                                       eigenDofHandlerIndex,
-							       0);
-
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),1> psiEvalNLP(matrixFreeData,
-	                                                       eigenDofHandlerIndex,
-							       2);
-#endif
-
   FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),1> phiTotInEval(matrixFreeData,
 	                                                            phiTotDofHandlerIndex,
 								    0);
@@ -211,16 +193,12 @@ void forceClass<FEOrder>::computeConfigurationalForceEEshelbyTensorFPSPFnlLinFE
     forceEvalKPoints.reinit(cell);
 #endif
 
-    psiEval.reinit(cell);
-
     if (isPseudopotential && dftParameters::useHigherQuadNLP)
     {
       forceEvalNLP.reinit(cell);
 #ifdef USE_COMPLEX
       forceEvalKPointsNLP.reinit(cell);
 #endif
-
-      psiEvalNLP.reinit(cell);
     }
 
     if (d_isElectrostaticsMeshSubdivided || dftParameters::nonSelfConsistentForce)
@@ -389,42 +367,84 @@ void forceClass<FEOrder>::computeConfigurationalForceEEshelbyTensorFPSPFnlLinFE
 #ifdef USE_COMPLEX
     std::vector<Tensor<1,2,VectorizedArray<double> > > psiQuads(numQuadPoints*numEigenVectors*numKPoints,zeroTensor1);
     std::vector<Tensor<1,2,Tensor<1,C_DIM,VectorizedArray<double> > > > gradPsiQuads(numQuadPoints*numEigenVectors*numKPoints,zeroTensor2);
-    Tensor<1,2,Tensor<2,C_DIM,VectorizedArray<double> > >  tempHessianPsi;
-    tempHessianPsi[0]=zeroTensor4;tempHessianPsi[1]=zeroTensor4;
+    std::vector<Tensor<1,2,Tensor<2,C_DIM,VectorizedArray<double> > > > hessianPsiQuads;
 #else
     std::vector< VectorizedArray<double> > psiQuads(numQuadPoints*numEigenVectors,make_vectorized_array(0.0));
     std::vector<Tensor<1,C_DIM,VectorizedArray<double> > > gradPsiQuads(numQuadPoints*numEigenVectors,zeroTensor3);
-    Tensor<2,C_DIM,VectorizedArray<double> >  tempHessianPsi=zeroTensor4;
+    std::vector<Tensor<2,C_DIM,VectorizedArray<double> > > hessianPsiQuads;
 #endif
+    if (dftParameters::nonSelfConsistentForce)
+       hessianPsiQuads.resize(psiQuads.size());
 
-    for (unsigned int ikPoint=0; ikPoint<numKPoints; ++ikPoint)
-        for (unsigned int iEigenVec=0; iEigenVec<numEigenVectors; ++iEigenVec)
-        {
-	  psiEval.read_dof_values_plain(eigenVectors[ikPoint][iEigenVec]);
-	  if (dftParameters::nonSelfConsistentForce)
-             psiEval.evaluate(true,true,true);
-	  else
-             psiEval.evaluate(true,true);
+    //
+    //evaluate the wavefunctions at the quadrature points. The (kPoint,eigenvector) pairs are distributed
+    //among the threads, each thread using its own FEEvaluation object
+    //
+    dealii::parallel::apply_to_subranges
+      (0U,
+       numKPoints*numEigenVectors,
+       [&](const unsigned int begin, const unsigned int end)
+       {
+#ifdef USE_COMPLEX
+	 FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),2> psiEval(matrixFreeData,
+								      eigenDofHandlerIndex,
+								      0);
+#else
+	 FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),1> psiEval(matrixFreeData,
+								      eigenDofHandlerIndex,
+								      0);
+#endif
+	 psiEval.reinit(cell);
 
-          for (unsigned int q=0; q<numQuadPoints; ++q)
-          {
-	     const unsigned int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
-             psiQuads[id]=psiEval.get_value(q);
-             gradPsiQuads[id]=psiEval.get_gradient(q);
-	     if (dftParameters::nonSelfConsistentForce)
-	        tempHessianPsi=psiEval.get_hessian(q);
-
-	     const double partOcc =dftUtils::getPartialOccupancy(dftPtr->eigenValues[ikPoint][iEigenVec],
-		                                                 dftPtr->fermiEnergy,
-							         C_kb,
-							         dftParameters::TVal);
-	     const VectorizedArray<double> factor=make_vectorized_array(2.0*dftPtr->d_kPointWeights[ikPoint]*partOcc);
-	     gradRhoQuads[q]+=factor*internalforce::computeGradRhoContribution(psiQuads[id],gradPsiQuads[id]);
-
-	     if (dftParameters::nonSelfConsistentForce)
-		 hessianRhoQuads[q]+=factor*internalforce::computeHessianRhoContribution(psiQuads[id],gradPsiQuads[id], tempHessianPsi);
-          }//quad point loop
-        } //eigenvector loop
+	 for (unsigned int i=begin; i<end; ++i)
+	 {
+	   const unsigned int ikPoint=i/numEigenVectors;
+	   const unsigned int iEigenVec=i%numEigenVectors;
+
+	   psiEval.read_dof_values_plain(eigenVectors[ikPoint][iEigenVec]);
+	   if (dftParameters::nonSelfConsistentForce)
+	      psiEval.evaluate(true,true,true);
+	   else
+	      psiEval.evaluate(true,true);
+
+	   for (unsigned int q=0; q<numQuadPoints; ++q)
+	   {
+	      const unsigned int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
+	      psiQuads[id]=psiEval.get_value(q);
+	      gradPsiQuads[id]=psiEval.get_gradient(q);
+	      if (dftParameters::nonSelfConsistentForce)
+		 hessianPsiQuads[id]=psiEval.get_hessian(q);
+	   }//quad point loop
+	 }//eigenvector loop
+       },
+       1);
+
+    //
+    //accumulate the gradRho and hessianRho contributions. The quadrature points are distributed among
+    //the threads and the summation order over the eigenvectors is the same for each quadrature point
+    //
+    dealii::parallel::apply_to_subranges
+      (0U,
+       numQuadPoints,
+       [&](const unsigned int qBegin, const unsigned int qEnd)
+       {
+	 for (unsigned int q=qBegin; q<qEnd; ++q)
+	   for (unsigned int ikPoint=0; ikPoint<numKPoints; ++ikPoint)
+	     for (unsigned int iEigenVec=0; iEigenVec<numEigenVectors; ++iEigenVec)
+	     {
+		const unsigned int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
+		const double partOcc =dftUtils::getPartialOccupancy(dftPtr->eigenValues[ikPoint][iEigenVec],
+								    dftPtr->fermiEnergy,
+								    C_kb,
+								    dftParameters::TVal);
+		const VectorizedArray<double> factor=make_vectorized_array(2.0*dftPtr->d_kPointWeights[ikPoint]*partOcc);
+		gradRhoQuads[q]+=factor*internalforce::computeGradRhoContribution(psiQuads[id],gradPsiQuads[id]);
+
+		if (dftParameters::nonSelfConsistentForce)
+		    hessianRhoQuads[q]+=factor*internalforce::computeHessianRhoContribution(psiQuads[id],gradPsiQuads[id],hessianPsiQuads[id]);
+	     }//eigenvector loop
+       },
+       1);
 
     //accumulate gradRho and hessian rho quad point contribution from all pools
     for (unsigned int iSubCell=0; iSubCell<numSubCells; ++iSubCell)
@@ -451,18 +471,38 @@ void forceClass<FEOrder>::computeConfigurationalForceEEshelbyTensorFPSPFnlLinFE
 #else
 	psiQuadsNLP.resize(numQuadPointsNLP*numEigenVectors,make_vectorized_array(0.0));
 #endif
-	for (unsigned int ikPoint=0; ikPoint<numKPoints; ++ikPoint)
-	    for (unsigned int iEigenVec=0; iEigenVec<numEigenVectors; ++iEigenVec)
-	    {
-	      psiEvalNLP.read_dof_values_plain(eigenVectors[ikPoint][iEigenVec]);
-	      psiEvalNLP.evaluate(true,false);
-
-	      for (unsigned int q=0; q<numQuadPointsNLP; ++q)
-	      {
-		 const unsigned int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
-		 psiQuadsNLP[id]=psiEvalNLP.get_value(q);
-	      }//quad point loop
-	    } //eigenvector loop
+	dealii::parallel::apply_to_subranges
+	  (0U,
+	   numKPoints*numEigenVectors,
+	   [&](const unsigned int begin, const unsigned int end)
+	   {
+#ifdef USE_COMPLEX
+	     FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),2> psiEvalNLP(matrixFreeData,
+									    eigenDofHandlerIndex,
+									    2);
+#else
+	     FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),1> psiEvalNLP(matrixFreeData,
+									    eigenDofHandlerIndex,
+									    2);
+#endif
+	     psiEvalNLP.reinit(cell);
+
+	     for (unsigned int i=begin; i<end; ++i)
+	     {
+	       const unsigned int ikPoint=i/numEigenVectors;
+	       const unsigned int iEigenVec=i%numEigenVectors;
+
+	       psiEvalNLP.read_dof_values_plain(eigenVectors[ikPoint][iEigenVec]);
+	       psiEvalNLP.evaluate(true,false);
+
+	       for (unsigned int q=0; q<numQuadPointsNLP; ++q)
+	       {
+		  const unsigned int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
+		  psiQuadsNLP[id]=psiEvalNLP.get_value(q);
+	       }//quad point loop
+	     }//eigenvector loop
+	   },
+	   1);
     }
 
     if(isPseudopotential)
@@ -540,150 +580,200 @@ void forceClass<FEOrder>::computeConfigurationalForceEEshelbyTensorFPSPFnlLinFE
 
     }//is pseudopotential check
 
-    for (unsigned int q=0; q<numQuadPoints; ++q)
-    {
-       const VectorizedArray<double> phiTot_q =d_isElectrostaticsMeshSubdivided?
-	                                        phiTotOutEval.get_value(q)
-						:make_vectorized_array(0.0);
-       const VectorizedArray<double> phiExt_q =d_isElectrostaticsMeshSubdivided?
-	                                        phiExtEval.get_value(q)
-						:make_vectorized_array(0.0);
-
-       Tensor<2,C_DIM,VectorizedArray<double> > E=eshelbyTensor::getELocXcEshelbyTensor
-						  (rhoQuads[q],
-						  gradRhoQuads[q],
-						  excQuads[q],
-						  derExchCorrEnergyWithGradRhoOutQuads[q]);
+    //
+    //the Eshelby tensors, which involve sums over all the eigenvectors, are computed in parallel over the
+    //quadrature points and then submitted to the FEEvaluation objects
+    //
+    std::vector<Tensor<1,C_DIM,VectorizedArray<double> > > FQuads(numQuadPoints,zeroTensor3);
+    std::vector<Tensor<2,C_DIM,VectorizedArray<double> > > EQuads(numQuadPoints,zeroTensor4);
+#ifdef USE_COMPLEX
+    std::vector<Tensor<1,C_DIM,VectorizedArray<double> > > FKPointsQuads(numQuadPoints,zeroTensor3);
+    std::vector<Tensor<2,C_DIM,VectorizedArray<double> > > EKPointsQuads(numQuadPoints,zeroTensor4);
+#endif
+    dealii::parallel::apply_to_subranges
+      (0U,
+       numQuadPoints,
+       [&](const unsigned int qBegin, const unsigned int qEnd)
+       {
+	 for (unsigned int q=qBegin; q<qEnd; ++q)
+	 {
+	    const VectorizedArray<double> phiTot_q =d_isElectrostaticsMeshSubdivided?
+						     phiTotOutEval.get_value(q)
+						     :make_vectorized_array(0.0);
+	    const VectorizedArray<double> phiExt_q =d_isElectrostaticsMeshSubdivided?
+						     phiExtEval.get_value(q)
+						     :make_vectorized_array(0.0);
+
+	    Tensor<2,C_DIM,VectorizedArray<double> > E=eshelbyTensor::getELocXcEshelbyTensor
+						       (rhoQuads[q],
+						       gradRhoQuads[q],
+						       excQuads[q],
+						       derExchCorrEnergyWithGradRhoOutQuads[q]);
 
 #ifdef USE_COMPLEX
-       Tensor<2,C_DIM,VectorizedArray<double> > EKPoints=eshelbyTensor::getELocWfcEshelbyTensorPeriodicKPoints
-						             (psiQuads.begin()+q*numEigenVectors*numKPoints,
-						              gradPsiQuads.begin()+q*numEigenVectors*numKPoints,
-							      dftPtr->d_kPointCoordinates,
-							      dftPtr->d_kPointWeights,
-							      dftPtr->eigenValues,
-							      dftPtr->fermiEnergy,
-							      dftParameters::TVal);
+	    Tensor<2,C_DIM,VectorizedArray<double> > EKPoints=eshelbyTensor::getELocWfcEshelbyTensorPeriodicKPoints
+								  (psiQuads.begin()+q*numEigenVectors*numKPoints,
+								   gradPsiQuads.begin()+q*numEigenVectors*numKPoints,
+								   dftPtr->d_kPointCoordinates,
+								   dftPtr->d_kPointWeights,
+								   dftPtr->eigenValues,
+								   dftPtr->fermiEnergy,
+								   dftParameters::TVal);
 #else
-       E+=eshelbyTensor::getELocWfcEshelbyTensorNonPeriodic
-					 (psiQuads.begin()+q*numEigenVectors,
-					 gradPsiQuads.begin()+q*numEigenVectors,
-					 (dftPtr->eigenValues)[0],
-					 dftPtr->fermiEnergy,
-					 dftParameters::TVal);
+	    E+=eshelbyTensor::getELocWfcEshelbyTensorNonPeriodic
+					      (psiQuads.begin()+q*numEigenVectors,
+					      gradPsiQuads.begin()+q*numEigenVectors,
+					      (dftPtr->eigenValues)[0],
+					      dftPtr->fermiEnergy,
+					      dftParameters::TVal);
 #endif
-       Tensor<1,C_DIM,VectorizedArray<double> > F=zeroTensor3;
+	    Tensor<1,C_DIM,VectorizedArray<double> > F=zeroTensor3;
 
-       if(d_isElectrostaticsMeshSubdivided)
-	   F-=gradRhoQuads[q]*phiTot_q;
+	    if(d_isElectrostaticsMeshSubdivided)
+		F-=gradRhoQuads[q]*phiTot_q;
 
-       if(isPseudopotential)
-       {
-	   //F+=rhoQuads[q]*gradPseudoVLocQuads[q];
+	    if(isPseudopotential)
+	    {
+		//F+=rhoQuads[q]*gradPseudoVLocQuads[q];
 
-           if(d_isElectrostaticsMeshSubdivided)
-	      F-=gradRhoQuads[q]*(pseudoVLocQuads[q]-phiExt_q);
+		if(d_isElectrostaticsMeshSubdivided)
+		   F-=gradRhoQuads[q]*(pseudoVLocQuads[q]-phiExt_q);
 
-	   if (!dftParameters::useHigherQuadNLP)
-	   {
+		if (!dftParameters::useHigherQuadNLP)
+		{
 #ifdef USE_COMPLEX
-	       Tensor<1,C_DIM,VectorizedArray<double> > FKPoints
-	          =eshelbyTensor::getFnlPeriodic(gradZetaDeltaVQuads[q],
-						projectorKetTimesPsiTimesV,
-						psiQuads.begin()+q*numEigenVectors*numKPoints,
-						dftPtr->d_kPointWeights,
-						dftPtr->eigenValues,
-						dftPtr->fermiEnergy,
-						dftParameters::TVal);
-
-
-	       EKPoints+=eshelbyTensor::getEnlEshelbyTensorPeriodic(ZetaDeltaVQuads[q],
-							     projectorKetTimesPsiTimesV,
-							     psiQuads.begin()+q*numEigenVectors*numKPoints,
-							     dftPtr->d_kPointWeights,
-							     dftPtr->eigenValues,
-							     dftPtr->fermiEnergy,
-							     dftParameters::TVal);
-	       forceEvalKPoints.submit_value(FKPoints,q);
+		    Tensor<1,C_DIM,VectorizedArray<double> > FKPoints
+		       =eshelbyTensor::getFnlPeriodic(gradZetaDeltaVQuads[q],
+						     projectorKetTimesPsiTimesV,
+						     psiQuads.begin()+q*numEigenVectors*numKPoints,
+						     dftPtr->d_kPointWeights,
+						     dftPtr->eigenValues,
+						     dftPtr->fermiEnergy,
+						     dftParameters::TVal);
+
+
+		    EKPoints+=eshelbyTensor::getEnlEshelbyTensorPeriodic(ZetaDeltaVQuads[q],
+								  projectorKetTimesPsiTimesV,
+								  psiQuads.begin()+q*numEigenVectors*numKPoints,
+								  dftPtr->d_kPointWeights,
+								  dftPtr->eigenValues,
+								  dftPtr->fermiEnergy,
+								  dftParameters::TVal);
+		    FKPointsQuads[q]=FKPoints;
 #else
-	       F+=eshelbyTensor::getFnlNonPeriodic(gradZetaDeltaVQuads[q],
-						   projectorKetTimesPsiTimesV[0],
-						   psiQuads.begin()+q*numEigenVectors,
-						   (dftPtr->eigenValues)[0],
-						   dftPtr->fermiEnergy,
-						   dftParameters::TVal);
-
-	       E+=eshelbyTensor::getEnlEshelbyTensorNonPeriodic(ZetaDeltaVQuads[q],
-								projectorKetTimesPsiTimesV[0],
-								psiQuads.begin()+q*numEigenVectors,
-								(dftPtr->eigenValues)[0],
-								dftPtr->fermiEnergy,
-								dftParameters::TVal);
+		    F+=eshelbyTensor::getFnlNonPeriodic(gradZetaDeltaVQuads[q],
+							projectorKetTimesPsiTimesV[0],
+							psiQuads.begin()+q*numEigenVectors,
+							(dftPtr->eigenValues)[0],
+							dftPtr->fermiEnergy,
+							dftParameters::TVal);
+
+		    E+=eshelbyTensor::getEnlEshelbyTensorNonPeriodic(ZetaDeltaVQuads[q],
+								     projectorKetTimesPsiTimesV[0],
+								     psiQuads.begin()+q*numEigenVectors,
+								     (dftPtr->eigenValues)[0],
+								     dftPtr->fermiEnergy,
+								     dftParameters::TVal);
 #endif
-	   }
+		}
 
-       }
+	    }
 
-       if (dftParameters::nonSelfConsistentForce)
-	   F+=eshelbyTensor::getNonSelfConsistentForce(vEffRhoInQuads[q],
-						       vEffRhoOutQuads[q],
-						       gradRhoQuads[q],
-						       derExchCorrEnergyWithGradRhoInQuads[q],
-						       derExchCorrEnergyWithGradRhoOutQuads[q],
-						       hessianRhoQuads[q]);
+	    if (dftParameters::nonSelfConsistentForce)
+		F+=eshelbyTensor::getNonSelfConsistentForce(vEffRhoInQuads[q],
+							    vEffRhoOutQuads[q],
+							    gradRhoQuads[q],
+							    derExchCorrEnergyWithGradRhoInQuads[q],
+							    derExchCorrEnergyWithGradRhoOutQuads[q],
+							    hessianRhoQuads[q]);
 
 
-       forceEval.submit_value(F,q);
-       forceEval.submit_gradient(E,q);
+	    FQuads[q]=F;
+	    EQuads[q]=E;
+#ifdef USE_COMPLEX
+	    EKPointsQuads[q]=EKPoints;
+#endif
+	 }//quad point loop
+       },
+       1);
+
+    for (unsigned int q=0; q<numQuadPoints; ++q)
+    {
+       forceEval.submit_value(FQuads[q],q);
+       forceEval.submit_gradient(EQuads[q],q);
 #ifdef USE_COMPLEX
-       forceEvalKPoints.submit_gradient(EKPoints,q);
+       if (isPseudopotential && !dftParameters::useHigherQuadNLP)
+	  forceEvalKPoints.submit_value(FKPointsQuads[q],q);
+       forceEvalKPoints.submit_gradient(EKPointsQuads[q],q);
 #endif
-    }//quad point loop
+    }
 
     if (isPseudopotential && dftParameters::useHigherQuadNLP)
+    {
+	std::vector<Tensor<1,C_DIM,VectorizedArray<double> > > FNLPQuads(numQuadPointsNLP,zeroTensor3);
+	std::vector<Tensor<2,C_DIM,VectorizedArray<double> > > ENLPQuads(numQuadPointsNLP,zeroTensor4);
+	dealii::parallel::apply_to_subranges
+	  (0U,
+	   numQuadPointsNLP,
+	   [&](const unsigned int qBegin, const unsigned int qEnd)
+	   {
+	     for (unsigned int q=qBegin; q<qEnd; ++q)
+	     {
+#ifdef USE_COMPLEX
+		    Tensor<1,C_DIM,VectorizedArray<double> > FKPoints
+		      =eshelbyTensor::getFnlPeriodic(gradZetaDeltaVQuads[q],
+						     projectorKetTimesPsiTimesV,
+						     psiQuadsNLP.begin()+q*numEigenVectors*numKPoints,
+						     dftPtr->d_kPointWeights,
+						     dftPtr->eigenValues,
+						     dftPtr->fermiEnergy,
+						     dftParameters::TVal);
+
+		    Tensor<2,C_DIM,VectorizedArray<double> > EKPoints
+		      =eshelbyTensor::getEnlEshelbyTensorPeriodic(ZetaDeltaVQuads[q],
+								  projectorKetTimesPsiTimesV,
+								  psiQuadsNLP.begin()+q*numEigenVectors*numKPoints,
+								  dftPtr->d_kPointWeights,
+								  dftPtr->eigenValues,
+								  dftPtr->fermiEnergy,
+								  dftParameters::TVal);
+		    FNLPQuads[q]=FKPoints;
+		    ENLPQuads[q]=EKPoints;
+#else
+		    Tensor<1,C_DIM,VectorizedArray<double> > F
+		      =eshelbyTensor::getFnlNonPeriodic(gradZetaDeltaVQuads[q],
+							projectorKetTimesPsiTimesV[0],
+							psiQuadsNLP.begin()+q*numEigenVectors,
+							(dftPtr->eigenValues)[0],
+							dftPtr->fermiEnergy,
+							dftParameters::TVal);
+
+		    Tensor<2,C_DIM,VectorizedArray<double> >	E
+		      =eshelbyTensor::getEnlEshelbyTensorNonPeriodic(ZetaDeltaVQuads[q],
+								     projectorKetTimesPsiTimesV[0],
+								     psiQuadsNLP.begin()+q*numEigenVectors,
+								     (dftPtr->eigenValues)[0],
+								     dftPtr->fermiEnergy,
+								     dftParameters::TVal);
+
+		    FNLPQuads[q]=F;
+		    ENLPQuads[q]=E;
+#endif
+	     }//nonlocal psp quad points loop
+	   },
+	   1);
+
 	for (unsigned int q=0; q<numQuadPointsNLP; ++q)
 	{
 #ifdef USE_COMPLEX
-	       Tensor<1,C_DIM,VectorizedArray<double> > FKPoints
-	         =eshelbyTensor::getFnlPeriodic(gradZetaDeltaVQuads[q],
-						projectorKetTimesPsiTimesV,
-						psiQuadsNLP.begin()+q*numEigenVectors*numKPoints,
-						dftPtr->d_kPointWeights,
-						dftPtr->eigenValues,
-						dftPtr->fermiEnergy,
-						dftParameters::TVal);
-
-               Tensor<2,C_DIM,VectorizedArray<double> > EKPoints
-	         =eshelbyTensor::getEnlEshelbyTensorPeriodic(ZetaDeltaVQuads[q],
-							     projectorKetTimesPsiTimesV,
-							     psiQuadsNLP.begin()+q*numEigenVectors*numKPoints,
-							     dftPtr->d_kPointWeights,
-							     dftPtr->eigenValues,
-							     dftPtr->fermiEnergy,
-							     dftParameters::TVal);
-	       forceEvalKPointsNLP.submit_value(FKPoints,q);
-	       forceEvalKPointsNLP.submit_gradient(EKPoints,q);
+	   forceEvalKPointsNLP.submit_value(FNLPQuads[q],q);
+	   forceEvalKPointsNLP.submit_gradient(ENLPQuads[q],q);
 #else
-	       Tensor<1,C_DIM,VectorizedArray<double> > F
-	         =eshelbyTensor::getFnlNonPeriodic(gradZetaDeltaVQuads[q],
-						   projectorKetTimesPsiTimesV[0],
-						   psiQuadsNLP.begin()+q*numEigenVectors,
-						   (dftPtr->eigenValues)[0],
-						   dftPtr->fermiEnergy,
-						   dftParameters::TVal);
-
-	       Tensor<2,C_DIM,VectorizedArray<double> >	E
-	         =eshelbyTensor::getEnlEshelbyTensorNonPeriodic(ZetaDeltaVQuads[q],
-								projectorKetTimesPsiTimesV[0],
-								psiQuadsNLP.begin()+q*numEigenVectors,
-								(dftPtr->eigenValues)[0],
-								dftPtr->fermiEnergy,
-								dftParameters::TVal);
-
-               forceEvalNLP.submit_value(F,q);
-	       forceEvalNLP.submit_gradient(E,q);
+	   forceEvalNLP.submit_value(FNLPQuads[q],q);
+	   forceEvalNLP.submit_gradient(ENLPQuads[q],q);
 #endif
-	}//nonlocal psp quad points loop
+	}
+    }
 
     forceEval.integrate(true,true);
 
@@ -756,8 +846,8 @@ void forceClass<FEOrder>::computeConfigurationalForceEEshelbyEElectroPhiTot
 		         const unsigned int phiExtDofHandlerIndexElectro,
 		         const vectorType & phiTotRhoOutElectro,
 		         const vectorType & phiExtElectro,
-			 const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			 const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			 const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			 const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		         const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		         const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 			 const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -824,14 +914,14 @@ void forceClass<FEOrder>::computeConfigurationalForceEEshelbyEElectroPhiTot
        subCellPtr= matrixFreeDataElectro.get_cell_iterator(cell,iSubCell);
        dealii::CellId subCellId=subCellPtr->id();
        for (unsigned int q=0; q<numQuadPoints; ++q)
-         rhoQuadsElectro[q][iSubCell]=rhoOutValuesElectro.find(subCellId)->second[q];
+         rhoQuadsElectro[q][iSubCell]=rhoOutValuesElectro[subCellId][q];
 
        if(d_isElectrostaticsMeshSubdivided)
 	  for (unsigned int q=0; q<numQuadPoints; ++q)
 	  {
-	     gradRhoQuadsElectro[q][0][iSubCell]=gradRhoOutValuesElectro.find(subCellId)->second[C_DIM*q+0];
-	     gradRhoQuadsElectro[q][1][iSubCell]=gradRhoOutValuesElectro.find(subCellId)->second[C_DIM*q+1];
-	     gradRhoQuadsElectro[q][2][iSubCell]=gradRhoOutValuesElectro.find(subCellId)->second[C_DIM*q+2];
+	     gradRhoQuadsElectro[q][0][iSubCell]=gradRhoOutValuesElectro[subCellId][C_DIM*q+0];
+	     gradRhoQuadsElectro[q][1][iSubCell]=gradRhoOutValuesElectro[subCellId][C_DIM*q+1];
+	     gradRhoQuadsElectro[q][2][iSubCell]=gradRhoOutValuesElectro[subCellId][C_DIM*q+2];
 	  }
 
        if(dftParameters::isPseudopotential)
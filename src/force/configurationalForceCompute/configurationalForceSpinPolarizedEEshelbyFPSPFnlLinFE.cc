@@ -34,8 +34,8 @@ void forceClass<FEOrder>::computeConfigurationalForceSpinPolarizedEEshelbyTensor
 		              const unsigned int phiExtDofHandlerIndexElectro,
 		              const vectorType & phiTotRhoOutElectro,
 		              const vectorType & phiExtElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		              const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -87,34 +87,6 @@ void forceClass<FEOrder>::computeConfigurationalForceSpinPolarizedEEshelbyTensor
 									     2);
 #endif
 
-#ifdef USE_COMPLEX
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),2> psiEvalSpin0(matrixFreeData,
-	                                                            eigenDofHandlerIndex,
-								    0);
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),2> psiEvalSpin1(matrixFreeData,
-	                                                            eigenDofHandlerIndex,
-								    0);
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),2> psiEvalSpin0NLP(matrixFreeData,
-	                                                            eigenDofHandlerIndex,
-								    2);
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),2> psiEvalSpin1NLP(matrixFreeData,
-	                                                            eigenDofHandlerIndex,
-								    2);
-#else
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),1> psiEvalSpin0(matrixFreeData,
-	                                                            eigenDofHandlerIndex,
-								    0);
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),1> psiEvalSpin1(matrixFreeData,
-	                                                            eigenDofHandlerIndex,
-								    0);
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),1> psiEvalSpin0NLP(matrixFreeData,
-	                                                               eigenDofHandlerIndex,
-								       2);
-  FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),1> psiEvalSpin1NLP(matrixFreeData,
-	                                                                  eigenDofHandlerIndex,
-								          2);
-#endif
-
   FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),1> phiTotOutEval(matrixFreeData,
 	                                                          phiTotDofHandlerIndex,
 								  0);
@@ -194,8 +166,6 @@ void forceClass<FEOrder>::computeConfigurationalForceSpinPolarizedEEshelbyTensor
 #ifdef USE_COMPLEX
     forceEvalKPoints.reinit(cell);
 #endif
-    psiEvalSpin0.reinit(cell);
-    psiEvalSpin1.reinit(cell);
 
     if (isPseudopotential && dftParameters::useHigherQuadNLP)
     {
@@ -203,9 +173,6 @@ void forceClass<FEOrder>::computeConfigurationalForceSpinPolarizedEEshelbyTensor
 #ifdef USE_COMPLEX
       forceEvalKPointsNLP.reinit(cell);
 #endif
-
-      psiEvalSpin0NLP.reinit(cell);
-      psiEvalSpin1NLP.reinit(cell);
     }
 
     if (d_isElectrostaticsMeshSubdivided || dftParameters::nonSelfConsistentForce)
@@ -407,69 +374,121 @@ void forceClass<FEOrder>::computeConfigurationalForceSpinPolarizedEEshelbyTensor
     std::vector<Tensor<1,2,VectorizedArray<double> > > psiSpin1Quads(numQuadPoints*numEigenVectors*numKPoints,zeroTensor1);
     std::vector<Tensor<1,2,Tensor<1,C_DIM,VectorizedArray<double> > > > gradPsiSpin0Quads(numQuadPoints*numEigenVectors*numKPoints,zeroTensor2);
     std::vector<Tensor<1,2,Tensor<1,C_DIM,VectorizedArray<double> > > > gradPsiSpin1Quads(numQuadPoints*numEigenVectors*numKPoints,zeroTensor2);
-    Tensor<1,2,Tensor<2,C_DIM,VectorizedArray<double> > >  tempHessianPsiSpin0;
-    Tensor<1,2,Tensor<2,C_DIM,VectorizedArray<double> > >  tempHessianPsiSpin1;
+    std::vector<Tensor<1,2,Tensor<2,C_DIM,VectorizedArray<double> > > > hessianPsiSpin0Quads;
+    std::vector<Tensor<1,2,Tensor<2,C_DIM,VectorizedArray<double> > > > hessianPsiSpin1Quads;
 #else
     std::vector< VectorizedArray<double> > psiSpin0Quads(numQuadPoints*numEigenVectors,make_vectorized_array(0.0));
     std::vector< VectorizedArray<double> > psiSpin1Quads(numQuadPoints*numEigenVectors,make_vectorized_array(0.0));
     std::vector<Tensor<1,C_DIM,VectorizedArray<double> > > gradPsiSpin0Quads(numQuadPoints*numEigenVectors,zeroTensor3);
     std::vector<Tensor<1,C_DIM,VectorizedArray<double> > > gradPsiSpin1Quads(numQuadPoints*numEigenVectors,zeroTensor3);
-    Tensor<2,C_DIM,VectorizedArray<double> >  tempHessianPsiSpin0;
-    Tensor<2,C_DIM,VectorizedArray<double> >  tempHessianPsiSpin1;
+    std::vector<Tensor<2,C_DIM,VectorizedArray<double> > > hessianPsiSpin0Quads;
+    std::vector<Tensor<2,C_DIM,VectorizedArray<double> > > hessianPsiSpin1Quads;
 #endif
+    if (dftParameters::nonSelfConsistentForce)
+    {
+       hessianPsiSpin0Quads.resize(psiSpin0Quads.size());
+       hessianPsiSpin1Quads.resize(psiSpin1Quads.size());
+    }
 
-    for (unsigned int ikPoint=0; ikPoint<numKPoints; ++ikPoint)
-        for (unsigned int iEigenVec=0; iEigenVec<numEigenVectors; ++iEigenVec)
-        {
-          psiEvalSpin0.read_dof_values_plain(eigenVectors[2*ikPoint][iEigenVec]);
-	  if (dftParameters::nonSelfConsistentForce)
-             psiEvalSpin0.evaluate(true,true,true);
-	  else
-             psiEvalSpin0.evaluate(true,true);
-
-          psiEvalSpin1.read_dof_values_plain(eigenVectors[2*ikPoint+1][iEigenVec]);
-	  if (dftParameters::nonSelfConsistentForce)
-             psiEvalSpin1.evaluate(true,true,true);
-	  else
-             psiEvalSpin1.evaluate(true,true);
+    //
+    //evaluate the wavefunctions at the quadrature points. The (kPoint,eigenvector) pairs are distributed
+    //among the threads, each thread using its own FEEvaluation objects
+    //
+    dealii::parallel::apply_to_subranges
+      (0U,
+       numKPoints*numEigenVectors,
+       [&](const unsigned int begin, const unsigned int end)
+       {
+#ifdef USE_COMPLEX
+	 FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),2> psiEvalSpin0(matrixFreeData,
+									   eigenDofHandlerIndex,
+									   0);
+	 FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),2> psiEvalSpin1(matrixFreeData,
+									   eigenDofHandlerIndex,
+									   0);
+#else
+	 FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),1> psiEvalSpin0(matrixFreeData,
+									   eigenDofHandlerIndex,
+									   0);
+	 FEEvaluation<C_DIM,FEOrder,C_num1DQuad<FEOrder>(),1> psiEvalSpin1(matrixFreeData,
+									   eigenDofHandlerIndex,
+									   0);
+#endif
+	 psiEvalSpin0.reinit(cell);
+	 psiEvalSpin1.reinit(cell);
+
+	 for (unsigned int i=begin; i<end; ++i)
+	 {
+	   const unsigned int ikPoint=i/numEigenVectors;
+	   const unsigned int iEigenVec=i%numEigenVectors;
+
+	   psiEvalSpin0.read_dof_values_plain(eigenVectors[2*ikPoint][iEigenVec]);
+	   if (dftParameters::nonSelfConsistentForce)
+	      psiEvalSpin0.evaluate(true,true,true);
+	   else
+	      psiEvalSpin0.evaluate(true,true);
+
+	   psiEvalSpin1.read_dof_values_plain(eigenVectors[2*ikPoint+1][iEigenVec]);
+	   if (dftParameters::nonSelfConsistentForce)
+	      psiEvalSpin1.evaluate(true,true,true);
+	   else
+	      psiEvalSpin1.evaluate(true,true);
+
+	   for (unsigned int q=0; q<numQuadPoints; ++q)
+	   {
+	      const int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
+	      psiSpin0Quads[id]=psiEvalSpin0.get_value(q);
+	      psiSpin1Quads[id]=psiEvalSpin1.get_value(q);
+	      gradPsiSpin0Quads[id]=psiEvalSpin0.get_gradient(q);
+	      gradPsiSpin1Quads[id]=psiEvalSpin1.get_gradient(q);
+	      if (dftParameters::nonSelfConsistentForce)
+	      {
+		 hessianPsiSpin0Quads[id]=psiEvalSpin0.get_hessian(q);
+		 hessianPsiSpin1Quads[id]=psiEvalSpin1.get_hessian(q);
+	      }
+	   }//quad point loop
+	 }//eigenvector loop
+       },
+       1);
 
-          for (unsigned int q=0; q<numQuadPoints; ++q)
-          {
-	     const int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
-             psiSpin0Quads[id]=psiEvalSpin0.get_value(q);
-	     psiSpin1Quads[id]=psiEvalSpin1.get_value(q);
-             gradPsiSpin0Quads[id]=psiEvalSpin0.get_gradient(q);
-	     gradPsiSpin1Quads[id]=psiEvalSpin1.get_gradient(q);
-	     if (dftParameters::nonSelfConsistentForce)
-	     {
-	        tempHessianPsiSpin0=psiEvalSpin0.get_hessian(q);
-	        tempHessianPsiSpin1=psiEvalSpin1.get_hessian(q);
-	     }
-
-             const double partOccSpin0 =dftUtils::getPartialOccupancy
-		                                                     (dftPtr->eigenValues[ikPoint][iEigenVec],
-		                                                      dftPtr->fermiEnergy,
-								      C_kb,
-								      dftParameters::TVal);
-             const double partOccSpin1 =dftUtils::getPartialOccupancy
-		                                                     (dftPtr->eigenValues[ikPoint][iEigenVec+numEigenVectors],
-		                                                      dftPtr->fermiEnergy,
-								      C_kb,
-								      dftParameters::TVal);
-	     const VectorizedArray<double> factor0=make_vectorized_array(dftPtr->d_kPointWeights[ikPoint]*partOccSpin0);
-	     const VectorizedArray<double> factor1=make_vectorized_array(dftPtr->d_kPointWeights[ikPoint]*partOccSpin1);
-
-	     gradRhoSpin0Quads[q]+=factor0*internalforce::computeGradRhoContribution(psiSpin0Quads[id],gradPsiSpin0Quads[id]);
-	     gradRhoSpin1Quads[q]+=factor1*internalforce::computeGradRhoContribution(psiSpin1Quads[id],gradPsiSpin1Quads[id]);
-
-	     if (dftParameters::nonSelfConsistentForce)
+    //
+    //accumulate the gradRho and hessianRho contributions. The quadrature points are distributed among
+    //the threads and the summation order over the eigenvectors is the same for each quadrature point
+    //
+    dealii::parallel::apply_to_subranges
+      (0U,
+       numQuadPoints,
+       [&](const unsigned int qBegin, const unsigned int qEnd)
+       {
+	 for (unsigned int q=qBegin; q<qEnd; ++q)
+	   for (unsigned int ikPoint=0; ikPoint<numKPoints; ++ikPoint)
+	     for (unsigned int iEigenVec=0; iEigenVec<numEigenVectors; ++iEigenVec)
 	     {
-		 hessianRhoSpin0Quads[q]+=factor0*internalforce::computeHessianRhoContribution(psiSpin0Quads[id],gradPsiSpin0Quads[id], tempHessianPsiSpin0);
-		 hessianRhoSpin1Quads[q]+=factor1*internalforce::computeHessianRhoContribution(psiSpin1Quads[id],gradPsiSpin1Quads[id], tempHessianPsiSpin1);
-	     }
-
-          }//quad point loop
-        } //eigenvector loop
+		const int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
+		const double partOccSpin0 =dftUtils::getPartialOccupancy
+								       (dftPtr->eigenValues[ikPoint][iEigenVec],
+									dftPtr->fermiEnergy,
+									C_kb,
+									dftParameters::TVal);
+		const double partOccSpin1 =dftUtils::getPartialOccupancy
+								       (dftPtr->eigenValues[ikPoint][iEigenVec+numEigenVectors],
+									dftPtr->fermiEnergy,
+									C_kb,
+									dftParameters::TVal);
+		const VectorizedArray<double> factor0=make_vectorized_array(dftPtr->d_kPointWeights[ikPoint]*partOccSpin0);
+		const VectorizedArray<double> factor1=make_vectorized_array(dftPtr->d_kPointWeights[ikPoint]*partOccSpin1);
+
+		gradRhoSpin0Quads[q]+=factor0*internalforce::computeGradRhoContribution(psiSpin0Quads[id],gradPsiSpin0Quads[id]);
+		gradRhoSpin1Quads[q]+=factor1*internalforce::computeGradRhoContribution(psiSpin1Quads[id],gradPsiSpin1Quads[id]);
+
+		if (dftParameters::nonSelfConsistentForce)
+		{
+		    hessianRhoSpin0Quads[q]+=factor0*internalforce::computeHessianRhoContribution(psiSpin0Quads[id],gradPsiSpin0Quads[id],hessianPsiSpin0Quads[id]);
+		    hessianRhoSpin1Quads[q]+=factor1*internalforce::computeHessianRhoContribution(psiSpin1Quads[id],gradPsiSpin1Quads[id],hessianPsiSpin1Quads[id]);
+		}
+	     }//eigenvector loop
+       },
+       1);
 
     //accumulate grad rho and hessian rho quad point contribution from all pools
     for (unsigned int iSubCell=0; iSubCell<numSubCells; ++iSubCell)
@@ -505,22 +524,49 @@ void forceClass<FEOrder>::computeConfigurationalForceSpinPolarizedEEshelbyTensor
 	psiSpin0QuadsNLP.resize(numQuadPointsNLP*numEigenVectors,make_vectorized_array(0.0));
 	psiSpin1QuadsNLP.resize(numQuadPointsNLP*numEigenVectors,make_vectorized_array(0.0));
 #endif
-	for (unsigned int ikPoint=0; ikPoint<numKPoints; ++ikPoint)
-	    for (unsigned int iEigenVec=0; iEigenVec<numEigenVectors; ++iEigenVec)
-	    {
-	      psiEvalSpin0NLP.read_dof_values_plain(eigenVectors[2*ikPoint][iEigenVec]);
-	      psiEvalSpin0NLP.evaluate(true,false);
-
-	      psiEvalSpin1NLP.read_dof_values_plain(eigenVectors[2*ikPoint+1][iEigenVec]);
-	      psiEvalSpin1NLP.evaluate(true,false);
+	dealii::parallel::apply_to_subranges
+	  (0U,
+	   numKPoints*numEigenVectors,
+	   [&](const unsigned int begin, const unsigned int end)
+	   {
+#ifdef USE_COMPLEX
+	     FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),2> psiEvalSpin0NLP(matrixFreeData,
+										 eigenDofHandlerIndex,
+										 2);
+	     FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),2> psiEvalSpin1NLP(matrixFreeData,
+										 eigenDofHandlerIndex,
+										 2);
+#else
+	     FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),1> psiEvalSpin0NLP(matrixFreeData,
+										 eigenDofHandlerIndex,
+										 2);
+	     FEEvaluation<C_DIM,FEOrder,C_num1DQuadPSP<FEOrder>(),1> psiEvalSpin1NLP(matrixFreeData,
+										 eigenDofHandlerIndex,
+										 2);
+#endif
+	     psiEvalSpin0NLP.reinit(cell);
+	     psiEvalSpin1NLP.reinit(cell);
 
-	      for (unsigned int q=0; q<numQuadPointsNLP; ++q)
-	      {
-		 const int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
-		 psiSpin0QuadsNLP[id]=psiEvalSpin0NLP.get_value(q);
-		 psiSpin1QuadsNLP[id]=psiEvalSpin1NLP.get_value(q);
-	      }//quad point loop
-	    } //eigenvector loop
+	     for (unsigned int i=begin; i<end; ++i)
+	     {
+	       const unsigned int ikPoint=i/numEigenVectors;
+	       const unsigned int iEigenVec=i%numEigenVectors;
+
+	       psiEvalSpin0NLP.read_dof_values_plain(eigenVectors[2*ikPoint][iEigenVec]);
+	       psiEvalSpin0NLP.evaluate(true,false);
+
+	       psiEvalSpin1NLP.read_dof_values_plain(eigenVectors[2*ikPoint+1][iEigenVec]);
+	       psiEvalSpin1NLP.evaluate(true,false);
+
+	       for (unsigned int q=0; q<numQuadPointsNLP; ++q)
+	       {
+		  const int id=q*numEigenVectors*numKPoints+numEigenVectors*ikPoint+iEigenVec;
+		  psiSpin0QuadsNLP[id]=psiEvalSpin0NLP.get_value(q);
+		  psiSpin1QuadsNLP[id]=psiEvalSpin1NLP.get_value(q);
+	       }//quad point loop
+	     }//eigenvector loop
+	   },
+	   1);
     }
 
     if(isPseudopotential)
@@ -609,182 +655,232 @@ void forceClass<FEOrder>::computeConfigurationalForceSpinPolarizedEEshelbyTensor
 #endif
     }//is pseudopotential check
 
-    for (unsigned int q=0; q<numQuadPoints; ++q)
-    {
-       const VectorizedArray<double> phiTot_q =d_isElectrostaticsMeshSubdivided?
-	                                        phiTotOutEval.get_value(q)
-						:make_vectorized_array(0.0);
-       const VectorizedArray<double> phiExt_q =d_isElectrostaticsMeshSubdivided?
-	                                        phiExtEval.get_value(q)
-						:make_vectorized_array(0.0);
-
-       Tensor<2,C_DIM,VectorizedArray<double> > E=eshelbyTensorSP::getELocXcEshelbyTensor
-				      (rhoQuads[q],
-				       gradRhoSpin0Quads[q],
-				       gradRhoSpin1Quads[q],
-				       excQuads[q],
-				       derExchCorrEnergyWithGradRhoOutSpin0Quads[q],
-				       derExchCorrEnergyWithGradRhoOutSpin1Quads[q]);
+    //
+    //the Eshelby tensors, which involve sums over all the eigenvectors, are computed in parallel over the
+    //quadrature points and then submitted to the FEEvaluation objects
+    //
+    std::vector<Tensor<1,C_DIM,VectorizedArray<double> > > FQuads(numQuadPoints,zeroTensor3);
+    std::vector<Tensor<2,C_DIM,VectorizedArray<double> > > EQuads(numQuadPoints,zeroTensor4);
+#ifdef USE_COMPLEX
+    std::vector<Tensor<1,C_DIM,VectorizedArray<double> > > FKPointsQuads(numQuadPoints,zeroTensor3);
+    std::vector<Tensor<2,C_DIM,VectorizedArray<double> > > EKPointsQuads(numQuadPoints,zeroTensor4);
+#endif
+    dealii::parallel::apply_to_subranges
+      (0U,
+       numQuadPoints,
+       [&](const unsigned int qBegin, const unsigned int qEnd)
+       {
+	 for (unsigned int q=qBegin; q<qEnd; ++q)
+	 {
+	    const VectorizedArray<double> phiTot_q =d_isElectrostaticsMeshSubdivided?
+						     phiTotOutEval.get_value(q)
+						     :make_vectorized_array(0.0);
+	    const VectorizedArray<double> phiExt_q =d_isElectrostaticsMeshSubdivided?
+						     phiExtEval.get_value(q)
+						     :make_vectorized_array(0.0);
+
+	    Tensor<2,C_DIM,VectorizedArray<double> > E=eshelbyTensorSP::getELocXcEshelbyTensor
+					   (rhoQuads[q],
+					    gradRhoSpin0Quads[q],
+					    gradRhoSpin1Quads[q],
+					    excQuads[q],
+					    derExchCorrEnergyWithGradRhoOutSpin0Quads[q],
+					    derExchCorrEnergyWithGradRhoOutSpin1Quads[q]);
 #ifdef USE_COMPLEX
-       Tensor<2,C_DIM,VectorizedArray<double> > EKPoints=eshelbyTensorSP::getELocWfcEshelbyTensorPeriodicKPoints
-							 (psiSpin0Quads.begin()+q*numEigenVectors*numKPoints,
-                                                          psiSpin1Quads.begin()+q*numEigenVectors*numKPoints,
-							  gradPsiSpin0Quads.begin()+q*numEigenVectors*numKPoints,
-							  gradPsiSpin1Quads.begin()+q*numEigenVectors*numKPoints,
-							  dftPtr->d_kPointCoordinates,
-							  dftPtr->d_kPointWeights,
-							  dftPtr->eigenValues,
-							  dftPtr->fermiEnergy,
-							  dftParameters::TVal);
+	    Tensor<2,C_DIM,VectorizedArray<double> > EKPoints=eshelbyTensorSP::getELocWfcEshelbyTensorPeriodicKPoints
+							      (psiSpin0Quads.begin()+q*numEigenVectors*numKPoints,
+							       psiSpin1Quads.begin()+q*numEigenVectors*numKPoints,
+							       gradPsiSpin0Quads.begin()+q*numEigenVectors*numKPoints,
+							       gradPsiSpin1Quads.begin()+q*numEigenVectors*numKPoints,
+							       dftPtr->d_kPointCoordinates,
+							       dftPtr->d_kPointWeights,
+							       dftPtr->eigenValues,
+							       dftPtr->fermiEnergy,
+							       dftParameters::TVal);
 #else
-       E+=eshelbyTensorSP::getELocWfcEshelbyTensorNonPeriodic
-					     (psiSpin0Quads.begin()+q*numEigenVectors,
-					     psiSpin1Quads.begin()+q*numEigenVectors,
-					     gradPsiSpin0Quads.begin()+q*numEigenVectors,
-					     gradPsiSpin1Quads.begin()+q*numEigenVectors,
-					     (dftPtr->eigenValues)[0],
-					     dftPtr->fermiEnergy,
-					     dftParameters::TVal);
+	    E+=eshelbyTensorSP::getELocWfcEshelbyTensorNonPeriodic
+						  (psiSpin0Quads.begin()+q*numEigenVectors,
+						  psiSpin1Quads.begin()+q*numEigenVectors,
+						  gradPsiSpin0Quads.begin()+q*numEigenVectors,
+						  gradPsiSpin1Quads.begin()+q*numEigenVectors,
+						  (dftPtr->eigenValues)[0],
+						  dftPtr->fermiEnergy,
+						  dftParameters::TVal);
 #endif
-       Tensor<1,C_DIM,VectorizedArray<double> > F=zeroTensor3;
+	    Tensor<1,C_DIM,VectorizedArray<double> > F=zeroTensor3;
 
-       if(d_isElectrostaticsMeshSubdivided)
-	   F-=(gradRhoSpin0Quads[q]+gradRhoSpin1Quads[q])*phiTot_q;
+	    if(d_isElectrostaticsMeshSubdivided)
+		F-=(gradRhoSpin0Quads[q]+gradRhoSpin1Quads[q])*phiTot_q;
 
-       if(isPseudopotential)
-       {
-	   //F+=rhoQuads[q]*gradPseudoVLocQuads[q];
-           if(d_isElectrostaticsMeshSubdivided)
-	      F-=(gradRhoSpin0Quads[q]+gradRhoSpin1Quads[q])*(pseudoVLocQuads[q]-phiExt_q);
+	    if(isPseudopotential)
+	    {
+		//F+=rhoQuads[q]*gradPseudoVLocQuads[q];
+		if(d_isElectrostaticsMeshSubdivided)
+		   F-=(gradRhoSpin0Quads[q]+gradRhoSpin1Quads[q])*(pseudoVLocQuads[q]-phiExt_q);
 
-           if (!dftParameters::useHigherQuadNLP)
-	   {
+		if (!dftParameters::useHigherQuadNLP)
+		{
 #ifdef USE_COMPLEX
-	       Tensor<1,C_DIM,VectorizedArray<double> > FKPoints
-	         =eshelbyTensorSP::getFnlPeriodic
-					       (gradZetaDeltaVQuads[q],
-						projectorKetTimesPsiSpin0TimesV,
-						projectorKetTimesPsiSpin1TimesV,
-						psiSpin0Quads.begin()+q*numEigenVectors*numKPoints,
-						psiSpin1Quads.begin()+q*numEigenVectors*numKPoints,
-						dftPtr->d_kPointWeights,
-						dftPtr->eigenValues,
-						dftPtr->fermiEnergy,
-						dftParameters::TVal);
-
-
-	       EKPoints+=eshelbyTensorSP::getEnlEshelbyTensorPeriodic
-							    (ZetaDeltaVQuads[q],
-							     projectorKetTimesPsiSpin0TimesV,
-							     projectorKetTimesPsiSpin1TimesV,
-							     psiSpin0Quads.begin()+q*numEigenVectors*numKPoints,
-							     psiSpin1Quads.begin()+q*numEigenVectors*numKPoints,
-							     dftPtr->d_kPointWeights,
-							     dftPtr->eigenValues,
-							     dftPtr->fermiEnergy,
-							     dftParameters::TVal);
-	       forceEvalKPoints.submit_value(FKPoints,q);
+		    Tensor<1,C_DIM,VectorizedArray<double> > FKPoints
+		      =eshelbyTensorSP::getFnlPeriodic
+						    (gradZetaDeltaVQuads[q],
+						     projectorKetTimesPsiSpin0TimesV,
+						     projectorKetTimesPsiSpin1TimesV,
+						     psiSpin0Quads.begin()+q*numEigenVectors*numKPoints,
+						     psiSpin1Quads.begin()+q*numEigenVectors*numKPoints,
+						     dftPtr->d_kPointWeights,
+						     dftPtr->eigenValues,
+						     dftPtr->fermiEnergy,
+						     dftParameters::TVal);
+
+
+		    EKPoints+=eshelbyTensorSP::getEnlEshelbyTensorPeriodic
+								 (ZetaDeltaVQuads[q],
+								  projectorKetTimesPsiSpin0TimesV,
+								  projectorKetTimesPsiSpin1TimesV,
+								  psiSpin0Quads.begin()+q*numEigenVectors*numKPoints,
+								  psiSpin1Quads.begin()+q*numEigenVectors*numKPoints,
+								  dftPtr->d_kPointWeights,
+								  dftPtr->eigenValues,
+								  dftPtr->fermiEnergy,
+								  dftParameters::TVal);
+		    FKPointsQuads[q]=FKPoints;
 #else
-	       F+=eshelbyTensorSP::getFnlNonPeriodic
-						  (gradZetaDeltaVQuads[q],
-						   projectorKetTimesPsiSpin0TimesV[0],
-						   projectorKetTimesPsiSpin1TimesV[0],
-						   psiSpin0Quads.begin()+q*numEigenVectors,
-						   psiSpin1Quads.begin()+q*numEigenVectors,
-						   (dftPtr->eigenValues)[0],
-						   dftPtr->fermiEnergy,
-						   dftParameters::TVal);
-
-	       E+=eshelbyTensorSP::getEnlEshelbyTensorNonPeriodic(ZetaDeltaVQuads[q],
-								projectorKetTimesPsiSpin0TimesV[0],
-								projectorKetTimesPsiSpin1TimesV[0],
-								psiSpin0Quads.begin()+q*numEigenVectors,
-								psiSpin1Quads.begin()+q*numEigenVectors,
-								(dftPtr->eigenValues)[0],
-								dftPtr->fermiEnergy,
-								dftParameters::TVal);
+		    F+=eshelbyTensorSP::getFnlNonPeriodic
+						       (gradZetaDeltaVQuads[q],
+							projectorKetTimesPsiSpin0TimesV[0],
+							projectorKetTimesPsiSpin1TimesV[0],
+							psiSpin0Quads.begin()+q*numEigenVectors,
+							psiSpin1Quads.begin()+q*numEigenVectors,
+							(dftPtr->eigenValues)[0],
+							dftPtr->fermiEnergy,
+							dftParameters::TVal);
+
+		    E+=eshelbyTensorSP::getEnlEshelbyTensorNonPeriodic(ZetaDeltaVQuads[q],
+								     projectorKetTimesPsiSpin0TimesV[0],
+								     projectorKetTimesPsiSpin1TimesV[0],
+								     psiSpin0Quads.begin()+q*numEigenVectors,
+								     psiSpin1Quads.begin()+q*numEigenVectors,
+								     (dftPtr->eigenValues)[0],
+								     dftPtr->fermiEnergy,
+								     dftParameters::TVal);
 #endif
-	   }
+		}
 
 
-       }
+	    }
 
-       if (dftParameters::nonSelfConsistentForce)
-	   F+=eshelbyTensorSP::getNonSelfConsistentForce
-						   (vEffRhoInSpin0Quads[q],
-						    vEffRhoInSpin1Quads[q],
-						    vEffRhoOutSpin0Quads[q],
-						    vEffRhoOutSpin1Quads[q],
-						    gradRhoSpin0Quads[q],
-						    gradRhoSpin1Quads[q],
-						    derExchCorrEnergyWithGradRhoInSpin0Quads[q],
-						    derExchCorrEnergyWithGradRhoInSpin1Quads[q],
-						    derExchCorrEnergyWithGradRhoOutSpin0Quads[q],
-						    derExchCorrEnergyWithGradRhoOutSpin1Quads[q],
-						    hessianRhoSpin0Quads[q],
-						    hessianRhoSpin1Quads[q]);
-
-
-       forceEval.submit_value(F,q);
-       forceEval.submit_gradient(E,q);
+	    if (dftParameters::nonSelfConsistentForce)
+		F+=eshelbyTensorSP::getNonSelfConsistentForce
+							(vEffRhoInSpin0Quads[q],
+							 vEffRhoInSpin1Quads[q],
+							 vEffRhoOutSpin0Quads[q],
+							 vEffRhoOutSpin1Quads[q],
+							 gradRhoSpin0Quads[q],
+							 gradRhoSpin1Quads[q],
+							 derExchCorrEnergyWithGradRhoInSpin0Quads[q],
+							 derExchCorrEnergyWithGradRhoInSpin1Quads[q],
+							 derExchCorrEnergyWithGradRhoOutSpin0Quads[q],
+							 derExchCorrEnergyWithGradRhoOutSpin1Quads[q],
+							 hessianRhoSpin0Quads[q],
+							 hessianRhoSpin1Quads[q]);
+
+
+	    FQuads[q]=F;
+	    EQuads[q]=E;
 #ifdef USE_COMPLEX
-       forceEvalKPoints.submit_gradient(EKPoints,q);
+	    EKPointsQuads[q]=EKPoints;
 #endif
-    }//quad point loop
+	 }//quad point loop
+       },
+       1);
+
+    for (unsigned int q=0; q<numQuadPoints; ++q)
+    {
+       forceEval.submit_value(FQuads[q],q);
+       forceEval.submit_gradient(EQuads[q],q);
+#ifdef USE_COMPLEX
+       if (isPseudopotential && !dftParameters::useHigherQuadNLP)
+	  forceEvalKPoints.submit_value(FKPointsQuads[q],q);
+       forceEvalKPoints.submit_gradient(EKPointsQuads[q],q);
+#endif
+    }
 
     if (isPseudopotential && dftParameters::useHigherQuadNLP)
+    {
+	std::vector<Tensor<1,C_DIM,VectorizedArray<double> > > FNLPQuads(numQuadPointsNLP,zeroTensor3);
+	std::vector<Tensor<2,C_DIM,VectorizedArray<double> > > ENLPQuads(numQuadPointsNLP,zeroTensor4);
+	dealii::parallel::apply_to_subranges
+	  (0U,
+	   numQuadPointsNLP,
+	   [&](const unsigned int qBegin, const unsigned int qEnd)
+	   {
+	     for (unsigned int q=qBegin; q<qEnd; ++q)
+	     {
+#ifdef USE_COMPLEX
+		    Tensor<1,C_DIM,VectorizedArray<double> > FKPoints
+			 =eshelbyTensorSP::getFnlPeriodic
+						    (gradZetaDeltaVQuads[q],
+						     projectorKetTimesPsiSpin0TimesV,
+						     projectorKetTimesPsiSpin1TimesV,
+						     psiSpin0QuadsNLP.begin()+q*numEigenVectors*numKPoints,
+						     psiSpin1QuadsNLP.begin()+q*numEigenVectors*numKPoints,
+						     dftPtr->d_kPointWeights,
+						     dftPtr->eigenValues,
+						     dftPtr->fermiEnergy,
+						     dftParameters::TVal);
+
+		    Tensor<2,C_DIM,VectorizedArray<double> > EKPoints
+			=eshelbyTensorSP::getEnlEshelbyTensorPeriodic
+								 (ZetaDeltaVQuads[q],
+								  projectorKetTimesPsiSpin0TimesV,
+								  projectorKetTimesPsiSpin1TimesV,
+								  psiSpin0QuadsNLP.begin()+q*numEigenVectors*numKPoints,
+								  psiSpin1QuadsNLP.begin()+q*numEigenVectors*numKPoints,
+								  dftPtr->d_kPointWeights,
+								  dftPtr->eigenValues,
+								  dftPtr->fermiEnergy,
+								  dftParameters::TVal);
+		    FNLPQuads[q]=FKPoints;
+		    ENLPQuads[q]=EKPoints;
+#else
+		    Tensor<1,C_DIM,VectorizedArray<double> > F
+		      =eshelbyTensorSP::getFnlNonPeriodic
+						       (gradZetaDeltaVQuads[q],
+							projectorKetTimesPsiSpin0TimesV[0],
+							projectorKetTimesPsiSpin1TimesV[0],
+							psiSpin0QuadsNLP.begin()+q*numEigenVectors,
+							psiSpin1QuadsNLP.begin()+q*numEigenVectors,
+							(dftPtr->eigenValues)[0],
+							dftPtr->fermiEnergy,
+							dftParameters::TVal);
+		    Tensor<2,C_DIM,VectorizedArray<double> >	E
+		      =eshelbyTensorSP::getEnlEshelbyTensorNonPeriodic(ZetaDeltaVQuads[q],
+								     projectorKetTimesPsiSpin0TimesV[0],
+								     projectorKetTimesPsiSpin1TimesV[0],
+								     psiSpin0QuadsNLP.begin()+q*numEigenVectors,
+								     psiSpin1QuadsNLP.begin()+q*numEigenVectors,
+								     (dftPtr->eigenValues)[0],
+								     dftPtr->fermiEnergy,
+								     dftParameters::TVal);
+		    FNLPQuads[q]=F;
+		    ENLPQuads[q]=E;
+#endif
+	     }//nonlocal psp quad points loop
+	   },
+	   1);
+
 	for (unsigned int q=0; q<numQuadPointsNLP; ++q)
 	{
 #ifdef USE_COMPLEX
-	       Tensor<1,C_DIM,VectorizedArray<double> > FKPoints
-	            =eshelbyTensorSP::getFnlPeriodic
-					       (gradZetaDeltaVQuads[q],
-						projectorKetTimesPsiSpin0TimesV,
-						projectorKetTimesPsiSpin1TimesV,
-						psiSpin0QuadsNLP.begin()+q*numEigenVectors*numKPoints,
-						psiSpin1QuadsNLP.begin()+q*numEigenVectors*numKPoints,
-						dftPtr->d_kPointWeights,
-						dftPtr->eigenValues,
-						dftPtr->fermiEnergy,
-						dftParameters::TVal);
-
-               Tensor<2,C_DIM,VectorizedArray<double> > EKPoints
-	           =eshelbyTensorSP::getEnlEshelbyTensorPeriodic
-							    (ZetaDeltaVQuads[q],
-							     projectorKetTimesPsiSpin0TimesV,
-							     projectorKetTimesPsiSpin1TimesV,
-							     psiSpin0QuadsNLP.begin()+q*numEigenVectors*numKPoints,
-							     psiSpin1QuadsNLP.begin()+q*numEigenVectors*numKPoints,
-							     dftPtr->d_kPointWeights,
-							     dftPtr->eigenValues,
-							     dftPtr->fermiEnergy,
-							     dftParameters::TVal);
-	       forceEvalKPointsNLP.submit_value(FKPoints,q);
-	       forceEvalKPointsNLP.submit_gradient(EKPoints,q);
+	   forceEvalKPointsNLP.submit_value(FNLPQuads[q],q);
+	   forceEvalKPointsNLP.submit_gradient(ENLPQuads[q],q);
 #else
-	       Tensor<1,C_DIM,VectorizedArray<double> > F
-	         =eshelbyTensorSP::getFnlNonPeriodic
-						  (gradZetaDeltaVQuads[q],
-						   projectorKetTimesPsiSpin0TimesV[0],
-						   projectorKetTimesPsiSpin1TimesV[0],
-						   psiSpin0QuadsNLP.begin()+q*numEigenVectors,
-						   psiSpin1QuadsNLP.begin()+q*numEigenVectors,
-						   (dftPtr->eigenValues)[0],
-						   dftPtr->fermiEnergy,
-						   dftParameters::TVal);
-               Tensor<2,C_DIM,VectorizedArray<double> >	E
-	         =eshelbyTensorSP::getEnlEshelbyTensorNonPeriodic(ZetaDeltaVQuads[q],
-								projectorKetTimesPsiSpin0TimesV[0],
-								projectorKetTimesPsiSpin1TimesV[0],
-								psiSpin0QuadsNLP.begin()+q*numEigenVectors,
-								psiSpin1QuadsNLP.begin()+q*numEigenVectors,
-								(dftPtr->eigenValues)[0],
-								dftPtr->fermiEnergy,
-								dftParameters::TVal);
-               forceEvalNLP.submit_value(F,q);
-	       forceEvalNLP.submit_gradient(E,q);
+	   forceEvalNLP.submit_value(FNLPQuads[q],q);
+	   forceEvalNLP.submit_gradient(ENLPQuads[q],q);
 #endif
-	}//nonlocal psp quad points loop
+	}
+    }
 
     if(isPseudopotential)
     {
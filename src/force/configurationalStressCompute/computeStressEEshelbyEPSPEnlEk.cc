@@ -34,8 +34,8 @@ void forceClass<FEOrder>::computeStressEEshelbyEPSPEnlEk(const MatrixFree<3,doub
 		              const unsigned int phiExtDofHandlerIndexElectro,
 		              const vectorType & phiTotRhoOutElectro,
 		              const vectorType & phiExtElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		              const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -526,8 +526,8 @@ void forceClass<FEOrder>::computeStressEEshelbyEElectroPhiTot
 		     const unsigned int phiExtDofHandlerIndexElectro,
 		     const vectorType & phiTotRhoOutElectro,
 		     const vectorType & phiExtElectro,
-		     const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-		     const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+		     const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+		     const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		     const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		     const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
 		     const vselfBinsManager<FEOrder> & vselfBinsManagerElectro)
@@ -592,14 +592,14 @@ void forceClass<FEOrder>::computeStressEEshelbyEElectroPhiTot
        subCellPtr= matrixFreeDataElectro.get_cell_iterator(cell,iSubCell);
        dealii::CellId subCellId=subCellPtr->id();
        for (unsigned int q=0; q<numQuadPoints; ++q)
-         rhoQuadsElectro[q][iSubCell]=rhoOutValuesElectro.find(subCellId)->second[q];
+         rhoQuadsElectro[q][iSubCell]=rhoOutValuesElectro[subCellId][q];
 
        if(d_isElectrostaticsMeshSubdivided)
 	  for (unsigned int q=0; q<numQuadPoints; ++q)
 	  {
-	     gradRhoQuadsElectro[q][0][iSubCell]=gradRhoOutValuesElectro.find(subCellId)->second[C_DIM*q+0];
-	     gradRhoQuadsElectro[q][1][iSubCell]=gradRhoOutValuesElectro.find(subCellId)->second[C_DIM*q+1];
-	     gradRhoQuadsElectro[q][2][iSubCell]=gradRhoOutValuesElectro.find(subCellId)->second[C_DIM*q+2];
+	     gradRhoQuadsElectro[q][0][iSubCell]=gradRhoOutValuesElectro[subCellId][C_DIM*q+0];
+	     gradRhoQuadsElectro[q][1][iSubCell]=gradRhoOutValuesElectro[subCellId][C_DIM*q+1];
+	     gradRhoQuadsElectro[q][2][iSubCell]=gradRhoOutValuesElectro[subCellId][C_DIM*q+2];
 	  }
 
        if(dftParameters::isPseudopotential)
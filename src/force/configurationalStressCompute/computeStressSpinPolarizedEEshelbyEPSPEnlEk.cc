@@ -35,8 +35,8 @@ void forceClass<FEOrder>::computeStressSpinPolarizedEEshelbyEPSPEnlEk
 		              const unsigned int phiExtDofHandlerIndexElectro,
 		              const vectorType & phiTotRhoOutElectro,
 		              const vectorType & phiExtElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-			      const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+			      const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		              const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		              const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
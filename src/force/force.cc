@@ -235,8 +235,8 @@ void forceClass<FEOrder>::computeAtomsForces
 		 const unsigned int phiExtDofHandlerIndexElectro,
 		 const vectorType & phiTotRhoOutElectro,
 		 const vectorType & phiExtElectro,
-		 const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-		 const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+		 const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+		 const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		 const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		 const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		 const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -358,8 +358,8 @@ void forceClass<FEOrder>::computeConfigurationalForceTotalLinFE
 				     const unsigned int phiExtDofHandlerIndexElectro,
 				     const vectorType & phiTotRhoOutElectro,
 				     const vectorType & phiExtElectro,
-				     const std::map<dealii::CellId, std::vector<double> > & rhoOutValuesElectro,
-				     const std::map<dealii::CellId, std::vector<double> > & gradRhoOutValuesElectro,
+				     const dftUtils::cellQuadratureField & rhoOutValuesElectro,
+				     const dftUtils::cellQuadratureField & gradRhoOutValuesElectro,
 		                     const std::map<dealii::CellId, std::vector<double> > & pseudoVLocElectro,
 		                     const std::map<dealii::CellId, std::vector<double> > & gradPseudoVLocElectro,
 		                     const std::map<unsigned int,std::map<dealii::CellId, std::vector<double> > > & gradPseudoVLocAtomsElectro,
@@ -0,0 +1,234 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2018 The Regents of the University of Michigan and DFT-FE authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+
+
+/** @file choleskyQR.cc
+ *  @brief Contains linear algebra operations for Cholesky-QR orthogonalization
+ *
+ */
+namespace dftfe
+{
+
+  namespace linearAlgebraOperations
+  {
+    namespace internal
+    {
+      //
+      //one Cholesky-QR pass: Sc=X^{T}*(Xc) from the local dofs with a single all reduce of the
+      //lower triangle, redundant Cholesky factorization Sc=Lc*L^{T} on every processor and
+      //X^{T}=Lc^{-1}*X^{T} in place. If shift is true, the overlap matrix is shifted by a multiple
+      //of its norm to guarantee the Cholesky factorization of ill-conditioned subspaces (shifted Cholesky-QR)
+      //
+      template<typename T>
+      int choleskyQRPass(std::vector<T> & X,
+			 const unsigned int numberVectors,
+			 const unsigned int globalVectorSize,
+			 const bool shift,
+			 const MPI_Comm & mpiComm,
+			 dealii::TimerOutput & computing_timer)
+      {
+	const unsigned int localVectorSize = X.size()/numberVectors;
+
+	computing_timer.enter_section("local overlap matrix for cholesky qr");
+	std::vector<T> overlapMatrix(numberVectors*numberVectors,0.0);
+	const char uplo1 = 'L';
+	const char trans1 = 'N';
+	const double alpha1 = 1.0, beta1 = 0.0;
+#ifdef USE_COMPLEX
+	zherk_(&uplo1,
+	       &trans1,
+	       &numberVectors,
+	       &localVectorSize,
+	       &alpha1,
+	       &X[0],
+	       &numberVectors,
+	       &beta1,
+	       &overlapMatrix[0],
+	       &numberVectors);
+#else
+	dsyrk_(&uplo1,
+	       &trans1,
+	       &numberVectors,
+	       &localVectorSize,
+	       &alpha1,
+	       &X[0],
+	       &numberVectors,
+	       &beta1,
+	       &overlapMatrix[0],
+	       &numberVectors);
+#endif
+
+	//
+	//only the lower triangle is communicated
+	//
+	std::vector<T> overlapMatrixPacked(numberVectors*(numberVectors+1)/2);
+	unsigned int count=0;
+	for (unsigned int j = 0; j < numberVectors; ++j)
+	  for (unsigned int i = j; i < numberVectors; ++i)
+	    overlapMatrixPacked[count++]=overlapMatrix[j*numberVectors+i];
+
+	MPI_Allreduce(MPI_IN_PLACE,
+		      &overlapMatrixPacked[0],
+		      overlapMatrixPacked.size(),
+		      dataTypes::mpi_type_id(&overlapMatrixPacked[0]),
+		      MPI_SUM,
+		      mpiComm);
+
+	count=0;
+	for (unsigned int j = 0; j < numberVectors; ++j)
+	  for (unsigned int i = j; i < numberVectors; ++i)
+	    overlapMatrix[j*numberVectors+i]=overlapMatrixPacked[count++];
+	computing_timer.exit_section("local overlap matrix for cholesky qr");
+
+	computing_timer.enter_section("cholesky qr cholesky factorization");
+	if (shift)
+	  {
+	    //
+	    //shift=11(mn+n(n+1))u||X||^2 with the squared Frobenius norm of X as an upper bound of ||X||_2^2
+	    //
+	    double frobeniusNormSquare=0.0;
+	    for (unsigned int i = 0; i < numberVectors; ++i)
+	      frobeniusNormSquare+=std::abs(overlapMatrix[i*numberVectors+i]);
+
+	    const double shiftValue=11.0*((double)globalVectorSize*numberVectors+(double)numberVectors*(numberVectors+1))
+	                            *std::numeric_limits<double>::epsilon()*frobeniusNormSquare;
+	    for (unsigned int i = 0; i < numberVectors; ++i)
+	      overlapMatrix[i*numberVectors+i]+=shiftValue;
+	  }
+
+	int info;
+	const char uplo2 = 'L';
+#ifdef USE_COMPLEX
+	zpotrf_(&uplo2,
+		&numberVectors,
+		&overlapMatrix[0],
+		&numberVectors,
+		&info);
+#else
+	dpotrf_(&uplo2,
+		&numberVectors,
+		&overlapMatrix[0],
+		&numberVectors,
+		&info);
+#endif
+	computing_timer.exit_section("cholesky qr cholesky factorization");
+
+	if (info!=0)
+	  return info;
+
+	//
+	//X=X*Lc^{-1}^{T} implemented as X^{T}=Lc^{-1}*X^{T} with X^{T} stored in the column major format
+	//
+	computing_timer.enter_section("cholesky qr triangular solve");
+	const char side3 = 'L', uplo3 = 'L', transA3 = 'N', diag3 = 'N';
+	const T alpha3 = 1.0;
+#ifdef USE_COMPLEX
+	ztrsm_(&side3,
+	       &uplo3,
+	       &transA3,
+	       &diag3,
+	       &numberVectors,
+	       &localVectorSize,
+	       &alpha3,
+	       &overlapMatrix[0],
+	       &numberVectors,
+	       &X[0],
+	       &numberVectors);
+#else
+	dtrsm_(&side3,
+	       &uplo3,
+	       &transA3,
+	       &diag3,
+	       &numberVectors,
+	       &localVectorSize,
+	       &alpha3,
+	       &overlapMatrix[0],
+	       &numberVectors,
+	       &X[0],
+	       &numberVectors);
+#endif
+	computing_timer.exit_section("cholesky qr triangular solve");
+
+	return 0;
+      }
+    }
+
+    template<typename T>
+    unsigned int choleskyQROrthogonalization(std::vector<T> & X,
+					     const unsigned int numberVectors,
+					     const unsigned int numberPasses,
+					     const MPI_Comm & mpiComm)
+    {
+      dealii::ConditionalOStream   pcout(std::cout,
+					 (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0));
+
+      dealii::TimerOutput computing_timer(mpiComm,
+					  pcout,
+					  dftParameters::reproducible_output ||
+					  dftParameters::verbosity<4? dealii::TimerOutput::never : dealii::TimerOutput::summary,
+					  dealii::TimerOutput::wall_times);
+
+      const unsigned int globalVectorSize=dealii::Utilities::MPI::sum((unsigned int)(X.size()/numberVectors),
+								      mpiComm);
+
+      //
+      //first pass. If the Cholesky factorization breaks down due to the ill-conditioning of the
+      //subspace, a shifted pass is done first followed by the requested number of passes (shifted Cholesky-QR3)
+      //
+      unsigned int numberPassesLeft=numberPasses;
+      if (internal::choleskyQRPass(X,
+				   numberVectors,
+				   globalVectorSize,
+				   false,
+				   mpiComm,
+				   computing_timer)!=0)
+	{
+	  if (dftParameters::verbosity>=4)
+	    pcout<<"Cholesky factorization in Cholesky-QR orthogonalization failed, switching to shifted Cholesky-QR"<<std::endl;
+
+	  if (internal::choleskyQRPass(X,
+				       numberVectors,
+				       globalVectorSize,
+				       true,
+				       mpiComm,
+				       computing_timer)!=0)
+	    {
+	      AssertThrow(dftParameters::enableSwitchToGS,
+			  dealii::ExcMessage("DFT-FE Error: Cholesky factorization in shifted Cholesky-QR orthogonalization failed"));
+	      return 1;
+	    }
+	}
+      else
+	numberPassesLeft--;
+
+      for (unsigned int ipass = 0; ipass < numberPassesLeft; ++ipass)
+	if (internal::choleskyQRPass(X,
+				     numberVectors,
+				     globalVectorSize,
+				     false,
+				     mpiComm,
+				     computing_timer)!=0)
+	  {
+	    AssertThrow(dftParameters::enableSwitchToGS,
+			dealii::ExcMessage("DFT-FE Error: Cholesky factorization in Cholesky-QR orthogonalization failed"));
+	    return 1;
+	  }
+
+      return 0;
+    }
+
+  }
+}
@@ -34,6 +34,15 @@ namespace dftfe
     namespace internal
     {
 #ifdef DEAL_II_WITH_SCALAPACK
+      namespace
+      {
+	//
+	//process grids of square matrices created so far, keyed on the communicator and the number of
+	//row processors, which is the only dependence of the process grid on the matrix size
+	//
+	std::map<std::pair<MPI_Comm,unsigned int>,std::shared_ptr< const dealii::Utilities::MPI::ProcessGrid> > processGridSquareMatrixCache;
+      }
+
       void createProcessGridSquareMatrix(const MPI_Comm & mpi_communicator,
 					 const unsigned size,
 					 std::shared_ptr< const dealii::Utilities::MPI::ProcessGrid>  & processGrid)
@@ -46,15 +55,33 @@ namespace dftfe
 		   std::ceil((double)size/(double)(1000))):
 	  std::min((unsigned int)std::floor(std::sqrt(numberProcs)),
 		   dftParameters::scalapackParalProcs);
-	if(dftParameters::verbosity>=4)
+
+	//
+	//reuse the process grid if already created, as the creation involves collective MPI communicator
+	//creation calls
+	//
+	std::shared_ptr< const dealii::Utilities::MPI::ProcessGrid> & cachedProcessGrid
+	  =processGridSquareMatrixCache[std::make_pair(mpi_communicator,rowProcs)];
+
+	if (!cachedProcessGrid)
 	  {
-	    dealii::ConditionalOStream   pcout(std::cout, (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0));
-	    pcout<<"Scalapack Matrix created, row procs: "<< rowProcs<<std::endl;
+	    if(dftParameters::verbosity>=4)
+	      {
+		dealii::ConditionalOStream   pcout(std::cout, (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0));
+		pcout<<"Scalapack Matrix created, row procs: "<< rowProcs<<std::endl;
+	      }
+
+	    cachedProcessGrid=std::make_shared<const dealii::Utilities::MPI::ProcessGrid>(mpi_communicator,
+											  rowProcs,
+											  rowProcs);
 	  }
 
-	processGrid=std::make_shared<const dealii::Utilities::MPI::ProcessGrid>(mpi_communicator,
-										rowProcs,
-										rowProcs);
+	processGrid=cachedProcessGrid;
+      }
+
+      void clearProcessGridCache()
+      {
+	processGridSquareMatrixCache.clear();
       }
 
 
@@ -84,14 +111,20 @@ namespace dftfe
       template<typename T>
       void createGlobalToLocalIdMapsScaLAPACKMat(const std::shared_ptr< const dealii::Utilities::MPI::ProcessGrid>  & processGrid,
 						 const dealii::ScaLAPACKMatrix<T> & mat,
-						 std::map<unsigned int, unsigned int> & globalToLocalRowIdMap,
-						 std::map<unsigned int, unsigned int> & globalToLocalColumnIdMap)
+						 std::vector<int> & globalToLocalRowIdMap,
+						 std::vector<int> & globalToLocalColumnIdMap)
       {
 #ifdef USE_COMPLEX
 	AssertThrow(false,dftUtils::ExcNotImplementedYet());
 #else
-	globalToLocalRowIdMap.clear();
-	globalToLocalColumnIdMap.clear();
+	//
+	//flat arrays over all global row/column ids with -1 for the ids not owned by the current processor
+	//as the lookups are done in the innermost loops of the blocked matrix fill and subspace rotation.
+	//Both are sized to the larger matrix dimension as rectangular matrices are looked up with square loop bounds
+	//
+	const unsigned int maxSize=std::max(mat.m(),mat.n());
+	globalToLocalRowIdMap.assign(maxSize,-1);
+	globalToLocalColumnIdMap.assign(maxSize,-1);
 	if (processGrid->is_process_active())
 	  {
 	    for (unsigned int i = 0; i < mat.local_m(); ++i)
@@ -201,8 +234,8 @@ namespace dftfe
 						     bandGroupLowHighPlusOneIndices);
 
           //get global to local index maps for Scalapack matrix
-	  std::map<unsigned int, unsigned int> globalToLocalColumnIdMap;
-	  std::map<unsigned int, unsigned int> globalToLocalRowIdMap;
+	  std::vector<int> globalToLocalColumnIdMap;
+	  std::vector<int> globalToLocalRowIdMap;
 	  internal::createGlobalToLocalIdMapsScaLAPACKMat(processGrid,
 		                                          overlapMatPar,
 				                          globalToLocalRowIdMap,
@@ -231,12 +264,51 @@ namespace dftfe
 	  const unsigned int vectorsBlockSize=std::min(dftParameters::wfcBlockSize,
 	                                               bandGroupLowHighPlusOneIndices[1]);
 
-	  std::vector<dataTypes::number> overlapMatrixBlock(N*vectorsBlockSize,0.0);
+	  /*
+	   * The all reduce of a block is pipelined with the computation of the next block
+	   * as in fillParallelOverlapMatrix.
+	   */
+	  std::vector<dataTypes::number> overlapMatrixBlock(2*N*vectorsBlockSize,0.0);
 	  std::vector<dataTypes::numberLowPrec> overlapMatrixBlockLowPrec(N*vectorsBlockSize,0.0);
+	  MPI_Request blockRequests[2]={MPI_REQUEST_NULL,MPI_REQUEST_NULL};
+	  unsigned int blockStartIds[2]={0,0};
+	  unsigned int blockSizes[2]={0,0};
+
+	  auto fillOverlapMatParFromBlock=[&](const unsigned int blockBuffer)
+	  {
+	      if (blockSizes[blockBuffer]==0)
+		  return;
+
+	      MPI_Wait(&blockRequests[blockBuffer],MPI_STATUS_IGNORE);
+
+	      const unsigned int ivec=blockStartIds[blockBuffer];
+	      const unsigned int B=blockSizes[blockBuffer];
+	      const unsigned int D=N-ivec;
+	      const dataTypes::number * overlapMatrixBlockBuffer=&overlapMatrixBlock[blockBuffer*N*vectorsBlockSize];
+
+	      //Copying only the lower triangular part to the ScaLAPACK overlap matrix
+	      if (processGrid->is_process_active())
+		  for(unsigned int i = 0; i <B; ++i)
+		      if (globalToLocalColumnIdMap[i+ivec]!=-1)
+		      {
+			  const unsigned int localColumnId=globalToLocalColumnIdMap[i+ivec];
+			  for (unsigned int j = ivec; j <N; ++j)
+			  {
+			     const int localId=globalToLocalRowIdMap[j];
+			     if(localId!=-1)
+				 overlapMatPar.local_el(localId,
+							localColumnId)
+							=overlapMatrixBlockBuffer[i*D+j-ivec];
+			  }
+		      }
+
+	      blockSizes[blockBuffer]=0;
+	  };
 
 	  std::vector<dataTypes::numberLowPrec> subspaceVectorsArrayLowPrec(subspaceVectorsArray,
 		                                                             subspaceVectorsArray+
 									     subspaceVectorsArrayLocalSize);
+	  unsigned int currentBlockBuffer=0;
 	  for (unsigned int ivec = 0; ivec < N; ivec += vectorsBlockSize)
 	  {
 	      // Correct block dimensions if block "goes off edge of" the matrix
@@ -252,10 +324,8 @@ namespace dftfe
 		  const dataTypes::number scalarCoeffAlpha = 1.0,scalarCoeffBeta = 0.0;
 		  const dataTypes::numberLowPrec scalarCoeffAlphaLowPrec = 1.0,scalarCoeffBetaLowPrec = 0.0;
 
-		  std::fill(overlapMatrixBlock.begin(),overlapMatrixBlock.end(),0.);
-                  std::fill(overlapMatrixBlockLowPrec.begin(),overlapMatrixBlockLowPrec.end(),0.);
-
 		  const unsigned int D=N-ivec;
+		  dataTypes::number * overlapMatrixBlockBuffer=&overlapMatrixBlock[currentBlockBuffer*N*vectorsBlockSize];
 
 		  dgemm_(&transA,
 			 &transB,
@@ -268,7 +338,7 @@ namespace dftfe
 			 subspaceVectorsArray+ivec,
 			 &N,
 			 &scalarCoeffBeta,
-			 &overlapMatrixBlock[0],
+			 overlapMatrixBlockBuffer,
 			 &D);
 
 		  const unsigned int DRem=D-B;
@@ -291,37 +361,28 @@ namespace dftfe
 
 		  for(unsigned int i = 0; i <B; ++i)
 		      for (unsigned int j = 0; j <DRem; ++j)
-			  overlapMatrixBlock[i*D+j+B]
+			  overlapMatrixBlockBuffer[i*D+j+B]
 			      =overlapMatrixBlockLowPrec[i*DRem+j];
 
-		  MPI_Barrier(mpiComm);
-		  // Sum local XTrunc^{T}*XcBlock across domain decomposition processors
-		  MPI_Allreduce(MPI_IN_PLACE,
-				&overlapMatrixBlock[0],
-				D*B,
-				dataTypes::mpi_type_id(&overlapMatrixBlock[0]),
-				MPI_SUM,
-				mpiComm);
-
-		  //Copying only the lower triangular part to the ScaLAPACK overlap matrix
-		  if (processGrid->is_process_active())
-		      for(unsigned int i = 0; i <B; ++i)
-			  if (globalToLocalColumnIdMap.find(i+ivec)!=globalToLocalColumnIdMap.end())
-			  {
-			      const unsigned int localColumnId=globalToLocalColumnIdMap[i+ivec];
-			      for (unsigned int j = ivec; j <N; ++j)
-			      {
-				 std::map<unsigned int, unsigned int>::iterator it=
-					      globalToLocalRowIdMap.find(j);
-				 if(it!=globalToLocalRowIdMap.end())
-				     overlapMatPar.local_el(it->second,
-							    localColumnId)
-							    =overlapMatrixBlock[i*D+j-ivec];
-			      }
-			  }
+		  // Start sum of local XTrunc^{T}*XcBlock across domain decomposition processors
+		  MPI_Iallreduce(MPI_IN_PLACE,
+				 overlapMatrixBlockBuffer,
+				 D*B,
+				 dataTypes::mpi_type_id(overlapMatrixBlockBuffer),
+				 MPI_SUM,
+				 mpiComm,
+				 &blockRequests[currentBlockBuffer]);
+		  blockStartIds[currentBlockBuffer]=ivec;
+		  blockSizes[currentBlockBuffer]=B;
+
+		  // Fill from the previous block, whose all reduce was overlapped with the above computation
+		  currentBlockBuffer=1-currentBlockBuffer;
+		  fillOverlapMatParFromBlock(currentBlockBuffer);
 	      }//band parallelization
 	  }//block loop
 
+	  fillOverlapMatParFromBlock(1-currentBlockBuffer);
+
 
 	  //accumulate contribution from all band parallelization groups
           linearAlgebraOperations::internal::sumAcrossInterCommScaLAPACKMat
@@ -357,8 +418,8 @@ namespace dftfe
 						     bandGroupLowHighPlusOneIndices);
 
           //get global to local index maps for Scalapack matrix
-	  std::map<unsigned int, unsigned int> globalToLocalColumnIdMap;
-	  std::map<unsigned int, unsigned int> globalToLocalRowIdMap;
+	  std::vector<int> globalToLocalColumnIdMap;
+	  std::vector<int> globalToLocalRowIdMap;
 	  internal::createGlobalToLocalIdMapsScaLAPACKMat(processGrid,
 		                                          overlapMatPar,
 				                          globalToLocalRowIdMap,
@@ -387,8 +448,49 @@ namespace dftfe
 	  const unsigned int vectorsBlockSize=std::min(dftParameters::wfcBlockSize,
 	                                               bandGroupLowHighPlusOneIndices[1]);
 
-	  std::vector<T> overlapMatrixBlock(N*vectorsBlockSize,0.0);
+	  /*
+	   * The all reduce of the XTrunc^{T}*XcBlock result of a block is done using a non-blocking
+	   * MPI_Iallreduce, which is overlapped with the computation of the next block. Two block
+	   * buffers are used for this pipelining. The ScaLAPACK overlap matrix is filled from a block
+	   * buffer once its all reduce is completed.
+	   */
+	  std::vector<T> overlapMatrixBlock(2*N*vectorsBlockSize,0.0);
+	  MPI_Request blockRequests[2]={MPI_REQUEST_NULL,MPI_REQUEST_NULL};
+	  unsigned int blockStartIds[2]={0,0};
+	  unsigned int blockSizes[2]={0,0};
+
+	  auto fillOverlapMatParFromBlock=[&](const unsigned int blockBuffer)
+	  {
+	      if (blockSizes[blockBuffer]==0)
+		  return;
+
+	      MPI_Wait(&blockRequests[blockBuffer],MPI_STATUS_IGNORE);
+
+	      const unsigned int ivec=blockStartIds[blockBuffer];
+	      const unsigned int B=blockSizes[blockBuffer];
+	      const unsigned int D=N-ivec;
+	      const T * overlapMatrixBlockBuffer=&overlapMatrixBlock[blockBuffer*N*vectorsBlockSize];
+
+	      //Copying only the lower triangular part to the ScaLAPACK overlap matrix
+	      if (processGrid->is_process_active())
+		  for(unsigned int i = 0; i <B; ++i)
+		      if (globalToLocalColumnIdMap[i+ivec]!=-1)
+		      {
+			  const unsigned int localColumnId=globalToLocalColumnIdMap[i+ivec];
+			  for (unsigned int j = ivec; j <N; ++j)
+			  {
+			     const int localId=globalToLocalRowIdMap[j];
+			     if(localId!=-1)
+				 overlapMatPar.local_el(localId,
+							localColumnId)
+							=overlapMatrixBlockBuffer[i*D+j-ivec];
+			  }
+		      }
+
+	      blockSizes[blockBuffer]=0;
+	  };
 
+	  unsigned int currentBlockBuffer=0;
 	  for (unsigned int ivec = 0; ivec < N; ivec += vectorsBlockSize)
 	  {
 	      // Correct block dimensions if block "goes off edge of" the matrix
@@ -403,9 +505,8 @@ namespace dftfe
 		  const char transA = 'N',transB = 'T';
 		  const T scalarCoeffAlpha = 1.0,scalarCoeffBeta = 0.0;
 
-		  std::fill(overlapMatrixBlock.begin(),overlapMatrixBlock.end(),0.);
-
 		  const unsigned int D=N-ivec;
+		  T * overlapMatrixBlockBuffer=&overlapMatrixBlock[currentBlockBuffer*N*vectorsBlockSize];
 
 		  // Comptute local XTrunc^{T}*XcBlock.
 		  dgemm_(&transA,
@@ -419,37 +520,28 @@ namespace dftfe
 			 subspaceVectorsArray+ivec,
 			 &N,
 			 &scalarCoeffBeta,
-			 &overlapMatrixBlock[0],
+			 overlapMatrixBlockBuffer,
 			 &D);
 
-                  MPI_Barrier(mpiComm);
-		  // Sum local XTrunc^{T}*XcBlock across domain decomposition processors
-		  MPI_Allreduce(MPI_IN_PLACE,
-				&overlapMatrixBlock[0],
-				D*B,
-				dataTypes::mpi_type_id(&overlapMatrixBlock[0]),
-				MPI_SUM,
-				mpiComm);
-
-		  //Copying only the lower triangular part to the ScaLAPACK overlap matrix
-		  if (processGrid->is_process_active())
-		      for(unsigned int i = 0; i <B; ++i)
-			  if (globalToLocalColumnIdMap.find(i+ivec)!=globalToLocalColumnIdMap.end())
-			  {
-			      const unsigned int localColumnId=globalToLocalColumnIdMap[i+ivec];
-			      for (unsigned int j = ivec; j <N; ++j)
-			      {
-				 std::map<unsigned int, unsigned int>::iterator it=
-					      globalToLocalRowIdMap.find(j);
-				 if(it!=globalToLocalRowIdMap.end())
-				     overlapMatPar.local_el(it->second,
-							    localColumnId)
-							    =overlapMatrixBlock[i*D+j-ivec];
-			      }
-			  }
+		  // Start sum of local XTrunc^{T}*XcBlock across domain decomposition processors
+		  MPI_Iallreduce(MPI_IN_PLACE,
+				 overlapMatrixBlockBuffer,
+				 D*B,
+				 dataTypes::mpi_type_id(overlapMatrixBlockBuffer),
+				 MPI_SUM,
+				 mpiComm,
+				 &blockRequests[currentBlockBuffer]);
+		  blockStartIds[currentBlockBuffer]=ivec;
+		  blockSizes[currentBlockBuffer]=B;
+
+		  // Fill from the previous block, whose all reduce was overlapped with the above computation
+		  currentBlockBuffer=1-currentBlockBuffer;
+		  fillOverlapMatParFromBlock(currentBlockBuffer);
 	      }//band parallelization
 	  }//block loop
 
+	  fillOverlapMatParFromBlock(1-currentBlockBuffer);
+
 
 	  //accumulate contribution from all band parallelization groups
           linearAlgebraOperations::internal::sumAcrossInterCommScaLAPACKMat
@@ -489,8 +581,8 @@ namespace dftfe
 						   N,
 						   bandGroupLowHighPlusOneIndices);
 
-	std::map<unsigned int, unsigned int> globalToLocalColumnIdMap;
-	std::map<unsigned int, unsigned int> globalToLocalRowIdMap;
+	std::vector<int> globalToLocalColumnIdMap;
+	std::vector<int> globalToLocalRowIdMap;
 	internal::createGlobalToLocalIdMapsScaLAPACKMat(processGrid,
 							rotationMatPar,
 							globalToLocalRowIdMap,
@@ -566,19 +658,17 @@ namespace dftfe
 		      {
 			if (processGrid->is_process_active())
 			  for (unsigned int i = 0; i <D; ++i)
-			    if (globalToLocalRowIdMap.find(i)
-				!=globalToLocalRowIdMap.end())
+			    if (globalToLocalRowIdMap[i]!=-1)
 			      {
 				const unsigned int localRowId=globalToLocalRowIdMap[i];
 				for (unsigned int j = 0; j <BVec; ++j)
 
 				  {
-				    std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalColumnIdMap.find(j+jvec);
-				    if(it!=globalToLocalColumnIdMap.end())
+				    const int localId=globalToLocalColumnIdMap[j+jvec];
+				    if(localId!=-1)
 				      rotationMatBlock[i*BVec+j]=
 					rotationMatPar.local_el(localRowId,
-								it->second);
+								localId);
 				  }
 			      }
 		      }
@@ -586,17 +676,15 @@ namespace dftfe
 		      {
 			if (processGrid->is_process_active())
 			  for (unsigned int i = 0; i <D; ++i)
-			    if(globalToLocalColumnIdMap.find(i)
-			       !=globalToLocalColumnIdMap.end())
+			    if(globalToLocalColumnIdMap[i]!=-1)
 			      {
 				const unsigned int localColumnId=globalToLocalColumnIdMap[i];
 				for (unsigned int j = 0; j <BVec; ++j)
 				  {
-				    std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalRowIdMap.find(j+jvec);
-				    if (it!=globalToLocalRowIdMap.end())
+				    const int localId=globalToLocalRowIdMap[j+jvec];
+				    if (localId!=-1)
 				      rotationMatBlock[i*BVec+j]=
-					rotationMatPar.local_el(it->second,
+					rotationMatPar.local_el(localId,
 								localColumnId);
 				  }
 			      }
@@ -692,8 +780,8 @@ namespace dftfe
 						   numberTopVectors,
 						   bandGroupLowHighPlusOneIndices);
 
-	std::map<unsigned int, unsigned int> globalToLocalColumnIdMap;
-	std::map<unsigned int, unsigned int> globalToLocalRowIdMap;
+	std::vector<int> globalToLocalColumnIdMap;
+	std::vector<int> globalToLocalRowIdMap;
 	internal::createGlobalToLocalIdMapsScaLAPACKMat(processGrid,
 							QMat,
 							globalToLocalRowIdMap,
@@ -741,19 +829,17 @@ namespace dftfe
 		      {
 			if (processGrid->is_process_active())
 			  for (unsigned int i = 0; i <N; ++i)
-			    if (globalToLocalRowIdMap.find(i)
-				!=globalToLocalRowIdMap.end())
+			    if (globalToLocalRowIdMap[i]!=-1)
 			      {
 				const unsigned int localRowId=globalToLocalRowIdMap[i];
 				for (unsigned int j = 0; j <BVec; ++j)
 
 				  {
-				    std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalColumnIdMap.find(j+jvec);
-				    if(it!=globalToLocalColumnIdMap.end())
+				    const int localId=globalToLocalColumnIdMap[j+jvec];
+				    if(localId!=-1)
 				      rotationMatBlock[i*BVec+j]=
 					QMat.local_el(localRowId,
-								it->second);
+								localId);
 				  }
 			      }
 		      }
@@ -761,17 +847,15 @@ namespace dftfe
 		      {
 			if (processGrid->is_process_active())
 			  for (unsigned int i = 0; i <N; ++i)
-			    if(globalToLocalColumnIdMap.find(i)
-			       !=globalToLocalColumnIdMap.end())
+			    if(globalToLocalColumnIdMap[i]!=-1)
 			      {
 				const unsigned int localColumnId=globalToLocalColumnIdMap[i];
 				for (unsigned int j = 0; j <BVec; ++j)
 				  {
-				    std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalRowIdMap.find(j+jvec);
-				    if (it!=globalToLocalRowIdMap.end())
+				    const int localId=globalToLocalRowIdMap[j+jvec];
+				    if (localId!=-1)
 				      rotationMatBlock[i*BVec+j]=
-					QMat.local_el(it->second,
+					QMat.local_el(localId,
 								localColumnId);
 				  }
 			      }
@@ -864,8 +948,8 @@ namespace dftfe
 						   numberTopVectors,
 						   bandGroupLowHighPlusOneIndices);
 
-	std::map<unsigned int, unsigned int> globalToLocalColumnIdMap;
-	std::map<unsigned int, unsigned int> globalToLocalRowIdMap;
+	std::vector<int> globalToLocalColumnIdMap;
+	std::vector<int> globalToLocalRowIdMap;
 	internal::createGlobalToLocalIdMapsScaLAPACKMat(processGrid,
 							QMat,
 							globalToLocalRowIdMap,
@@ -922,20 +1006,18 @@ namespace dftfe
 		      {
 			if (processGrid->is_process_active())
 			  for (unsigned int i = 0; i <N; ++i)
-			    if (globalToLocalRowIdMap.find(i)
-				!=globalToLocalRowIdMap.end())
+			    if (globalToLocalRowIdMap[i]!=-1)
 			      {
 				const unsigned int localRowId=globalToLocalRowIdMap[i];
 				for (unsigned int j = 0; j <BVec; ++j)
 
 				  {
-				    std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalColumnIdMap.find(j+jvec);
-				    if(it!=globalToLocalColumnIdMap.end())
+				    const int localId=globalToLocalColumnIdMap[j+jvec];
+				    if(localId!=-1)
 				    {
 				        const dataTypes::number val=
 					          QMat.local_el(localRowId,
-								it->second);
+								localId);
 					if (i<Ncore)
 					  rotationMatCoreCompBlock[i*BVec+j]=val;
 					else
@@ -948,18 +1030,16 @@ namespace dftfe
 		      {
 			if (processGrid->is_process_active())
 			  for (unsigned int i = 0; i <N; ++i)
-			    if(globalToLocalColumnIdMap.find(i)
-			       !=globalToLocalColumnIdMap.end())
+			    if(globalToLocalColumnIdMap[i]!=-1)
 			      {
 				const unsigned int localColumnId=globalToLocalColumnIdMap[i];
 				for (unsigned int j = 0; j <BVec; ++j)
 				  {
-				    std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalRowIdMap.find(j+jvec);
-				    if (it!=globalToLocalRowIdMap.end())
+				    const int localId=globalToLocalRowIdMap[j+jvec];
+				    if (localId!=-1)
 				    {
 				        const dataTypes::number val=
-				 	          QMat.local_el(it->second,
+				 	          QMat.local_el(localId,
 								localColumnId);
 					if (i<Ncore)
 					  rotationMatCoreCompBlock[i*BVec+j]=val;
@@ -1081,8 +1161,8 @@ namespace dftfe
 						   N,
 						   bandGroupLowHighPlusOneIndices);
 
-	std::map<unsigned int, unsigned int> globalToLocalColumnIdMap;
-	std::map<unsigned int, unsigned int> globalToLocalRowIdMap;
+	std::vector<int> globalToLocalColumnIdMap;
+	std::vector<int> globalToLocalRowIdMap;
 	internal::createGlobalToLocalIdMapsScaLAPACKMat(processGrid,
 							rotationMatPar,
 							globalToLocalRowIdMap,
@@ -1159,32 +1239,29 @@ namespace dftfe
 		      {
 			if (processGrid->is_process_active())
 			  for (unsigned int i = 0; i <D; ++i)
-			    if (globalToLocalRowIdMap.find(i)
-				!=globalToLocalRowIdMap.end())
+			    if (globalToLocalRowIdMap[i]!=-1)
 			      {
 				const unsigned int localRowId=globalToLocalRowIdMap[i];
 				for (unsigned int j = 0; j <BVec; ++j)
 				{
-				    std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalColumnIdMap.find(j+jvec);
-				    if(it!=globalToLocalColumnIdMap.end())
+				    const int localId=globalToLocalColumnIdMap[j+jvec];
+				    if(localId!=-1)
 				    {
 				      rotationMatBlock[i*BVec+j]=
 					rotationMatPar.local_el(localRowId,
-								it->second);
+								localId);
 
 				    }
 				}
 
 				if (i>=jvec && i<(jvec+BVec))
 				{
-				  std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalColumnIdMap.find(i);
-				  if (it!=globalToLocalColumnIdMap.end())
+				  const int localId=globalToLocalColumnIdMap[i];
+				  if (localId!=-1)
 				  {
                                     rotationMatBlock[i*BVec+i-jvec]=0.0;
 				    diagValuesBlock[i-jvec]=rotationMatPar.local_el(localRowId,
-								                    it->second);
+								                    localId);
 				  }
 				}
 			      }
@@ -1193,31 +1270,28 @@ namespace dftfe
 		      {
 			if (processGrid->is_process_active())
 			  for (unsigned int i = 0; i <D; ++i)
-			    if(globalToLocalColumnIdMap.find(i)
-			       !=globalToLocalColumnIdMap.end())
+			    if(globalToLocalColumnIdMap[i]!=-1)
 			      {
 				const unsigned int localColumnId=globalToLocalColumnIdMap[i];
 				for (unsigned int j = 0; j <BVec; ++j)
 				  {
-				    std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalRowIdMap.find(j+jvec);
-				    if (it!=globalToLocalRowIdMap.end())
+				    const int localId=globalToLocalRowIdMap[j+jvec];
+				    if (localId!=-1)
 				    {
 				      rotationMatBlock[i*BVec+j]=
-					rotationMatPar.local_el(it->second,
+					rotationMatPar.local_el(localId,
 								localColumnId);
 				    }
 				  }
 
 				  if (i>=jvec && i<(jvec+BVec))
 				  {
-				    std::map<unsigned int, unsigned int>::iterator it=
-				      globalToLocalRowIdMap.find(i);
-				    if (globalToLocalRowIdMap.find(i)!=globalToLocalRowIdMap.end())
+				    const int localId=globalToLocalRowIdMap[i];
+				    if (globalToLocalRowIdMap[i]!=-1)
 				    {
                                       rotationMatBlock[i*BVec+i-jvec]=0.0;
 				      diagValuesBlock[i-jvec]
-					=rotationMatPar.local_el(it->second,
+					=rotationMatPar.local_el(localId,
 								 localColumnId);
 				    }
 				  }
@@ -1298,8 +1372,8 @@ namespace dftfe
       template
       void createGlobalToLocalIdMapsScaLAPACKMat(const std::shared_ptr< const dealii::Utilities::MPI::ProcessGrid>  & processGrid,
 						 const dealii::ScaLAPACKMatrix<dataTypes::number> & mat,
-						 std::map<unsigned int, unsigned int> & globalToLocalRowIdMap,
-						 std::map<unsigned int, unsigned int> & globalToLocalColumnIdMap);
+						 std::vector<int> & globalToLocalRowIdMap,
+						 std::vector<int> & globalToLocalColumnIdMap);
 
       template
       void fillParallelOverlapMatrix(const dataTypes::number* X,
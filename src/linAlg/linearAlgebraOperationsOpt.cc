@@ -28,6 +28,7 @@
 #include <dftUtils.h>
 
 #include "pseudoGS.cc"
+#include "choleskyQR.cc"
 
 namespace dftfe{
 
@@ -256,7 +257,8 @@ namespace dftfe{
 
 
     //
-    //chebyshev filtering of given subspace XArray
+    //chebyshev filtering of given subspace XArray. The ghost exchange of each recurrence
+    //step is overlapped with the cell level work on the interior cells inside HX
     //
     template<typename T>
     void chebyshevFilter(operatorDFTClass & operatorMatrix,
@@ -272,12 +274,14 @@ namespace dftfe{
       e = (b-a)/2.0; c = (b+a)/2.0;
       sigma = e/(a0-c); sigma1 = sigma; gamma = 2.0/sigma1;
 
-      dealii::parallel::distributed::Vector<T> YArray;//,YNewArray;
-
       //
-      //create YArray
+      //YArray is taken from the workspaces of the operator (workspace id 2), which are reused across the
+      //calls and have the same parallel layout as the flattened array XArray
       //
-      YArray.reinit(XArray);
+      dealii::parallel::distributed::Vector<T> & YArray=operatorMatrix.getFlattenedArrayWorkspace(numberWaveFunctions,
+												   2);
+      Assert(YArray.partitioners_are_compatible(*XArray.get_partitioner()),
+	     dealii::ExcMessage("XArray is not a flattened array created by the operator"));
 
 
       //
@@ -630,17 +634,147 @@ namespace dftfe{
 #endif
 
 #if(defined DEAL_II_WITH_SCALAPACK && !USE_COMPLEX)
+    namespace internal
+    {
+      //
+      //rotate the valence block X_v of the orthonormal subspace X within its own span, X_v=X_v*U, with
+      //U=Q_v*L^{-T} where Q_v are the valence block rows of the valence eigenvectors Q of the projected
+      //Hamiltonian and Q_v^{T}*Q_v=L*L^{T}. X stays orthonormal with an unchanged span, and the valence block
+      //columns are the Gram-Schmidt orthonormalized valence block components of the valence Ritz vectors X*Q.
+      //Returns the Cholesky factorization info, X is unchanged if it is non-zero
+      //
+      template<typename T>
+      int valenceBlockRotationSpectrumSplit(std::vector<T> & X,
+					    const unsigned int N,
+					    const unsigned int numberCoreStates,
+					    const std::shared_ptr< const dealii::Utilities::MPI::ProcessGrid>  & processGrid,
+					    const dealii::ScaLAPACKMatrix<T> & QMat,
+					    const MPI_Comm &mpiComm)
+      {
+	const unsigned int numberValenceStates=N-numberCoreStates;
+	const unsigned int numLocalDofs = X.size()/N;
+
+	std::vector<int> globalToLocalColumnIdMap;
+	std::vector<int> globalToLocalRowIdMap;
+	createGlobalToLocalIdMapsScaLAPACKMat(processGrid,
+					      QMat,
+					      globalToLocalRowIdMap,
+					      globalToLocalColumnIdMap);
+
+	//
+	//Q_v stored in the column major format
+	//
+	std::vector<T> rotationMat(numberValenceStates*numberValenceStates,0.0);
+	if (processGrid->is_process_active())
+	  for (unsigned int i = 0; i <numberValenceStates; ++i)
+	    if (globalToLocalRowIdMap[numberCoreStates+i]!=-1)
+	      {
+		const unsigned int localRowId=globalToLocalRowIdMap[numberCoreStates+i];
+		for (unsigned int j = 0; j <numberValenceStates; ++j)
+		  {
+		    const int localColumnId=globalToLocalColumnIdMap[j];
+		    if (localColumnId!=-1)
+		      rotationMat[j*numberValenceStates+i]=QMat.local_el(localRowId,
+									 localColumnId);
+		  }
+	      }
+
+	MPI_Allreduce(MPI_IN_PLACE,
+		      &rotationMat[0],
+		      rotationMat.size(),
+		      dataTypes::mpi_type_id(&rotationMat[0]),
+		      MPI_SUM,
+		      mpiComm);
+
+	//
+	//U=Q_v*L^{-T}
+	//
+	std::vector<T> overlapMat(numberValenceStates*numberValenceStates,0.0);
+	const char uplo1 = 'L', trans1 = 'T';
+	const double alpha1 = 1.0, beta1 = 0.0;
+	dsyrk_(&uplo1,
+	       &trans1,
+	       &numberValenceStates,
+	       &numberValenceStates,
+	       &alpha1,
+	       &rotationMat[0],
+	       &numberValenceStates,
+	       &beta1,
+	       &overlapMat[0],
+	       &numberValenceStates);
+
+	int info;
+	const char uplo2 = 'L';
+	dpotrf_(&uplo2,
+		&numberValenceStates,
+		&overlapMat[0],
+		&numberValenceStates,
+		&info);
+
+	if (info!=0)
+	  return info;
+
+	const char side3 = 'R', uplo3 = 'L', transA3 = 'T', diag3 = 'N';
+	const T alpha3 = 1.0;
+	dtrsm_(&side3,
+	       &uplo3,
+	       &transA3,
+	       &diag3,
+	       &numberValenceStates,
+	       &numberValenceStates,
+	       &alpha3,
+	       &overlapMat[0],
+	       &numberValenceStates,
+	       &rotationMat[0],
+	       &numberValenceStates);
+
+	//
+	//X_v=X_v*U, implemented as X_v^{T}=U^{T}*X_v^{T} with X^{T} stored in the column major format
+	//
+	const unsigned int dofsBlockSize=std::min(numLocalDofs,
+						  dftParameters::subspaceRotDofsBlockSize);
+	std::vector<T> rotatedVectorsMatBlock(numberValenceStates*dofsBlockSize,0.0);
+	const char transA4 = 'T', transB4 = 'N';
+	const T alpha4 = 1.0, beta4 = 0.0;
+	for (unsigned int idof = 0; idof < numLocalDofs; idof += dofsBlockSize)
+	  {
+	    const unsigned int BDof=std::min(dofsBlockSize, numLocalDofs-idof);
+
+	    dgemm_(&transA4,
+		   &transB4,
+		   &numberValenceStates,
+		   &BDof,
+		   &numberValenceStates,
+		   &alpha4,
+		   &rotationMat[0],
+		   &numberValenceStates,
+		   &X[0]+idof*N+numberCoreStates,
+		   &N,
+		   &beta4,
+		   &rotatedVectorsMatBlock[0],
+		   &numberValenceStates);
+
+	    for (unsigned int i = 0; i <BDof; ++i)
+	      for (unsigned int j = 0; j <numberValenceStates; ++j)
+		X[(idof+i)*N+numberCoreStates+j]=rotatedVectorsMatBlock[i*numberValenceStates+j];
+	  }
+
+	return 0;
+      }
+    }
+
     template<typename T>
     void rayleighRitzSpectrumSplitDirect
                     (operatorDFTClass & operatorMatrix,
-		     const std::vector<T> & X,
+		     std::vector<T> & X,
 		     std::vector<T> & Y,
 		     const unsigned int numberWaveFunctions,
 		     const unsigned int numberCoreStates,
 		     const MPI_Comm &interBandGroupComm,
 		     const MPI_Comm &mpi_communicator,
 		     const bool useMixedPrec,
-		     std::vector<double> & eigenValues)
+		     std::vector<double> & eigenValues,
+		     const bool rotateValenceBlock)
 
     {
       dealii::ConditionalOStream   pcout(std::cout, (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0));
@@ -749,20 +883,35 @@ namespace dftfe{
 	  computing_timer.exit_section("Blocked subspace rotation, RR step");
       }
 
+      if (rotateValenceBlock)
+      {
+	  computing_timer.enter_section("Valence block rotation, RR step");
+	  const int info=internal::valenceBlockRotationSpectrumSplit(X,
+								     numberWaveFunctions,
+								     numberCoreStates,
+								     processGrid,
+								     projHamPar,
+								     mpi_communicator);
+	  if (info!=0 && dftParameters::verbosity>=4)
+	    pcout<<"Cholesky factorization in the valence block rotation failed, the valence block is not rotated"<<std::endl;
+	  computing_timer.exit_section("Valence block rotation, RR step");
+      }
+
     }
 #else
 
     template<typename T>
     void rayleighRitzSpectrumSplitDirect
                   (operatorDFTClass & operatorMatrix,
-		   const std::vector<T> & X,
+		   std::vector<T> & X,
 		   std::vector<T> & Y,
 		   const unsigned int numberWaveFunctions,
 		   const unsigned int numberCoreStates,
 		   const MPI_Comm &interBandGroupComm,
 		   const MPI_Comm &mpi_communicator,
 		   const bool useMixedPrec,
-		   std::vector<double> & eigenValues)
+		   std::vector<double> & eigenValues,
+		   const bool rotateValenceBlock)
     {
        AssertThrow(false,dftUtils::ExcNotImplementedYet());
     }
@@ -785,8 +934,8 @@ namespace dftfe{
       const unsigned int localVectorSize = X.size()/totalNumberVectors;
       std::vector<double> residualNormSquare(totalNumberVectors,0.0);
 
-      //create temporary arrays XBlock,HXBlock
-      dealii::parallel::distributed::Vector<T> XBlock,HXBlock;
+      //temporary arrays XBlock,HXBlock taken from the workspaces of the operator
+      dealii::parallel::distributed::Vector<T> * XBlock, * HXBlock;
 
       // Do H*X using a blocked approach and compute
       // the residual norms: H*XBlock-XBlock*D, where
@@ -800,38 +949,39 @@ namespace dftfe{
 	  const unsigned int B = std::min(vectorsBlockSize, totalNumberVectors-jvec);
 	  if (jvec==0 || B!=vectorsBlockSize)
 	  {
+	     XBlock=&operatorMatrix.getFlattenedArrayWorkspace(B,0);
+	     HXBlock=&operatorMatrix.getFlattenedArrayWorkspace(B,1);
 	     operatorMatrix.reinit(B,
-		                   XBlock,
-		                   true);
-	     HXBlock.reinit(XBlock);
+		                   *XBlock,
+		                   false);
 	  }
 
-          XBlock=T(0.);
+          *XBlock=T(0.);
 	  //fill XBlock from X:
 	  for(unsigned int iNode = 0; iNode<localVectorSize; ++iNode)
 	      for(unsigned int iWave = 0; iWave < B; ++iWave)
-		    XBlock.local_element(iNode*B
-			     +iWave)
+		    XBlock->local_element(iNode*B
+			      +iWave)
 			 =X[iNode*totalNumberVectors+jvec+iWave];
 
 	  MPI_Barrier(mpiComm);
 	  //evaluate H times XBlock and store in HXBlock
-	  HXBlock=T(0.);
+	  *HXBlock=T(0.);
 	  const bool scaleFlag = false;
 	  const double scalar = 1.0;
-	  operatorMatrix.HX(XBlock,
+	  operatorMatrix.HX(*XBlock,
 	                    B,
 	                    scaleFlag,
 	                    scalar,
 			    false,
-	                    HXBlock);
+	                    *HXBlock);
 
 	  //compute residual norms:
 	  for(unsigned int iDof = 0; iDof < localVectorSize; ++iDof)
 	      for(unsigned int iWave = 0; iWave < B; iWave++)
 		{
-		  const double temp =std::abs(HXBlock.local_element(B*iDof + iWave) -
-		      eigenValues[jvec+iWave]*XBlock.local_element(B*iDof + iWave));
+		  const double temp =std::abs(HXBlock->local_element(B*iDof + iWave) -
+		      eigenValues[jvec+iWave]*XBlock->local_element(B*iDof + iWave));
 		  residualNormSquare[jvec+iWave] += temp*temp;
 		}
       }
@@ -1240,6 +1390,11 @@ namespace dftfe{
 							     const MPI_Comm &mpiComm,
 							     const bool useMixedPrec);
 
+    template unsigned int choleskyQROrthogonalization(std::vector<dataTypes::number> &,
+						      const unsigned int,
+						      const unsigned int,
+						      const MPI_Comm &);
+
     template void rayleighRitz(operatorDFTClass  & operatorMatrix,
 			       std::vector<dataTypes::number> &,
 			       const unsigned int numberWaveFunctions,
@@ -1250,14 +1405,15 @@ namespace dftfe{
 
     template void rayleighRitzSpectrumSplitDirect
 	                  (operatorDFTClass  & operatorMatrix,
-			   const std::vector<dataTypes::number> &,
+			   std::vector<dataTypes::number> &,
 			   std::vector<dataTypes::number> &,
 			   const unsigned int numberWaveFunctions,
 			   const unsigned int numberCoreStates,
 			   const MPI_Comm &,
 			   const MPI_Comm &,
 			   const bool useMixedPrec,
-			   std::vector<double>     & eigenValues);
+			   std::vector<double>     & eigenValues,
+			   const bool rotateValenceBlock);
 
     template void computeEigenResidualNorm(operatorDFTClass        & operatorMatrix,
 					   std::vector<dataTypes::number> & X,
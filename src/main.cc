@@ -56,6 +56,9 @@ int main (int argc, char *argv[])
   prm.parse_input(parameter_file);
   dftfe::dftParameters::parse_parameters(prm);
 
+  //limit the number of threads used by the thread parallel cell loops in each MPI task
+  dealii::MultithreadInfo::set_thread_limit(dftfe::dftParameters::numThreadsPerTask);
+
   deallog.depth_console(0);
 
   dftfe::dftUtils::Pool kPointPool(MPI_COMM_WORLD, dftfe::dftParameters::npool);
@@ -78,6 +81,9 @@ int main (int argc, char *argv[])
       pcout << "Number of MPI tasks for finite-element domain decomposition: "
 	    << Utilities::MPI::n_mpi_processes(bandGroupsPool.get_intrapool_comm())
 	    << std::endl;
+      pcout << "Number of threads per MPI task: "
+	    << dealii::MultithreadInfo::n_threads()
+	    << std::endl;
       pcout <<"============================================================================================" << std::endl ;
   }
 
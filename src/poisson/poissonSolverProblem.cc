@@ -40,8 +40,9 @@ namespace dftfe {
 		     const dealii::ConstraintMatrix & constraintMatrix,
 		     const unsigned int matrixFreeVectorComponent,
 	             const std::map<dealii::types::global_dof_index, double> & atoms,
-		     const std::map<dealii::CellId,std::vector<double> > & rhoValues,
-		     const bool isComputeDiagonalA)
+		     const dftUtils::cellQuadratureField & rhoValues,
+		     const bool isComputeDiagonalA,
+		     const double screeningParameter)
     {
         d_matrixFreeDataPtr=&matrixFreeData;
 	d_xPtr=&x;
@@ -49,6 +50,7 @@ namespace dftfe {
 	d_matrixFreeVectorComponent=matrixFreeVectorComponent;
 	d_rhoValuesPtr=&rhoValues;
 	d_atomsPtr=&atoms;
+	d_screeningParameter=screeningParameter;
 
 	if (isComputeDiagonalA)
 	  computeDiagonalA();
@@ -70,6 +72,7 @@ namespace dftfe {
 	d_matrixFreeVectorComponent=matrixFreeVectorComponent;
 	d_rhoValuesPtr=NULL;
 	d_atomsPtr=&atoms;
+	d_screeningParameter=0.0;
 
 	if (isComputeDiagonalA)
 	  computeDiagonalA();
@@ -126,7 +129,8 @@ namespace dftfe {
 			      //compute contribution to rhs
 			      double localStiffnessMatIJ = 0.0;
 			      for (unsigned int q_point=0; q_point<num_quad_points; ++q_point)
-				  localStiffnessMatIJ += (1.0/(4.0*M_PI))*(fe_values.shape_grad(i,q_point)*fe_values.shape_grad(j,q_point))*fe_values.JxW(q_point);
+				  localStiffnessMatIJ += (1.0/(4.0*M_PI))*(fe_values.shape_grad(i,q_point)*fe_values.shape_grad(j,q_point)
+					                                  +d_screeningParameter*fe_values.shape_value(i,q_point)*fe_values.shape_value(j,q_point))*fe_values.JxW(q_point);
 
 			      elementalRhs(i)-=d_constraintMatrixPtr->
 				  get_inhomogeneity(columnID)*localStiffnessMatIJ;
@@ -149,9 +153,10 @@ namespace dftfe {
 		   fe_values.reinit (cell);
 		   elementalRhs=0.0;
 
+		   const double * rhoValuesCell=(*d_rhoValuesPtr)[cell->id()];
 		   for (unsigned int i=0; i<dofs_per_cell; ++i)
 		       for (unsigned int q_point=0; q_point<num_quad_points; ++q_point)
-			      elementalRhs(i) += fe_values.shape_value(i, q_point)*d_rhoValuesPtr->find(cell->id())->second[q_point]*fe_values.JxW (q_point);
+			      elementalRhs(i) += fe_values.shape_value(i, q_point)*rhoValuesCell[q_point]*fe_values.JxW (q_point);
 
 		   //assemble to global data structures
 		   cell->get_dof_indices (local_dof_indices);
@@ -190,6 +195,11 @@ namespace dftfe {
     template<unsigned int FEOrder>
     void poissonSolverProblem<FEOrder>::computeDiagonalA()
     {
+	//
+	//A may have changed, so the cached spectrum estimate of the Jacobi preconditioned A is discarded
+	//
+	setMaxEigenValueJacobiPreconditioned(0.0);
+
 	d_diagonalA.reinit(*d_xPtr);
 
 	const dealii::DoFHandler<3> & dofHandler=
@@ -214,7 +224,8 @@ namespace dftfe {
 	      elementalDiagonalA=0.0;
 	      for (unsigned int i = 0; i < dofs_per_cell; ++i)
 		  for (unsigned int q_point = 0; q_point < num_quad_points; ++q_point)
-		      elementalDiagonalA(i) += (1.0/(4.0*M_PI))*(fe_values.shape_grad(i, q_point)*fe_values.shape_grad (i, q_point))*fe_values.JxW(q_point);
+		      elementalDiagonalA(i) += (1.0/(4.0*M_PI))*(fe_values.shape_grad(i, q_point)*fe_values.shape_grad (i, q_point)
+			                                         +d_screeningParameter*fe_values.shape_value(i, q_point)*fe_values.shape_value(i, q_point))*fe_values.JxW(q_point);
 
 	      d_constraintMatrixPtr->distribute_local_to_global(elementalDiagonalA,
 		                                                local_dof_indices,
@@ -240,6 +251,8 @@ namespace dftfe {
 				     const std::pair<unsigned int,unsigned int> &cell_range) const
     {
       dealii::VectorizedArray<double>  quarter = dealii::make_vectorized_array (1.0/(4.0*M_PI));
+      dealii::VectorizedArray<double>  screeningQuarter = dealii::make_vectorized_array (d_screeningParameter/(4.0*M_PI));
+      const bool isScreened=d_screeningParameter!=0.0;
 
       dealii::FEEvaluation<3,FEOrder,C_num1DQuad<FEOrder>()> fe_eval(matrixFreeData,
 	                                                             d_matrixFreeVectorComponent,
@@ -249,12 +262,14 @@ namespace dftfe {
 	{
 	  fe_eval.reinit(cell);
 	  fe_eval.read_dof_values(src);
-	  fe_eval.evaluate(false,true,false);
+	  fe_eval.evaluate(isScreened,true,false);
 	  for (unsigned int q=0; q<fe_eval.n_q_points; ++q)
 	    {
 	      fe_eval.submit_gradient(fe_eval.get_gradient(q)*quarter, q);
+	      if (isScreened)
+		fe_eval.submit_value(fe_eval.get_value(q)*screeningQuarter, q);
 	    }
-	  fe_eval.integrate(false, true);
+	  fe_eval.integrate(isScreened, true);
 	  fe_eval.distribute_local_to_global(dst);
 	}
     }
@@ -17,9 +17,123 @@
 //
 
 #include <dealiiLinearSolver.h>
+#include <dftParameters.h>
 
 namespace dftfe {
 
+    namespace internal
+    {
+      //
+      //Chebyshev accelerated Jacobi preconditioner: applies p(D^{-1}A)D^{-1} to a vector, where p(D^{-1}A)D^{-1}src
+      //is the result of degree steps of the Chebyshev semi-iteration (Saad, Iterative methods for sparse linear
+      //systems, Algorithm 12.1) for D^{-1}A x=D^{-1}src starting from x=0, with D the diagonal of A.
+      //The Chebyshev polynomial damps the spectrum of D^{-1}A in [lowerBound,upperBound], so that the outer CG solve
+      //only sees the low end of the spectrum below lowerBound. Only matrix-vector products and the Jacobi preconditioning
+      //function of the dealiiLinearSolverProblem are required
+      //
+      class preconditionChebyshevJacobi
+      {
+      public:
+	preconditionChebyshevJacobi(const dealiiLinearSolverProblem & problem,
+				    const vectorType & templateVector,
+				    const unsigned int degree,
+				    const double lowerBound,
+				    const double upperBound):
+	  d_problem(problem),
+	  d_degree(degree),
+	  d_theta(0.5*(upperBound+lowerBound)),
+	  d_delta(0.5*(upperBound-lowerBound))
+	{
+	  d_residual.reinit(templateVector);
+	  d_update.reinit(templateVector);
+	  d_AUpdate.reinit(templateVector);
+	  d_DInvAUpdate.reinit(templateVector);
+	}
+
+	void vmult(vectorType & dst,
+		   const vectorType & src) const
+	{
+	  const double sigma=d_theta/d_delta;
+	  double rho=1.0/sigma;
+
+	  //r=D^{-1}src, d=r/theta, x=d
+	  d_problem.precondition_Jacobi(d_residual,src,1.0);
+	  d_update.equ(1.0/d_theta,d_residual);
+	  dst=d_update;
+
+	  for (unsigned int k=1; k<d_degree; ++k)
+	    {
+	      //r=r-D^{-1}A d
+	      d_problem.vmult(d_AUpdate,d_update);
+	      d_problem.precondition_Jacobi(d_DInvAUpdate,d_AUpdate,1.0);
+	      d_residual.add(-1.0,d_DInvAUpdate);
+
+	      //d=rhoNew*rho*d+2*rhoNew/delta*r, x=x+d
+	      const double rhoNew=1.0/(2.0*sigma-rho);
+	      d_update.sadd(rhoNew*rho,2.0*rhoNew/d_delta,d_residual);
+	      dst.add(1.0,d_update);
+	      rho=rhoNew;
+	    }
+	}
+
+      private:
+	const dealiiLinearSolverProblem & d_problem;
+	const unsigned int d_degree;
+	const double d_theta;
+	const double d_delta;
+	mutable vectorType d_residual,d_update,d_AUpdate,d_DInvAUpdate;
+      };
+
+      //
+      //estimate the largest eigenvalue of D^{-1}A from the Lanczos tridiagonal matrix of Jacobi preconditioned
+      //CG iterations. The rhs of the physical problem can be nearly orthogonal to the eigenvectors of the high end
+      //of the spectrum, which are the oscillatory modes at the mesh size scale, and hence the CG iterations are
+      //started from a pseudo-random vector with entries depending only on the global index for reproducibility.
+      //The Ritz values converge to the largest eigenvalue from below, so the estimate is still an underestimate
+      //and has to be used with a safety factor
+      //
+      double estimateMaxEigenValueJacobiPreconditioned(dealiiLinearSolverProblem & problem,
+							 const vectorType & templateVector,
+							 const unsigned int numberIterations)
+      {
+	vectorType x, randomVector, rhs;
+	x.reinit(templateVector);
+	randomVector.reinit(templateVector);
+	rhs.reinit(templateVector);
+
+	for (dealii::types::global_dof_index i = 0; i < randomVector.size(); ++i)
+	  if (randomVector.in_local_range(i))
+	    randomVector(i)=1.0+std::sin(1.0+2.0*i)*std::cos(3.0+5.0*i);
+	randomVector.compress(dealii::VectorOperation::insert);
+
+	//
+	//the scaling with D^{-1} zeros the constrained entries
+	//
+	problem.precondition_Jacobi(rhs,randomVector,1.0);
+
+	dealii::PreconditionJacobi<dealiiLinearSolverProblem> preconditioner;
+	preconditioner.initialize (problem, 1.0);
+
+	double maxEigenValue=0.0;
+	dealii::SolverControl solverControl(numberIterations,0.0,false,false);
+	dealii::SolverCG<vectorType> solver(solverControl);
+	solver.connect_eigenvalues_slot([&maxEigenValue](const std::vector<double> & eigenValues)
+					{
+					  if (!eigenValues.empty())
+					    maxEigenValue=*std::max_element(eigenValues.begin(),eigenValues.end());
+					});
+	try
+	  {
+	    solver.solve(problem,x,rhs,preconditioner);
+	  }
+	catch (dealii::SolverControl::NoConvergence &)
+	  {
+	  }
+
+	return maxEigenValue;
+      }
+    }
+
     //constructor
     dealiiLinearSolver::dealiiLinearSolver(const MPI_Comm &mpi_comm,
 	                                       const solverType type):
@@ -42,15 +156,58 @@ namespace dftfe {
       //compute RHS
       vectorType rhs;
       problem.computeRhs(rhs);
+      const double rhsNorm=rhs.l2_norm();
 
       //create dealii solver control object
-      dealii::SolverControl solverControl(maxNumberIterations,relTolerance*rhs.l2_norm());
+      dealii::SolverControl solverControl(maxNumberIterations,relTolerance*rhsNorm);
 
 
       //initialize preconditioner
       dealii::PreconditionJacobi<dealiiLinearSolverProblem> preconditioner;
       preconditioner.initialize (problem, 0.3);
 
+      //
+      //(experimental) Chebyshev accelerated Jacobi preconditioner for the symmetric positive definite CG solves.
+      //The upper bound of the Chebyshev interval is a safety factor times the Lanczos estimate of the largest
+      //eigenvalue of D^{-1}A, and the lower bound is chosen such that the damping interval scales with the square
+      //of the polynomial degree. The estimate is cached in the problem object and reused until A changes (new mesh
+      //or new constraints).
+      //
+      //The Lanczos estimate is not a guaranteed upper bound. The preconditioned operator is p(D^{-1}A)D^{-1}A=I-R(D^{-1}A)
+      //with the residual polynomial R(x)=T_k((theta-x)/delta)/T_k(theta/delta), where |R|<1 on the interval and 0<R<1
+      //below it. Above the upper bound |R| grows without bound, with R negative for odd degrees k, which keeps I-R
+      //positive, but R positive for even k, which makes the preconditioner indefinite for the eigenvalues beyond an
+      //underestimated bound. Hence the degree is rounded up to an odd number, which keeps the preconditioner positive definite for any
+      //upper bound, and an underestimated bound only reduces its efficiency
+      //
+      std::shared_ptr<internal::preconditionChebyshevJacobi> chebyshevPreconditioner;
+      if (d_type==CG && dftParameters::poissonPreconditionerType=="CHEBYSHEV JACOBI" && rhsNorm>0.0)
+      {
+	double maxEigenValue=problem.getMaxEigenValueJacobiPreconditioned();
+	if (maxEigenValue<=0.0)
+	{
+	  maxEigenValue=internal::estimateMaxEigenValueJacobiPreconditioned(problem,
+									     rhs,
+									     30);
+	  problem.setMaxEigenValueJacobiPreconditioned(maxEigenValue);
+	}
+
+	if (maxEigenValue>0.0)
+	{
+	  const unsigned int degree=dftParameters::poissonChebyshevPreconditionerDegree%2==0?
+	                            dftParameters::poissonChebyshevPreconditionerDegree+1
+				    :dftParameters::poissonChebyshevPreconditionerDegree;
+	  const double upperBound=1.3*maxEigenValue;
+	  chebyshevPreconditioner=std::make_shared<internal::preconditionChebyshevJacobi>(problem,
+											    rhs,
+											    degree,
+											    upperBound/(degree*degree),
+											    upperBound);
+	  if (debugLevel>=4)
+	    pcout<<"Chebyshev Jacobi preconditioner upper bound: "<<upperBound<<std::endl;
+	}
+      }
+
       vectorType & x= problem.getX();
       try{
 	x.update_ghost_values();
@@ -58,7 +215,10 @@ namespace dftfe {
 	if (d_type==CG)
 	{
 	  dealii::SolverCG<vectorType> solver(solverControl);
-	  solver.solve(problem,x, rhs, preconditioner);
+	  if (chebyshevPreconditioner)
+	    solver.solve(problem,x, rhs, *chebyshevPreconditioner);
+	  else
+	    solver.solve(problem,x, rhs, preconditioner);
 	}
 	else if (d_type==GMRES)
 	{
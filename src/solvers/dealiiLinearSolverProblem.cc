@@ -19,9 +19,20 @@
 
 namespace dftfe {
   // Constructor.
-  dealiiLinearSolverProblem::dealiiLinearSolverProblem()
+  dealiiLinearSolverProblem::dealiiLinearSolverProblem():
+    d_maxEigenValueJacobiPreconditioned(0.0)
   {
     return;
   }
 
+  double dealiiLinearSolverProblem::getMaxEigenValueJacobiPreconditioned() const
+  {
+    return d_maxEigenValueJacobiPreconditioned;
+  }
+
+  void dealiiLinearSolverProblem::setMaxEigenValueJacobiPreconditioned(const double maxEigenValue)
+  {
+    d_maxEigenValueJacobiPreconditioned=maxEigenValue;
+  }
+
 }
@@ -17,6 +17,7 @@
 
 #include <chebyshevOrthogonalizedSubspaceIterationSolver.h>
 #include <linearAlgebraOperations.h>
+#include <linearAlgebraOperationsInternal.h>
 #include <vectorUtilities.h>
 #include <dftUtils.h>
 
@@ -72,6 +73,13 @@ namespace dftfe{
    double lowerBoundUnWantedSpectrum):
     d_lowerBoundWantedSpectrum(lowerBoundWantedSpectrum),
     d_lowerBoundUnWantedSpectrum(lowerBoundUnWantedSpectrum),
+    d_upperBoundUnWantedSpectrumRequested(0.0),
+    d_upperBoundUnWantedSpectrum(0.0),
+    d_chebyshevOrderRequested(0),
+    d_chebyshevOrder(0),
+    d_partialRayleighRitzRequested(false),
+    d_filterWallTimePerDegree(0.0),
+    d_subspaceWallTime(0.0),
     pcout(std::cout, (dealii::Utilities::MPI::this_mpi_process(MPI_COMM_WORLD) == 0)),
     computing_timer(mpi_comm,
 	            pcout,
@@ -87,6 +95,12 @@ namespace dftfe{
   //
   chebyshevOrthogonalizedSubspaceIterationSolver::~chebyshevOrthogonalizedSubspaceIterationSolver()
   {
+#ifdef DEAL_II_WITH_SCALAPACK
+    //
+    //release the ScaLAPACK process grids reused across the solves of this solver
+    //
+    linearAlgebraOperations::internal::clearProcessGridCache();
+#endif
 
     //
     //
@@ -106,6 +120,143 @@ namespace dftfe{
     d_lowerBoundUnWantedSpectrum = lowerBoundUnWantedSpectrum;
   }
 
+  //
+  //set Chebyshev polynomial degree for the next solve
+  //
+  void
+  chebyshevOrthogonalizedSubspaceIterationSolver::setChebyshevPolynomialDegree(const unsigned int chebyshevOrder)
+  {
+    d_chebyshevOrderRequested = chebyshevOrder;
+  }
+
+  //
+  //Chebyshev polynomial degree used in the last solve
+  //
+  unsigned int
+  chebyshevOrthogonalizedSubspaceIterationSolver::getChebyshevPolynomialDegree() const
+  {
+    return d_chebyshevOrder;
+  }
+
+  //
+  //set upper bound of the unwanted spectrum for the next solve
+  //
+  void
+  chebyshevOrthogonalizedSubspaceIterationSolver::setUpperBoundUnWantedSpectrum(const double upperBoundUnWantedSpectrum)
+  {
+    d_upperBoundUnWantedSpectrumRequested = upperBoundUnWantedSpectrum;
+  }
+
+  //
+  //upper bound of the unwanted spectrum used in the last solve
+  //
+  double
+  chebyshevOrthogonalizedSubspaceIterationSolver::getUpperBoundUnWantedSpectrum() const
+  {
+    return d_upperBoundUnWantedSpectrum;
+  }
+
+  //
+  //wall time of the Chebyshev filtering per polynomial degree in the last solve
+  //
+  double
+  chebyshevOrthogonalizedSubspaceIterationSolver::getFilterWallTimePerDegree() const
+  {
+    return d_filterWallTimePerDegree;
+  }
+
+  //
+  //wall time of the orthogonalization, Rayleigh-Ritz and residual computation steps in the last solve
+  //
+  double
+  chebyshevOrthogonalizedSubspaceIterationSolver::getSubspaceWallTime() const
+  {
+    return d_subspaceWallTime;
+  }
+
+  //
+  //set partial Rayleigh-Ritz step for the next solve
+  //
+  void
+  chebyshevOrthogonalizedSubspaceIterationSolver::setPartialRayleighRitz(const bool partialRayleighRitz)
+  {
+    d_partialRayleighRitzRequested = partialRayleighRitz;
+  }
+
+  //
+  //set residual norms for soft locking in the next solve
+  //
+  void
+  chebyshevOrthogonalizedSubspaceIterationSolver::setLockingResidualNorms(const std::vector<double> & residualNorms)
+  {
+    d_lockingResidualNorms = residualNorms;
+  }
+
+  //
+  //compute Chebyshev polynomial degree for the next solve
+  //
+  unsigned int
+  chebyshevOrthogonalizedSubspaceIterationSolver::computeAdaptiveChebyshevPolynomialDegree(const double highestOccupiedRitzValue,
+											   const double residualNorm,
+											   const double measuredResidualReductionRate,
+											   const double upperBoundUnWantedSpectrum,
+											   const double lowerBoundUnWantedSpectrum,
+											   const double filterWallTimePerDegree,
+											   const double subspaceWallTime) const
+  {
+    const unsigned int maxChebyshevOrder=dftParameters::chebyshevOrder>0?
+                                         dftParameters::chebyshevOrder
+					 :internal::setChebyshevOrder(upperBoundUnWantedSpectrum);
+    const unsigned int minChebyshevOrder=std::min((unsigned int)10,maxChebyshevOrder);
+
+    const double lowerBound=dftParameters::lowerBoundUnwantedFracUpper>1e-6?
+                            dftParameters::lowerBoundUnwantedFracUpper*upperBoundUnWantedSpectrum
+			    :lowerBoundUnWantedSpectrum;
+
+    //
+    //residual reduction per polynomial degree of the highest occupied state, estimated from the growth
+    //rate of the Chebyshev polynomial mapped to the interval [lowerBound,upperBoundUnWantedSpectrum]
+    //
+    const double e=(upperBoundUnWantedSpectrum-lowerBound)/2.0;
+    const double c=(upperBoundUnWantedSpectrum+lowerBound)/2.0;
+    double rate=0.0;
+    if (e>0.0 && (c-highestOccupiedRitzValue)/e>1.0)
+      rate=std::acosh((c-highestOccupiedRitzValue)/e);
+
+    //
+    //the measured residual reduction also includes the change of the Hamiltonian between the SCF iterations
+    //
+    if (measuredResidualReductionRate>0.0)
+      rate=rate>0.0?std::min(rate,measuredResidualReductionRate):measuredResidualReductionRate;
+
+    if (rate<=0.0)
+      return maxChebyshevOrder;
+
+    //
+    //degree required to reduce the residual norm by one order of magnitude. There is no
+    //benefit in reducing the residual norm further than the SCF tolerance
+    //
+    const double targetResidualNorm=std::max(0.1*residualNorm,
+					     dftParameters::selfConsistentSolverTolerance);
+    double chebyshevOrder=residualNorm>targetResidualNorm?
+                          std::log(residualNorm/targetResidualNorm)/rate
+			  :0.0;
+
+    //
+    //below the degree for which the Chebyshev filtering costs as much as the orthogonalization, Rayleigh-Ritz
+    //and residual computation steps, more filtering passes are more expensive than a larger degree. This bound
+    //depends on the measured wall times and is hence only used on request
+    //
+    if (dftParameters::adaptiveChebyshevOrderWallTime
+	&& !dftParameters::reproducible_output
+	&& filterWallTimePerDegree>0.0)
+      chebyshevOrder=std::max(chebyshevOrder,subspaceWallTime/filterWallTimePerDegree);
+
+    chebyshevOrder=std::min(std::ceil(chebyshevOrder),(double)maxChebyshevOrder);
+
+    return std::max((unsigned int)chebyshevOrder,minChebyshevOrder);
+  }
+
 
   //
   // solve
@@ -119,21 +270,41 @@ namespace dftfe{
 							std::vector<double>        & eigenValues,
 							std::vector<double>        & residualNorms,
 							const MPI_Comm &interBandGroupComm,
-							const bool useMixedPrec)
+							const bool useMixedPrec,
+							const bool useMixedPrecCheby)
   {
 
 
-    if (dftParameters::verbosity>=4)
-      dftUtils::printCurrentMemoryUsage(operatorMatrix.getMPICommunicator(),
-					"Before Lanczos k-step upper Bound");
+    //
+    //estimate the upper bound of the unwanted spectrum using the k-step Lanczos iteration, unless
+    //an upper bound was set for this solve
+    //
+    double upperBoundUnwantedSpectrum = d_upperBoundUnWantedSpectrumRequested;
+    d_upperBoundUnWantedSpectrumRequested = 0.0;
+
+    const bool partialRayleighRitz = d_partialRayleighRitzRequested
+                                     && eigenValues.size()!=totalNumberWaveFunctions;
+    d_partialRayleighRitzRequested = false;
 
-    computing_timer.enter_section("Lanczos k-step Upper Bound");
-    operatorMatrix.reinit(1);
-    const double upperBoundUnwantedSpectrum = linearAlgebraOperations::lanczosUpperBoundEigenSpectrum(operatorMatrix,
-												      tempEigenVec);
-    computing_timer.exit_section("Lanczos k-step Upper Bound");
+    std::vector<double> lockingResidualNorms;
+    lockingResidualNorms.swap(d_lockingResidualNorms);
 
-    unsigned int chebyshevOrder = dftParameters::chebyshevOrder;
+    if (upperBoundUnwantedSpectrum==0.0)
+      {
+	if (dftParameters::verbosity>=4)
+	  dftUtils::printCurrentMemoryUsage(operatorMatrix.getMPICommunicator(),
+					    "Before Lanczos k-step upper Bound");
+
+	computing_timer.enter_section("Lanczos k-step Upper Bound");
+	operatorMatrix.reinit(1);
+	upperBoundUnwantedSpectrum = linearAlgebraOperations::lanczosUpperBoundEigenSpectrum(operatorMatrix,
+											     tempEigenVec);
+	computing_timer.exit_section("Lanczos k-step Upper Bound");
+      }
+
+    unsigned int chebyshevOrder = d_chebyshevOrderRequested>0?
+                                  d_chebyshevOrderRequested:dftParameters::chebyshevOrder;
+    d_chebyshevOrderRequested=0;
 
     //
     //set Chebyshev order
@@ -141,6 +312,9 @@ namespace dftfe{
     if(chebyshevOrder == 0)
       chebyshevOrder=internal::setChebyshevOrder(upperBoundUnwantedSpectrum);
 
+    d_chebyshevOrder=chebyshevOrder;
+    d_upperBoundUnWantedSpectrum=upperBoundUnwantedSpectrum;
+
     if (dftParameters::lowerBoundUnwantedFracUpper>1e-6)
       d_lowerBoundUnWantedSpectrum=dftParameters::lowerBoundUnwantedFracUpper*upperBoundUnwantedSpectrum;
     //
@@ -187,93 +361,231 @@ namespace dftfe{
 
 
     //
-    //allocate storage for eigenVectorsFlattenedArray for multiple blocks
+    //soft locking: a block is locked if the residual norms of all its eigenstates from the last solve are
+    //below the locking tolerance. The residual norms are only available for the highest eigenstates
+    //in case of spectrum splitting
     //
-    dealii::parallel::distributed::Vector<dataTypes::number> eigenVectorsFlattenedArrayBlock;
-    operatorMatrix.reinit(vectorsBlockSize,
-			  eigenVectorsFlattenedArrayBlock,
-			  true);
+    const unsigned int lockingResidualNormsOffset=totalNumberWaveFunctions-std::min((unsigned int)lockingResidualNorms.size(),
+										   totalNumberWaveFunctions);
+    auto isBlockLocked=[&](const unsigned int jvec,
+			   const unsigned int BVec)
+      {
+	if (lockingResidualNorms.empty() || jvec<lockingResidualNormsOffset)
+	  return false;
 
+	for(unsigned int iWave = jvec; iWave < jvec+BVec; ++iWave)
+	  if (lockingResidualNorms[iWave-lockingResidualNormsOffset]>=dftParameters::lockingResidualTol)
+	    return false;
+
+	return true;
+      };
+
+    //
+    //set to zero wavefunctions which wont go through chebyshev filtering inside a given band group
+    //and collect the starting indices of the blocks filtered in this band group. Locked blocks
+    //are not filtered if LOCKED STATES CHEBYSHEV DEGREE is zero
+    //
+    std::vector<unsigned int> blockStartIndices;
+    std::vector<bool> blockLocked;
+    unsigned int numberLockedBlocks=0;
     for (unsigned int jvec = 0; jvec < totalNumberWaveFunctions; jvec += vectorsBlockSize)
       {
-
 	// Correct block dimensions if block "goes off edge of" the matrix
 	const unsigned int BVec = std::min(vectorsBlockSize, totalNumberWaveFunctions-jvec);
 
 	if ((jvec+BVec)<=bandGroupLowHighPlusOneIndices[2*bandGroupTaskId+1] &&
 	    (jvec+BVec)>bandGroupLowHighPlusOneIndices[2*bandGroupTaskId])
 	  {
-	    //create custom partitioned dealii array
-	    if (BVec!=vectorsBlockSize)
-	      operatorMatrix.reinit(BVec,
-				    eigenVectorsFlattenedArrayBlock,
-				    true);
+	    const bool locked=isBlockLocked(jvec,BVec);
+	    if (locked)
+	      numberLockedBlocks++;
 
-	    //fill the eigenVectorsFlattenedArrayBlock from eigenVectorsFlattenedArray
-	    computing_timer.enter_section("Copy from full to block flattened array");
-	    for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
-	      for(unsigned int iWave = 0; iWave < BVec; ++iWave)
-		eigenVectorsFlattenedArrayBlock.local_element(iNode*BVec+iWave)
-		  =eigenVectorsFlattened[iNode*totalNumberWaveFunctions+jvec+iWave];
+	    if (!locked || dftParameters::lockedStatesChebyshevOrder>0)
+	      {
+		blockStartIndices.push_back(jvec);
+		blockLocked.push_back(locked);
+	      }
+	  }
+	else
+	  for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
+	    for(unsigned int iWave = 0; iWave < BVec; ++iWave)
+	      eigenVectorsFlattened[iNode*totalNumberWaveFunctions+jvec+iWave]
+		= dataTypes::number(0.0);
+      }
 
-	    computing_timer.exit_section("Copy from full to block flattened array");
+    if (dftParameters::verbosity>=2 && !lockingResidualNorms.empty())
+      pcout<<"Number of locked wavefunction blocks: "
+	   <<dealii::Utilities::MPI::sum(numberLockedBlocks,interBandGroupComm)<<std::endl;
 
-	    //
-	    //call Chebyshev filtering function only for the current block to be filtered
-	    //and does in-place filtering
-	    computing_timer.enter_section("Chebyshev filtering opt");
-	    if (jvec+BVec<dftParameters::numAdaptiveFilterStates)
+    //
+    //copy functions between eigenVectorsFlattened and the block flattened arrays
+    //
+    auto copyFullToBlock=[&](const unsigned int jvec,
+			     dealii::parallel::distributed::Vector<dataTypes::number> & flattenedArrayBlock)
+      {
+	const unsigned int BVec = std::min(vectorsBlockSize, totalNumberWaveFunctions-jvec);
+	for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
+	  for(unsigned int iWave = 0; iWave < BVec; ++iWave)
+	    flattenedArrayBlock.local_element(iNode*BVec+iWave)
+	      =eigenVectorsFlattened[iNode*totalNumberWaveFunctions+jvec+iWave];
+      };
+
+    auto copyBlockToFull=[&](const unsigned int jvec,
+			     const dealii::parallel::distributed::Vector<dataTypes::number> & flattenedArrayBlock)
+      {
+	const unsigned int BVec = std::min(vectorsBlockSize, totalNumberWaveFunctions-jvec);
+	for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
+	  for(unsigned int iWave = 0; iWave < BVec; ++iWave)
+	    eigenVectorsFlattened[iNode*totalNumberWaveFunctions+jvec+iWave]
+	      = flattenedArrayBlock.local_element(iNode*BVec+iWave);
+      };
+
+    //
+    //two block flattened arrays taken from the workspaces of the operator (workspace ids 0 and 1), which are
+    //reused across the blocks, solves, k points and SCF iterations. The blocks are filtered in a double buffered pipeline: while a block is filtered
+    //in one array, a task scatters the previously filtered block from the other array back into
+    //eigenVectorsFlattened and gathers the next block into it. The copies only overlap with the filtering
+    //if THREADS PER MPI TASK>1, otherwise they are done before the filtering of the block. The second
+    //array is only needed if there is more than one block
+    //
+    dealii::parallel::distributed::Vector<dataTypes::number> * eigenVectorsFlattenedArrayBlock[2]={NULL,NULL};
+    const bool overlapBlockCopies=dealii::MultithreadInfo::n_threads()>1;
+    auto reinitBlock=[&](const unsigned int BVec,
+			 const unsigned int workspaceId)
+      {
+	eigenVectorsFlattenedArrayBlock[workspaceId]=&operatorMatrix.getFlattenedArrayWorkspace(BVec,
+												workspaceId);
+	operatorMatrix.reinit(BVec,
+			      *eigenVectorsFlattenedArrayBlock[workspaceId],
+			      false);
+      };
+
+    const double filterStartTime=MPI_Wtime();
+
+    if (!blockStartIndices.empty())
+      {
+	const unsigned int BVecFirst = std::min(vectorsBlockSize, totalNumberWaveFunctions-blockStartIndices[0]);
+	reinitBlock(BVecFirst,0);
+	if (blockStartIndices.size()>1)
+	  reinitBlock(BVecFirst,1);
+
+	computing_timer.enter_section("Copy from full to block flattened array");
+	copyFullToBlock(blockStartIndices[0],
+			*eigenVectorsFlattenedArrayBlock[0]);
+	computing_timer.exit_section("Copy from full to block flattened array");
+      }
+
+    for (unsigned int iBlock = 0; iBlock < blockStartIndices.size(); ++iBlock)
+      {
+	const unsigned int jvec = blockStartIndices[iBlock];
+	const unsigned int BVec = std::min(vectorsBlockSize, totalNumberWaveFunctions-jvec);
+
+	dealii::parallel::distributed::Vector<dataTypes::number> & currentBlock=*eigenVectorsFlattenedArrayBlock[iBlock%2];
+	dealii::parallel::distributed::Vector<dataTypes::number> * otherBlock=eigenVectorsFlattenedArrayBlock[(iBlock+1)%2];
+
+	//
+	//the next block can only be gathered concurrently if it has the same size as the current one,
+	//as otherwise the operator and the block flattened array need to be reinitialized
+	//
+	const bool prefetchNextBlock=(iBlock+1)<blockStartIndices.size()
+	  && std::min(vectorsBlockSize, totalNumberWaveFunctions-blockStartIndices[iBlock+1])==BVec;
+
+	auto copyOtherBlock=[&]()
+	  {
+	    if (iBlock>0)
+	      copyBlockToFull(blockStartIndices[iBlock-1],
+			      *otherBlock);
+
+	    if (prefetchNextBlock)
+	      copyFullToBlock(blockStartIndices[iBlock+1],
+			      *otherBlock);
+	  };
+
+	dealii::Threads::Task<void> copyTask;
+	if (iBlock>0 || prefetchNextBlock)
+	  {
+	    if (overlapBlockCopies)
+	      copyTask=dealii::Threads::new_task([&]()
+		{
+		  computing_timer.enter_section("Copy between full and block flattened arrays (overlapped)");
+		  copyOtherBlock();
+		  computing_timer.exit_section("Copy between full and block flattened arrays (overlapped)");
+		});
+	    else
 	      {
-		const double chebyshevOrd=(double)chebyshevOrder;
-		const double adaptiveOrder=0.5*chebyshevOrd
-		  +jvec*0.3*chebyshevOrd/dftParameters::numAdaptiveFilterStates;
-		linearAlgebraOperations::chebyshevFilter(operatorMatrix,
-							 eigenVectorsFlattenedArrayBlock,
-							 BVec,
-							 std::ceil(adaptiveOrder),
-							 d_lowerBoundUnWantedSpectrum,
-							 upperBoundUnwantedSpectrum,
-							 d_lowerBoundWantedSpectrum,
-							 dftParameters::useMixedPrecCheby && useMixedPrec?
-							 true:false);
+		computing_timer.enter_section("Copy between full and block flattened arrays");
+		copyOtherBlock();
+		computing_timer.exit_section("Copy between full and block flattened arrays");
 	      }
-	    else
-	      linearAlgebraOperations::chebyshevFilter(operatorMatrix,
-						       eigenVectorsFlattenedArrayBlock,
-						       BVec,
-						       chebyshevOrder,
-						       d_lowerBoundUnWantedSpectrum,
-						       upperBoundUnwantedSpectrum,
-						       d_lowerBoundWantedSpectrum,
-						       dftParameters::useMixedPrecCheby && useMixedPrec?
-						       true:false);
-	    computing_timer.exit_section("Chebyshev filtering opt");
-
-	    if (dftParameters::verbosity>=4)
-	      dftUtils::printCurrentMemoryUsage(operatorMatrix.getMPICommunicator(),
-						"During blocked chebyshev filtering");
-
-	    //copy the eigenVectorsFlattenedArrayBlock into eigenVectorsFlattenedArray after filtering
-	    computing_timer.enter_section("Copy from block to full flattened array");
-	    for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
-	      for(unsigned int iWave = 0; iWave < BVec; ++iWave)
-		eigenVectorsFlattened[iNode*totalNumberWaveFunctions+jvec+iWave]
-		  = eigenVectorsFlattenedArrayBlock.local_element(iNode*BVec+iWave);
+	  }
 
-	    computing_timer.exit_section("Copy from block to full flattened array");
+	//
+	//call Chebyshev filtering function only for the current block to be filtered
+	//and does in-place filtering
+	computing_timer.enter_section("Chebyshev filtering opt");
+	if (blockLocked[iBlock])
+	  linearAlgebraOperations::chebyshevFilter(operatorMatrix,
+						   currentBlock,
+						   BVec,
+						   std::min(dftParameters::lockedStatesChebyshevOrder,chebyshevOrder),
+						   d_lowerBoundUnWantedSpectrum,
+						   upperBoundUnwantedSpectrum,
+						   d_lowerBoundWantedSpectrum,
+						   useMixedPrecCheby);
+	else if (jvec+BVec<dftParameters::numAdaptiveFilterStates)
+	  {
+	    const double chebyshevOrd=(double)chebyshevOrder;
+	    const double adaptiveOrder=0.5*chebyshevOrd
+	      +jvec*0.3*chebyshevOrd/dftParameters::numAdaptiveFilterStates;
+	    linearAlgebraOperations::chebyshevFilter(operatorMatrix,
+						     currentBlock,
+						     BVec,
+						     std::ceil(adaptiveOrder),
+						     d_lowerBoundUnWantedSpectrum,
+						     upperBoundUnwantedSpectrum,
+						     d_lowerBoundWantedSpectrum,
+						     useMixedPrecCheby);
 	  }
 	else
+	  linearAlgebraOperations::chebyshevFilter(operatorMatrix,
+						   currentBlock,
+						   BVec,
+						   chebyshevOrder,
+						   d_lowerBoundUnWantedSpectrum,
+						   upperBoundUnwantedSpectrum,
+						   d_lowerBoundWantedSpectrum,
+						   useMixedPrecCheby);
+	computing_timer.exit_section("Chebyshev filtering opt");
+
+	if (copyTask.joinable())
+	  copyTask.join();
+
+	if (dftParameters::verbosity>=4)
+	  dftUtils::printCurrentMemoryUsage(operatorMatrix.getMPICommunicator(),
+					    "During blocked chebyshev filtering");
+
+	if ((iBlock+1)<blockStartIndices.size() && !prefetchNextBlock)
 	  {
-	    //set to zero wavefunctions which wont go through chebyshev filtering inside a given band group
-	    for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
-	      for(unsigned int iWave = 0; iWave < BVec; ++iWave)
-		eigenVectorsFlattened[iNode*totalNumberWaveFunctions+jvec+iWave]
-		  = dataTypes::number(0.0);
+	    const unsigned int BVecNext=std::min(vectorsBlockSize, totalNumberWaveFunctions-blockStartIndices[iBlock+1]);
+	    reinitBlock(BVecNext,(iBlock+1)%2);
 
+	    computing_timer.enter_section("Copy from full to block flattened array");
+	    copyFullToBlock(blockStartIndices[iBlock+1],
+			    *eigenVectorsFlattenedArrayBlock[(iBlock+1)%2]);
+	    computing_timer.exit_section("Copy from full to block flattened array");
 	  }
       }//block loop
 
-    eigenVectorsFlattenedArrayBlock.reinit(0);
+    //
+    //copy the last filtered block into eigenVectorsFlattened
+    //
+    if (!blockStartIndices.empty())
+      {
+	computing_timer.enter_section("Copy from block to full flattened array");
+	copyBlockToFull(blockStartIndices.back(),
+			*eigenVectorsFlattenedArrayBlock[(blockStartIndices.size()-1)%2]);
+	computing_timer.exit_section("Copy from block to full flattened array");
+      }
 
     if (numberBandGroups>1)
       {
@@ -295,9 +607,13 @@ namespace dftfe{
       }
 
 
+    const double filterWallTime=MPI_Wtime()-filterStartTime;
+
     if(dftParameters::verbosity >= 4)
       pcout<<"ChebyShev Filtering Done: "<<std::endl;
 
+    const double subspaceStartTime=MPI_Wtime();
+
 
     if(dftParameters::orthogType.compare("LW") == 0)
       {
@@ -342,6 +658,28 @@ namespace dftfe{
 	  }
 	computing_timer.exit_section("Pseudo-Gram-Schmidt");
       }
+    else if (dftParameters::orthogType.compare("CQR") == 0)
+      {
+	computing_timer.enter_section("Cholesky-QR");
+	const unsigned int flag=linearAlgebraOperations::choleskyQROrthogonalization
+	  (eigenVectorsFlattened,
+	   totalNumberWaveFunctions,
+	   dftParameters::choleskyQRPasses,
+	   operatorMatrix.getMPICommunicator());
+
+	if (flag==1)
+	  {
+	    if(dftParameters::verbosity >= 1)
+	      pcout<<"Switching to Gram-Schimdt orthogonalization as Cholesky-QR orthogonalization was not successful"<<std::endl;
+
+	    computing_timer.enter_section("Gram-Schmidt Orthogn Opt");
+	    linearAlgebraOperations::gramSchmidtOrthogonalization(eigenVectorsFlattened,
+								  totalNumberWaveFunctions,
+								  operatorMatrix.getMPICommunicator());
+	    computing_timer.exit_section("Gram-Schmidt Orthogn Opt");
+	  }
+	computing_timer.exit_section("Cholesky-QR");
+      }
     else if (dftParameters::orthogType.compare("GS") == 0)
       {
 	computing_timer.enter_section("Gram-Schmidt Orthogn Opt");
@@ -368,33 +706,42 @@ namespace dftfe{
 								 interBandGroupComm,
 								 operatorMatrix.getMPICommunicator(),
 								 useMixedPrec,
-								 eigenValues);
+								 eigenValues,
+								 partialRayleighRitz);
 
 
-	eigenVectorsFlattenedRR.resize(eigenValues.size()*localVectorSize,dataTypes::number(0.0));
-	for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
-	  for(unsigned int iWave = 0; iWave < eigenValues.size(); ++iWave)
-	    eigenVectorsFlattenedRR[iNode*eigenValues.size()
-				    +iWave]
-	      =eigenVectorsFlattened[iNode*totalNumberWaveFunctions+
-				     (totalNumberWaveFunctions-eigenValues.size())+iWave];
+	//
+	//in the partial Rayleigh-Ritz step the valence block of the subspace is only rotated within its own
+	//span above, which keeps the subspace orthonormal as required by the spectrum split electron-density
+	//computation, instead of the dense Rayleigh-Ritz step on the valence block
+	//
+	if (!partialRayleighRitz)
+	  {
+	    eigenVectorsFlattenedRR.resize(eigenValues.size()*localVectorSize,dataTypes::number(0.0));
+	    for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
+	      for(unsigned int iWave = 0; iWave < eigenValues.size(); ++iWave)
+		eigenVectorsFlattenedRR[iNode*eigenValues.size()
+					+iWave]
+		  =eigenVectorsFlattened[iNode*totalNumberWaveFunctions+
+					 (totalNumberWaveFunctions-eigenValues.size())+iWave];
 
 
-	std::vector<double> eigenValuesTemp(eigenValues.size());
-	linearAlgebraOperations::rayleighRitz(operatorMatrix,
-					      eigenVectorsFlattenedRR,
-					      eigenValues.size(),
-					      interBandGroupComm,
-					      operatorMatrix.getMPICommunicator(),
-					      eigenValuesTemp);
+	    std::vector<double> eigenValuesTemp(eigenValues.size());
+	    linearAlgebraOperations::rayleighRitz(operatorMatrix,
+						  eigenVectorsFlattenedRR,
+						  eigenValues.size(),
+						  interBandGroupComm,
+						  operatorMatrix.getMPICommunicator(),
+						  eigenValuesTemp);
 
 
-	for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
-	  for(unsigned int iWave = 0; iWave < eigenValues.size(); ++iWave)
-	    eigenVectorsFlattened[iNode*totalNumberWaveFunctions+
-				  (totalNumberWaveFunctions-eigenValues.size())+iWave]
-	      =eigenVectorsFlattenedRR[iNode*eigenValues.size()
-				       +iWave];
+	    for(unsigned int iNode = 0; iNode < localVectorSize; ++iNode)
+	      for(unsigned int iWave = 0; iWave < eigenValues.size(); ++iWave)
+		eigenVectorsFlattened[iNode*totalNumberWaveFunctions+
+				      (totalNumberWaveFunctions-eigenValues.size())+iWave]
+		  =eigenVectorsFlattenedRR[iNode*eigenValues.size()
+					   +iWave];
+	  }
 
       }
     else
@@ -424,7 +771,8 @@ namespace dftfe{
     if (eigenValues.size()!=totalNumberWaveFunctions)
       {
         linearAlgebraOperations::computeEigenResidualNorm(operatorMatrix,
-							  eigenVectorsFlattenedRR,
+							  partialRayleighRitz?eigenVectorsRotFracDensityFlattened
+							  :eigenVectorsFlattenedRR,
 							  eigenValues,
 							  operatorMatrix.getMPICommunicator(),
 							  residualNorms);
@@ -437,6 +785,29 @@ namespace dftfe{
       						        residualNorms);
     computing_timer.exit_section("eigen vectors residuals opt");
 
+    //
+    //wall times used for the choice of the adaptive Chebyshev polynomial degree. The maximum over
+    //all processors is taken so that all processors choose the same degree
+    //
+    if (dftParameters::adaptiveChebyshevOrder)
+      {
+	double wallTimes[2]={filterWallTime/chebyshevOrder,MPI_Wtime()-subspaceStartTime};
+	MPI_Allreduce(MPI_IN_PLACE,
+		      wallTimes,
+		      2,
+		      MPI_DOUBLE,
+		      MPI_MAX,
+		      operatorMatrix.getMPICommunicator());
+	MPI_Allreduce(MPI_IN_PLACE,
+		      wallTimes,
+		      2,
+		      MPI_DOUBLE,
+		      MPI_MAX,
+		      interBandGroupComm);
+	d_filterWallTimePerDegree=wallTimes[0];
+	d_subspaceWallTime=wallTimes[1];
+      }
+
     if(dftParameters::verbosity >= 4)
       {
 	pcout<<"EigenVector Residual Computation Done: "<<std::endl;
@@ -463,14 +834,21 @@ namespace dftfe{
   {
 
 
-    computing_timer.enter_section("Lanczos k-step Upper Bound");
-    operatorMatrix.reinit(1);
-    double upperBoundUnwantedSpectrum = linearAlgebraOperations::lanczosUpperBoundEigenSpectrum(operatorMatrix,
-												eigenVectors[0]);
+    double upperBoundUnwantedSpectrum = d_upperBoundUnWantedSpectrumRequested;
+    d_upperBoundUnWantedSpectrumRequested = 0.0;
 
-    computing_timer.exit_section("Lanczos k-step Upper Bound");
+    if (upperBoundUnwantedSpectrum==0.0)
+      {
+	computing_timer.enter_section("Lanczos k-step Upper Bound");
+	operatorMatrix.reinit(1);
+	upperBoundUnwantedSpectrum = linearAlgebraOperations::lanczosUpperBoundEigenSpectrum(operatorMatrix,
+											     eigenVectors[0]);
+	computing_timer.exit_section("Lanczos k-step Upper Bound");
+      }
 
-    unsigned int chebyshevOrder = dftParameters::chebyshevOrder;
+    unsigned int chebyshevOrder = d_chebyshevOrderRequested>0?
+                                  d_chebyshevOrderRequested:dftParameters::chebyshevOrder;
+    d_chebyshevOrderRequested=0;
 
     const unsigned int totalNumberWaveFunctions = eigenVectors.size();
 
@@ -478,6 +856,9 @@ namespace dftfe{
     if(chebyshevOrder == 0)
       chebyshevOrder=internal::setChebyshevOrder(upperBoundUnwantedSpectrum);
 
+    d_chebyshevOrder=chebyshevOrder;
+    d_upperBoundUnWantedSpectrum=upperBoundUnwantedSpectrum;
+
     //
     //output statements
     //
@@ -45,22 +45,20 @@ void symmetryClass<FEOrder>::computeAndSymmetrize_rhoOut()
   QGauss<3>  quadrature(C_num1DQuad<FEOrder>());
   const unsigned int num_quad_points = quadrature.size();
   //
-  dftPtr->rhoOutVals.push_back(std::map<dealii::CellId,std::vector<double> >());
+  dftPtr->resizeAndAllocateRhoTableStorage
+		    (dftPtr->rhoOutVals,
+		     dftPtr->gradRhoOutVals,
+		     dftPtr->rhoOutValsSpinPolarized,
+		     dftPtr->gradRhoOutValsSpinPolarized);
+
   dftPtr->rhoOutValues=&(dftPtr->rhoOutVals.back());
   if (dftParameters::spinPolarized==1)
-     {
-     dftPtr->rhoOutValsSpinPolarized.push_back(std::map<dealii::CellId,std::vector<double> >());
      dftPtr->rhoOutValuesSpinPolarized= &(dftPtr->rhoOutValsSpinPolarized.back());
-     }
   if(dftParameters::xc_id == 4)
      {
-     dftPtr->gradRhoOutVals.push_back(std::map<dealii::CellId, std::vector<double> >());
      dftPtr->gradRhoOutValues=&(dftPtr->gradRhoOutVals.back());
      if (dftParameters::spinPolarized==1)
-        {
-        dftPtr->gradRhoOutValsSpinPolarized.push_back(std::map<dealii::CellId, std::vector<double> >());
         dftPtr->gradRhoOutValuesSpinPolarized=&(dftPtr->gradRhoOutValsSpinPolarized.back());
-        }
      }
   std::vector<double> rhoOut(num_quad_points), gradRhoOut(3*num_quad_points), rhoOutSpinPolarized(2*num_quad_points),  gradRhoOutSpinPolarized(6*num_quad_points);
 //=============================================================================================================================================
@@ -71,21 +69,17 @@ void symmetryClass<FEOrder>::computeAndSymmetrize_rhoOut()
      {
      if (cell->is_locally_owned())
 	{
-	(*(dftPtr->rhoOutValues))[cell->id()] = std::vector<double>(num_quad_points);
 	std::fill(rhoOut.begin(),rhoOut.end(),0.0);
         if(dftParameters::spinPolarized==1)
     	   {
-	      (*(dftPtr->rhoOutValuesSpinPolarized))[cell->id()] = std::vector<double>(2*num_quad_points);
               std::fill(rhoOutSpinPolarized.begin(),rhoOutSpinPolarized.end(),0.0);
 	   }
 	  //
 	if(dftParameters::xc_id == 4)
            {
-	   (*(dftPtr->gradRhoOutValues))[cell->id()] = std::vector<double>(3*num_quad_points);
 	   std::fill(gradRhoOut.begin(),gradRhoOut.end(),0.0);
 	   if(dftParameters::spinPolarized==1)
               {
-	      (*(dftPtr->gradRhoOutValuesSpinPolarized))[cell->id()] = std::vector<double>(6*num_quad_points);
 	      std::fill(gradRhoOutSpinPolarized.begin(),gradRhoOutSpinPolarized.end(),0.0);
 	      }
 	   }
@@ -150,7 +144,7 @@ void symmetryClass<FEOrder>::computeAndSymmetrize_rhoOut()
 //=============================================================================================================================================
 //			Free up some memory by getting rid of density history beyond what is required by mixing scheme
 //=============================================================================================================================================
-  if((dftPtr->rhoInVals).size() == dftParameters::mixingHistory)
+  while((dftPtr->rhoInVals).size() >= dftParameters::mixingHistory)
      {
      dftPtr->rhoInVals.pop_front();
      dftPtr->rhoOutVals.pop_front();
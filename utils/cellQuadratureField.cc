@@ -0,0 +1,220 @@
+// ---------------------------------------------------------------------
+//
+// Copyright (c) 2017-2018 The Regents of the University of Michigan and DFT-FE authors.
+//
+// This file is part of the DFT-FE code.
+//
+// The DFT-FE code is free software; you can use it, redistribute
+// it, and/or modify it under the terms of the GNU Lesser General
+// Public License as published by the Free Software Foundation; either
+// version 2.1 of the License, or (at your option) any later version.
+// The full text of the license can be found in the file LICENSE at
+// the top level of the DFT-FE distribution.
+//
+// ---------------------------------------------------------------------
+//
+#include <cellQuadratureField.h>
+
+namespace dftfe {
+//
+//Declare dftUtils functions
+//
+namespace dftUtils
+{
+
+  //
+  //constructor
+  //
+  cellQuadratureFieldLayout::cellQuadratureFieldLayout():
+    d_macroCellStartIndex(1,0)
+  {
+
+  }
+
+  void cellQuadratureFieldLayout::reinit(const dealii::MatrixFree<3,double> & matrixFreeData,
+	                                 const unsigned int dofHandlerIndex)
+  {
+    d_cellIds.clear();
+    d_cellIdToCellIndexMap.clear();
+
+    const unsigned int numMacroCells=matrixFreeData.n_macro_cells();
+    d_macroCellStartIndex.resize(numMacroCells+1);
+    d_macroCellStartIndex[0]=0;
+
+    for (unsigned int macrocell = 0; macrocell < numMacroCells; ++macrocell)
+    {
+      const unsigned int numSubCells= matrixFreeData.n_components_filled(macrocell);
+      for (unsigned int iSubCell=0; iSubCell<numSubCells; ++iSubCell)
+      {
+	const dealii::CellId subCellId=matrixFreeData.get_cell_iterator(macrocell,iSubCell,dofHandlerIndex)->id();
+	d_cellIdToCellIndexMap[subCellId]=d_cellIds.size();
+	d_cellIds.push_back(subCellId);
+      }
+      d_macroCellStartIndex[macrocell+1]=d_cellIds.size();
+    }
+  }
+
+  void cellQuadratureFieldLayout::reinit(const dealii::Triangulation<3> & triangulation)
+  {
+    d_cellIds.clear();
+    d_cellIdToCellIndexMap.clear();
+    d_macroCellStartIndex.assign(1,0);
+
+    dealii::Triangulation<3>::active_cell_iterator cell = triangulation.begin_active(), endc = triangulation.end();
+    for (; cell!=endc; ++cell)
+      if (cell->is_locally_owned())
+      {
+	const dealii::CellId cellId=cell->id();
+	d_cellIdToCellIndexMap[cellId]=d_cellIds.size();
+	d_cellIds.push_back(cellId);
+	d_macroCellStartIndex.push_back(d_cellIds.size());
+      }
+  }
+
+  unsigned int cellQuadratureFieldLayout::cellIndex(const dealii::CellId & cellId) const
+  {
+    std::map<dealii::CellId,unsigned int>::const_iterator it=d_cellIdToCellIndexMap.find(cellId);
+    Assert(it!=d_cellIdToCellIndexMap.end(),dealii::ExcMessage("DFT-FE Error: cell not found in cell quadrature field layout"));
+    return it->second;
+  }
+
+  //
+  //constructor
+  //
+  cellQuadratureField::cellQuadratureField():
+    d_nValuesPerCell(0)
+  {
+
+  }
+
+  void cellQuadratureField::reinit(const std::shared_ptr<const cellQuadratureFieldLayout> & layout,
+	                           const unsigned int nValuesPerCell)
+  {
+    d_layout=layout;
+    d_nValuesPerCell=nValuesPerCell;
+    d_data.resize_fast(layout->nCells()*nValuesPerCell);
+    setZero();
+  }
+
+  void cellQuadratureField::copyFrom(const cellQuadratureField & field)
+  {
+    AssertThrow(field.d_layout,dealii::ExcMessage("DFT-FE Error: source cell quadrature field not initialized"));
+
+    if (!d_layout)
+      reinit(field.d_layout,field.d_nValuesPerCell);
+
+    AssertThrow(d_nValuesPerCell==field.d_nValuesPerCell,
+	        dealii::ExcMessage("DFT-FE Error: mismatch in number of values per cell of cell quadrature fields"));
+
+    if (d_layout==field.d_layout)
+      std::copy(field.d_data.begin(),field.d_data.end(),d_data.begin());
+    else
+    {
+      const unsigned int numCells=d_layout->nCells();
+      for (unsigned int icell=0; icell<numCells; ++icell)
+      {
+	const double * source=field[d_layout->cellId(icell)];
+	std::copy(source,source+d_nValuesPerCell,cellData(icell));
+      }
+    }
+  }
+
+  void cellQuadratureField::copyFrom(const std::map<dealii::CellId, std::vector<double> > & cellQuadDataMap)
+  {
+    const unsigned int numCells=d_layout->nCells();
+    for (unsigned int icell=0; icell<numCells; ++icell)
+    {
+      std::map<dealii::CellId, std::vector<double> >::const_iterator it=cellQuadDataMap.find(d_layout->cellId(icell));
+      AssertThrow(it!=cellQuadDataMap.end() && it->second.size()==d_nValuesPerCell,
+	          dealii::ExcMessage("DFT-FE Error: mismatch in cell quadrature data"));
+      std::copy(it->second.begin(),it->second.end(),cellData(icell));
+    }
+  }
+
+  void cellQuadratureField::copyTo(std::map<dealii::CellId, std::vector<double> > & cellQuadDataMap) const
+  {
+    cellQuadDataMap.clear();
+    const unsigned int numCells=d_layout->nCells();
+    for (unsigned int icell=0; icell<numCells; ++icell)
+    {
+      const double * source=cellData(icell);
+      cellQuadDataMap[d_layout->cellId(icell)]=std::vector<double>(source,source+d_nValuesPerCell);
+    }
+  }
+
+  void cellQuadratureField::setZero()
+  {
+    std::fill(d_data.begin(),d_data.end(),0.0);
+  }
+
+  void cellQuadratureField::clear()
+  {
+    d_data.clear();
+    d_layout.reset();
+    d_nValuesPerCell=0;
+  }
+
+
+  //
+  //constructor
+  //
+  cellQuadratureFieldHistory::cellQuadratureFieldHistory():
+    d_head(0),
+    d_size(0)
+  {
+
+  }
+
+  void cellQuadratureFieldHistory::setCapacity(const unsigned int capacity)
+  {
+    AssertThrow(capacity>0,dealii::ExcMessage("DFT-FE Error: capacity of cell quadrature field history must be positive"));
+    if (capacity!=d_slots.size())
+      d_slots.resize(capacity);
+    clear();
+  }
+
+  unsigned int cellQuadratureFieldHistory::nextSlotIndex()
+  {
+    AssertThrow(d_slots.size()>0,dealii::ExcMessage("DFT-FE Error: capacity of cell quadrature field history not set"));
+    if (d_size==d_slots.size())
+      pop_front();
+
+    const unsigned int index=slotIndex(d_size);
+    d_size++;
+    return index;
+  }
+
+  cellQuadratureField & cellQuadratureFieldHistory::push_back(const std::shared_ptr<const cellQuadratureFieldLayout> & layout,
+		                                              const unsigned int nValuesPerCell)
+  {
+    cellQuadratureField & field=d_slots[nextSlotIndex()];
+    field.reinit(layout,nValuesPerCell);
+    return field;
+  }
+
+  void cellQuadratureFieldHistory::push_back(const cellQuadratureField & field)
+  {
+    cellQuadratureField & slot=d_slots[nextSlotIndex()];
+    if (&slot!=&field)
+    {
+      slot.reinit(field.getLayout(),field.nValuesPerCell());
+      slot.copyFrom(field);
+    }
+  }
+
+  void cellQuadratureFieldHistory::pop_front()
+  {
+    Assert(d_size>0,dealii::ExcMessage("DFT-FE Error: cell quadrature field history is empty"));
+    d_head=(d_head+1)%d_slots.size();
+    d_size--;
+  }
+
+  void cellQuadratureFieldHistory::clear()
+  {
+    d_head=0;
+    d_size=0;
+  }
+
+}
+
+}
@@ -194,9 +194,11 @@ namespace dftUtils
 
   template<typename T>
   void constraintMatrixInfo::distribute(dealii::parallel::distributed::Vector<T> &fieldVector,
-					const unsigned int blockSize) const
+					const unsigned int blockSize,
+					const bool updateGhostValues) const
   {
-    fieldVector.update_ghost_values();
+    if (updateGhostValues)
+      fieldVector.update_ghost_values();
 
 
     unsigned int count = 0;
@@ -310,7 +312,8 @@ namespace dftUtils
 
 
   template void constraintMatrixInfo::distribute(dealii::parallel::distributed::Vector<dataTypes::number> & fieldVector,
-						 const unsigned int blockSize) const;
+						 const unsigned int blockSize,
+						 const bool updateGhostValues) const;
 
   template void constraintMatrixInfo::distribute_slave_to_master(dealii::parallel::distributed::Vector<dataTypes::number> & fieldVector,
 						 const unsigned int blockSize) const;
@@ -28,15 +28,15 @@ namespace dftParameters
 {
 
   unsigned int finiteElementPolynomialOrder=1,n_refinement_steps=1,numberEigenValues=1,xc_id=1, spinPolarized=0, nkx=1,nky=1,nkz=1, offsetFlagX=0,offsetFlagY=0,offsetFlagZ=0;
-  unsigned int chebyshevOrder=1,numPass=1, numSCFIterations=1,maxLinearSolverIterations=1, mixingHistory=1, npool=1;
+  unsigned int chebyshevOrder=1,numPass=1, numSCFIterations=1,maxLinearSolverIterations=1,poissonChebyshevPreconditionerDegree=5, mixingHistory=1, npool=1;
 
-  double radiusAtomBall=0.0, mixingParameter=0.5;
+  double radiusAtomBall=0.0, mixingParameter=0.5, kerkerParameter=0.05;
   double lowerEndWantedSpectrum=0.0,relLinearSolverTolerance=1e-10,selfConsistentSolverTolerance=1e-10,TVal=500, start_magnetization=0.0;
   double chebyshevTolerance = 1e-02;
   std::string mixingMethod = "";
 
   bool isPseudopotential=false,periodicX=false,periodicY=false,periodicZ=false, useSymm=false, timeReversal=false,pseudoTestsFlag=false, constraintMagnetization=false;
-  std::string meshFileName="",coordinatesFile="",domainBoundingVectorsFile="",kPointDataFile="", ionRelaxFlagsFile="",orthogType="",pseudoPotentialFile="";
+  std::string meshFileName="",coordinatesFile="",domainBoundingVectorsFile="",kPointDataFile="", ionRelaxFlagsFile="",orthogType="",pseudoPotentialFile="",poissonPreconditionerType="";
 
   double outerAtomBallRadius=2.0, meshSizeOuterDomain=10.0;
   double meshSizeInnerBall=1.0, meshSizeOuterBall=1.0;
@@ -62,6 +62,7 @@ namespace dftParameters
   unsigned int subspaceRotDofsBlockSize=2000;
   bool enableSwitchToGS=true;
   unsigned int nbandGrps=1;
+  unsigned int numThreadsPerTask=1;
   bool computeEnergyEverySCF=true;
   unsigned int scalapackParalProcs=0;
   unsigned int natoms=0;
@@ -69,6 +70,7 @@ namespace dftParameters
   double lowerBoundUnwantedFracUpper=0;
   unsigned int numCoreWfcRR=0;
   bool triMatPGSOpt=true;
+  unsigned int choleskyQRPasses=2;
   bool reuseWfcGeoOpt=true;
   extern double mpiAllReduceMessageBlockSizeMB=2.0;
   bool useHigherQuadNLP=true;
@@ -77,8 +79,21 @@ namespace dftParameters
   bool useMixedPrecXTHXSpectrumSplit=false;
   bool useMixedPrecSubspaceRotSpectrumSplit=false;
   bool useMixedPrecCheby=false;
+  double mixedPrecStoppingTol=1e-4;
+  double lockingResidualTol=0.0;
+  unsigned int lockedStatesChebyshevOrder=0;
   unsigned int numAdaptiveFilterStates=0;
+  bool adaptiveChebyshevOrder=false;
+  bool adaptiveChebyshevOrderWallTime=false;
+  unsigned int lanczosUpperBoundUpdateFrequency=1;
+  double lanczosUpperBoundVEffTol=0.1;
+  bool matrixFreeHamiltonian=false;
+  bool packedCellHamiltonianMatrices=false;
   unsigned int spectrumSplitStartingScfIter=1;
+  double spectrumSplitPartialRRTol=0.0;
+  bool poissonWarmStart=false;
+  bool vselfBlockCG=false;
+  double poissonAdaptiveToleranceFactor=0.0;
 
   void declare_parameters(ParameterHandler &prm)
   {
@@ -120,6 +135,10 @@ namespace dftParameters
 	prm.declare_entry("MPI ALLREDUCE BLOCK SIZE", "100.0",
 			   Patterns::Double(0),
 			   "[Advanced] Block message size in MB used to break a single MPI_Allreduce call on wavefunction vectors data into multiple MPI_Allreduce calls. This is useful on certain architectures which take advantage of High Bandwidth Memory to improve efficiency of MPI operations. This variable is relevant only if NPBAND>1. Default value is 100.0 MB.");
+
+	prm.declare_entry("THREADS PER MPI TASK", "1",
+			   Patterns::Integer(1),
+			   "[Advanced] Number of threads spawned by each MPI task to parallelise the finite-element cell loops in the Hamiltonian application, Hamiltonian matrix assembly, electron-density computation and configurational force computation. This allows to run fewer MPI tasks per node, which reduces the memory overhead of ghost nodes and replicated pseudopotential data, while retaining the throughput. The total number of MPI tasks times THREADS PER MPI TASK must not exceed the number of cores. Default value is 1.");
     }
     prm.leave_subsection ();
 
@@ -357,8 +376,12 @@ namespace dftParameters
 			  "[Standard] Mixing parameter to be used in density mixing schemes.");
 
 	prm.declare_entry("MIXING METHOD","ANDERSON",
-			      Patterns::Selection("BROYDEN|ANDERSON"),
-			      "[Standard] Method for density mixing. ANDERSON is the default option.");
+			      Patterns::Selection("BROYDEN|ANDERSON|ANDERSON_WITH_KERKER"),
+			      "[Standard] Method for density mixing. ANDERSON is the default option. ANDERSON_WITH_KERKER applies a Kerker preconditioner to the Anderson extrapolated electron-density residual, which suppresses the long-wavelength charge sloshing in metallic systems and large simulation domains.");
+
+	prm.declare_entry("KERKER MIXING PARAMETER", "0.05",
+			  Patterns::Double(1e-4),
+			  "[Advanced] Square of the screening wavevector (in a.u.) used in the Kerker preconditioner of the ANDERSON_WITH_KERKER mixing method. The residual is preconditioned by solving a screened Poisson problem, which damps the residual components with wavevectors smaller than the screening wavevector. Default value is 0.05.");
 
 	prm.declare_entry("CONSTRAINT MAGNETIZATION", "false",
 			  Patterns::Bool(),
@@ -391,6 +414,10 @@ namespace dftParameters
 			      Patterns::Integer(0),
 			      "[Advanced] SCF iteration no beyond which spectrum splitting based can be used.");
 
+	    prm.declare_entry("SPECTRUM SPLIT PARTIAL RR TOL", "0.0",
+			      Patterns::Double(0),
+			      "[Advanced] Residual norm tolerance for the partial Rayleigh-Ritz step when SPECTRUM SPLIT CORE EIGENSTATES>0. If the maximum residual norm of the valence eigenstates of a k point and spin in the previous SCF iteration is below this tolerance, the valence Ritz pairs are taken directly from the partial diagonalization of the projected Hamiltonian and the secondary dense Rayleigh-Ritz diagonalization of the valence block of the subspace is skipped. The projected Hamiltonian over the full subspace and its partial diagonalization are still computed. Soft locking is not used in the solve following a partial Rayleigh-Ritz step. The valence block of the subspace is then only rotated within its own span, which keeps the subspace orthonormal, and the core block of the subspace is reused as is. A full spectrum Rayleigh-Ritz step is always done after the SCF convergence. Default value is 0.0, which turns off the partial Rayleigh-Ritz step.");
+
 	    prm.declare_entry("LOWER BOUND WANTED SPECTRUM", "-10.0",
 			      Patterns::Double(),
 			      "[Developer] The lower bound of the wanted eigen spectrum. It is only used for the first iteration of the Chebyshev filtered subspace iteration procedure. A rough estimate based on single atom eigen values can be used here. Default value is good enough for most problems.");
@@ -399,6 +426,22 @@ namespace dftParameters
 			      Patterns::Integer(0,2000),
 			      "[Advanced] Chebyshev polynomial degree to be employed for the Chebyshev filtering subspace iteration procedure to dampen the unwanted spectrum of the Kohn-Sham Hamiltonian. If set to 0, a default value depending on the upper bound of the eigen-spectrum is used. See Phani Motamarri et.al., J. Comp. Phys. 253, 308-343 (2013).");
 
+	    prm.declare_entry("ADAPTIVE CHEBYSHEV POLYNOMIAL DEGREE", "false",
+			      Patterns::Bool(),
+			      "[Advanced] Boolean parameter specifying whether to choose the Chebyshev polynomial degree separately for every SCF iteration, k point and spin from the residual reduction measured in the previous Chebyshev filtering passes and the previous Ritz values. The degree is chosen such that the residual norm of the highest occupied state is reduced by one order of magnitude per pass. The choice only depends on the computed residual norms and Ritz values, see ADAPTIVE CHEBYSHEV POLYNOMIAL DEGREE WALL TIME for the optional wall time based lower bound. The degree never exceeds the value given by CHEBYSHEV POLYNOMIAL DEGREE, or the default value depending on the upper bound of the eigen-spectrum if CHEBYSHEV POLYNOMIAL DEGREE is set to 0. Default option is false.");
+
+	    prm.declare_entry("ADAPTIVE CHEBYSHEV POLYNOMIAL DEGREE WALL TIME", "false",
+			      Patterns::Bool(),
+			      "[Advanced] Boolean parameter specifying whether the Chebyshev polynomial degree chosen with ADAPTIVE CHEBYSHEV POLYNOMIAL DEGREE is additionally bounded from below by the degree for which the measured wall time of the Chebyshev filtering equals the measured wall time of the orthogonalization, Rayleigh-Ritz and residual computation steps. As the degree then depends on the timings, the results are not reproducible between runs. Not used if REPRODUCIBLE OUTPUT is true. Default option is false.");
+
+	    prm.declare_entry("LANCZOS UPPER BOUND UPDATE FREQUENCY", "1",
+			      Patterns::Integer(1,1000),
+			      "[Advanced] Number of Chebyshev filtering solves of a given k point and spin after which the upper bound of the eigen-spectrum of the Kohn-Sham Hamiltonian is estimated again using the k-step Lanczos iteration. In the solves in between, the last estimate is reused after shifting it by the accumulated maximum change of the effective potential at the quadrature points since the estimate. The upper bound is also estimated again if this change exceeds LANCZOS UPPER BOUND VEFF TOLERANCE. Default value is 1, i.e., the upper bound is estimated in every solve.");
+
+	    prm.declare_entry("LANCZOS UPPER BOUND VEFF TOLERANCE", "0.1",
+			      Patterns::Double(0),
+			      "[Advanced] Accumulated maximum change of the effective potential (in Hartree) since the last k-step Lanczos estimate of the upper bound of the eigen-spectrum, beyond which the upper bound is estimated again. Only used if LANCZOS UPPER BOUND UPDATE FREQUENCY is greater than 1. Default value is 0.1.");
+
 	    prm.declare_entry("LOWER BOUND UNWANTED FRAC UPPER", "0",
 			      Patterns::Double(0,1),
 			      "[Developer] The value of the fraction of the upper bound of the unwanted spectrum, the lower bound of the unwanted spectrum will be set. Default value is 0.");
@@ -411,9 +454,21 @@ namespace dftParameters
 			      Patterns::Bool(),
 			      "[Advanced] Boolean parameter specifying whether to use gemm batch blas routines to perform matrix-matrix multiplication operations with groups of matrices, processing a number of groups at once using threads instead of the standard serial route. CAUTION: gemm batch blas routines will only be activated if the CHEBY WFC BLOCK SIZE is less than 1000, and only if intel mkl blas library is linked with the dealii installation. Default option is true.");
 
+	    prm.declare_entry("MATRIX FREE HAMILTONIAN", "false",
+			      Patterns::Bool(),
+			      "[Advanced] Boolean parameter specifying whether to compute the action of the local part of the discretized Kohn-Sham Hamiltonian on the wavefunctions in the Chebyshev filtering using matrix-free sum factorization on the fly instead of the precomputed finite-element cell level Hamiltonian matrices. This avoids the storage of the cell level Hamiltonian matrices, whose size grows as the sixth power of the finite-element polynomial order, and reduces the floating point operations for higher polynomial orders. Recommended for FEORDER 6 and higher. If set to true, BATCH GEMM is not used for the local part of the Hamiltonian. Default option is false.");
+
+	    prm.declare_entry("PACKED CELL HAMILTONIAN MATRICES", "false",
+			      Patterns::Bool(),
+			      "[Advanced] Boolean parameter specifying whether to store only the upper triangle of the symmetric finite-element cell level Hamiltonian matrices in packed format, which halves the memory of the cell level Hamiltonian matrices and the memory traffic in the Chebyshev filtering. The packed matrix of a cell is expanded into a small full matrix buffer before it is used in the matrix-matrix multiplications. Only available with the real executable, as the cell level Hamiltonian matrices are not Hermitian for non-zero k points. Default option is false.");
+
 	    prm.declare_entry("ORTHOGONALIZATION TYPE","Auto",
-			      Patterns::Selection("GS|LW|PGS|Auto"),
-			      "[Advanced] Parameter specifying the type of orthogonalization to be used: GS(Gram-Schmidt Orthogonalization using SLEPc library), LW(Lowden Orthogonalization implemented using LAPACK/BLAS routines, extension to use ScaLAPACK library not implemented yet), PGS(Pseudo-Gram-Schmidt Orthogonalization: if dealii library is compiled with ScaLAPACK and if you are using the real executable, parallel ScaLAPACK functions are used, otherwise serial LAPACK functions are used.) Auto is the default option, which chooses GS for all-electron case and PGS for pseudopotential case.");
+			      Patterns::Selection("GS|LW|PGS|CQR|Auto"),
+			      "[Advanced] Parameter specifying the type of orthogonalization to be used: GS(Gram-Schmidt Orthogonalization using SLEPc library), LW(Lowden Orthogonalization implemented using LAPACK/BLAS routines, extension to use ScaLAPACK library not implemented yet), PGS(Pseudo-Gram-Schmidt Orthogonalization: if dealii library is compiled with ScaLAPACK and if you are using the real executable, parallel ScaLAPACK functions are used, otherwise serial LAPACK functions are used.), CQR(Cholesky-QR Orthogonalization: the overlap matrix is computed with a single MPI all reduce and its Cholesky factorization is done redundantly on every processor using LAPACK, which avoids the ScaLAPACK process grid setup and data redistribution. Recommended for large number of processors if the number of wavefunctions is not more than a few thousand. See CHOLESKY QR PASSES.) Auto is the default option, which chooses GS for all-electron case and PGS for pseudopotential case.");
+
+	    prm.declare_entry("CHOLESKY QR PASSES", "2",
+			      Patterns::Integer(1,3),
+			      "[Advanced] Number of Cholesky-QR passes if ORTHOGONALIZATION TYPE is set to CQR. A single pass loses orthogonality for ill-conditioned subspaces, while two passes (Cholesky-QR2) give orthogonality to machine precision if the Cholesky factorization of the first pass is successful. If the Cholesky factorization of the first pass breaks down, a shifted Cholesky-QR pass is done before the given number of passes. Default value is 2.");
 
 	    prm.declare_entry("ENABLE SWITCH TO GS", "true",
 			      Patterns::Bool(),
@@ -457,6 +512,22 @@ namespace dftParameters
 			      Patterns::Bool(),
 			      "[Advanced] Use mixed precision arithmetic in Rayleigh-Ritz subspace rotation step when SPECTRUM SPLIT CORE EIGENSTATES>0. Currently this optimization is only enabled for the real executable and with ScaLAPACK linking. Default setting is false.");
 
+	    prm.declare_entry("USE MIXED PREC CHEBY", "false",
+			      Patterns::Bool(),
+			      "[Advanced] Use mixed precision arithmetic in Chebyshev filtering. The cell level Hamiltonian times wavefunctions products of all but the last 10 percent of the Chebyshev polynomial degrees are computed in single precision, while the recurrence itself and the remaining degrees are in double precision. Mixed precision is only used in the SCF iterations whose electron-density residual is greater than MIXED PREC STOPPING TOL. Currently this optimization is only enabled for the real executable, and is not used if MATRIX FREE HAMILTONIAN is true. Default setting is false.");
+
+	    prm.declare_entry("MIXED PREC STOPPING TOL", "1e-4",
+			      Patterns::Double(0),
+			      "[Advanced] Electron-density residual L2 norm of the previous SCF iteration below which mixed precision Chebyshev filtering (USE MIXED PREC CHEBY) is not used. Default value is 1e-4.");
+
+	    prm.declare_entry("LOCKING RESIDUAL TOL", "0.0",
+			      Patterns::Double(0),
+			      "[Advanced] Residual norm tolerance for the soft locking of converged Kohn-Sham eigenstates in the Chebyshev filtering. Blocks of eigenstates (of size CHEBY WFC BLOCK SIZE) whose residual norms in the last Chebyshev filtering pass are all below this tolerance are filtered with the Chebyshev polynomial degree LOCKED STATES CHEBYSHEV DEGREE, while still being part of the orthogonalization and Rayleigh-Ritz steps. With SPECTRUM SPLIT CORE EIGENSTATES>0, only the valence eigenstates can be locked. Default value is 0.0, which switches off the locking.");
+
+	    prm.declare_entry("LOCKED STATES CHEBYSHEV DEGREE", "0",
+			      Patterns::Integer(0),
+			      "[Advanced] Chebyshev polynomial degree used to filter the locked eigenstates (see LOCKING RESIDUAL TOL). Default value is 0, for which the locked eigenstates are not filtered.");
+
 	    prm.declare_entry("ADAPTIVE FILTER STATES", "0",
 			      Patterns::Integer(0),
 			      "[Advanced] Number of lowest Kohn-Sham eigenstates which are filtered with Chebyshev polynomial degree linearly varying from 50 percent (starting from the lowest) to 80 percent of the value specified by CHEBYSHEV POLYNOMIAL DEGREE. This imposes a step function filtering polynomial order on the ADAPTIVE FILTER STATES as filtering is done with blocks of size WFC BLOCK SIZE. This setting is recommended for large systems (greater than 5000 electrons). Default value is 0 i.e., all states are filtered with the same Chebyshev polynomial degree.");
@@ -474,6 +545,26 @@ namespace dftParameters
         prm.declare_entry("TOLERANCE", "1e-14",
 			  Patterns::Double(0,1.0),
 			  "[Advanced] Relative tolerance as stopping criterion for Poisson problem convergence.");
+
+	prm.declare_entry("PRECONDITIONER TYPE", "JACOBI",
+			  Patterns::Selection("JACOBI|CHEBYSHEV JACOBI"),
+			  "[Advanced] Preconditioner used in the conjugate gradient solves of the Poisson problems. JACOBI is the diagonal preconditioner. CHEBYSHEV JACOBI (experimental) applies a Chebyshev polynomial (see CHEBYSHEV PRECONDITIONER DEGREE) of the Jacobi preconditioned operator, which is intended to reduce the number of conjugate gradient iterations at the cost of additional matrix-vector products per iteration. Its effect on the total number of matrix-vector products and on the wall time has not been benchmarked yet. The largest eigenvalue of the Jacobi preconditioned operator needed for the Chebyshev polynomial is estimated once per mesh. Default: JACOBI.");
+
+	prm.declare_entry("CHEBYSHEV PRECONDITIONER DEGREE", "5",
+			  Patterns::Integer(2,50),
+			  "[Advanced] Chebyshev polynomial degree of the experimental CHEBYSHEV JACOBI preconditioner (see PRECONDITIONER TYPE). Even values are increased by one, as only odd degrees keep the preconditioner positive definite if the largest eigenvalue of the Jacobi preconditioned operator is underestimated. Each application of the preconditioner requires degree-1 matrix-vector products.");
+
+	prm.declare_entry("ADAPTIVE TOLERANCE FACTOR", "0.0",
+			  Patterns::Double(0,1.0),
+			  "[Advanced] Safety factor of the inexact SCF mode of the total electrostatic potential solve with the input electron-density. If greater than zero, the relative tolerance of this solve is the maximum of TOLERANCE and ADAPTIVE TOLERANCE FACTOR times the L2 norm of the electron-density difference of the current SCF iteration, and it is tightened to TOLERANCE once this norm is less than ten times the TOLERANCE in SCF parameters. The other Poisson solves always use TOLERANCE. Default value is 0.0, which always uses TOLERANCE.");
+
+	prm.declare_entry("WARM START", "false",
+			  Patterns::Bool(),
+			  "[Advanced] Boolean parameter specifying the initial guesses of the Poisson solves. If true, the total electrostatic potential solve with the input electron-density starts from the linear extrapolation of the solutions of the last two SCF iterations, and the nuclear self-potential solves in a geometry optimization start from the solutions of the previous ionic step when the mesh is moved without remeshing. If false, the total electrostatic potential solve starts from the solution with the output electron-density of the previous SCF iteration. Default: false.");
+
+	prm.declare_entry("VSELF BLOCK CG", "false",
+			  Patterns::Bool(),
+			  "[Advanced] Boolean parameter specifying whether the nuclear self-potential problems of all the atom bins are solved together in a single block conjugate gradient solve, which applies the operators of all the bins in one cell loop and does the inner products of all the bins with one MPI reduction. If false, the bins are solved one after the other with separate conjugate gradient solves. Both give the same self-potential fields up to the TOLERANCE of the Poisson solves. Default: false.");
     }
     prm.leave_subsection ();
 
@@ -494,6 +585,7 @@ namespace dftParameters
 	dftParameters::npool             = prm.get_integer("NPKPT");
 	dftParameters::nbandGrps         = prm.get_integer("NPBAND");
 	dftParameters::mpiAllReduceMessageBlockSizeMB = prm.get_double("MPI ALLREDUCE BLOCK SIZE");
+	dftParameters::numThreadsPerTask = prm.get_integer("THREADS PER MPI TASK");
     }
     prm.leave_subsection ();
 
@@ -590,6 +682,7 @@ namespace dftParameters
 	dftParameters::mixingHistory                 = prm.get_integer("MIXING HISTORY");
 	dftParameters::mixingParameter               = prm.get_double("MIXING PARAMETER");
 	dftParameters::mixingMethod                  = prm.get("MIXING METHOD");
+	dftParameters::kerkerParameter               = prm.get_double("KERKER MIXING PARAMETER");
 	dftParameters::constraintMagnetization       = prm.get_bool("CONSTRAINT MAGNETIZATION");
         dftParameters::startingWFCType               = prm.get("STARTING WFC");
 	dftParameters::computeEnergyEverySCF         = prm.get_bool("COMPUTE ENERGY EACH ITER");
@@ -601,11 +694,19 @@ namespace dftParameters
 	   dftParameters::numberEigenValues             = prm.get_integer("NUMBER OF KOHN-SHAM WAVEFUNCTIONS");
 	   dftParameters::numCoreWfcRR                  = prm.get_integer("SPECTRUM SPLIT CORE EIGENSTATES");
 	   dftParameters::spectrumSplitStartingScfIter  = prm.get_integer("SPECTRUM SPLIT STARTING SCF ITER");
+	   dftParameters::spectrumSplitPartialRRTol     = prm.get_double("SPECTRUM SPLIT PARTIAL RR TOL");
 	   dftParameters::lowerEndWantedSpectrum        = prm.get_double("LOWER BOUND WANTED SPECTRUM");
 	   dftParameters::lowerBoundUnwantedFracUpper   = prm.get_double("LOWER BOUND UNWANTED FRAC UPPER");
 	   dftParameters::chebyshevOrder                = prm.get_integer("CHEBYSHEV POLYNOMIAL DEGREE");
+	   dftParameters::adaptiveChebyshevOrder        = prm.get_bool("ADAPTIVE CHEBYSHEV POLYNOMIAL DEGREE");
+	   dftParameters::adaptiveChebyshevOrderWallTime= prm.get_bool("ADAPTIVE CHEBYSHEV POLYNOMIAL DEGREE WALL TIME");
+	   dftParameters::lanczosUpperBoundUpdateFrequency= prm.get_integer("LANCZOS UPPER BOUND UPDATE FREQUENCY");
+	   dftParameters::lanczosUpperBoundVEffTol= prm.get_double("LANCZOS UPPER BOUND VEFF TOLERANCE");
 	   dftParameters::useBatchGEMM= prm.get_bool("BATCH GEMM");
+	   dftParameters::matrixFreeHamiltonian= prm.get_bool("MATRIX FREE HAMILTONIAN");
+	   dftParameters::packedCellHamiltonianMatrices= prm.get_bool("PACKED CELL HAMILTONIAN MATRICES");
 	   dftParameters::orthogType        = prm.get("ORTHOGONALIZATION TYPE");
+	   dftParameters::choleskyQRPasses= prm.get_integer("CHOLESKY QR PASSES");
 	   dftParameters::chebyshevTolerance = prm.get_double("CHEBYSHEV FILTER TOLERANCE");
 	   dftParameters::wfcBlockSize= prm.get_integer("WFC BLOCK SIZE");
 	   dftParameters::chebyWfcBlockSize= prm.get_integer("CHEBY WFC BLOCK SIZE");
@@ -617,6 +718,10 @@ namespace dftParameters
 	   dftParameters::useMixedPrecPGS_O= prm.get_bool("USE MIXED PREC PGS O");
 	   dftParameters::useMixedPrecXTHXSpectrumSplit= prm.get_bool("USE MIXED PREC XTHX SPECTRUM SPLIT");
 	   dftParameters::useMixedPrecSubspaceRotSpectrumSplit= prm.get_bool("USE MIXED PREC RR_SR SPECTRUM SPLIT");
+	   dftParameters::useMixedPrecCheby= prm.get_bool("USE MIXED PREC CHEBY");
+	   dftParameters::mixedPrecStoppingTol= prm.get_double("MIXED PREC STOPPING TOL");
+	   dftParameters::lockingResidualTol= prm.get_double("LOCKING RESIDUAL TOL");
+	   dftParameters::lockedStatesChebyshevOrder= prm.get_integer("LOCKED STATES CHEBYSHEV DEGREE");
 	   dftParameters::numAdaptiveFilterStates= prm.get_integer("ADAPTIVE FILTER STATES");
 	}
 	prm.leave_subsection ();
@@ -627,6 +732,11 @@ namespace dftParameters
     {
        dftParameters::maxLinearSolverIterations     = prm.get_integer("MAXIMUM ITERATIONS");
        dftParameters::relLinearSolverTolerance      = prm.get_double("TOLERANCE");
+       dftParameters::poissonPreconditionerType     = prm.get("PRECONDITIONER TYPE");
+       dftParameters::poissonChebyshevPreconditionerDegree = prm.get_integer("CHEBYSHEV PRECONDITIONER DEGREE");
+       dftParameters::poissonWarmStart              = prm.get_bool("WARM START");
+       dftParameters::vselfBlockCG                  = prm.get_bool("VSELF BLOCK CG");
+       dftParameters::poissonAdaptiveToleranceFactor = prm.get_double("ADAPTIVE TOLERANCE FACTOR");
     }
     prm.leave_subsection ();
 
@@ -682,6 +792,8 @@ namespace dftParameters
 
     if (dftParameters::numCoreWfcRR>0)
        AssertThrow(false,ExcMessage("DFT-FE Error: SPECTRUM SPLIT CORE EIGENSTATES cannot be set to a non-zero value when using complex executable. This optimization will be added in a future release"));
+
+    AssertThrow(!dftParameters::packedCellHamiltonianMatrices,ExcMessage("DFT-FE Error: PACKED CELL HAMILTONIAN MATRICES cannot be set to true when using complex executable, as the cell level Hamiltonian matrices are not Hermitian for non-zero k points."));
 #else
     AssertThrow( dftParameters::nkx==1 &&  dftParameters::nky==1 &&  dftParameters::nkz==1
              && dftParameters::offsetFlagX==0 &&  dftParameters::offsetFlagY==0 &&  dftParameters::offsetFlagZ==0
@@ -199,6 +199,87 @@ namespace dftfe
 
     }
 
+
+
+    void computeInteriorCellFlags(const std::shared_ptr< const dealii::Utilities::MPI::Partitioner > & partitioner,
+				  const dealii::MatrixFree<3,double>                                 & matrix_free_data,
+				  const dealii::ConstraintMatrix                                     & constraintMatrix,
+				  std::vector<bool>                                                  & isInteriorCell)
+    {
+      const unsigned int numberMacroCells = matrix_free_data.n_macro_cells();
+      const unsigned int numberNodesPerElement = matrix_free_data.get_dofs_per_cell();
+
+      std::vector<dealii::types::global_dof_index> cell_dof_indicesGlobal(numberNodesPerElement);
+
+      isInteriorCell.clear();
+      typename dealii::DoFHandler<3>::active_cell_iterator cellPtr;
+      for(unsigned int iMacroCell = 0; iMacroCell < numberMacroCells; ++iMacroCell)
+	{
+	  const unsigned int n_sub_cells = matrix_free_data.n_components_filled(iMacroCell);
+	  for(unsigned int iCell = 0; iCell < n_sub_cells; ++iCell)
+	    {
+	      cellPtr = matrix_free_data.get_cell_iterator(iMacroCell,iCell);
+	      cellPtr->get_dof_indices(cell_dof_indicesGlobal);
+
+	      bool isInterior = true;
+	      for(unsigned int iNode = 0; iNode < numberNodesPerElement; ++iNode)
+		if(!partitioner->in_local_range(cell_dof_indicesGlobal[iNode])
+		   || constraintMatrix.is_constrained(cell_dof_indicesGlobal[iNode]))
+		  {
+		    isInterior = false;
+		    break;
+		  }
+
+	      isInteriorCell.push_back(isInterior);
+	    }//subcell loop
+	}//macrocell loop
+    }
+
+
+    void computeCellColoring(const std::vector<std::vector<dealii::types::global_dof_index> > & cellLocalProcIndexIdMap,
+			     std::vector<std::vector<unsigned int> >                          & cellColors)
+    {
+      const unsigned int numberCells = cellLocalProcIndexIdMap.size();
+
+      //
+      //create map from node to the cells sharing the node
+      //
+      std::map<dealii::types::global_dof_index,std::vector<unsigned int> > nodeToCellsMap;
+      for(unsigned int iCell = 0; iCell < numberCells; ++iCell)
+	for(unsigned int iNode = 0; iNode < cellLocalProcIndexIdMap[iCell].size(); ++iNode)
+	  nodeToCellsMap[cellLocalProcIndexIdMap[iCell][iNode]].push_back(iCell);
+
+      //
+      //greedy coloring: assign to each cell the smallest color not taken by any
+      //of its already colored neighbours
+      //
+      const unsigned int invalidColor = dealii::numbers::invalid_unsigned_int;
+      std::vector<unsigned int> cellColor(numberCells,invalidColor);
+      std::vector<bool> isColorTaken;
+      cellColors.clear();
+      for(unsigned int iCell = 0; iCell < numberCells; ++iCell)
+	{
+	  isColorTaken.assign(cellColors.size(),false);
+	  for(unsigned int iNode = 0; iNode < cellLocalProcIndexIdMap[iCell].size(); ++iNode)
+	    {
+	      const std::vector<unsigned int> & neighbourCells = nodeToCellsMap[cellLocalProcIndexIdMap[iCell][iNode]];
+	      for(unsigned int i = 0; i < neighbourCells.size(); ++i)
+		if(cellColor[neighbourCells[i]]!=invalidColor)
+		  isColorTaken[cellColor[neighbourCells[i]]] = true;
+	    }
+
+	  unsigned int color = 0;
+	  while(color < cellColors.size() && isColorTaken[color])
+	    ++color;
+
+	  if(color==cellColors.size())
+	    cellColors.push_back(std::vector<unsigned int>());
+
+	  cellColor[iCell] = color;
+	  cellColors[color].push_back(iCell);
+	}
+    }
+
 #ifdef USE_COMPLEX
     void copyFlattenedSTLVecToSingleCompVec
                              (const std::vector<std::complex<double>>  & flattenedArray,